@@ -0,0 +1,358 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_vfs.h"
+#include "app_assets.h"
+
+/* Files open at once */
+#define ASSETS_MAX_FILES    (8)
+
+static const char *TAG = "ASSETS";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    const app_assets_entry_t *entry;    /*!< NULL if the descriptor is free */
+    uint32_t pos;
+} assets_file_t;
+
+typedef struct {
+    DIR dir;                    /*!< Must be first, filled by VFS */
+    struct dirent de;
+    uint32_t next;
+    bool used;
+} assets_dir_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static const uint8_t *assets_image = NULL;
+static const app_assets_header_t *assets_header = NULL;
+static const app_assets_entry_t *assets_entries = NULL;
+static esp_partition_mmap_handle_t assets_mmap;
+
+static portMUX_TYPE assets_lock = portMUX_INITIALIZER_UNLOCKED;
+static assets_file_t assets_files[ASSETS_MAX_FILES];
+static assets_dir_t assets_dir;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+/* Path relative to the mount point, with or without leading slash */
+static const app_assets_entry_t *assets_find(const char *name)
+{
+    if (name[0] == '/') {
+        name++;
+    }
+    for (uint32_t i = 0; i < assets_header->count; i++) {
+        if (strcmp(assets_entries[i].name, name) == 0) {
+            return &assets_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static int assets_vfs_open(const char *path, int flags, int mode)
+{
+    if ((flags & O_ACCMODE) != O_RDONLY) {
+        errno = EROFS;
+        return -1;
+    }
+
+    const app_assets_entry_t *entry = assets_find(path);
+    if (entry == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    int fd = -1;
+    taskENTER_CRITICAL(&assets_lock);
+    for (int i = 0; i < ASSETS_MAX_FILES; i++) {
+        if (assets_files[i].entry == NULL) {
+            assets_files[i].entry = entry;
+            assets_files[i].pos = 0;
+            fd = i;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&assets_lock);
+
+    if (fd < 0) {
+        errno = ENFILE;
+    }
+    return fd;
+}
+
+static ssize_t assets_vfs_read(int fd, void *dst, size_t size)
+{
+    if (fd < 0 || fd >= ASSETS_MAX_FILES || assets_files[fd].entry == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    /* Copy straight from the mapped flash */
+    assets_file_t *file = &assets_files[fd];
+    uint32_t left = file->entry->size - file->pos;
+    if (size > left) {
+        size = left;
+    }
+    memcpy(dst, assets_image + file->entry->offset + file->pos, size);
+    file->pos += size;
+
+    return size;
+}
+
+static off_t assets_vfs_lseek(int fd, off_t offset, int whence)
+{
+    if (fd < 0 || fd >= ASSETS_MAX_FILES || assets_files[fd].entry == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    assets_file_t *file = &assets_files[fd];
+    off_t pos;
+    switch (whence) {
+    case SEEK_SET:
+        pos = offset;
+        break;
+    case SEEK_CUR:
+        pos = (off_t)file->pos + offset;
+        break;
+    case SEEK_END:
+        pos = (off_t)file->entry->size + offset;
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    if (pos < 0 || pos > (off_t)file->entry->size) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    file->pos = pos;
+    return pos;
+}
+
+static int assets_vfs_close(int fd)
+{
+    if (fd < 0 || fd >= ASSETS_MAX_FILES || assets_files[fd].entry == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    assets_files[fd].entry = NULL;
+    return 0;
+}
+
+static void assets_fill_stat(const app_assets_entry_t *entry, struct stat *st)
+{
+    memset(st, 0, sizeof(struct stat));
+    st->st_mode = S_IFREG | S_IRUSR | S_IRGRP | S_IROTH;
+    st->st_size = entry->size;
+}
+
+static int assets_vfs_fstat(int fd, struct stat *st)
+{
+    if (fd < 0 || fd >= ASSETS_MAX_FILES || assets_files[fd].entry == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+
+    assets_fill_stat(assets_files[fd].entry, st);
+    return 0;
+}
+
+static int assets_vfs_stat(const char *path, struct stat *st)
+{
+    const app_assets_entry_t *entry = assets_find(path);
+    if (entry == NULL) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    assets_fill_stat(entry, st);
+    return 0;
+}
+
+/* The pack is flat, only the root can be listed (by one lister at a time) */
+static DIR *assets_vfs_opendir(const char *name)
+{
+    if (strcmp(name, "/") != 0 && name[0] != '\0') {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    DIR *dir = NULL;
+    taskENTER_CRITICAL(&assets_lock);
+    if (!assets_dir.used) {
+        assets_dir.used = true;
+        assets_dir.next = 0;
+        dir = &assets_dir.dir;
+    }
+    taskEXIT_CRITICAL(&assets_lock);
+
+    if (dir == NULL) {
+        errno = ENFILE;
+    }
+    return dir;
+}
+
+static struct dirent *assets_vfs_readdir(DIR *pdir)
+{
+    assets_dir_t *dir = (assets_dir_t *)pdir;
+
+    if (dir->next >= assets_header->count) {
+        return NULL;
+    }
+
+    const app_assets_entry_t *entry = &assets_entries[dir->next];
+    dir->de.d_ino = dir->next;
+    dir->de.d_type = DT_REG;
+    strlcpy(dir->de.d_name, entry->name, sizeof(dir->de.d_name));
+    dir->next++;
+
+    return &dir->de;
+}
+
+static int assets_vfs_closedir(DIR *pdir)
+{
+    assets_dir_t *dir = (assets_dir_t *)pdir;
+
+    dir->used = false;
+    return 0;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_assets_check(const uint8_t *image, size_t size)
+{
+    const app_assets_header_t *header = (const app_assets_header_t *)image;
+
+    if (size < sizeof(app_assets_header_t) || header->magic != APP_ASSETS_MAGIC) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (header->version != APP_ASSETS_VERSION || header->entry_size != sizeof(app_assets_entry_t)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    /* Count is bound first, its index size cannot wrap */
+    if (header->image_size > size || header->image_size < sizeof(app_assets_header_t) ||
+            header->count > (header->image_size - sizeof(app_assets_header_t)) / sizeof(app_assets_entry_t)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t index_size = (size_t)header->count * sizeof(app_assets_entry_t);
+
+    const app_assets_entry_t *entries = (const app_assets_entry_t *)(image + sizeof(app_assets_header_t));
+    if (esp_rom_crc32_le(0, (const uint8_t *)entries, index_size) != header->index_crc) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    /* Index is valid, check the entries fit the image */
+    for (uint32_t i = 0; i < header->count; i++) {
+        if (entries[i].name[APP_ASSETS_NAME_LEN - 1] != '\0' ||
+                entries[i].offset > header->image_size || entries[i].size > header->image_size - entries[i].offset) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_assets_init(void)
+{
+    app_assets_header_t header;
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, APP_ASSETS_SUBTYPE, APP_ASSETS_PARTITION);
+    if (part == NULL) {
+        ESP_LOGW(TAG, "No asset pack partition");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* Map only the used part of the partition */
+    esp_err_t ret = esp_partition_read(part, 0, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (header.magic != APP_ASSETS_MAGIC || header.image_size > part->size) {
+        ESP_LOGW(TAG, "No asset pack in partition");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *ptr;
+    ret = esp_partition_mmap(part, 0, header.image_size, ESP_PARTITION_MMAP_DATA, &ptr, &assets_mmap);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot map asset pack (%s)", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = app_assets_check(ptr, header.image_size);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid asset pack (%s)", esp_err_to_name(ret));
+        esp_partition_munmap(assets_mmap);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    assets_image = ptr;
+    assets_header = ptr;
+    assets_entries = (const app_assets_entry_t *)(assets_image + sizeof(app_assets_header_t));
+
+    const esp_vfs_t vfs = {
+        .flags = ESP_VFS_FLAG_DEFAULT,
+        .open = assets_vfs_open,
+        .read = assets_vfs_read,
+        .lseek = assets_vfs_lseek,
+        .close = assets_vfs_close,
+        .fstat = assets_vfs_fstat,
+        .stat = assets_vfs_stat,
+        .opendir = assets_vfs_opendir,
+        .readdir = assets_vfs_readdir,
+        .closedir = assets_vfs_closedir,
+    };
+    ret = esp_vfs_register(APP_ASSETS_MOUNT_POINT, &vfs, NULL);
+    if (ret != ESP_OK) {
+        esp_partition_munmap(assets_mmap);
+        assets_image = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Asset pack: %" PRIu32 " files, %" PRIu32 " bytes mapped at %p", assets_header->count, assets_header->image_size, ptr);
+    return ESP_OK;
+}
+
+esp_err_t app_assets_get(const char *path, const uint8_t **data, size_t *size)
+{
+    const size_t mount_len = strlen(APP_ASSETS_MOUNT_POINT);
+
+    if (assets_image == NULL || strncmp(path, APP_ASSETS_MOUNT_POINT, mount_len) != 0 || path[mount_len] != '/') {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const app_assets_entry_t *entry = assets_find(&path[mount_len]);
+    if (entry == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    *data = assets_image + entry->offset;
+    *size = entry->size;
+    return ESP_OK;
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/* Static media files are served from here */
+#define APP_ASSETS_MOUNT_POINT  "/assets"
+/* Asset pack partition */
+#define APP_ASSETS_PARTITION    "assets"
+#define APP_ASSETS_SUBTYPE      (0x40)
+
+/*
+ * Asset pack image format (little endian), made by tools/mkassetpack.py
+ *
+ * header | entry[count] | data (each entry aligned to header.align)
+ */
+#define APP_ASSETS_MAGIC        (0x4B415041)    /* "APAK" */
+#define APP_ASSETS_VERSION      (1)
+#define APP_ASSETS_NAME_LEN     (48)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;        /*!< sizeof(app_assets_entry_t) */
+    uint32_t count;
+    uint32_t index_crc;         /*!< CRC32 of all entries */
+    uint32_t align;
+    uint32_t image_size;        /*!< Header, index and data */
+    uint32_t reserved[2];
+} app_assets_header_t;
+
+typedef struct {
+    char name[APP_ASSETS_NAME_LEN];     /*!< NUL terminated file name */
+    uint32_t offset;            /*!< From the start of the image */
+    uint32_t size;
+    uint32_t crc;               /*!< CRC32 of the data */
+    uint32_t reserved;
+} app_assets_entry_t;
+
+/**
+ * @brief Map the asset pack partition and mount it (read-only) at APP_ASSETS_MOUNT_POINT
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there is no partition or no valid pack in it
+ */
+esp_err_t app_assets_init(void);
+
+/**
+ * @brief Get memory-mapped data of asset file
+ *
+ * @param path Full path (starting with APP_ASSETS_MOUNT_POINT)
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the path is not in the pack
+ */
+esp_err_t app_assets_get(const char *path, const uint8_t **data, size_t *size);
+
+/**
+ * @brief Check asset pack index in memory
+ *
+ * @return ESP_OK when valid, ESP_ERR_INVALID_VERSION, ESP_ERR_INVALID_SIZE or ESP_ERR_INVALID_CRC otherwise
+ */
+esp_err_t app_assets_check(const uint8_t *image, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,544 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "app_mem.h"
+#include "app_audio_dec.h"
+
+#define WAV_FORMAT_PCM          (0x0001)
+#define WAV_FORMAT_IMA_ADPCM    (0x0011)
+#define WAV_FORMAT_EXTENSIBLE   (0xFFFE)
+
+/* Size of the header written by older firmware (no RIFF/fmt chunk IDs, fixed layout) */
+#define WAV_LEGACY_HEADER_SIZE  (44)
+/* Size of "fmt " chunk of WAVE_FORMAT_EXTENSIBLE, up to the end of SubFormat GUID */
+#define WAV_FMT_EXTENSIBLE_SIZE (40)
+
+static const char *TAG = "AUDIO_DEC";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint16_t block_align;
+    uint16_t bits_per_sample;
+    uint16_t samples_per_block;     /*!< ADPCM only */
+    uint32_t fact_frames;           /*!< Length from "fact" chunk, 0 if not present */
+    uint32_t data_offset;
+    uint32_t data_size;
+} wav_fmt_t;
+
+typedef struct {
+    FILE *file;
+    wav_fmt_t fmt;
+    uint32_t data_pos;              /*!< Bytes of "data" chunk consumed */
+} wav_pcm_ctx_t;
+
+typedef struct {
+    int32_t predictor;
+    int32_t index;
+} ima_state_t;
+
+typedef struct {
+    FILE *file;
+    wav_fmt_t fmt;
+    uint32_t data_pos;              /*!< Bytes of "data" chunk consumed */
+    uint8_t *block;                 /*!< Encoded block, block_align bytes */
+    int16_t *pcm;                   /*!< Decoded block, samples_per_block * channels samples */
+    size_t pcm_pos;                 /*!< Next sample to output */
+    size_t pcm_len;                 /*!< Valid samples in pcm buffer */
+    uint32_t total_frames;          /*!< The last block is padded, stop at the stream length */
+    uint32_t frames_left;
+} wav_ima_ctx_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+static const app_audio_decoder_t *decoders[APP_AUDIO_DEC_MAX] = {
+    &app_audio_dec_wav_pcm,
+    &app_audio_dec_wav_ima_adpcm,
+};
+static size_t decoders_count = 2;
+
+static const int16_t ima_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/* SubFormat GUIDs of WAVE_FORMAT_EXTENSIBLE are the format tag followed by this (KSDATAFORMAT_SUBTYPE_*) */
+static const uint8_t wav_subformat_guid[14] = {
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
+static const int8_t ima_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_audio_dec_register(const app_audio_decoder_t *decoder)
+{
+    assert(decoder != NULL);
+    assert(decoder->open && decoder->decode && decoder->seek && decoder->close);
+
+    if (decoders_count >= APP_AUDIO_DEC_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    decoders[decoders_count++] = decoder;
+    return ESP_OK;
+}
+
+const app_audio_decoder_t *app_audio_dec_open(app_file_type_t type, FILE *file, void **ctx, app_audio_info_t *info)
+{
+    assert(file != NULL && ctx != NULL && info != NULL);
+
+    for (size_t i = 0; i < decoders_count; i++) {
+        if (decoders[i]->type != type) {
+            continue;
+        }
+
+        fseek(file, 0, SEEK_SET);
+        esp_err_t ret = decoders[i]->open(file, ctx, info);
+        if (ret == ESP_OK) {
+            ESP_LOGI(TAG, "Decoder: %s", decoders[i]->name);
+            return decoders[i];
+        } else if (ret != ESP_ERR_NOT_SUPPORTED) {
+            ESP_LOGW(TAG, "Decoder %s failed: %s", decoders[i]->name, esp_err_to_name(ret));
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint16_t rd16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool wav_is_zero(const uint8_t *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (p[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Legacy header (see dumb_wav_header_t): only channels, sample rate, bits per sample and data
+ * size are written, all other bytes are zero. Any other file without RIFF header is rejected.
+ */
+static esp_err_t wav_parse_legacy(const uint8_t *buf, wav_fmt_t *fmt)
+{
+    if (!wav_is_zero(&buf[0], 22) || !wav_is_zero(&buf[28], 6) || !wav_is_zero(&buf[36], 4)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    fmt->format = WAV_FORMAT_PCM;
+    fmt->channels = rd16(&buf[22]);
+    fmt->sample_rate = rd32(&buf[24]);
+    fmt->bits_per_sample = rd16(&buf[34]);
+    fmt->block_align = fmt->channels * fmt->bits_per_sample / 8;
+    fmt->data_size = rd32(&buf[40]);
+    fmt->data_offset = WAV_LEGACY_HEADER_SIZE;
+
+    if (fmt->channels == 0 || fmt->channels > 2 || fmt->sample_rate == 0 ||
+            (fmt->bits_per_sample != 8 && fmt->bits_per_sample != 16)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    return ESP_OK;
+}
+
+/* Find "fmt " and "data" chunks, files without RIFF header are checked for legacy recording header */
+static esp_err_t wav_parse(FILE *file, wav_fmt_t *fmt)
+{
+    uint8_t buf[WAV_LEGACY_HEADER_SIZE];
+
+    memset(fmt, 0, sizeof(wav_fmt_t));
+
+    if (fread(buf, 1, 12, file) != 12) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (memcmp(buf, "RIFF", 4) != 0 || memcmp(&buf[8], "WAVE", 4) != 0) {
+        if (fread(&buf[12], 1, WAV_LEGACY_HEADER_SIZE - 12, file) != WAV_LEGACY_HEADER_SIZE - 12) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        return wav_parse_legacy(buf, fmt);
+    }
+
+    bool fmt_found = false;
+    while (fread(buf, 1, 8, file) == 8) {
+        uint32_t chunk_size = rd32(&buf[4]);
+
+        if (memcmp(buf, "fmt ", 4) == 0) {
+            size_t len = chunk_size < WAV_FMT_EXTENSIBLE_SIZE ? chunk_size : WAV_FMT_EXTENSIBLE_SIZE;
+            if (len < 16 || fread(buf, 1, len, file) != len) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            fmt->format = rd16(&buf[0]);
+            fmt->channels = rd16(&buf[2]);
+            fmt->sample_rate = rd32(&buf[4]);
+            fmt->block_align = rd16(&buf[12]);
+            fmt->bits_per_sample = rd16(&buf[14]);
+            if (len >= 20) {
+                fmt->samples_per_block = rd16(&buf[18]);
+            }
+            if (fmt->format == WAV_FORMAT_EXTENSIBLE) {
+                /* Actual format is given by SubFormat GUID, unknown GUIDs are left as EXTENSIBLE */
+                if (len == WAV_FMT_EXTENSIBLE_SIZE && memcmp(&buf[26], wav_subformat_guid, sizeof(wav_subformat_guid)) == 0) {
+                    fmt->format = rd16(&buf[24]);
+                }
+            }
+            fseek(file, (chunk_size - len) + (chunk_size & 1), SEEK_CUR);
+            fmt_found = true;
+        } else if (memcmp(buf, "fact", 4) == 0 && chunk_size >= 4) {
+            if (fread(&buf[8], 1, 4, file) != 4) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            fmt->fact_frames = rd32(&buf[8]);
+            fseek(file, (chunk_size - 4) + (chunk_size & 1), SEEK_CUR);
+        } else if (memcmp(buf, "data", 4) == 0) {
+            fmt->data_offset = ftell(file);
+            fmt->data_size = chunk_size;
+            break;
+        } else {
+            fseek(file, chunk_size + (chunk_size & 1), SEEK_CUR);
+        }
+    }
+
+    if (!fmt_found || fmt->data_offset == 0 || fmt->channels == 0 || fmt->block_align == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+/* ---------------------------- Raw PCM WAV ---------------------------------- */
+
+static esp_err_t wav_pcm_open(FILE *file, void **ctx, app_audio_info_t *info)
+{
+    wav_fmt_t fmt;
+    esp_err_t ret = wav_parse(file, &fmt);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* Integer PCM only (also EXTENSIBLE with KSDATAFORMAT_SUBTYPE_PCM), float and unknown formats are rejected */
+    if (fmt.format != WAV_FORMAT_PCM) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if ((fmt.bits_per_sample != 8 && fmt.bits_per_sample != 16 && fmt.bits_per_sample != 24 && fmt.bits_per_sample != 32) ||
+            fmt.block_align != fmt.channels * fmt.bits_per_sample / 8) {
+        ESP_LOGW(TAG, "Unsupported PCM: %" PRIu16 " bits, block %" PRIu16, fmt.bits_per_sample, fmt.block_align);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    wav_pcm_ctx_t *pcm = app_mem_arena_alloc(APP_MEM_ARENA_PLAY, sizeof(wav_pcm_ctx_t));
+    if (pcm == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    pcm->file = file;
+    pcm->fmt = fmt;
+    fseek(file, fmt.data_offset, SEEK_SET);
+
+    info->sample_rate = fmt.sample_rate;
+    info->channels = fmt.channels;
+    info->bits_per_sample = fmt.bits_per_sample;
+    info->total_frames = fmt.data_size / fmt.block_align;
+    *ctx = pcm;
+
+    return ESP_OK;
+}
+
+static esp_err_t wav_pcm_decode(void *ctx, void *out, size_t len, size_t *out_len)
+{
+    wav_pcm_ctx_t *pcm = ctx;
+    uint32_t left = pcm->fmt.data_size - pcm->data_pos;
+
+    if (len > left) {
+        len = left;
+    }
+
+    *out_len = fread(out, 1, len, pcm->file);
+    pcm->data_pos += *out_len;
+
+    return ferror(pcm->file) ? ESP_FAIL : ESP_OK;
+}
+
+static esp_err_t wav_pcm_seek(void *ctx, uint32_t frame)
+{
+    wav_pcm_ctx_t *pcm = ctx;
+    /* 64 bits, a frame far past the end must not wrap into the data */
+    uint64_t pos = (uint64_t)frame * pcm->fmt.block_align;
+
+    if (pos > pcm->fmt.data_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pcm->data_pos = pos;
+    return fseek(pcm->file, pcm->fmt.data_offset + pos, SEEK_SET) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+static void wav_pcm_close(void *ctx)
+{
+    app_mem_arena_free(APP_MEM_ARENA_PLAY, ctx);
+}
+
+const app_audio_decoder_t app_audio_dec_wav_pcm = {
+    .name = "WAV PCM",
+    .type = APP_FILE_TYPE_WAV,
+    .open = wav_pcm_open,
+    .decode = wav_pcm_decode,
+    .seek = wav_pcm_seek,
+    .close = wav_pcm_close,
+};
+
+/* ---------------------------- IMA ADPCM WAV -------------------------------- */
+
+static inline int16_t ima_decode_nibble(ima_state_t *st, uint8_t nibble)
+{
+    int32_t step = ima_step_table[st->index];
+    int32_t diff = step >> 3;
+
+    if (nibble & 1) {
+        diff += step >> 2;
+    }
+    if (nibble & 2) {
+        diff += step >> 1;
+    }
+    if (nibble & 4) {
+        diff += step;
+    }
+    if (nibble & 8) {
+        diff = -diff;
+    }
+
+    st->predictor += diff;
+    if (st->predictor > INT16_MAX) {
+        st->predictor = INT16_MAX;
+    } else if (st->predictor < INT16_MIN) {
+        st->predictor = INT16_MIN;
+    }
+
+    st->index += ima_index_table[nibble];
+    if (st->index < 0) {
+        st->index = 0;
+    } else if (st->index > 88) {
+        st->index = 88;
+    }
+
+    return (int16_t)st->predictor;
+}
+
+/* Decode one block (or shorter last block) into interleaved PCM, returns number of frames */
+static size_t ima_decode_block(const uint8_t *block, size_t size, uint16_t channels, int16_t *pcm)
+{
+    ima_state_t st[2];
+
+    if (size <= 4U * channels) {
+        return 0;
+    }
+
+    /* Block header per channel: first sample and step index */
+    for (int c = 0; c < channels; c++) {
+        st[c].predictor = (int16_t)rd16(&block[4 * c]);
+        st[c].index = block[4 * c + 2] > 88 ? 88 : block[4 * c + 2];
+        pcm[c] = (int16_t)st[c].predictor;
+    }
+
+    /* Data: 4 bytes (8 samples) per channel, channels interleaved */
+    size_t groups = (size - 4 * channels) / (4 * channels);
+    const uint8_t *data = &block[4 * channels];
+    for (size_t g = 0; g < groups; g++) {
+        for (int c = 0; c < channels; c++) {
+            int16_t *out = &pcm[(1 + g * 8) * channels + c];
+            for (int b = 0; b < 4; b++) {
+                uint8_t byte = *data++;
+                out[(2 * b) * channels] = ima_decode_nibble(&st[c], byte & 0x0F);
+                out[(2 * b + 1) * channels] = ima_decode_nibble(&st[c], byte >> 4);
+            }
+        }
+    }
+
+    return groups * 8 + 1;
+}
+
+static esp_err_t wav_ima_next_block(wav_ima_ctx_t *ima)
+{
+    uint32_t left = ima->fmt.data_size - ima->data_pos;
+    size_t len = left < ima->fmt.block_align ? left : ima->fmt.block_align;
+
+    ima->pcm_pos = 0;
+    ima->pcm_len = 0;
+    if (len == 0) {
+        return ESP_OK;
+    }
+
+    len = fread(ima->block, 1, len, ima->file);
+    ima->data_pos += len;
+    ima->pcm_len = ima_decode_block(ima->block, len, ima->fmt.channels, ima->pcm) * ima->fmt.channels;
+
+    return ferror(ima->file) ? ESP_FAIL : ESP_OK;
+}
+
+static void wav_ima_close(void *ctx)
+{
+    wav_ima_ctx_t *ima = ctx;
+
+    app_mem_arena_free(APP_MEM_ARENA_PLAY, ima->pcm);
+    app_mem_arena_free(APP_MEM_ARENA_PLAY, ima->block);
+    app_mem_arena_free(APP_MEM_ARENA_PLAY, ima);
+}
+
+static esp_err_t wav_ima_open(FILE *file, void **ctx, app_audio_info_t *info)
+{
+    wav_fmt_t fmt;
+    esp_err_t ret = wav_parse(file, &fmt);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (fmt.format != WAV_FORMAT_IMA_ADPCM) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (fmt.bits_per_sample != 4 || fmt.channels > 2 || fmt.block_align <= 4 * fmt.channels) {
+        ESP_LOGW(TAG, "Unsupported IMA ADPCM: %" PRIu16 " bits, %" PRIu16 " channels", fmt.bits_per_sample, fmt.channels);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Every block holds the same number of frames, given by block alignment */
+    uint16_t samples_per_block = ((fmt.block_align - 4 * fmt.channels) * 2) / fmt.channels + 1;
+    if (fmt.samples_per_block != 0 && fmt.samples_per_block != samples_per_block) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    fmt.samples_per_block = samples_per_block;
+
+    wav_ima_ctx_t *ima = app_mem_arena_alloc(APP_MEM_ARENA_PLAY, sizeof(wav_ima_ctx_t));
+    if (ima == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    ima->file = file;
+    ima->fmt = fmt;
+    ima->block = app_mem_arena_alloc(APP_MEM_ARENA_PLAY, fmt.block_align);
+    ima->pcm = app_mem_arena_alloc(APP_MEM_ARENA_PLAY, samples_per_block * fmt.channels * sizeof(int16_t));
+    if (ima->block == NULL || ima->pcm == NULL) {
+        wav_ima_close(ima);
+        return ESP_ERR_NO_MEM;
+    }
+    fseek(file, fmt.data_offset, SEEK_SET);
+
+    info->sample_rate = fmt.sample_rate;
+    info->channels = fmt.channels;
+    info->bits_per_sample = 16;
+    if (fmt.fact_frames) {
+        info->total_frames = fmt.fact_frames;
+    } else {
+        info->total_frames = (fmt.data_size / fmt.block_align) * samples_per_block;
+    }
+    ima->total_frames = info->total_frames;
+    ima->frames_left = info->total_frames;
+    *ctx = ima;
+
+    return ESP_OK;
+}
+
+static esp_err_t wav_ima_decode(void *ctx, void *out, size_t len, size_t *out_len)
+{
+    wav_ima_ctx_t *ima = ctx;
+    int16_t *dst = out;
+    size_t samples = len / sizeof(int16_t);
+    size_t done = 0;
+
+    if (samples > (size_t)ima->frames_left * ima->fmt.channels) {
+        samples = (size_t)ima->frames_left * ima->fmt.channels;
+    }
+
+    while (done < samples) {
+        if (ima->pcm_pos >= ima->pcm_len) {
+            esp_err_t ret = wav_ima_next_block(ima);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+            if (ima->pcm_len == 0) {
+                break;
+            }
+        }
+
+        size_t n = ima->pcm_len - ima->pcm_pos;
+        if (n > samples - done) {
+            n = samples - done;
+        }
+        memcpy(&dst[done], &ima->pcm[ima->pcm_pos], n * sizeof(int16_t));
+        ima->pcm_pos += n;
+        done += n;
+    }
+
+    ima->frames_left -= done / ima->fmt.channels;
+    *out_len = done * sizeof(int16_t);
+    return ESP_OK;
+}
+
+static esp_err_t wav_ima_seek(void *ctx, uint32_t frame)
+{
+    wav_ima_ctx_t *ima = ctx;
+    uint32_t block = frame / ima->fmt.samples_per_block;
+    uint64_t pos = (uint64_t)block * ima->fmt.block_align;
+
+    if (pos > ima->fmt.data_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (fseek(ima->file, ima->fmt.data_offset + pos, SEEK_SET) != 0) {
+        return ESP_FAIL;
+    }
+    ima->data_pos = pos;
+    ima->frames_left = frame < ima->total_frames ? ima->total_frames - frame : 0;
+
+    esp_err_t ret = wav_ima_next_block(ima);
+    if (ret == ESP_OK) {
+        size_t skip = (frame % ima->fmt.samples_per_block) * ima->fmt.channels;
+        ima->pcm_pos = skip < ima->pcm_len ? skip : ima->pcm_len;
+    }
+
+    return ret;
+}
+
+const app_audio_decoder_t app_audio_dec_wav_ima_adpcm = {
+    .name = "WAV IMA ADPCM",
+    .type = APP_FILE_TYPE_WAV,
+    .open = wav_ima_open,
+    .decode = wav_ima_decode,
+    .seek = wav_ima_seek,
+    .close = wav_ima_close,
+};
@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "app_file_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximal number of registered audio decoders */
+#define APP_AUDIO_DEC_MAX   (8)
+
+/**
+ * @brief Format of the decoded PCM stream
+ */
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits_per_sample;   /*!< Bits per sample of the decoded output */
+    uint32_t total_frames;      /*!< Length of the stream in frames (samples per channel), 0 if unknown */
+} app_audio_info_t;
+
+/**
+ * @brief Audio decoder plug-in
+ *
+ * All callbacks work on an already opened file, the file is owned by the caller.
+ * Decoder state is allocated from APP_MEM_ARENA_PLAY, owned by the caller during playback.
+ */
+typedef struct {
+    const char *name;
+    app_file_type_t type;       /*!< File type handled by this decoder */
+
+    /**
+     * @brief Check stream format and prepare decoding from the first sample
+     *
+     * @return ESP_ERR_NOT_SUPPORTED when the stream is not in a format of this decoder,
+     *         the next decoder registered for the same file type is tried then
+     */
+    esp_err_t (*open)(FILE *file, void **ctx, app_audio_info_t *info);
+
+    /**
+     * @brief Decode next block of PCM data, *out_len is 0 at the end of the stream
+     */
+    esp_err_t (*decode)(void *ctx, void *out, size_t len, size_t *out_len);
+
+    /**
+     * @brief Continue decoding from frame
+     */
+    esp_err_t (*seek)(void *ctx, uint32_t frame);
+
+    void (*close)(void *ctx);
+} app_audio_decoder_t;
+
+/**
+ * @brief Register audio decoder, the built-in WAV decoders are always available
+ */
+esp_err_t app_audio_dec_register(const app_audio_decoder_t *decoder);
+
+/**
+ * @brief Open stream by the first decoder of the file type, which accepts its format
+ *
+ * @return Decoder used for the stream or NULL, if no decoder accepted it
+ */
+const app_audio_decoder_t *app_audio_dec_open(app_file_type_t type, FILE *file, void **ctx, app_audio_info_t *info);
+
+/* Built-in decoders */
+extern const app_audio_decoder_t app_audio_dec_wav_pcm;
+extern const app_audio_decoder_t app_audio_dec_wav_ima_adpcm;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "app_avi.h"
+
+#define AVI_WAVE_FORMAT_PCM     (0x0001)
+
+static const char *TAG = "AVI";
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint16_t rd16le(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Read chunk header (FourCC and size) at offset */
+static bool avi_chunk_at(FILE *file, uint32_t offset, uint8_t hdr[12], size_t len)
+{
+    return fseek(file, offset, SEEK_SET) == 0 && fread(hdr, 1, len, file) == len;
+}
+
+/* Stream header list: "strh" and "strf" chunks of one stream */
+static void avi_parse_strl(app_avi_t *avi, uint32_t pos, uint32_t end, int8_t stream)
+{
+    uint8_t hdr[12];
+    uint8_t strh[36] = { 0 };
+    bool video = false, audio = false;
+
+    while (pos + 8 <= end && avi_chunk_at(avi->file, pos, hdr, 8)) {
+        uint32_t size = rd32le(&hdr[4]);
+
+        if (memcmp(hdr, "strh", 4) == 0) {
+            fread(strh, 1, size < sizeof(strh) ? size : sizeof(strh), avi->file);
+            video = (memcmp(strh, "vids", 4) == 0);
+            audio = (memcmp(strh, "auds", 4) == 0);
+        } else if (memcmp(hdr, "strf", 4) == 0 && video && avi->video_stream < 0) {
+            uint8_t bih[20] = { 0 };
+            fread(bih, 1, size < sizeof(bih) ? size : sizeof(bih), avi->file);
+            if (memcmp(&bih[16], "MJPG", 4) == 0 || memcmp(&strh[4], "MJPG", 4) == 0 || memcmp(&strh[4], "mjpg", 4) == 0) {
+                int32_t h = (int32_t)rd32le(&bih[8]);
+                avi->video_stream = stream;
+                avi->info.width = rd32le(&bih[4]);
+                avi->info.height = h < 0 ? -h : h;
+                /* Frame rate of the stream is more precise than the main header */
+                uint32_t scale = rd32le(&strh[20]);
+                uint32_t rate = rd32le(&strh[24]);
+                if (scale && rate) {
+                    avi->info.frame_us = (uint32_t)((uint64_t)scale * 1000000 / rate);
+                }
+                if (rd32le(&strh[32])) {
+                    avi->info.total_frames = rd32le(&strh[32]);
+                }
+            } else {
+                ESP_LOGW(TAG, "Video codec %.4s not supported", (const char *)&bih[16]);
+            }
+        } else if (memcmp(hdr, "strf", 4) == 0 && audio && avi->audio_stream < 0) {
+            uint8_t wfx[16] = { 0 };
+            fread(wfx, 1, size < sizeof(wfx) ? size : sizeof(wfx), avi->file);
+            if (rd16le(&wfx[0]) == AVI_WAVE_FORMAT_PCM && rd16le(&wfx[14]) == 16) {
+                avi->audio_stream = stream;
+                avi->info.has_audio = true;
+                avi->info.channels = rd16le(&wfx[2]);
+                avi->info.sample_rate = rd32le(&wfx[4]);
+                avi->info.bits_per_sample = 16;
+            } else {
+                ESP_LOGW(TAG, "Audio format 0x%04x, %u bits not supported, playing without sound", rd16le(&wfx[0]), rd16le(&wfx[14]));
+            }
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+}
+
+/* Header list: main header and stream lists */
+static void avi_parse_hdrl(app_avi_t *avi, uint32_t pos, uint32_t end)
+{
+    uint8_t hdr[12];
+    int8_t stream = 0;
+
+    while (pos + 8 <= end && avi_chunk_at(avi->file, pos, hdr, 12)) {
+        uint32_t size = rd32le(&hdr[4]);
+
+        if (memcmp(hdr, "avih", 4) == 0) {
+            uint8_t avih[20] = { 0 };
+            fseek(avi->file, pos + 8, SEEK_SET);
+            fread(avih, 1, size < sizeof(avih) ? size : sizeof(avih), avi->file);
+            avi->info.frame_us = rd32le(&avih[0]);
+            avi->info.total_frames = rd32le(&avih[16]);
+        } else if (memcmp(hdr, "LIST", 4) == 0 && memcmp(&hdr[8], "strl", 4) == 0) {
+            avi_parse_strl(avi, pos + 12, pos + 8 + size, stream++);
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_avi_open(app_avi_t *avi, FILE *file)
+{
+    uint8_t hdr[12];
+
+    assert(avi != NULL && file != NULL);
+
+    memset(avi, 0, sizeof(app_avi_t));
+    avi->file = file;
+    avi->video_stream = -1;
+    avi->audio_stream = -1;
+
+    if (!avi_chunk_at(file, 0, hdr, 12) || memcmp(hdr, "RIFF", 4) != 0 || memcmp(&hdr[8], "AVI ", 4) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t riff_end = 8 + rd32le(&hdr[4]);
+
+    /* Top level lists, the stream data follows the headers */
+    uint32_t pos = 12;
+    while (pos + 12 <= riff_end && avi_chunk_at(file, pos, hdr, 12)) {
+        uint32_t size = rd32le(&hdr[4]);
+
+        if (memcmp(hdr, "LIST", 4) == 0 && memcmp(&hdr[8], "hdrl", 4) == 0) {
+            avi_parse_hdrl(avi, pos + 12, pos + 8 + size);
+        } else if (memcmp(hdr, "LIST", 4) == 0 && memcmp(&hdr[8], "movi", 4) == 0) {
+            avi->pos = pos + 12;
+            avi->movi_end = pos + 8 + size;
+            break;
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+
+    if (avi->video_stream < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (avi->movi_end == 0 || avi->info.frame_us == 0 || avi->info.width == 0 || avi->info.height == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(TAG, "MJPEG %" PRIu16 "x%" PRIu16 ", %" PRIu32 " us/frame, %" PRIu32 " frames",
+             avi->info.width, avi->info.height, avi->info.frame_us, avi->info.total_frames);
+    if (avi->info.has_audio) {
+        ESP_LOGI(TAG, "PCM %" PRIu32 " Hz, %" PRIu16 " channels", avi->info.sample_rate, avi->info.channels);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_avi_next_chunk(app_avi_t *avi, app_avi_chunk_t *type, uint32_t *size)
+{
+    uint8_t hdr[12];
+
+    assert(avi != NULL && type != NULL && size != NULL);
+
+    while (avi->pos + 8 <= avi->movi_end && avi_chunk_at(avi->file, avi->pos, hdr, 8)) {
+        uint32_t chunk_size = rd32le(&hdr[4]);
+
+        /* "rec " lists group chunks of one time slot, descend into them */
+        if (memcmp(hdr, "LIST", 4) == 0) {
+            avi->pos += 12;
+            continue;
+        }
+
+        uint32_t data = avi->pos + 8;
+        avi->pos = data + chunk_size + (chunk_size & 1);
+
+        /* Chunk ID is stream number in two digits and type: "00dc", "01wb" */
+        if (hdr[0] < '0' || hdr[0] > '9' || hdr[1] < '0' || hdr[1] > '9') {
+            continue;
+        }
+        int8_t stream = (hdr[0] - '0') * 10 + (hdr[1] - '0');
+        if (stream == avi->video_stream && hdr[2] == 'd' && (hdr[3] == 'c' || hdr[3] == 'b')) {
+            *type = APP_AVI_CHUNK_VIDEO;
+        } else if (stream == avi->audio_stream && hdr[2] == 'w' && hdr[3] == 'b') {
+            *type = APP_AVI_CHUNK_AUDIO;
+        } else {
+            continue;
+        }
+
+        /* The data follows the header, no seek is needed */
+        avi->chunk_left = chunk_size;
+        *size = chunk_size;
+        return ESP_OK;
+    }
+
+    avi->chunk_left = 0;
+    return ESP_ERR_NOT_FOUND;
+}
+
+size_t app_avi_read(app_avi_t *avi, void *buf, size_t len)
+{
+    assert(avi != NULL && buf != NULL);
+
+    if (len > avi->chunk_left) {
+        len = avi->chunk_left;
+    }
+    len = fread(buf, 1, len, avi->file);
+    avi->chunk_left -= len;
+
+    return len;
+}
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Streams of the AVI file
+ */
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t frame_us;          /*!< Video frame duration */
+    uint32_t total_frames;
+    bool has_audio;             /*!< PCM audio stream is present */
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint16_t bits_per_sample;
+} app_avi_info_t;
+
+typedef enum {
+    APP_AVI_CHUNK_VIDEO,        /*!< One JPEG frame */
+    APP_AVI_CHUNK_AUDIO,        /*!< PCM samples */
+} app_avi_chunk_t;
+
+/**
+ * @brief AVI demuxer, reads the "movi" list sequentially with one file
+ */
+typedef struct {
+    FILE *file;
+    app_avi_info_t info;
+    uint32_t movi_end;          /*!< End offset of the "movi" list */
+    uint32_t pos;               /*!< Offset of the next chunk header */
+    uint32_t chunk_left;        /*!< Unread data of the current chunk */
+    int8_t video_stream;
+    int8_t audio_stream;
+} app_avi_t;
+
+/**
+ * @brief Parse AVI headers of MJPEG video with optional PCM audio
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED for other codecs, ESP_ERR_INVALID_ARG if not an AVI file
+ */
+esp_err_t app_avi_open(app_avi_t *avi, FILE *file);
+
+/**
+ * @brief Skip to the next video or audio chunk, other chunks are ignored
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND at the end of the stream
+ */
+esp_err_t app_avi_next_chunk(app_avi_t *avi, app_avi_chunk_t *type, uint32_t *size);
+
+/**
+ * @brief Read up to len bytes of the current chunk data
+ *
+ * @return Number of bytes read, 0 at the end of the chunk
+ */
+size_t app_avi_read(app_avi_t *avi, void *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include "esp_bit_defs.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "app_boot.h"
+
+/* Width of the timeline bars in characters */
+#define BOOT_BAR_WIDTH      (40)
+
+#if CONFIG_APP_BOOT_PARALLEL
+#define BOOT_MODE           "parallel"
+#else
+#define BOOT_MODE           "sequential"
+#endif
+
+static const char *TAG = "BOOT";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    int64_t start_us;
+    int64_t end_us;
+    esp_err_t ret;
+    int core;
+} boot_record_t;
+
+typedef struct {
+    const char *name;
+    int64_t time_us;
+} boot_mark_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static const app_boot_stage_t *boot_stages = NULL;
+static size_t boot_count = 0;
+static boot_record_t boot_records[APP_BOOT_MAX_STAGES];
+static int64_t boot_start_us = 0;
+
+/* One bit per finished stage */
+static EventGroupHandle_t boot_done = NULL;
+static StaticEventGroup_t boot_done_buf;
+
+static portMUX_TYPE boot_lock = portMUX_INITIALIZER_UNLOCKED;
+static size_t boot_finished = 0;
+static boot_mark_t boot_marks[APP_BOOT_MAX_MARKS];
+static size_t boot_marks_count = 0;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void boot_run_stage(size_t index)
+{
+    const app_boot_stage_t *stage = &boot_stages[index];
+    boot_record_t *rec = &boot_records[index];
+
+    if (stage->deps) {
+        xEventGroupWaitBits(boot_done, stage->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    rec->start_us = esp_timer_get_time();
+    rec->core = xPortGetCoreID();
+    rec->ret = ESP_OK;
+
+    /* Stages depending on a failed stage are skipped */
+    for (size_t i = 0; i < index; i++) {
+        if ((stage->deps & BIT(i)) && boot_records[i].ret != ESP_OK) {
+            ESP_LOGW(TAG, "Stage %s skipped, %s failed", stage->name, boot_stages[i].name);
+            rec->ret = ESP_ERR_INVALID_STATE;
+            break;
+        }
+    }
+    if (rec->ret == ESP_OK) {
+        rec->ret = stage->fn();
+        if (rec->ret != ESP_OK) {
+            ESP_LOGE(TAG, "Stage %s failed: %s", stage->name, esp_err_to_name(rec->ret));
+        }
+    }
+    rec->end_us = esp_timer_get_time();
+
+    xEventGroupSetBits(boot_done, BIT(index));
+
+    portENTER_CRITICAL(&boot_lock);
+    bool last = (++boot_finished == boot_count);
+    portEXIT_CRITICAL(&boot_lock);
+    if (last) {
+        app_boot_report();
+    }
+}
+
+#if CONFIG_APP_BOOT_PARALLEL
+static void boot_task(void *arg)
+{
+    boot_run_stage((size_t)arg);
+    vTaskDelete(NULL);
+}
+#endif
+
+static void boot_bar(char *bar, int64_t start_us, int64_t end_us, int64_t span_us)
+{
+    int from = (start_us - boot_start_us) * BOOT_BAR_WIDTH / span_us;
+    int to = (end_us - boot_start_us) * BOOT_BAR_WIDTH / span_us;
+
+    memset(bar, ' ', BOOT_BAR_WIDTH);
+    bar[BOOT_BAR_WIDTH] = '\0';
+    if (to <= from) {
+        to = from + 1;
+    }
+    for (int i = from; i < to && i < BOOT_BAR_WIDTH; i++) {
+        bar[i] = '#';
+    }
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_boot_run(const app_boot_stage_t *stages, size_t count)
+{
+    esp_err_t ret = ESP_OK;
+
+    if (stages == NULL || count == 0 || count > APP_BOOT_MAX_STAGES || boot_done) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        /* Only earlier stages can be waited for, this also rules out cycles */
+        if (stages[i].fn == NULL || (stages[i].deps >> i) != 0) {
+            ESP_LOGE(TAG, "Invalid stage %s", stages[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    boot_stages = stages;
+    boot_count = count;
+    boot_start_us = esp_timer_get_time();
+    boot_done = xEventGroupCreateStatic(&boot_done_buf);
+
+    /* Background stages start first and wait for their dependencies in their tasks */
+    uint32_t foreground = (uint32_t)BIT(count) - 1;
+#if CONFIG_APP_BOOT_PARALLEL
+    for (size_t i = 0; i < count; i++) {
+        const app_boot_stage_t *stage = &stages[i];
+        if (stage->background) {
+            uint32_t stack_size = stage->stack_size ? stage->stack_size : APP_BOOT_STACK_SIZE;
+            if (xTaskCreate(boot_task, stage->name, stack_size, (void *)i, uxTaskPriorityGet(NULL), NULL) == pdPASS) {
+                foreground &= ~BIT(i);
+            } else {
+                ESP_LOGW(TAG, "No memory for stage %s task, running it in foreground", stage->name);
+            }
+        }
+    }
+#endif
+
+    /* Stages wait only for earlier ones, so running the rest in table order cannot deadlock */
+    for (size_t i = 0; i < count; i++) {
+        if (foreground & BIT(i)) {
+            boot_run_stage(i);
+            if (ret == ESP_OK && boot_records[i].ret != ESP_OK && !stages[i].background) {
+                ret = boot_records[i].ret;
+            }
+        }
+    }
+
+    return ret;
+}
+
+esp_err_t app_boot_wait(const char *name, TickType_t timeout)
+{
+    if (boot_done == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    for (size_t i = 0; i < boot_count; i++) {
+        if (strcmp(boot_stages[i].name, name) == 0) {
+            EventBits_t bits = xEventGroupWaitBits(boot_done, BIT(i), pdFALSE, pdTRUE, timeout);
+            return (bits & BIT(i)) ? boot_records[i].ret : ESP_ERR_TIMEOUT;
+        }
+    }
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+void app_boot_mark(const char *name)
+{
+    int64_t now = esp_timer_get_time();
+    bool added = false;
+    bool reported;
+
+    portENTER_CRITICAL(&boot_lock);
+    size_t i = 0;
+    while (i < boot_marks_count && strcmp(boot_marks[i].name, name) != 0) {
+        i++;
+    }
+    if (i == boot_marks_count && i < APP_BOOT_MAX_MARKS) {
+        boot_marks[i].name = name;
+        boot_marks[i].time_us = now;
+        boot_marks_count++;
+        added = true;
+    }
+    reported = (boot_count > 0 && boot_finished == boot_count);
+    portEXIT_CRITICAL(&boot_lock);
+
+    /* Milestones after the report are logged alone */
+    if (added && reported) {
+        ESP_LOGI(TAG, "%s at %" PRId64 " ms", name, now / 1000);
+    }
+}
+
+void app_boot_report(void)
+{
+    char bar[BOOT_BAR_WIDTH + 1];
+    int64_t end_us = boot_start_us;
+
+    for (size_t i = 0; i < boot_count; i++) {
+        if (boot_records[i].end_us > end_us) {
+            end_us = boot_records[i].end_us;
+        }
+    }
+    for (size_t i = 0; i < boot_marks_count; i++) {
+        if (boot_marks[i].time_us > end_us) {
+            end_us = boot_marks[i].time_us;
+        }
+    }
+    int64_t span_us = (end_us > boot_start_us) ? end_us - boot_start_us : 1;
+
+    ESP_LOGI(TAG, "Boot timeline (ms since reset, " BOOT_MODE "):");
+    ESP_LOGI(TAG, "%-12s %4s %6s %6s  |%-*s|", "stage", "core", "start", "end", BOOT_BAR_WIDTH, "");
+    for (size_t i = 0; i < boot_count; i++) {
+        const boot_record_t *rec = &boot_records[i];
+        boot_bar(bar, rec->start_us, rec->end_us, span_us);
+        ESP_LOGI(TAG, "%-12s %4d %6" PRId64 " %6" PRId64 "  |%s| %s", boot_stages[i].name, rec->core,
+                 rec->start_us / 1000, rec->end_us / 1000, bar,
+                 rec->ret == ESP_OK ? "" : (rec->ret == ESP_ERR_INVALID_STATE ? "skipped" : "failed"));
+    }
+    for (size_t i = 0; i < boot_marks_count; i++) {
+        boot_bar(bar, boot_marks[i].time_us, boot_marks[i].time_us, span_us);
+        ESP_LOGI(TAG, "%-12s %4s %6" PRId64 " %6s  |%s|", boot_marks[i].name, "", boot_marks[i].time_us / 1000, "", bar);
+    }
+    ESP_LOGI(TAG, "Boot done in %" PRId64 " ms (%" PRId64 " ms since reset)", span_us / 1000, end_us / 1000);
+}
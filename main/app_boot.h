@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximal number of boot stages (one event group bit each) */
+#define APP_BOOT_MAX_STAGES     (16)
+/* Maximal number of milestones in the boot timeline */
+#define APP_BOOT_MAX_MARKS      (4)
+/* Default stack of background stage tasks */
+#define APP_BOOT_STACK_SIZE     (4096)
+
+/**
+ * @brief Boot stage initialization function
+ */
+typedef esp_err_t (*app_boot_fn_t)(void);
+
+/**
+ * @brief Boot stage, node of the init graph
+ *
+ * A stage starts when all stages in deps finish. Dependencies must have lower index than the
+ * stage, so the stage table is in a valid order. If any dependency fails, the stage is skipped
+ * (and so are the stages depending on it).
+ */
+typedef struct {
+    const char *name;
+    app_boot_fn_t fn;
+    uint32_t deps;          /*!< Bit mask of stage indices, which must finish first (BIT(index)) */
+    bool background;        /*!< Run in its own task, otherwise in the caller of app_boot_run() */
+    uint32_t stack_size;    /*!< Stack of the background task, 0 for APP_BOOT_STACK_SIZE */
+} app_boot_stage_t;
+
+/**
+ * @brief Run boot stages
+ *
+ * Background stages are started in their own tasks first, then foreground stages run in the
+ * caller in table order, concurrently with them. The function returns when all foreground
+ * stages finish, background stages may still run. When the last stage finishes, the boot
+ * timeline is logged. With CONFIG_APP_BOOT_PARALLEL disabled, all stages run in the caller
+ * one by one in table order.
+ *
+ * @param stages Stage table, must stay valid (static)
+ * @param count Number of stages
+ *
+ * @return ESP_OK if all foreground stages succeeded, error of the first failed one otherwise,
+ *         ESP_ERR_INVALID_ARG if the table is invalid
+ */
+esp_err_t app_boot_run(const app_boot_stage_t *stages, size_t count);
+
+/**
+ * @brief Wait until boot stage finishes
+ *
+ * Used by modules, which are initialized in background, before their first use.
+ *
+ * @return Result of the stage, ESP_ERR_TIMEOUT if it is still running,
+ *         ESP_ERR_NOT_FOUND if there is no such stage (or boot was not started by app_boot_run())
+ */
+esp_err_t app_boot_wait(const char *name, TickType_t timeout);
+
+/**
+ * @brief Record boot milestone (e.g. first frame) in the timeline, only the first call of each name counts
+ */
+void app_boot_mark(const char *name);
+
+/**
+ * @brief Log boot timeline: start, end and core of each stage and milestones
+ */
+void app_boot_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,303 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "app_color.h"
+
+/* RGB565 pixel spread into 32bit word as 00000GGG GGG00000 RRRRR000 000BBBBB, so all three
+   channels can be multiplied by one 5bit weight at once without overflow into each other */
+#define SPREAD_MASK     (0x07E0F81FU)
+
+/* The optimized kernels store two pixels in one 32bit word, first pixel in the low half (little endian).
+   Big endian builds use the reference implementation for the packed paths. */
+#define IS_ALIGNED32(p) ((((uintptr_t)(p)) & 3) == 0)
+#define WORDS_LE        (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+/* Word access through memcpy does not break strict aliasing, it compiles into one aligned load/store */
+static inline uint32_t load32(const void *p)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static inline void store32(void *p, uint32_t w)
+{
+    memcpy(p, &w, sizeof(w));
+}
+
+static inline uint32_t spread(uint16_t px)
+{
+    return (px | ((uint32_t)px << 16)) & SPREAD_MASK;
+}
+
+static inline uint16_t unspread(uint32_t s)
+{
+    return (uint16_t)(s | (s >> 16));
+}
+
+/* Blend two pixels per channel, a * (32 - w) + b * w with rounding down, w = 0..32 */
+static inline uint16_t lerp_rgb565(uint16_t a, uint16_t b, uint32_t w)
+{
+    uint32_t iw = 32 - w;
+    uint32_t r = (((a >> 11) & 0x1F) * iw + ((b >> 11) & 0x1F) * w) >> 5;
+    uint32_t g = (((a >> 5) & 0x3F) * iw + ((b >> 5) & 0x3F) * w) >> 5;
+    uint32_t bl = ((a & 0x1F) * iw + (b & 0x1F) * w) >> 5;
+    return (uint16_t)((r << 11) | (g << 5) | bl);
+}
+
+/* Same as lerp_rgb565 on spread pixels, the fractional bits fall into the gaps and are masked out */
+static inline uint32_t lerp_spread(uint32_t a, uint32_t b, uint32_t w)
+{
+    return ((a * (32 - w) + b * w) >> 5) & SPREAD_MASK;
+}
+
+/* Source position of destination pixel i in 16.16 fixed point, pixel centers aligned */
+static inline uint32_t bilinear_pos(uint32_t i, uint32_t step)
+{
+    uint32_t pos = i * step + (step >> 1);
+    return pos < 0x8000 ? 0 : pos - 0x8000;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+/* ---------------------------- RGB888 -> RGB565 ----------------------------- */
+
+void app_color_rgb888_to_rgb565_ansi(const uint8_t *src, uint16_t *dst, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++, src += 3) {
+        dst[i] = app_color_rgb565(src[0], src[1], src[2]);
+    }
+}
+
+void app_color_rgb888_to_rgb565_opt(const uint8_t *src, uint16_t *dst, size_t pixels)
+{
+    /* Align destination, then the source alignment decides about the fast path */
+    if (!IS_ALIGNED32(dst) && pixels > 0) {
+        *dst++ = app_color_rgb565(src[0], src[1], src[2]);
+        src += 3;
+        pixels--;
+    }
+
+    if (WORDS_LE && IS_ALIGNED32(src)) {
+        /* 4 pixels from 3 words: R0G0B0R1 G1B1R2G2 B2R3G3B3 */
+        for (size_t i = 0; i < pixels / 4; i++) {
+            uint32_t w0 = load32(src);
+            uint32_t w1 = load32(src + 4);
+            uint32_t w2 = load32(src + 8);
+            src += 12;
+
+            uint32_t p0 = ((w0 & 0xF8) << 8) | ((w0 >> 5) & 0x07E0) | ((w0 >> 19) & 0x1F);
+            uint32_t p1 = ((w0 >> 16) & 0xF800) | ((w1 & 0xFC) << 3) | ((w1 >> 11) & 0x1F);
+            uint32_t p2 = ((w1 >> 8) & 0xF800) | ((w1 >> 21) & 0x07E0) | ((w2 >> 3) & 0x1F);
+            uint32_t p3 = (w2 & 0xF800) | ((w2 >> 13) & 0x07E0) | (w2 >> 27);
+            store32(dst, p0 | (p1 << 16));
+            store32(dst + 2, p2 | (p3 << 16));
+            dst += 4;
+        }
+        pixels &= 3;
+    }
+
+    app_color_rgb888_to_rgb565_ansi(src, dst, pixels);
+}
+
+/* ---------------------------- Byte swap ------------------------------------ */
+
+void app_color_swap_rgb565_ansi(uint16_t *buf, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++) {
+        buf[i] = (uint16_t)((buf[i] << 8) | (buf[i] >> 8));
+    }
+}
+
+void app_color_swap_rgb565_opt(uint16_t *buf, size_t pixels)
+{
+    if (!IS_ALIGNED32(buf) && pixels > 0) {
+        app_color_swap_rgb565_ansi(buf, 1);
+        buf++;
+        pixels--;
+    }
+
+    /* Two pixels per word, unrolled; swapping bytes inside both halves does not depend on the byte order */
+    size_t words = pixels / 2;
+    size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        uint32_t w0 = load32(&buf[2 * i]);
+        uint32_t w1 = load32(&buf[2 * i + 2]);
+        uint32_t w2 = load32(&buf[2 * i + 4]);
+        uint32_t w3 = load32(&buf[2 * i + 6]);
+        store32(&buf[2 * i], ((w0 & 0x00FF00FF) << 8) | ((w0 >> 8) & 0x00FF00FF));
+        store32(&buf[2 * i + 2], ((w1 & 0x00FF00FF) << 8) | ((w1 >> 8) & 0x00FF00FF));
+        store32(&buf[2 * i + 4], ((w2 & 0x00FF00FF) << 8) | ((w2 >> 8) & 0x00FF00FF));
+        store32(&buf[2 * i + 6], ((w3 & 0x00FF00FF) << 8) | ((w3 >> 8) & 0x00FF00FF));
+    }
+    for (; i < words; i++) {
+        uint32_t w = load32(&buf[2 * i]);
+        store32(&buf[2 * i], ((w & 0x00FF00FF) << 8) | ((w >> 8) & 0x00FF00FF));
+    }
+
+    app_color_swap_rgb565_ansi(&buf[2 * words], pixels & 1);
+}
+
+/* ---------------------------- Nearest neighbour scale ---------------------- */
+
+void app_color_scale_nearest_rgb565_ansi(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                         uint16_t *dst, uint16_t dst_w, uint16_t dst_h)
+{
+    if (dst_w == 0 || dst_h == 0) {
+        return;
+    }
+
+    uint32_t step_x = ((uint32_t)src_w << 16) / dst_w;
+    uint32_t step_y = ((uint32_t)src_h << 16) / dst_h;
+
+    for (uint32_t y = 0; y < dst_h; y++) {
+        const uint16_t *src_row = src + ((y * step_y) >> 16) * src_w;
+        for (uint32_t x = 0; x < dst_w; x++) {
+            *dst++ = src_row[(x * step_x) >> 16];
+        }
+    }
+}
+
+void app_color_scale_nearest_rgb565_opt(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                        uint16_t *dst, uint16_t dst_w, uint16_t dst_h)
+{
+    if (!WORDS_LE) {
+        app_color_scale_nearest_rgb565_ansi(src, src_w, src_h, dst, dst_w, dst_h);
+        return;
+    }
+    if (dst_w == 0 || dst_h == 0) {
+        return;
+    }
+
+    uint32_t step_x = ((uint32_t)src_w << 16) / dst_w;
+    uint32_t step_y = ((uint32_t)src_h << 16) / dst_h;
+    uint32_t pos_y = 0;
+
+    for (uint32_t y = 0; y < dst_h; y++, pos_y += step_y) {
+        const uint16_t *src_row = src + (pos_y >> 16) * src_w;
+        uint32_t pos_x = 0;
+        uint32_t x = 0;
+
+        if (!IS_ALIGNED32(dst)) {
+            *dst++ = src_row[0];
+            pos_x += step_x;
+            x++;
+        }
+
+        for (; x + 2 <= dst_w; x += 2) {
+            uint32_t p0 = src_row[pos_x >> 16];
+            uint32_t p1 = src_row[(pos_x + step_x) >> 16];
+            store32(dst, p0 | (p1 << 16));
+            dst += 2;
+            pos_x += 2 * step_x;
+        }
+
+        if (x < dst_w) {
+            *dst++ = src_row[pos_x >> 16];
+        }
+    }
+}
+
+/* ---------------------------- Bilinear scale ------------------------------- */
+
+void app_color_scale_bilinear_rgb565_ansi(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                          uint16_t *dst, uint16_t dst_w, uint16_t dst_h)
+{
+    if (dst_w == 0 || dst_h == 0 || src_w == 0 || src_h == 0) {
+        return;
+    }
+
+    uint32_t step_x = ((uint32_t)src_w << 16) / dst_w;
+    uint32_t step_y = ((uint32_t)src_h << 16) / dst_h;
+
+    for (uint32_t y = 0; y < dst_h; y++) {
+        uint32_t pos_y = bilinear_pos(y, step_y);
+        uint32_t y0 = pos_y >> 16;
+        uint32_t y1 = (y0 + 1 < src_h) ? y0 + 1 : y0;
+        uint32_t fy = (pos_y >> 11) & 0x1F;
+        const uint16_t *row0 = src + y0 * src_w;
+        const uint16_t *row1 = src + y1 * src_w;
+
+        for (uint32_t x = 0; x < dst_w; x++) {
+            uint32_t pos_x = bilinear_pos(x, step_x);
+            uint32_t x0 = pos_x >> 16;
+            uint32_t x1 = (x0 + 1 < src_w) ? x0 + 1 : x0;
+            uint32_t fx = (pos_x >> 11) & 0x1F;
+
+            uint16_t top = lerp_rgb565(row0[x0], row0[x1], fx);
+            uint16_t bottom = lerp_rgb565(row1[x0], row1[x1], fx);
+            *dst++ = lerp_rgb565(top, bottom, fy);
+        }
+    }
+}
+
+void app_color_scale_bilinear_rgb565_opt(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                         uint16_t *dst, uint16_t dst_w, uint16_t dst_h)
+{
+    if (dst_w == 0 || dst_h == 0 || src_w == 0 || src_h == 0) {
+        return;
+    }
+
+    uint32_t step_x = ((uint32_t)src_w << 16) / dst_w;
+    uint32_t step_y = ((uint32_t)src_h << 16) / dst_h;
+
+    for (uint32_t y = 0; y < dst_h; y++) {
+        uint32_t pos_y = bilinear_pos(y, step_y);
+        uint32_t y0 = pos_y >> 16;
+        uint32_t y1 = (y0 + 1 < src_h) ? y0 + 1 : y0;
+        uint32_t fy = (pos_y >> 11) & 0x1F;
+        const uint16_t *row0 = src + y0 * src_w;
+        const uint16_t *row1 = src + y1 * src_w;
+
+        /* All three channels in one multiply per weight, the source position is stepped (bilinear_pos) */
+        uint32_t pos_x = step_x >> 1;
+        for (uint32_t x = 0; x < dst_w; x++, pos_x += step_x) {
+            uint32_t p = pos_x < 0x8000 ? 0 : pos_x - 0x8000;
+            uint32_t x0 = p >> 16;
+            uint32_t x1 = (x0 + 1 < src_w) ? x0 + 1 : x0;
+            uint32_t fx = (p >> 11) & 0x1F;
+
+            uint32_t top = lerp_spread(spread(row0[x0]), spread(row0[x1]), fx);
+            uint32_t bottom = lerp_spread(spread(row1[x0]), spread(row1[x1]), fx);
+            *dst++ = unspread(lerp_spread(top, bottom, fy));
+        }
+    }
+}
+
+/* ---------------------------- Alpha blend ---------------------------------- */
+
+void app_color_blend_rgba8888_to_rgb565_ansi(const uint8_t *src, uint16_t *dst, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++, src += 4) {
+        uint32_t alpha = (src[3] + 4) >> 3;
+        dst[i] = lerp_rgb565(dst[i], app_color_rgb565(src[0], src[1], src[2]), alpha);
+    }
+}
+
+void app_color_blend_rgba8888_to_rgb565_opt(const uint8_t *src, uint16_t *dst, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++, src += 4) {
+        uint32_t alpha = (src[3] + 4) >> 3;
+
+        /* Opaque and transparent pixels are common, skip the blending */
+        if (alpha == 32) {
+            dst[i] = app_color_rgb565(src[0], src[1], src[2]);
+        } else if (alpha != 0) {
+            uint32_t s = spread(app_color_rgb565(src[0], src[1], src[2]));
+            dst[i] = unspread(lerp_spread(spread(dst[i]), s, alpha));
+        }
+    }
+}
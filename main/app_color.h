@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Color conversion and blit kernels
+ *
+ * Every kernel has a portable reference implementation (suffix _ansi) and an optimized one
+ * (suffix _opt), which processes two RGB565 pixels per 32bit word in plain C (no PIE vector
+ * instructions, so it builds for any target). Both give bit-exact results.
+ * The name without suffix selects the optimized one, if CONFIG_APP_COLOR_OPTIMIZED is enabled,
+ * except for the blend, which is only faster for mostly opaque or transparent images
+ * (CONFIG_APP_COLOR_OPTIMIZED_BLEND).
+ *
+ * All RGB565 buffers are in native byte order, use app_color_swap_rgb565() for CONFIG_LV_COLOR_16_SWAP.
+ */
+
+/**
+ * @brief Pack 8bit RGB components into one RGB565 pixel
+ */
+static inline uint16_t app_color_rgb565(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+/**
+ * @brief Convert packed RGB888 pixels (R, G, B byte order) into RGB565
+ */
+void app_color_rgb888_to_rgb565_ansi(const uint8_t *src, uint16_t *dst, size_t pixels);
+void app_color_rgb888_to_rgb565_opt(const uint8_t *src, uint16_t *dst, size_t pixels);
+
+/**
+ * @brief Swap bytes of RGB565 pixels in place
+ */
+void app_color_swap_rgb565_ansi(uint16_t *buf, size_t pixels);
+void app_color_swap_rgb565_opt(uint16_t *buf, size_t pixels);
+
+/**
+ * @brief Scale RGB565 image by nearest neighbour, the destination must not overlap the source
+ */
+void app_color_scale_nearest_rgb565_ansi(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                         uint16_t *dst, uint16_t dst_w, uint16_t dst_h);
+void app_color_scale_nearest_rgb565_opt(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                        uint16_t *dst, uint16_t dst_w, uint16_t dst_h);
+
+/**
+ * @brief Scale RGB565 image with bilinear filter (1/32 step weights), the destination must not overlap the source
+ */
+void app_color_scale_bilinear_rgb565_ansi(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                          uint16_t *dst, uint16_t dst_w, uint16_t dst_h);
+void app_color_scale_bilinear_rgb565_opt(const uint16_t *src, uint16_t src_w, uint16_t src_h,
+                                         uint16_t *dst, uint16_t dst_w, uint16_t dst_h);
+
+/**
+ * @brief Blend RGBA8888 pixels (R, G, B, A byte order) over RGB565 pixels (1/32 step alpha)
+ */
+void app_color_blend_rgba8888_to_rgb565_ansi(const uint8_t *src, uint16_t *dst, size_t pixels);
+void app_color_blend_rgba8888_to_rgb565_opt(const uint8_t *src, uint16_t *dst, size_t pixels);
+
+#if CONFIG_APP_COLOR_OPTIMIZED
+#define app_color_rgb888_to_rgb565          app_color_rgb888_to_rgb565_opt
+#define app_color_swap_rgb565               app_color_swap_rgb565_opt
+#define app_color_scale_nearest_rgb565      app_color_scale_nearest_rgb565_opt
+#define app_color_scale_bilinear_rgb565     app_color_scale_bilinear_rgb565_opt
+#else
+#define app_color_rgb888_to_rgb565          app_color_rgb888_to_rgb565_ansi
+#define app_color_swap_rgb565               app_color_swap_rgb565_ansi
+#define app_color_scale_nearest_rgb565      app_color_scale_nearest_rgb565_ansi
+#define app_color_scale_bilinear_rgb565     app_color_scale_bilinear_rgb565_ansi
+#endif
+
+#if CONFIG_APP_COLOR_OPTIMIZED_BLEND
+#define app_color_blend_rgba8888_to_rgb565  app_color_blend_rgba8888_to_rgb565_opt
+#else
+#define app_color_blend_rgba8888_to_rgb565  app_color_blend_rgba8888_to_rgb565_ansi
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,25 +6,42 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <assert.h>
 #include <unistd.h>
 #include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <dirent.h>
 #include <inttypes.h>
+#include <sys/stat.h>
 
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_err.h"
-#include "esp_spiffs.h"
+#include "esp_timer.h"
 #include "bsp/esp-bsp.h"
 #include "lvgl.h"
 #include "app_disp_fs.h"
-#include "jpeg_decoder.h"
-
-/* SPIFFS mount root */
-#define FS_MNT_PATH  BSP_SPIFFS_MOUNT_POINT
+#include "app_file_type.h"
+#include "app_mem.h"
+#include "app_vad.h"
+#include "app_img_dec.h"
+#include "app_text_view.h"
+#include "app_video.h"
+#include "app_assets.h"
+#include "app_boot.h"
+#include "app_spectrum.h"
+#include "app_media.h"
+#include "app_storage.h"
+#include "app_file_index.h"
+
+/* Storage mount root (SPIFFS or LittleFS) */
+#define FS_MNT_PATH  APP_STORAGE_MOUNT_POINT
+/* Buttons in the file list, more matches are narrowed by the search */
+#define FS_LIST_MAX_ITEMS   (50)
+#define FS_SEARCH_HEIGHT    (36)
 
 /* Buffer for reading/writing to I2S driver. Same length as SPIFFS buffer and I2S buffer, for optimal read/write performance.
    Recording audio data path:
@@ -36,8 +53,15 @@
 /* The recording will be RECORDING_LENGTH * BUFFER_SIZE long (in bytes)
    With sampling frequency 22050 Hz and 16bit mono resolution it equals to ~3.715 seconds */
 #define RECORDING_LENGTH (160)
+/* The media controller closes the played file within one audio block, this is a safe bound */
+#define MEDIA_STOP_TIMEOUT_MS   (1000)
 
 #define REC_FILENAME    FS_MNT_PATH"/recording.wav"
+/* Voice activity triggered recordings, numbered from 0 */
+#define REC_VAD_FILENAME    FS_MNT_PATH"/vad_%03d.wav"
+#define REC_VAD_MAX_FILES   (1000)
+
+_Static_assert(BSP_LCD_H_RES * BSP_LCD_V_RES * sizeof(lv_color_t) <= APP_MEM_FRAME_BLOCK_SIZE, "Frame pool block smaller than the display");
 
 static const char *TAG = "DISP";
 
@@ -49,13 +73,6 @@ static esp_codec_dev_handle_t mic_codec_dev = NULL;
 /*******************************************************************************
 * Types definitions
 *******************************************************************************/
-typedef enum {
-    APP_FILE_TYPE_UNKNOWN,
-    APP_FILE_TYPE_TXT,
-    APP_FILE_TYPE_IMG,
-    APP_FILE_TYPE_WAV,
-} app_file_type_t;
-
 // Very simple WAV header, ignores most fields
 typedef struct __attribute__((packed))
 {
@@ -69,6 +86,13 @@ typedef struct __attribute__((packed))
     uint8_t data[];
 } dumb_wav_header_t;
 
+/* Index tags of the file list entries */
+enum {
+    FS_TAG_FILE,
+    FS_TAG_DIR,
+    FS_TAG_ASSET,               /*!< File of the asset pack, listed in the root */
+};
+
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
@@ -76,8 +100,13 @@ static void app_disp_lvgl_show_settings(lv_obj_t *screen, lv_group_t *group);
 static void app_disp_lvgl_show_record(lv_obj_t *screen, lv_group_t *group);
 static void app_disp_lvgl_show_filesystem(lv_obj_t *screen, lv_group_t *group);
 static void app_disp_lvgl_show_files(const char *path);
+static void app_disp_lvgl_refresh_files(void);
 static void tab_changed_event(lv_event_t *e);
 static void set_tab_group(void);
+static app_file_type_t get_file_type(const char *filepath);
+static bool is_image_type(app_file_type_t type);
+static void media_state_cb(app_media_state_t state, void *user_data);
+static void media_state_timer_cb(lv_timer_t *timer);
 
 /*******************************************************************************
 * Local variables
@@ -91,18 +120,33 @@ static lv_group_t *settings_group = NULL;
 
 /* FS */
 static lv_obj_t *fs_list = NULL;
+static lv_obj_t *fs_search = NULL;
+static lv_obj_t *fs_keyboard = NULL;
+/* List items are created once and recycled by every refresh (search keystroke) */
+static lv_obj_t *fs_path_label = NULL;
+static lv_obj_t *fs_back_btn = NULL;
+static lv_obj_t *fs_more_label = NULL;
+static lv_obj_t *fs_items[FS_LIST_MAX_ITEMS];
+static size_t fs_items_count = 0;
+/* Names of the shown directory, the list shows those matching the search */
+static app_file_index_t fs_index;
 static lv_obj_t *fs_img = NULL;
 static char fs_current_path[250];
+/* Asset pack files are listed in the root */
+static bool fs_assets_mounted = false;
 
 static uint8_t *file_buffer = NULL;
 static size_t file_buffer_size = 0;
 
 /* Audio */
-static SemaphoreHandle_t audio_mux;
-static bool play_file_repeat = false;
-static bool play_file_stop = false;
-static char usb_drive_play_file[250];
+static char usb_drive_play_file[APP_MEDIA_PATH_MAX];
 static lv_obj_t *play_btn = NULL, *play1_btn = NULL, *rec_btn = NULL, *rec_stop_btn = NULL;
+static lv_obj_t *vad_btn = NULL;
+/* Set by the UI task, polled by the recording task */
+static volatile bool rec_vad_stop = false;
+/* Player state reported by the media task, shown by the LVGL task */
+static volatile app_media_state_t media_ui_state = APP_MEDIA_STATE_IDLE;
+static volatile bool media_ui_changed = false;
 
 /*******************************************************************************
 * Public API functions
@@ -151,31 +195,51 @@ void app_disp_lvgl_show(void)
     /* Show settings tab page */
     app_disp_lvgl_show_settings(tab_settings, settings_group);
 
+    /* Player state is applied to the buttons here, the media task never waits for LVGL */
+    lv_timer_create(media_state_timer_cb, 50, NULL);
+
     bsp_display_unlock();
 }
 
-void app_audio_init(void)
+esp_err_t app_audio_init(void)
 {
     /* Initialize speaker */
     spk_codec_dev = bsp_audio_codec_speaker_init();
-    assert(spk_codec_dev);
-    /* Speaker output volume */
-    esp_codec_dev_set_out_vol(spk_codec_dev, DEFAULT_VOLUME);
+    if (spk_codec_dev == NULL) {
+        ESP_LOGE(TAG, "Speaker codec init failed!");
+        return ESP_FAIL;
+    }
+
+    /* Playback is controlled by commands to the media task, which owns the speaker */
+    const app_media_config_t media_cfg = {
+        .codec = spk_codec_dev,
+        .volume = DEFAULT_VOLUME,
+        .state_cb = media_state_cb,
+    };
+    esp_err_t ret = app_media_init(&media_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Media controller init failed!");
+        return ret;
+    }
 
     /* Initialize microphone */
 #if BSP_CAPS_AUDIO_MIC
     mic_codec_dev = bsp_audio_codec_microphone_init();
-    assert(mic_codec_dev);
+    if (mic_codec_dev == NULL) {
+        ESP_LOGE(TAG, "Microphone codec init failed!");
+        return ESP_FAIL;
+    }
     /* Microphone input gain */
     esp_codec_dev_set_in_gain(mic_codec_dev, 50.0);
 #endif
+
+    return ESP_OK;
 }
 
 void app_disp_fs_init(void)
 {
-    file_buffer_size = BSP_LCD_H_RES * BSP_LCD_V_RES * sizeof(lv_color_t);
-    file_buffer = heap_caps_calloc(file_buffer_size, 1, MALLOC_CAP_DEFAULT);
-    assert(file_buffer);
+    /* Read-only media from the memory-mapped asset pack (optional) */
+    fs_assets_mounted = (app_assets_init() == ESP_OK);
 
     /* Initialize root path */
     strcpy(fs_current_path, FS_MNT_PATH);
@@ -188,9 +252,32 @@ void app_disp_fs_init(void)
 * Private API function
 *******************************************************************************/
 
-static void app_lvgl_add_text(const char *text)
+/* Image buffer is the frame pool block, taken by an image window and returned when it closes */
+static uint8_t *get_file_buffer(void)
+{
+    if (file_buffer == NULL) {
+        file_buffer = app_mem_pool_alloc(APP_MEM_POOL_FRAME);
+        file_buffer_size = file_buffer ? APP_MEM_FRAME_BLOCK_SIZE : 0;
+    }
+    return file_buffer;
+}
+
+static void release_file_buffer(void)
 {
-    lv_list_add_text(fs_list, text);
+    app_mem_pool_free(file_buffer);
+    file_buffer = NULL;
+    file_buffer_size = 0;
+}
+
+/* Audio and storage are brought up in background at boot, tasks wait for them before the first use */
+static bool wait_boot_stage(const char *stage)
+{
+    esp_err_t ret = app_boot_wait(stage, portMAX_DELAY);
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "Boot stage %s failed: %s", stage, esp_err_to_name(ret));
+        return false;
+    }
+    return true;
 }
 
 static void folder_handler(lv_event_t *e)
@@ -215,19 +302,48 @@ static void close_window_handler(lv_event_t *e)
     lv_event_code_t code = lv_event_get_code(e);
 
     if (code == LV_EVENT_CLICKED) {
-        memset(file_buffer, 0, file_buffer_size);
         lv_obj_del(lv_event_get_user_data(e));
 
+        /* All window buffers are released at once, the canvas using the frame is deleted */
+        release_file_buffer();
+        app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+        app_mem_log_stats();
+
         /* Re-set the TAB group */
         set_tab_group();
     }
 }
 
+/* Scroll text viewer by one page */
+static void text_page_up_handler(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_CLICKED) {
+        app_text_view_scroll(lv_event_get_user_data(e), -APP_TEXT_VIEW_ROWS);
+    }
+}
+
+static void text_page_down_handler(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_CLICKED) {
+        app_text_view_scroll(lv_event_get_user_data(e), APP_TEXT_VIEW_ROWS);
+    }
+}
+
 static void show_window(const char *path, app_file_type_t type)
 {
-    struct stat st;
     lv_obj_t *label = NULL;
     lv_obj_t *btn;
+    lv_obj_t *up_btn = NULL, *down_btn = NULL;
+
+    if (app_mem_arena_begin(APP_MEM_ARENA_WINDOW) != ESP_OK) {
+        ESP_LOGE(TAG, "Window memory is in use!");
+        return;
+    }
+
     lv_obj_t *win = lv_win_create(lv_scr_act()); //, 40
     lv_win_add_title(win, path);
 
@@ -243,62 +359,74 @@ static void show_window(const char *path, app_file_type_t type)
     lv_label_set_text(label, "");
     lv_obj_center(label);
 
-    if (type == APP_FILE_TYPE_IMG) {
-        fs_img = lv_canvas_create(cont);
-    }
-
     /* Show image or text file */
-    if (type == APP_FILE_TYPE_TXT || type == APP_FILE_TYPE_IMG) {
-        /* Get file size */
-        int f = stat(path, &st);
-        if (f == 0) {
-            uint32_t filesize = (uint32_t) st.st_size;
-            char *file_buf = heap_caps_malloc(filesize + 1, MALLOC_CAP_DMA);
-            if (file_buf == NULL) {
-                lv_label_set_text(label, "Not enough memory!");
-                return;
-            }
-
-            /* Open file */
-            f = open(path, O_RDONLY);
-            if (f > 0) {
-                /* Read file */
-                read(f, file_buf, filesize);
-                if (type == APP_FILE_TYPE_TXT && label) {
-                    file_buf[filesize] = 0;
-                    lv_label_set_text(label, file_buf);
-                } else if (fs_img) {
-                    ESP_LOGI(TAG, "Decoding JPEG image...");
-                    /* JPEG decode */
-                    esp_jpeg_image_cfg_t jpeg_cfg = {
-                        .indata = (uint8_t *)file_buf,
-                        .indata_size = filesize,
-                        .outbuf = file_buffer,
-                        .outbuf_size = file_buffer_size,
-                        .out_format = JPEG_IMAGE_FORMAT_RGB565,
-                        .out_scale = JPEG_IMAGE_SCALE_0,
-                        .flags = {
+    if (type == APP_FILE_TYPE_TXT) {
+        /* Paged viewer, only the visible lines are loaded */
+        lv_obj_t *view = app_text_view_create(cont, path);
+        if (view) {
+            up_btn = lv_win_add_button(win, LV_SYMBOL_UP, 50);
+            lv_obj_add_event_cb(up_btn, text_page_up_handler, LV_EVENT_CLICKED, view);
+            down_btn = lv_win_add_button(win, LV_SYMBOL_DOWN, 50);
+            lv_obj_add_event_cb(down_btn, text_page_down_handler, LV_EVENT_CLICKED, view);
+        } else {
+            lv_label_set_text(label, "File not found!");
+        }
+    } else if (is_image_type(type)) {
+        uint8_t *buf = get_file_buffer();
+        app_img_out_t out = {
+            .buf = buf,
+            .buf_size = file_buffer_size,
+            .max_width = BSP_LCD_H_RES,
+            .max_height = BSP_LCD_V_RES,
+            .fit = true,
 #if CONFIG_LV_COLOR_16_SWAP
-                            .swap_color_bytes = 1,
+            .swap_bytes = true,
 #endif
-                        }
-                    };
-                    esp_jpeg_image_output_t outimg;
-                    esp_jpeg_decode(&jpeg_cfg, &outimg);
-
-                    lv_canvas_set_buffer(fs_img, file_buffer, outimg.width, outimg.height, LV_COLOR_FORMAT_RGB565);
-                    lv_obj_center(fs_img);
-                    lv_obj_invalidate(fs_img);
-                }
-
-                close(f);
-            } else {
-                lv_label_set_text(label, "File not found!");
+        };
+        const uint8_t *data;
+        size_t data_size;
+        esp_err_t ret = ESP_ERR_NOT_FOUND;
+        int64_t start_us = esp_timer_get_time();
+        if (out.buf == NULL) {
+            ret = ESP_ERR_NO_MEM;
+        } else if (app_assets_get(path, &data, &data_size) == ESP_OK) {
+            /* Assets are decoded straight from the mapped flash, no copy into RAM */
+            ret = app_img_dec_decode_mem(type, data, data_size, &out);
+        } else {
+            FILE *file = fopen(path, "rb");
+            if (file) {
+                ret = app_img_dec_decode(type, file, &out);
+                fclose(file);
             }
+        }
 
-            free(file_buf);
-        } else {
+        if (ret == ESP_OK) {
+            ESP_LOGI(TAG, "Image %dx%d opened in %" PRId64 " ms", out.width, out.height, (esp_timer_get_time() - start_us) / 1000);
+            fs_img = lv_canvas_create(cont);
+            lv_canvas_set_buffer(fs_img, file_buffer, out.width, out.height, LV_COLOR_FORMAT_RGB565);
+            lv_obj_center(fs_img);
+            lv_obj_invalidate(fs_img);
+        } else if (ret == ESP_ERR_NOT_FOUND) {
             lv_label_set_text(label, "File not found!");
+        } else if (ret == ESP_ERR_NO_MEM) {
+            lv_label_set_text(label, "Not enough memory!");
+        } else {
+            lv_label_set_text(label, "Unsupported image format!");
+        }
+    } else if (type == APP_FILE_TYPE_AVI) {
+        const app_video_config_t video_cfg = {
+            .codec = spk_codec_dev,
+            .max_width = BSP_LCD_H_RES,
+            .max_height = BSP_LCD_V_RES,
+#if CONFIG_LV_COLOR_16_SWAP
+            .swap_bytes = true,
+#endif
+        };
+        /* The player takes the speaker codec and audio blocks of a running playback */
+        if (app_media_stop_sync(MEDIA_STOP_TIMEOUT_MS) != ESP_OK) {
+            lv_label_set_text(label, "Playback did not stop!");
+        } else if (app_video_create(cont, path, &video_cfg) == NULL) {
+            lv_label_set_text(label, "Unsupported video format!");
         }
     } else if (label) {
         lv_label_set_text(label, "Unsupported file type!");
@@ -309,107 +437,59 @@ static void show_window(const char *path, app_file_type_t type)
     if (indev && lv_indev_get_type(indev) == LV_INDEV_TYPE_ENCODER) {
         lv_group_t *group = lv_group_create();
         lv_group_add_obj(group, btn);
+        if (up_btn && down_btn) {
+            lv_group_add_obj(group, up_btn);
+            lv_group_add_obj(group, down_btn);
+        }
         lv_indev_set_group(indev, group);
     }
 
 }
 
-static void play_file(void *arg)
+/* Player state, called from the media task: only noted, the audio is not held by rendering */
+static void media_state_cb(app_media_state_t state, void *user_data)
 {
-    char *path = arg;
-    FILE *file = NULL;
-    int16_t *wav_bytes = heap_caps_malloc(BUFFER_SIZE, MALLOC_CAP_DEFAULT);
-    if (wav_bytes == NULL) {
-        ESP_LOGE(TAG, "Not enough memory for playing!");
-        goto END;
-    }
-
-    /* Open file */
-    file = fopen(path, "rb");
-    if (file == NULL) {
-        ESP_LOGE(TAG, "%s file does not exist!", path);
-        goto END;
-    }
-
-    /* Read WAV header file */
-    dumb_wav_header_t wav_header;
-    if (fread((void *)&wav_header, 1, sizeof(wav_header), file) != sizeof(wav_header)) {
-        ESP_LOGW(TAG, "Error in reading file");
-        goto END;
-    }
-    ESP_LOGI(TAG, "Number of channels: %" PRIu16 "", wav_header.num_channels);
-    ESP_LOGI(TAG, "Bits per sample: %" PRIu16 "", wav_header.bits_per_sample);
-    ESP_LOGI(TAG, "Sample rate: %" PRIu32 "", wav_header.sample_rate);
-    ESP_LOGI(TAG, "Data size: %" PRIu32 "", wav_header.data_size);
-
-
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = wav_header.sample_rate,
-        .channel = wav_header.num_channels,
-        .bits_per_sample = wav_header.bits_per_sample,
-        .mclk_multiple = I2S_MCLK_MULTIPLE_384,
-    };
-    esp_codec_dev_open(spk_codec_dev, &fs);
-
-    uint32_t bytes_send_to_i2s = 0;
-    do {
-        bytes_send_to_i2s = 0;
-        fseek(file, sizeof(wav_header), SEEK_SET);
-        while (bytes_send_to_i2s < wav_header.data_size) {
-            if (play_file_stop) {
-                goto END;
-            }
-            xSemaphoreTake(audio_mux, portMAX_DELAY);
-
-            /* Get data from SPIFFS */
-            size_t bytes_read_from_spiffs = fread(wav_bytes, 1, BUFFER_SIZE, file);
-
-            /* Send it to I2S */
-            esp_codec_dev_write(spk_codec_dev, wav_bytes, bytes_read_from_spiffs);
-            bytes_send_to_i2s += bytes_read_from_spiffs;
-            xSemaphoreGive(audio_mux);
-        }
-        vTaskDelay(pdMS_TO_TICKS(100));
-    } while (play_file_repeat);
-
-
-
-END:
-    esp_codec_dev_close(spk_codec_dev);
-
-    if (file) {
-        fclose(file);
-    }
+    media_ui_state = state;
+    media_ui_changed = true;
+}
 
-    if (wav_bytes) {
-        free(wav_bytes);
+/* LVGL timer (display lock held): show the last reported player state */
+static void media_state_timer_cb(lv_timer_t *timer)
+{
+    if (!media_ui_changed) {
+        return;
     }
+    media_ui_changed = false;
 
+    const char *symbol = (media_ui_state == APP_MEDIA_STATE_PLAYING) ? LV_SYMBOL_PAUSE : LV_SYMBOL_PLAY;
     if (play_btn) {
-        bsp_display_lock(0);
-        lv_obj_clear_state(play_btn, LV_STATE_DISABLED);
-        bsp_display_unlock();
+        lv_label_set_text_static(lv_obj_get_child(play_btn, 0), symbol);
     }
-
     if (play1_btn) {
-        bsp_display_lock(0);
-        lv_obj_clear_state(play1_btn, LV_STATE_DISABLED);
-        bsp_display_unlock();
+        lv_label_set_text_static(lv_obj_get_child(play1_btn, 0), symbol);
     }
-
-    vTaskDelete(NULL);
 }
 
-/* Play selected audio file */
+/* Play selected audio file, pause or resume it */
 static void play_event_cb(lv_event_t *e)
 {
     lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t *obj = lv_event_get_target(e);
+    const char *path = lv_event_get_user_data(e);
 
     if (code == LV_EVENT_CLICKED) {
-        play_file_stop = false;
-        lv_obj_add_state(obj, LV_STATE_DISABLED);
-        xTaskCreate(play_file, "audio_task", 4096, lv_event_get_user_data(e), 6, NULL);
+        switch (app_media_get_state()) {
+        case APP_MEDIA_STATE_PLAYING:
+            app_media_pause();
+            break;
+        case APP_MEDIA_STATE_PAUSED:
+            app_media_resume();
+            break;
+        default:
+            if (app_media_play(path, get_file_type(path)) != ESP_OK) {
+                ESP_LOGW(TAG, "Audio is not ready");
+            }
+            break;
+        }
     }
 }
 
@@ -419,7 +499,7 @@ static void stop_event_cb(lv_event_t *e)
     lv_event_code_t code = lv_event_get_code(e);
 
     if (code == LV_EVENT_CLICKED) {
-        play_file_stop = true;
+        app_media_stop();
     }
 }
 
@@ -430,7 +510,7 @@ static void repeat_event_cb(lv_event_t *e)
     lv_obj_t *obj = lv_event_get_target(e);
 
     if (code == LV_EVENT_VALUE_CHANGED) {
-        play_file_repeat = ( (lv_obj_get_state(obj) & LV_STATE_CHECKED) ? true : false);
+        app_media_set_repeat((lv_obj_get_state(obj) & LV_STATE_CHECKED) ? true : false);
     }
 }
 
@@ -440,10 +520,7 @@ static void volume_event_cb(lv_event_t *e)
 
     assert(slider != NULL);
 
-    int32_t volume = lv_slider_get_value(slider);
-    if (spk_codec_dev) {
-        esp_codec_dev_set_out_vol(spk_codec_dev, volume);
-    }
+    app_media_set_volume(lv_slider_get_value(slider));
 }
 
 static void close_window_wav_handler(lv_event_t *e)
@@ -451,12 +528,10 @@ static void close_window_wav_handler(lv_event_t *e)
     lv_event_code_t code = lv_event_get_code(e);
 
     if (code == LV_EVENT_CLICKED) {
-        memset(file_buffer, 0, file_buffer_size);
+        /* The media task keeps its own copy of the path, nothing is freed under it */
+        app_media_stop();
+        play_btn = NULL;
         lv_obj_del(lv_event_get_user_data(e));
-        play_file_stop = true;
-
-        xSemaphoreTake(audio_mux, portMAX_DELAY);
-        vSemaphoreDelete(audio_mux);
 
         /* Re-set the TAB group */
         set_tab_group();
@@ -470,12 +545,11 @@ static void show_window_wav(const char *path)
     lv_obj_t *win = lv_win_create(lv_scr_act()); //, 40
     lv_win_add_title(win, path);
 
-    strcpy(usb_drive_play_file, path);
+    strlcpy(usb_drive_play_file, path, sizeof(usb_drive_play_file));
 
-    play_file_repeat = false;
-
-    audio_mux = xSemaphoreCreateMutex();
-    assert(audio_mux);
+    /* The window plays only its own file */
+    app_media_stop();
+    app_media_set_repeat(false);
 
     /* Close button */
     btn = lv_win_add_button(win, LV_SYMBOL_CLOSE, 60);
@@ -487,7 +561,7 @@ static void show_window_wav(const char *path)
     lv_obj_set_flex_align(cont, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
     lv_obj_t *cont_row = lv_obj_create(cont);
-    lv_obj_set_size(cont_row, BSP_LCD_H_RES - 20, 80);
+    lv_obj_set_size(cont_row, BSP_LCD_H_RES - 20, 60);
     lv_obj_align(cont_row, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_flex_flow(cont_row, LV_FLEX_FLOW_ROW);
     lv_obj_set_style_pad_top(cont_row, 2, 0);
@@ -514,7 +588,7 @@ static void show_window_wav(const char *path)
     lv_obj_add_event_cb(repeat_btn, repeat_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
 
     cont_row = lv_obj_create(cont);
-    lv_obj_set_size(cont_row, BSP_LCD_H_RES - 20, 80);
+    lv_obj_set_size(cont_row, BSP_LCD_H_RES - 20, 60);
     lv_obj_align(cont_row, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_flex_flow(cont_row, LV_FLEX_FLOW_ROW);
     lv_obj_set_style_pad_top(cont_row, 2, 0);
@@ -533,6 +607,9 @@ static void show_window_wav(const char *path)
     lv_obj_center(slider);
     lv_obj_add_event_cb(slider, volume_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
 
+    /* Spectrum of the played audio */
+    app_spectrum_create(cont, BSP_LCD_H_RES - 20, 60);
+
     /* Input device group */
     lv_indev_t *indev = bsp_display_get_input_dev();
     if (indev && lv_indev_get_type(indev) == LV_INDEV_TYPE_ENCODER) {
@@ -546,6 +623,13 @@ static void show_window_wav(const char *path)
     }
 }
 
+static bool is_image_type(app_file_type_t type)
+{
+    return (type == APP_FILE_TYPE_JPG || type == APP_FILE_TYPE_BMP ||
+            type == APP_FILE_TYPE_QOI || type == APP_FILE_TYPE_PNG ||
+            type == APP_FILE_TYPE_RGBZ);
+}
+
 /* Get file type by filename extension */
 static app_file_type_t get_file_type(const char *filepath)
 {
@@ -556,11 +640,21 @@ static app_file_type_t get_file_type(const char *filepath)
         if (filepath[i] == '.') {
 
             if (strcmp(&filepath[i + 1], "JPG") == 0 || strcmp(&filepath[i + 1], "jpg") == 0) {
-                return APP_FILE_TYPE_IMG;
+                return APP_FILE_TYPE_JPG;
+            } else if (strcmp(&filepath[i + 1], "BMP") == 0 || strcmp(&filepath[i + 1], "bmp") == 0) {
+                return APP_FILE_TYPE_BMP;
+            } else if (strcmp(&filepath[i + 1], "QOI") == 0 || strcmp(&filepath[i + 1], "qoi") == 0) {
+                return APP_FILE_TYPE_QOI;
+            } else if (strcmp(&filepath[i + 1], "PNG") == 0 || strcmp(&filepath[i + 1], "png") == 0) {
+                return APP_FILE_TYPE_PNG;
+            } else if (strcmp(&filepath[i + 1], "RGBZ") == 0 || strcmp(&filepath[i + 1], "rgbz") == 0) {
+                return APP_FILE_TYPE_RGBZ;
             } else if (strcmp(&filepath[i + 1], "TXT") == 0 || strcmp(&filepath[i + 1], "txt") == 0) {
                 return APP_FILE_TYPE_TXT;
             } else if (strcmp(&filepath[i + 1], "WAV") == 0 || strcmp(&filepath[i + 1], "wav") == 0) {
                 return APP_FILE_TYPE_WAV;
+            } else if (strcmp(&filepath[i + 1], "AVI") == 0 || strcmp(&filepath[i + 1], "avi") == 0) {
+                return APP_FILE_TYPE_AVI;
             }
 
             break;
@@ -570,6 +664,26 @@ static app_file_type_t get_file_type(const char *filepath)
     return APP_FILE_TYPE_UNKNOWN;
 }
 
+/* Replace image path by its pre-decoded variant (same name, *.rgbz), if it exists */
+static bool find_predecoded(char *path, size_t path_len)
+{
+    char alt[250];
+    struct stat st;
+
+    const char *dot = strrchr(path, '.');
+    if (dot == NULL || (size_t)(dot - path) + sizeof(".rgbz") > sizeof(alt)) {
+        return false;
+    }
+    memcpy(alt, path, dot - path);
+    strcpy(&alt[dot - path], ".rgbz");
+
+    if (stat(alt, &st) != 0 || strlen(alt) >= path_len) {
+        return false;
+    }
+    strcpy(path, alt);
+    return true;
+}
+
 /* Clicked to file button */
 static void file_handler(lv_event_t *e)
 {
@@ -579,14 +693,20 @@ static void file_handler(lv_event_t *e)
     if (code == LV_EVENT_CLICKED) {
         char filepath[250];
         const char *filename = lv_list_get_btn_text(fs_list, obj);
+        /* Files from other mount points (asset pack) are listed with the root files */
+        const bool asset = (uintptr_t)lv_obj_get_user_data(obj) == FS_TAG_ASSET;
 
-        strcpy(filepath, fs_current_path);
+        strcpy(filepath, asset ? APP_ASSETS_MOUNT_POINT : fs_current_path);
         strcat(filepath, "/");
         strcat(filepath, filename);
 
         /* Open window by file type (Image, text or music) */
         ESP_LOGI(TAG, "Clicked: %s", lv_list_get_btn_text(fs_list, obj));
         app_file_type_t filetype = get_file_type(filepath);
+        if (is_image_type(filetype) && filetype != APP_FILE_TYPE_RGBZ && find_predecoded(filepath, sizeof(filepath))) {
+            ESP_LOGI(TAG, "Using pre-decoded %s", filepath);
+            filetype = APP_FILE_TYPE_RGBZ;
+        }
         if (filetype == APP_FILE_TYPE_WAV) {
             show_window_wav(filepath);
         } else {
@@ -619,97 +739,184 @@ static void back_handler(lv_event_t *e)
     }
 }
 
-static void app_lvgl_add_back(void)
+/* Clicked to recycled list button, by the tag of the shown entry */
+static void item_handler(lv_event_t *e)
 {
-    lv_obj_t *btn;
-
-    /* Back button */
-    btn = lv_list_add_btn(fs_list, LV_SYMBOL_LEFT, "Back");
-    lv_obj_set_style_bg_color(btn, lv_color_make(0x00, 0x00, 0x00), 0);
-    lv_obj_set_style_text_color(btn, lv_color_make(0xFF, 0xFF, 0xFF), 0);
-    lv_obj_add_event_cb(btn, back_handler, LV_EVENT_CLICKED, NULL);
+    if ((uintptr_t)lv_obj_get_user_data(lv_event_get_target(e)) == FS_TAG_DIR) {
+        folder_handler(e);
+    } else {
+        file_handler(e);
+    }
 }
 
-static void app_lvgl_add_file(const char *filename)
+static const char *get_file_icon(const char *filename)
 {
-    lv_obj_t *btn;
-    char *icon = LV_SYMBOL_FILE;
-    app_file_type_t filetype = get_file_type(filename);
-
     /* File icon by type */
-    switch (filetype) {
-    case APP_FILE_TYPE_IMG:
-        icon = LV_SYMBOL_IMAGE;
-        break;
+    switch (get_file_type(filename)) {
+    case APP_FILE_TYPE_JPG:
+    case APP_FILE_TYPE_BMP:
+    case APP_FILE_TYPE_QOI:
+    case APP_FILE_TYPE_PNG:
+    case APP_FILE_TYPE_RGBZ:
+        return LV_SYMBOL_IMAGE;
     case APP_FILE_TYPE_WAV:
-        icon = LV_SYMBOL_AUDIO;
-        break;
+        return LV_SYMBOL_AUDIO;
+    case APP_FILE_TYPE_AVI:
+        return LV_SYMBOL_VIDEO;
     default:
-        icon = LV_SYMBOL_FILE;
+        return LV_SYMBOL_FILE;
     }
+}
 
-    /* File button */
-    btn = lv_list_add_btn(fs_list, icon, filename);
+static lv_obj_t *app_lvgl_add_btn(const char *icon, const char *text)
+{
+    lv_obj_t *btn = lv_list_add_btn(fs_list, icon, text);
     lv_obj_set_style_bg_color(btn, lv_color_make(0x00, 0x00, 0x00), 0);
     lv_obj_set_style_text_color(btn, lv_color_make(0xFF, 0xFF, 0xFF), 0);
-    lv_obj_add_event_cb(btn, file_handler, LV_EVENT_CLICKED, NULL);
+    return btn;
+}
 
+/* List button i, created on the first use (the list shows them in order, before the "more" text) */
+static lv_obj_t *app_lvgl_get_item(size_t i)
+{
+    if (i < fs_items_count) {
+        return fs_items[i];
+    }
+
+    lv_obj_t *btn = app_lvgl_add_btn(LV_SYMBOL_FILE, "");
+    lv_obj_add_event_cb(btn, item_handler, LV_EVENT_CLICKED, NULL);
+    lv_obj_move_foreground(fs_more_label);
     if (filesystem_group) {
         lv_group_add_obj(filesystem_group, btn);
     }
+    fs_items[fs_items_count++] = btn;
+    return btn;
 }
 
-static void app_lvgl_add_folder(const char *filename)
+/* Show index entry on the list button (icon is the first child, text the second) */
+static void app_lvgl_set_item(lv_obj_t *btn, const char *name, uint8_t tag)
 {
-    lv_obj_t *btn;
+    const char *icon = tag == FS_TAG_DIR ? LV_SYMBOL_DIRECTORY : get_file_icon(name);
 
-    /* Directory button */
-    btn = lv_list_add_btn(fs_list, LV_SYMBOL_DIRECTORY, filename);
-    lv_obj_set_style_bg_color(btn, lv_color_make(0x00, 0x00, 0x00), 0);
-    lv_obj_set_style_text_color(btn, lv_color_make(0xFF, 0xFF, 0xFF), 0);
-    lv_obj_add_event_cb(btn, folder_handler, LV_EVENT_CLICKED, NULL);
-
-    if (filesystem_group) {
-        lv_group_add_obj(filesystem_group, btn);
+    if (strcmp(lv_image_get_src(lv_obj_get_child(btn, 0)), icon) != 0) {
+        lv_image_set_src(lv_obj_get_child(btn, 0), icon);
     }
+    if (strcmp(lv_label_get_text(lv_obj_get_child(btn, 1)), name) != 0) {
+        lv_label_set_text(lv_obj_get_child(btn, 1), name);
+    }
+    lv_obj_set_user_data(btn, (void *)(uintptr_t)tag);
+    lv_obj_clear_flag(btn, LV_OBJ_FLAG_HIDDEN);
 }
 
-static void app_disp_lvgl_show_files(const char *path)
+/* Add all items in the directory into the index, files get the tag */
+static void app_lvgl_add_dir(const char *path, uint8_t tag)
 {
-    struct dirent *dir;
+    struct dirent *de;
     DIR *d;
 
+    d = opendir(path);
+    if (d != NULL) {
+        /* (Note: Directories are not supported in SPIFFS) */
+        while ((de = readdir(d)) != NULL) {
+            if (app_file_index_push(&fs_index, de->d_name, de->d_type == DT_DIR ? FS_TAG_DIR : tag) != ESP_OK) {
+                ESP_LOGW(TAG, "Not enough memory, %s is not listed", de->d_name);
+                break;
+            }
+        }
+
+        closedir(d);
+    }
+}
+
+static void app_disp_lvgl_show_files(const char *path)
+{
     bsp_display_lock(0);
 
-    /* Clean all items in the list */
-    lv_obj_clean(fs_list);
+    /* The directory is read once, the search filters the index */
+    app_file_index_clear(&fs_index);
+    if (fs_search && lv_textarea_get_text(fs_search)[0] != '\0') {
+        lv_textarea_set_text(fs_search, "");
+    }
+    app_lvgl_add_dir(path, FS_TAG_FILE);
 
-    /* Current path */
-    app_lvgl_add_text(path);
+    /* Static media from the asset pack are shown together with the root files */
+    if (fs_assets_mounted && strcmp(path, FS_MNT_PATH) == 0) {
+        app_lvgl_add_dir(APP_ASSETS_MOUNT_POINT, FS_TAG_ASSET);
+    }
+    app_file_index_sort(&fs_index);
+
+    app_disp_lvgl_refresh_files();
+
+    bsp_display_unlock();
+}
+
+/* Show the files of the index matching the search on the list (display is locked) */
+static void app_disp_lvgl_refresh_files(void)
+{
+    const char *search = fs_search ? lv_textarea_get_text(fs_search) : "";
+    size_t first = 0;
+    size_t count = app_file_index_find(&fs_index, search, &first);
+    size_t shown = count < FS_LIST_MAX_ITEMS ? count : FS_LIST_MAX_ITEMS;
 
-    /* Not root -> Add back button */
-    if (strcmp(path, FS_MNT_PATH) != 0) {
-        app_lvgl_add_back();
+    /* Current path */
+    if (search[0] != '\0') {
+        lv_label_set_text_fmt(fs_path_label, "%s (%zu of %zu)", fs_current_path, count, fs_index.count);
+    } else {
+        lv_label_set_text(fs_path_label, fs_current_path);
     }
 
-    /* Open directory */
-    d = opendir(path);
-    if (d != NULL) {
-        /* Show button in the list for file of directory (Note: Directories are not supported in SPIFFS) */
-        while ((dir = readdir(d)) != NULL) {
-            if (dir->d_type == DT_DIR) {
-                app_lvgl_add_folder(dir->d_name);
-            } else {
-                app_lvgl_add_file(dir->d_name);
-            }
-        }
+    /* Not root -> Show back button */
+    if (strcmp(fs_current_path, FS_MNT_PATH) != 0) {
+        lv_obj_clear_flag(fs_back_btn, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(fs_back_btn, LV_OBJ_FLAG_HIDDEN);
+    }
 
-        closedir(d);
+    /* The buttons are relabeled, not rebuilt, so a keystroke costs only the changed texts and a redraw */
+    for (size_t i = 0; i < shown; i++) {
+        app_lvgl_set_item(app_lvgl_get_item(i), app_file_index_name(&fs_index, first + i),
+                          app_file_index_tag(&fs_index, first + i));
+    }
+    for (size_t i = shown; i < fs_items_count; i++) {
+        lv_obj_add_flag(fs_items[i], LV_OBJ_FLAG_HIDDEN);
+    }
+    if (count > shown) {
+        lv_label_set_text_fmt(fs_more_label, "%zu more, search to narrow", count - shown);
+        lv_obj_clear_flag(fs_more_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(fs_more_label, LV_OBJ_FLAG_HIDDEN);
     }
+    lv_obj_scroll_to_y(fs_list, 0, LV_ANIM_OFF);
+}
+
+/* A file was written, add it to the index, if its directory is shown (no directory scan) */
+static void app_disp_lvgl_file_added(const char *path)
+{
+    const char *name = strrchr(path, '/');
 
+    bsp_display_lock(0);
+    if (name && strlen(fs_current_path) == (size_t)(name - path) && strncmp(path, fs_current_path, name - path) == 0) {
+        app_file_index_add(&fs_index, name + 1, FS_TAG_FILE);
+        app_disp_lvgl_refresh_files();
+    }
     bsp_display_unlock();
 }
 
+static void search_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_CLICKED) {
+        lv_keyboard_set_textarea(fs_keyboard, fs_search);
+        lv_obj_clear_flag(fs_keyboard, LV_OBJ_FLAG_HIDDEN);
+    } else if (code == LV_EVENT_DEFOCUSED || code == LV_EVENT_READY || code == LV_EVENT_CANCEL) {
+        lv_obj_add_flag(fs_keyboard, LV_OBJ_FLAG_HIDDEN);
+    } else if (code == LV_EVENT_VALUE_CHANGED) {
+        /* Every typed character */
+        app_disp_lvgl_refresh_files();
+    }
+}
+
 static void app_disp_lvgl_show_filesystem(lv_obj_t *screen, lv_group_t *group)
 {
     /* Disable scrolling in this TAB */
@@ -721,13 +928,41 @@ static void app_disp_lvgl_show_filesystem(lv_obj_t *screen, lv_group_t *group)
     lv_obj_set_style_bg_grad_color(screen, lv_color_make(0x05, 0x05, 0x05), 0);
     lv_obj_set_style_bg_grad_dir(screen, LV_GRAD_DIR_VER, 0);
     lv_obj_set_style_bg_opa(screen, 255, 0);
+    lv_obj_set_style_pad_all(screen, 0, 0);
+
+    app_file_index_init(&fs_index);
+
+    /* Search of file names, filters the list as typed */
+    fs_search = lv_textarea_create(screen);
+    lv_textarea_set_one_line(fs_search, true);
+    lv_textarea_set_placeholder_text(fs_search, LV_SYMBOL_LIST" Search file name");
+    lv_obj_set_size(fs_search, BSP_LCD_H_RES, FS_SEARCH_HEIGHT);
+    lv_obj_set_style_pad_ver(fs_search, 6, 0);
+    lv_obj_align(fs_search, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_add_event_cb(fs_search, search_event_cb, LV_EVENT_ALL, NULL);
+
+    /* Shown while the search is edited (touch only) */
+    fs_keyboard = lv_keyboard_create(lv_layer_top());
+    lv_obj_add_flag(fs_keyboard, LV_OBJ_FLAG_HIDDEN);
 
     /* File list */
     fs_list = lv_list_create(screen);
-    lv_obj_set_size(fs_list, BSP_LCD_H_RES, BSP_LCD_V_RES - 40);
+    lv_obj_set_size(fs_list, BSP_LCD_H_RES, BSP_LCD_V_RES - 40 - FS_SEARCH_HEIGHT);
     lv_obj_set_style_bg_color(fs_list, lv_color_make(0x00, 0x00, 0x00), 0);
     lv_obj_set_style_text_color(fs_list, lv_color_make(0xFF, 0xFF, 0xFF), 0);
-    lv_obj_center(fs_list);
+    lv_obj_align(fs_list, LV_ALIGN_BOTTOM_MID, 0, 0);
+
+    /* Replaced by the path, once the storage is mounted */
+    fs_path_label = lv_list_add_text(fs_list, "Loading...");
+
+    /* Back button, shown out of the root */
+    fs_back_btn = app_lvgl_add_btn(LV_SYMBOL_LEFT, "Back");
+    lv_obj_add_event_cb(fs_back_btn, back_handler, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_flag(fs_back_btn, LV_OBJ_FLAG_HIDDEN);
+
+    /* Matches over FS_LIST_MAX_ITEMS, the file buttons go before it */
+    fs_more_label = lv_list_add_text(fs_list, "");
+    lv_obj_add_flag(fs_more_label, LV_OBJ_FLAG_HIDDEN);
 }
 
 static void slider_brightness_event_cb(lv_event_t *e)
@@ -740,37 +975,23 @@ static void slider_brightness_event_cb(lv_event_t *e)
     bsp_display_brightness_set(lv_slider_get_value(slider));
 }
 
-/* Play recorded audio file */
-static void rec_play_event_cb(lv_event_t *e)
-{
-    lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t *obj = lv_event_get_target(e);
-
-    if (code == LV_EVENT_CLICKED) {
-        audio_mux = xSemaphoreCreateMutex();
-        assert(audio_mux);
-        play_file_stop = false;
-        lv_obj_add_state(obj, LV_STATE_DISABLED);
-        xTaskCreate(play_file, "audio_task", 4096, lv_event_get_user_data(e), 6, NULL);
-    }
-}
-
-/* Stop playing recorded audio file */
-static void rec_stop_event_cb(lv_event_t *e)
-{
-    lv_event_code_t code = lv_event_get_code(e);
-
-    if (code == LV_EVENT_CLICKED) {
-        play_file_stop = true;
-    }
-}
-
 static void rec_file(void *arg)
 {
 #if BSP_CAPS_AUDIO_MIC
     char *path = arg;
     FILE *record_file = NULL;
-    int16_t *recording_buffer = heap_caps_malloc(BUFFER_SIZE, MALLOC_CAP_DEFAULT);
+    int16_t *recording_buffer = NULL;
+    if (!wait_boot_stage(APP_DISP_STAGE_AUDIO) || !wait_boot_stage(APP_DISP_STAGE_FILES)) {
+        goto END;
+    }
+
+    /* The recording may overwrite the played file, it must be closed first */
+    if (app_media_stop_sync(MEDIA_STOP_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGE(TAG, "Playback did not stop!");
+        goto END;
+    }
+
+    recording_buffer = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
     if (recording_buffer == NULL) {
         ESP_LOGE(TAG, "Not enough memory for playing!");
         goto END;
@@ -792,6 +1013,9 @@ static void rec_file(void *arg)
     };
     if (fwrite((void *)&recording_header, 1, sizeof(dumb_wav_header_t), record_file) != sizeof(dumb_wav_header_t)) {
         ESP_LOGW(TAG, "Error in writting to file");
+        fclose(record_file);
+        record_file = NULL;
+        unlink(path);
         goto END;
     }
 
@@ -808,30 +1032,33 @@ static void rec_file(void *arg)
     size_t bytes_written_to_spiffs = 0;
     while (bytes_written_to_spiffs < RECORDING_LENGTH * BUFFER_SIZE) {
         ESP_ERROR_CHECK(esp_codec_dev_read(mic_codec_dev, recording_buffer, BUFFER_SIZE));
+        app_spectrum_feed(recording_buffer, BUFFER_SIZE / sizeof(int16_t), 1, SAMPLE_RATE);
 
         /* Write WAV file data */
         size_t data_written = fwrite(recording_buffer, 1, BUFFER_SIZE, record_file);
         bytes_written_to_spiffs += data_written;
     }
 
-    ESP_LOGI(TAG, "Recording stop, length: %i bytes", bytes_written_to_spiffs);
+    ESP_LOGI(TAG, "Recording stop, length: %zu bytes", bytes_written_to_spiffs);
 
 END:
     esp_codec_dev_close(mic_codec_dev);
 
     if (record_file) {
         fclose(record_file);
+        app_disp_lvgl_file_added(path);
     }
 
-    if (recording_buffer) {
-        free(recording_buffer);
-    }
+    app_mem_pool_free(recording_buffer);
 
     if (rec_btn && play1_btn && rec_stop_btn) {
         bsp_display_lock(0);
         lv_obj_clear_state(rec_btn, LV_STATE_DISABLED);
         lv_obj_clear_state(play1_btn, LV_STATE_DISABLED);
         lv_obj_clear_state(rec_stop_btn, LV_STATE_DISABLED);
+        if (vad_btn) {
+            lv_obj_clear_state(vad_btn, LV_STATE_DISABLED);
+        }
         bsp_display_unlock();
     }
 
@@ -841,6 +1068,201 @@ END:
 #endif
 }
 
+#if BSP_CAPS_AUDIO_MIC
+/* Open next free VAD recording file and write WAV header, the data size is patched on close */
+static FILE *rec_vad_open(char *path, size_t path_len)
+{
+    struct stat st;
+
+    for (int i = 0; i < REC_VAD_MAX_FILES; i++) {
+        snprintf(path, path_len, REC_VAD_FILENAME, i);
+        if (stat(path, &st) != 0) {
+            FILE *file = fopen(path, "wb");
+            if (file) {
+                const dumb_wav_header_t header = {
+                    .bits_per_sample = 16,
+                    .data_size = 0,
+                    .num_channels = 1,
+                    .sample_rate = SAMPLE_RATE
+                };
+                if (fwrite((void *)&header, 1, sizeof(dumb_wav_header_t), file) != sizeof(dumb_wav_header_t)) {
+                    ESP_LOGW(TAG, "Error in writting to file");
+                    fclose(file);
+                    unlink(path);
+                    return NULL;
+                }
+            }
+            return file;
+        }
+    }
+
+    return NULL;
+}
+
+/* Patch the data size and close, a recording with a broken header is deleted */
+static bool rec_vad_close(FILE *file, const char *path, uint32_t data_size)
+{
+    const dumb_wav_header_t header = {
+        .bits_per_sample = 16,
+        .data_size = data_size,
+        .num_channels = 1,
+        .sample_rate = SAMPLE_RATE
+    };
+
+    bool ok = fseek(file, 0, SEEK_SET) == 0 &&
+              fwrite((void *)&header, 1, sizeof(dumb_wav_header_t), file) == sizeof(dumb_wav_header_t);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok) {
+        ESP_LOGE(TAG, "VAD recording %s not saved, header write failed", path);
+        unlink(path);
+        return false;
+    }
+
+    ESP_LOGI(TAG, "VAD recording stop: %s, length: %" PRIu32 " bytes", path, data_size);
+    return true;
+}
+#endif
+
+/* Record continuously into pre-roll ring, write to file only while speech is detected */
+static void rec_vad_file(void *arg)
+{
+#if BSP_CAPS_AUDIO_MIC
+    char path[32];
+    FILE *record_file = NULL;
+    uint32_t bytes_written_to_spiffs = 0;
+    app_vad_t vad;
+    app_vad_preroll_t preroll = { 0 };
+    const app_vad_config_t vad_cfg = {
+        .sample_rate = SAMPLE_RATE,
+        .threshold_db = CONFIG_APP_VAD_THRESHOLD_DB,
+        .min_energy = CONFIG_APP_VAD_MIN_ENERGY,
+        .attack_ms = CONFIG_APP_VAD_ATTACK_MS,
+        .hangover_ms = CONFIG_APP_VAD_HANGOVER_MS,
+    };
+
+    bool arena = false;
+    int16_t *recording_buffer = NULL;
+    if (!wait_boot_stage(APP_DISP_STAGE_AUDIO) || !wait_boot_stage(APP_DISP_STAGE_FILES)) {
+        goto END;
+    }
+
+    recording_buffer = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    if (recording_buffer == NULL) {
+        ESP_LOGE(TAG, "Not enough memory for recording!");
+        goto END;
+    }
+
+    if (app_mem_arena_begin(APP_MEM_ARENA_REC) != ESP_OK) {
+        ESP_LOGE(TAG, "Recording memory is in use!");
+        goto END;
+    }
+    arena = true;
+
+    if (!app_vad_preroll_init(&preroll, BUFFER_SIZE, CONFIG_APP_VAD_PREROLL_MS, SAMPLE_RATE)) {
+        ESP_LOGE(TAG, "Not enough memory for pre-roll!");
+        goto END;
+    }
+
+    app_vad_init(&vad, &vad_cfg);
+
+    esp_codec_dev_sample_info_t fs = {
+        .sample_rate = SAMPLE_RATE,
+        .channel = 1,
+        .bits_per_sample = 16,
+        .mclk_multiple = I2S_MCLK_MULTIPLE_384,
+    };
+    esp_codec_dev_open(mic_codec_dev, &fs);
+
+    ESP_LOGI(TAG, "VAD armed");
+
+    while (!rec_vad_stop) {
+        ESP_ERROR_CHECK(esp_codec_dev_read(mic_codec_dev, recording_buffer, BUFFER_SIZE));
+        app_spectrum_feed(recording_buffer, BUFFER_SIZE / sizeof(int16_t), 1, SAMPLE_RATE);
+        app_vad_event_t event = app_vad_process(&vad, recording_buffer, BUFFER_SIZE / sizeof(int16_t));
+
+        if (record_file == NULL) {
+            if (event == APP_VAD_EVENT_SPEECH_START) {
+                record_file = rec_vad_open(path, sizeof(path));
+                if (record_file == NULL) {
+                    ESP_LOGE(TAG, "Cannot create VAD recording file!");
+                    break;
+                }
+                ESP_LOGI(TAG, "VAD recording start: %s", path);
+
+                /* Write pre-roll first, then the current block */
+                bytes_written_to_spiffs = 0;
+                const void *block;
+                while ((block = app_vad_preroll_pop(&preroll)) != NULL) {
+                    bytes_written_to_spiffs += fwrite(block, 1, BUFFER_SIZE, record_file);
+                }
+                bytes_written_to_spiffs += fwrite(recording_buffer, 1, BUFFER_SIZE, record_file);
+            } else {
+                app_vad_preroll_push(&preroll, recording_buffer);
+            }
+        } else {
+            bytes_written_to_spiffs += fwrite(recording_buffer, 1, BUFFER_SIZE, record_file);
+            if (event == APP_VAD_EVENT_SPEECH_END) {
+                if (rec_vad_close(record_file, path, bytes_written_to_spiffs)) {
+                    app_disp_lvgl_file_added(path);
+                }
+                record_file = NULL;
+            }
+        }
+    }
+
+    ESP_LOGI(TAG, "VAD disarmed");
+
+END:
+    esp_codec_dev_close(mic_codec_dev);
+
+    if (record_file && rec_vad_close(record_file, path, bytes_written_to_spiffs)) {
+        app_disp_lvgl_file_added(path);
+    }
+
+    app_vad_preroll_deinit(&preroll);
+    if (arena) {
+        app_mem_arena_end(APP_MEM_ARENA_REC);
+    }
+    app_mem_pool_free(recording_buffer);
+
+    if (rec_btn && play1_btn && rec_stop_btn && vad_btn) {
+        bsp_display_lock(0);
+        lv_obj_clear_state(rec_btn, LV_STATE_DISABLED);
+        lv_obj_clear_state(play1_btn, LV_STATE_DISABLED);
+        lv_obj_clear_state(rec_stop_btn, LV_STATE_DISABLED);
+        lv_obj_clear_state(vad_btn, LV_STATE_CHECKED | LV_STATE_DISABLED);
+        bsp_display_unlock();
+    }
+
+    vTaskDelete(NULL);
+#else
+    ESP_LOGI(TAG, "Recording not supported!");
+#endif
+}
+
+/* Arm/disarm voice activity triggered recording */
+static void vad_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t *obj = lv_event_get_target(e);
+
+    if (code == LV_EVENT_VALUE_CHANGED) {
+        if (lv_obj_get_state(obj) & LV_STATE_CHECKED) {
+            rec_vad_stop = false;
+            if (rec_btn && rec_stop_btn && play1_btn) {
+                lv_obj_add_state(rec_btn, LV_STATE_DISABLED);
+                lv_obj_add_state(play1_btn, LV_STATE_DISABLED);
+                lv_obj_add_state(rec_stop_btn, LV_STATE_DISABLED);
+            }
+            xTaskCreate(rec_vad_file, "rec_vad_file", 4096, NULL, 6, NULL);
+        } else {
+            /* The task re-enables the buttons when the file is closed */
+            rec_vad_stop = true;
+            lv_obj_add_state(obj, LV_STATE_DISABLED);
+        }
+    }
+}
+
 /* Stop playing recorded audio file */
 static void rec_event_cb(lv_event_t *e)
 {
@@ -853,6 +1275,10 @@ static void rec_event_cb(lv_event_t *e)
             lv_obj_add_state(play1_btn, LV_STATE_DISABLED);
             lv_obj_add_state(rec_stop_btn, LV_STATE_DISABLED);
         }
+        if (vad_btn) {
+            lv_obj_add_state(vad_btn, LV_STATE_DISABLED);
+        }
+        /* The task stops the playback first, the recording may overwrite the played file */
         xTaskCreate(rec_file, "rec_file", 4096, lv_event_get_user_data(e), 6, NULL);
     }
 }
@@ -893,18 +1319,29 @@ static void app_disp_lvgl_show_record(lv_obj_t *screen, lv_group_t *group)
     play1_btn = lv_btn_create(cont_row);
     label = lv_label_create(play1_btn);
     lv_label_set_text_static(label, LV_SYMBOL_PLAY);
-    lv_obj_add_event_cb(play1_btn, rec_play_event_cb, LV_EVENT_CLICKED, (char *)REC_FILENAME);
+    lv_obj_add_event_cb(play1_btn, play_event_cb, LV_EVENT_CLICKED, (char *)REC_FILENAME);
 
     /* Stop button */
     rec_stop_btn = lv_btn_create(cont_row);
     label = lv_label_create(rec_stop_btn);
     lv_label_set_text_static(label, LV_SYMBOL_STOP);
-    lv_obj_add_event_cb(rec_stop_btn, rec_stop_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(rec_stop_btn, stop_event_cb, LV_EVENT_CLICKED, NULL);
+
+    /* Voice activity triggered recording */
+    vad_btn = lv_btn_create(cont_row);
+    label = lv_label_create(vad_btn);
+    lv_obj_add_flag(vad_btn, LV_OBJ_FLAG_CHECKABLE);
+    lv_label_set_text_static(label, "VAD");
+    lv_obj_add_event_cb(vad_btn, vad_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    /* Spectrum of the recorded and played audio */
+    app_spectrum_create(screen, BSP_LCD_H_RES - 20, 90);
 
     if (group) {
         lv_group_add_obj(group, rec_btn);
         lv_group_add_obj(group, play1_btn);
         lv_group_add_obj(group, rec_stop_btn);
+        lv_group_add_obj(group, vad_btn);
     }
 }
 
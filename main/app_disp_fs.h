@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include "esp_err.h"
 
 /* Default screen brightness */
 #define APP_DISP_DEFAULT_BRIGHTNESS  (50)
 
+/* Boot stages (app_boot.h) waited for by the audio and recording tasks */
+#define APP_DISP_STAGE_AUDIO    "audio"
+#define APP_DISP_STAGE_FILES    "files"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,14 +25,16 @@ extern "C" {
 void app_disp_lvgl_show(void);
 
 /**
- * @brief Initialize SPI Flash File System and show list of files on display
+ * @brief Show list of files on display, the storage must be mounted
  */
 void app_disp_fs_init(void);
 
 /**
  * @brief Initialize audio
+ *
+ * @return ESP_OK on success, ESP_FAIL if the speaker or microphone codec is not available
  */
-void app_audio_init(void);
+esp_err_t app_audio_init(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Radix-4 decimation in time on bit-reversed input. Two radix-2 stages of span L and 2L are
+ * merged into one butterfly on x[k], x[k+L], x[k+2L], x[k+3L] with w = exp(-2*pi*i*j/4L):
+ *
+ *   X0 = (a + w^2 b) + (w c + w^3 d)      X1 = (a - w^2 b) - i (w c - w^3 d)
+ *   X2 = (a + w^2 b) - (w c + w^3 d)      X3 = (a - w^2 b) + i (w c - w^3 d)
+ *
+ * which needs 3 complex multiplications instead of 4 and half of the passes over the data.
+ * If log2 of the size is odd, one radix-2 stage (span 1) goes first. Every butterfly is scaled
+ * by 1/4 (1/2), so the magnitude never grows; products are accumulated in Q28, so only the
+ * final rounding loses precision.
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "esp_heap_caps.h"
+#include "app_fft.h"
+
+/* 10 * log10(2) in Q15 and Q8 scaling: 3.0103 * 256 / 32768 */
+#define FFT_DB_PER_LOG2_Q15     (771)
+/* Full-scale sine (amplitude 32768) with Hann window has bin amplitude 8192, power 2^26 */
+#define FFT_REF_LOG2            (26)
+#define FFT_MIN_DB_Q8           (-120 * 256)
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline int16_t fft_sat16(int32_t x)
+{
+    if (x > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+/* exp(-2*pi*i*k/size) for k < size */
+static inline app_fft_cpx_t fft_twiddle(const app_fft_t *fft, uint32_t k)
+{
+    uint32_t half = fft->size / 2;
+    if (k < half) {
+        return fft->twiddle[k];
+    }
+    app_fft_cpx_t w = fft->twiddle[k - half];
+    w.re = -w.re;
+    w.im = -w.im;
+    return w;
+}
+
+/* Q15 x Q15 complex product in Q28 */
+static inline void fft_mul_q28(app_fft_cpx_t x, app_fft_cpx_t w, int32_t *re, int32_t *im)
+{
+    *re = ((int32_t)x.re * w.re - (int32_t)x.im * w.im) >> 2;
+    *im = ((int32_t)x.re * w.im + (int32_t)x.im * w.re) >> 2;
+}
+
+static void fft_radix2_first(app_fft_cpx_t *data, uint32_t n)
+{
+    for (uint32_t k = 0; k < n; k += 2) {
+        app_fft_cpx_t a = data[k];
+        app_fft_cpx_t b = data[k + 1];
+        data[k].re = (int16_t)(((int32_t)a.re + b.re) >> 1);
+        data[k].im = (int16_t)(((int32_t)a.im + b.im) >> 1);
+        data[k + 1].re = (int16_t)(((int32_t)a.re - b.re) >> 1);
+        data[k + 1].im = (int16_t)(((int32_t)a.im - b.im) >> 1);
+    }
+}
+
+static void fft_radix4_stage(const app_fft_t *fft, app_fft_cpx_t *data, uint32_t n, uint32_t span)
+{
+    /* Twiddle of the 4*span point DFT is every (size / 4 / span)-th of the table */
+    const uint32_t step = fft->size / (4 * span);
+
+    for (uint32_t j = 0; j < span; j++) {
+        const app_fft_cpx_t w1 = fft_twiddle(fft, j * step);
+        const app_fft_cpx_t w2 = fft_twiddle(fft, 2 * j * step);
+        const app_fft_cpx_t w3 = fft_twiddle(fft, 3 * j * step);
+
+        for (uint32_t k = j; k < n; k += 4 * span) {
+            app_fft_cpx_t *p0 = &data[k];
+            app_fft_cpx_t *p1 = p0 + span;
+            app_fft_cpx_t *p2 = p1 + span;
+            app_fft_cpx_t *p3 = p2 + span;
+
+            int32_t b_re, b_im, c_re, c_im, d_re, d_im;
+            fft_mul_q28(*p1, w2, &b_re, &b_im);
+            fft_mul_q28(*p2, w1, &c_re, &c_im);
+            fft_mul_q28(*p3, w3, &d_re, &d_im);
+            const int32_t a_re = (int32_t)p0->re * (1 << 13);
+            const int32_t a_im = (int32_t)p0->im * (1 << 13);
+
+            const int32_t t0_re = a_re + b_re, t0_im = a_im + b_im;
+            const int32_t t1_re = a_re - b_re, t1_im = a_im - b_im;
+            const int32_t t2_re = c_re + d_re, t2_im = c_im + d_im;
+            const int32_t t3_re = c_re - d_re, t3_im = c_im - d_im;
+
+            /* Q28 / 4 -> Q15, the magnitude does not grow, so no saturation is needed */
+            const int32_t round = 1 << 14;
+            p0->re = (int16_t)((t0_re + t2_re + round) >> 15);
+            p0->im = (int16_t)((t0_im + t2_im + round) >> 15);
+            p1->re = (int16_t)((t1_re + t3_im + round) >> 15);
+            p1->im = (int16_t)((t1_im - t3_re + round) >> 15);
+            p2->re = (int16_t)((t0_re - t2_re + round) >> 15);
+            p2->im = (int16_t)((t0_im - t2_im + round) >> 15);
+            p3->re = (int16_t)((t1_re - t3_im + round) >> 15);
+            p3->im = (int16_t)((t1_im + t3_re + round) >> 15);
+        }
+    }
+}
+
+/* Fast log2 in Q15, log2(1 + f) ~ f * (1.3466 - 0.3466 f), error below 0.005 */
+static inline int32_t fft_log2_q15(uint32_t x)
+{
+    int n = 31 - __builtin_clz(x);
+    int32_t f = (n >= 15) ? (int32_t)(x >> (n - 15)) - 32768 : (int32_t)(x << (15 - n)) - 32768;
+    int32_t frac = (f * (44127 - ((11359 * f) >> 15))) >> 15;
+    return n * 32768 + frac;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_fft_init(app_fft_t *fft, uint16_t size)
+{
+    if (size < APP_FFT_MIN_SIZE || size > APP_FFT_MAX_SIZE || (size & (size - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const uint32_t half = size / 2;
+    memset(fft, 0, sizeof(app_fft_t));
+    fft->size = size;
+    fft->log2_half = __builtin_ctz(half);
+
+    /* All tables in one block */
+    uint8_t *mem = heap_caps_malloc(half * sizeof(app_fft_cpx_t) + (half + 1) * sizeof(app_fft_cpx_t) +
+                                    size * sizeof(int16_t) + half * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    if (mem == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    fft->twiddle = (app_fft_cpx_t *)mem;
+    fft->work = fft->twiddle + half;
+    fft->window = (int16_t *)(fft->work + half + 1);
+    fft->bitrev = (uint16_t *)(fft->window + size);
+
+    for (uint32_t k = 0; k < half; k++) {
+        double angle = -2.0 * M_PI * k / size;
+        fft->twiddle[k].re = fft_sat16(lround(cos(angle) * 32768.0));
+        fft->twiddle[k].im = fft_sat16(lround(sin(angle) * 32768.0));
+    }
+    for (uint32_t n = 0; n < size; n++) {
+        fft->window[n] = fft_sat16(lround(0.5 * (1.0 - cos(2.0 * M_PI * n / size)) * 32768.0));
+    }
+    for (uint32_t i = 0; i < half; i++) {
+        uint32_t r = 0;
+        for (uint8_t b = 0; b < fft->log2_half; b++) {
+            r |= ((i >> b) & 1) << (fft->log2_half - 1 - b);
+        }
+        fft->bitrev[i] = r;
+    }
+
+    return ESP_OK;
+}
+
+void app_fft_deinit(app_fft_t *fft)
+{
+    /* Tables start with the twiddle factors */
+    heap_caps_free(fft->twiddle);
+    memset(fft, 0, sizeof(app_fft_t));
+}
+
+void app_fft_cpx(const app_fft_t *fft, app_fft_cpx_t *data)
+{
+    const uint32_t n = fft->size / 2;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t j = fft->bitrev[i];
+        if (j > i) {
+            app_fft_cpx_t t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+    }
+
+    uint32_t span = 1;
+    if (fft->log2_half & 1) {
+        fft_radix2_first(data, n);
+        span = 2;
+    }
+    for (; span < n; span *= 4) {
+        fft_radix4_stage(fft, data, n, span);
+    }
+}
+
+const app_fft_cpx_t *app_fft_real(const app_fft_t *fft, const int16_t *in, bool windowed)
+{
+    const uint32_t half = fft->size / 2;
+    app_fft_cpx_t *z = fft->work;
+
+    /*
+     * Even samples are the real part, odd samples the imaginary part. The input is halved, so
+     * the magnitude of a complex sample stays in Q15 range.
+     */
+    for (uint32_t n = 0; n < half; n++) {
+        if (windowed) {
+            z[n].re = (int16_t)(((int32_t)in[2 * n] * fft->window[2 * n] + (1 << 15)) >> 16);
+            z[n].im = (int16_t)(((int32_t)in[2 * n + 1] * fft->window[2 * n + 1] + (1 << 15)) >> 16);
+        } else {
+            z[n].re = in[2 * n] >> 1;
+            z[n].im = in[2 * n + 1] >> 1;
+        }
+    }
+
+    app_fft_cpx(fft, z);
+
+    /*
+     * Split: X[k] = E[k] + W^k O[k], E = (Z[k] + Z*[M-k]) / 2, O = (Z[k] - Z*[M-k]) / 2i.
+     * Bins k and M - k use the same pair of Z, so the split is done in place. Z[M] = Z[0].
+     */
+    z[half] = z[0];
+    for (uint32_t k = 0; k <= half / 2; k++) {
+        const uint32_t m = half - k;
+        const app_fft_cpx_t zk = z[k];
+        const app_fft_cpx_t zm = z[m];
+
+        for (int pass = 0; pass < 2; pass++) {
+            const app_fft_cpx_t a = pass ? zm : zk;
+            const app_fft_cpx_t b = pass ? zk : zm;
+            const uint32_t bin = pass ? m : k;
+
+            /* 2E and 2O */
+            const int32_t e_re = (int32_t)a.re + b.re;
+            const int32_t e_im = (int32_t)a.im - b.im;
+            const int32_t o_re = (int32_t)a.im + b.im;
+            const int32_t o_im = (int32_t)b.re - a.re;
+
+            const app_fft_cpx_t w = fft_twiddle(fft, bin);
+            const int64_t x_re = (int64_t)e_re * (1 << 15) + (int64_t)o_re * w.re - (int64_t)o_im * w.im;
+            const int64_t x_im = (int64_t)e_im * (1 << 15) + (int64_t)o_re * w.im + (int64_t)o_im * w.re;
+
+            z[bin].re = fft_sat16((int32_t)((x_re + (1 << 15)) >> 16));
+            z[bin].im = fft_sat16((int32_t)((x_im + (1 << 15)) >> 16));
+
+            if (m == k) {
+                break;
+            }
+        }
+    }
+
+    return z;
+}
+
+void app_fft_power_db(const app_fft_t *fft, const app_fft_cpx_t *bins, int16_t *db)
+{
+    for (uint32_t k = 0; k <= fft->size / 2u; k++) {
+        uint32_t power = (uint32_t)((int32_t)bins[k].re * bins[k].re) + (uint32_t)((int32_t)bins[k].im * bins[k].im);
+        if (power == 0) {
+            db[k] = FFT_MIN_DB_Q8;
+            continue;
+        }
+        int32_t value = ((fft_log2_q15(power) - FFT_REF_LOG2 * 32768) * FFT_DB_PER_LOG2_Q15) >> 15;
+        db[k] = value < FFT_MIN_DB_Q8 ? FFT_MIN_DB_Q8 : (int16_t)value;
+    }
+}
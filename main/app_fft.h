@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Supported real FFT sizes */
+#define APP_FFT_MIN_SIZE    (256)
+#define APP_FFT_MAX_SIZE    (2048)
+
+/**
+ * @brief Complex Q15 sample
+ */
+typedef struct {
+    int16_t re;
+    int16_t im;
+} app_fft_cpx_t;
+
+/**
+ * @brief Fixed-point real FFT plan
+ *
+ * The transform is done as a complex FFT of half size (radix-4 stages on bit-reversed
+ * input, one radix-2 stage if needed) followed by the real split step. Every stage is
+ * scaled down, so the output never overflows: X[k] = DFT(x)[k] / size.
+ */
+typedef struct {
+    uint16_t size;              /*!< Real FFT size (power of two) */
+    uint8_t log2_half;          /*!< log2(size / 2) */
+    app_fft_cpx_t *twiddle;     /*!< exp(-2*pi*i*k/size), k < size / 2 */
+    uint16_t *bitrev;           /*!< Bit reversal of indices < size / 2 */
+    int16_t *window;            /*!< Hann window, Q15 */
+    app_fft_cpx_t *work;        /*!< size / 2 + 1 complex samples */
+} app_fft_t;
+
+/**
+ * @brief Allocate tables and work buffer of the plan
+ *
+ * @return ESP_ERR_INVALID_ARG if size is not a power of two in APP_FFT_MIN_SIZE ... APP_FFT_MAX_SIZE
+ */
+esp_err_t app_fft_init(app_fft_t *fft, uint16_t size);
+
+/**
+ * @brief Free the plan
+ */
+void app_fft_deinit(app_fft_t *fft);
+
+/**
+ * @brief In-place complex FFT of size / 2 points (natural order input and output), scaled by 2 / size
+ *
+ * The magnitude of the input samples must not exceed 23170 (32767 / sqrt(2)).
+ */
+void app_fft_cpx(const app_fft_t *fft, app_fft_cpx_t *data);
+
+/**
+ * @brief Real FFT of size samples
+ *
+ * @param[in] in size Q15 samples
+ * @param[in] windowed Apply Hann window
+ * @return size / 2 + 1 bins (DC ... Nyquist) in fft->work, scaled by 1 / size
+ */
+const app_fft_cpx_t *app_fft_real(const app_fft_t *fft, const int16_t *in, bool windowed);
+
+/**
+ * @brief Power of bins in dB relative to a full-scale sine with Hann window
+ *
+ * @param[out] db size / 2 + 1 values in 1/256 dB (Q8), -120 dB for empty bins
+ */
+void app_fft_power_db(const app_fft_t *fft, const app_fft_cpx_t *bins, int16_t *db);
+
+#ifdef __cplusplus
+}
+#endif
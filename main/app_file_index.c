@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+
+#include "esp_heap_caps.h"
+#include "app_file_index.h"
+
+/* Initial allocation, doubled when full */
+#define INDEX_MIN_ENTRIES   (64)
+#define INDEX_MIN_POOL      (1024)
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void *index_realloc(void *ptr, size_t size)
+{
+    void *mem = heap_caps_realloc(ptr, size, MALLOC_CAP_SPIRAM);
+    if (mem == NULL) {
+        mem = heap_caps_realloc(ptr, size, MALLOC_CAP_DEFAULT);
+    }
+    return mem;
+}
+
+/* Case-insensitive order, names differing only in case are ordered by bytes */
+static int index_compare(const char *a, const char *b)
+{
+    int ret = strcasecmp(a, b);
+    return ret ? ret : strcmp(a, b);
+}
+
+static int index_compare_at(const app_file_index_t *index, size_t a, size_t b)
+{
+    return index_compare(app_file_index_name(index, a), app_file_index_name(index, b));
+}
+
+static void index_swap(app_file_index_entry_t *entries, size_t a, size_t b)
+{
+    app_file_index_entry_t tmp = entries[a];
+    entries[a] = entries[b];
+    entries[b] = tmp;
+}
+
+/* Heap sort, in place and without recursion */
+static void index_sift_down(app_file_index_t *index, size_t root, size_t count)
+{
+    for (size_t child; (child = 2 * root + 1) < count; root = child) {
+        if (child + 1 < count && index_compare_at(index, child, child + 1) < 0) {
+            child++;
+        }
+        if (index_compare_at(index, root, child) >= 0) {
+            return;
+        }
+        index_swap(index->entries, root, child);
+    }
+}
+
+static esp_err_t index_append(app_file_index_t *index, const char *name, uint8_t tag)
+{
+    const size_t len = strlen(name) + 1;
+
+    if (index->count == index->capacity) {
+        size_t capacity = index->capacity ? 2 * index->capacity : INDEX_MIN_ENTRIES;
+        app_file_index_entry_t *entries = index_realloc(index->entries, capacity * sizeof(app_file_index_entry_t));
+        if (entries == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        index->entries = entries;
+        index->capacity = capacity;
+    }
+    if (index->pool_len + len > index->pool_size) {
+        size_t size = index->pool_size ? index->pool_size : INDEX_MIN_POOL;
+        while (index->pool_len + len > size) {
+            size *= 2;
+        }
+        char *pool = index_realloc(index->pool, size);
+        if (pool == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        index->pool = pool;
+        index->pool_size = size;
+    }
+
+    memcpy(index->pool + index->pool_len, name, len);
+    index->entries[index->count].name = index->pool_len;
+    index->entries[index->count].tag = tag;
+    index->pool_len += len;
+    index->count++;
+    return ESP_OK;
+}
+
+/* First entry not ordered before name (by the first n characters, if n > 0) */
+static size_t index_lower_bound(const app_file_index_t *index, const char *name, size_t n, bool after)
+{
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const char *entry = app_file_index_name(index, mid);
+        int cmp = n ? strncasecmp(entry, name, n) : index_compare(entry, name);
+        if (cmp < 0 || (after && cmp == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+void app_file_index_init(app_file_index_t *index)
+{
+    memset(index, 0, sizeof(app_file_index_t));
+}
+
+void app_file_index_clear(app_file_index_t *index)
+{
+    index->count = 0;
+    index->sorted = 0;
+    index->pool_len = 0;
+}
+
+void app_file_index_deinit(app_file_index_t *index)
+{
+    heap_caps_free(index->entries);
+    heap_caps_free(index->pool);
+    app_file_index_init(index);
+}
+
+esp_err_t app_file_index_push(app_file_index_t *index, const char *name, uint8_t tag)
+{
+    return index_append(index, name, tag);
+}
+
+void app_file_index_sort(app_file_index_t *index)
+{
+    if (index->sorted == index->count) {
+        return;
+    }
+
+    const size_t count = index->count;
+    for (size_t i = count / 2; i-- > 0;) {
+        index_sift_down(index, i, count);
+    }
+    for (size_t end = count; end-- > 1;) {
+        index_swap(index->entries, 0, end);
+        index_sift_down(index, 0, end);
+    }
+    index->sorted = count;
+}
+
+esp_err_t app_file_index_add(app_file_index_t *index, const char *name, uint8_t tag)
+{
+    app_file_index_sort(index);
+
+    size_t pos = index_lower_bound(index, name, 0, false);
+    if (pos < index->count && strcmp(app_file_index_name(index, pos), name) == 0) {
+        index->entries[pos].tag = tag;
+        return ESP_OK;
+    }
+
+    esp_err_t ret = index_append(index, name, tag);
+    if (ret == ESP_OK) {
+        /* Move the new entry from the end to its place */
+        app_file_index_entry_t entry = index->entries[index->count - 1];
+        memmove(&index->entries[pos + 1], &index->entries[pos], (index->count - 1 - pos) * sizeof(app_file_index_entry_t));
+        index->entries[pos] = entry;
+        index->sorted = index->count;
+    }
+    return ret;
+}
+
+size_t app_file_index_find(const app_file_index_t *index, const char *prefix, size_t *first)
+{
+    const size_t n = strlen(prefix);
+    if (n == 0) {
+        *first = 0;
+        return index->count;
+    }
+
+    *first = index_lower_bound(index, prefix, n, false);
+    return index_lower_bound(index, prefix, n, true) - *first;
+}
+
+size_t app_file_index_memory(const app_file_index_t *index)
+{
+    return index->capacity * sizeof(app_file_index_entry_t) + index->pool_size;
+}
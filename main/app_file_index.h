@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Entry of the file name index
+ */
+typedef struct {
+    uint32_t name;              /*!< Offset of the name in the pool */
+    uint8_t tag;                /*!< Caller's value (file, directory, mount point...) */
+} app_file_index_entry_t;
+
+/**
+ * @brief File names of a directory, sorted case-insensitively
+ *
+ * Names are kept in one pool and the entries in one array sorted by name, so all names
+ * starting with a prefix are a contiguous run found by binary search. Memory is taken
+ * from PSRAM, if available.
+ */
+typedef struct {
+    app_file_index_entry_t *entries;
+    size_t count;
+    size_t capacity;
+    char *pool;
+    size_t pool_len;
+    size_t pool_size;
+    size_t sorted;              /*!< Entries from here are appended, not sorted yet */
+} app_file_index_t;
+
+/**
+ * @brief Initialize empty index
+ */
+void app_file_index_init(app_file_index_t *index);
+
+/**
+ * @brief Remove all names, the memory is kept for the next directory
+ */
+void app_file_index_clear(app_file_index_t *index);
+
+/**
+ * @brief Free index memory
+ */
+void app_file_index_deinit(app_file_index_t *index);
+
+/**
+ * @brief Append name to be sorted by app_file_index_sort() (building from a directory listing)
+ *
+ * The index must not be searched until it is sorted.
+ */
+esp_err_t app_file_index_push(app_file_index_t *index, const char *name, uint8_t tag);
+
+/**
+ * @brief Sort appended names
+ */
+void app_file_index_sort(app_file_index_t *index);
+
+/**
+ * @brief Insert name into the sorted index (a new file)
+ *
+ * If the name is already indexed, only its tag is updated.
+ */
+esp_err_t app_file_index_add(app_file_index_t *index, const char *name, uint8_t tag);
+
+/**
+ * @brief Find names starting with prefix (case-insensitive)
+ *
+ * @param first Index of the first matching entry
+ * @return Number of matching entries, they follow the first one (an empty prefix matches all)
+ */
+size_t app_file_index_find(const app_file_index_t *index, const char *prefix, size_t *first);
+
+/**
+ * @brief Name of the entry i, in sorted order
+ */
+static inline const char *app_file_index_name(const app_file_index_t *index, size_t i)
+{
+    return index->pool + index->entries[i].name;
+}
+
+/**
+ * @brief Tag of the entry i
+ */
+static inline uint8_t app_file_index_tag(const app_file_index_t *index, size_t i)
+{
+    return index->entries[i].tag;
+}
+
+/**
+ * @brief Allocated memory (entries and names), in bytes
+ */
+size_t app_file_index_memory(const app_file_index_t *index);
+
+#ifdef __cplusplus
+}
+#endif
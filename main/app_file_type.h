@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File types recognized by the file browser (by filename extension)
+ */
+typedef enum {
+    APP_FILE_TYPE_UNKNOWN,
+    APP_FILE_TYPE_TXT,
+    APP_FILE_TYPE_JPG,
+    APP_FILE_TYPE_BMP,
+    APP_FILE_TYPE_QOI,
+    APP_FILE_TYPE_PNG,
+    APP_FILE_TYPE_WAV,
+    APP_FILE_TYPE_AVI,
+    APP_FILE_TYPE_RGBZ,         /*!< Pre-decoded RGB565 + LZ4 image (tools/mkrgbz.py) */
+} app_file_type_t;
+
+#ifdef __cplusplus
+}
+#endif
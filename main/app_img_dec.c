@@ -0,0 +1,583 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "app_mem.h"
+#include "jpeg_decoder.h"
+#include "app_jpeg_par.h"
+#include "app_color.h"
+#include "app_img_dec.h"
+
+/* Input chunk size of the streaming decoders */
+#define IMG_READ_CHUNK      (512)
+
+/* BMP compression methods */
+#define BMP_BI_RGB          (0)
+#define BMP_BI_BITFIELDS    (3)
+
+static const char *TAG = "IMG_DEC";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    FILE *file;
+    size_t pos;
+    size_t len;
+    uint8_t buf[IMG_READ_CHUNK];
+} img_reader_t;
+
+typedef struct {
+    FILE *file;
+    uint32_t data_offset;
+    uint32_t stride;                /*!< Bytes per row incl. padding to 4 bytes */
+    uint16_t width;
+    uint16_t height;
+    uint16_t bpp;
+    bool bottom_up;
+    bool rgb555;                    /*!< 16bit: RGB555 instead of RGB565 */
+    uint16_t y;                     /*!< Next row to decode */
+    uint8_t *line;
+    uint16_t palette[256];          /*!< RGB565 palette for 1/4/8bit images */
+} bmp_ctx_t;
+
+typedef struct {
+    uint8_t r, g, b, a;
+} qoi_px_t;
+
+typedef struct {
+    img_reader_t reader;
+    uint16_t width;
+    uint16_t height;
+    qoi_px_t px;
+    qoi_px_t index[64];
+    uint32_t run;
+} qoi_ctx_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+static const app_img_decoder_t *decoders[APP_IMG_DEC_MAX] = {
+    &app_img_dec_jpg,
+    &app_img_dec_bmp,
+    &app_img_dec_qoi,
+    &app_img_dec_png,
+    &app_img_dec_rgbz,
+};
+static size_t decoders_count = 5;
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+static const app_img_decoder_t *img_dec_find(app_file_type_t type)
+{
+    for (size_t i = 0; i < decoders_count; i++) {
+        if (decoders[i]->type == type) {
+            return decoders[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t app_img_dec_register(const app_img_decoder_t *decoder)
+{
+    assert(decoder != NULL);
+    assert(decoder->decode || (decoder->open && decoder->read_row && decoder->close));
+
+    if (decoders_count >= APP_IMG_DEC_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    decoders[decoders_count++] = decoder;
+    return ESP_OK;
+}
+
+esp_err_t app_img_dec_decode(app_file_type_t type, FILE *file, app_img_out_t *out)
+{
+    assert(file != NULL && out != NULL && out->buf != NULL);
+
+    const app_img_decoder_t *decoder = img_dec_find(type);
+    if (decoder == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    ESP_LOGI(TAG, "Decoding %s image...", decoder->name);
+
+    out->width = 0;
+    out->height = 0;
+    if (decoder->decode) {
+        return decoder->decode(file, out);
+    }
+
+    void *ctx = NULL;
+    uint16_t width, height;
+    esp_err_t ret = decoder->open(file, &ctx, &width, &height);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* Scale down or crop to the output size */
+    uint16_t out_width = width < out->max_width ? width : out->max_width;
+    uint16_t out_height = height < out->max_height ? height : out->max_height;
+    bool scale = out->fit && (width > out->max_width || height > out->max_height);
+    if (scale) {
+        if ((uint32_t)width * out->max_height > (uint32_t)height * out->max_width) {
+            out_width = out->max_width;
+            out_height = (uint32_t)height * out->max_width / width;
+        } else {
+            out_width = (uint32_t)width * out->max_height / height;
+            out_height = out->max_height;
+        }
+        out_width = out_width ? out_width : 1;
+        out_height = out_height ? out_height : 1;
+    }
+    if ((size_t)out_width * out_height * sizeof(uint16_t) > out->buf_size) {
+        out_height = out->buf_size / (out_width * sizeof(uint16_t));
+    }
+
+    /* Wider or scaled rows are decoded into a temporary row first */
+    uint16_t *row = NULL;
+    if (out_width != width || scale) {
+        row = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, width * sizeof(uint16_t));
+        if (row == NULL) {
+            decoder->close(ctx);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    uint32_t src_y = 0;
+    for (uint16_t y = 0; y < out_height && ret == ESP_OK; y++) {
+        uint16_t *dst = (uint16_t *)out->buf + (size_t)y * out_width;
+        if (scale) {
+            /* Rows between the sampled ones are decoded and dropped */
+            uint32_t sample_y = (uint64_t)y * height / out_height;
+            for (; src_y <= sample_y && ret == ESP_OK; src_y++) {
+                ret = decoder->read_row(ctx, row);
+            }
+            app_color_scale_nearest_rgb565(row, width, 1, dst, out_width, 1);
+        } else if (row) {
+            ret = decoder->read_row(ctx, row);
+            memcpy(dst, row, out_width * sizeof(uint16_t));
+        } else {
+            ret = decoder->read_row(ctx, dst);
+        }
+        if (out->swap_bytes) {
+            app_color_swap_rgb565(dst, out_width);
+        }
+    }
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, row);
+    decoder->close(ctx);
+
+    if (ret == ESP_OK) {
+        out->width = out_width;
+        out->height = out_height;
+    }
+
+    return ret;
+}
+
+esp_err_t app_img_dec_decode_mem(app_file_type_t type, const uint8_t *data, size_t size, app_img_out_t *out)
+{
+    assert(data != NULL && out != NULL && out->buf != NULL);
+
+    const app_img_decoder_t *decoder = img_dec_find(type);
+    if (decoder == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (decoder->decode_mem) {
+        ESP_LOGI(TAG, "Decoding %s image from memory...", decoder->name);
+        out->width = 0;
+        out->height = 0;
+        return decoder->decode_mem(data, size, out);
+    }
+
+    FILE *file = fmemopen((void *)data, size, "rb");
+    if (file == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = app_img_dec_decode(type, file, out);
+    fclose(file);
+
+    return ret;
+}
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint16_t rd16le(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rd32be(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline int reader_byte(img_reader_t *reader)
+{
+    if (reader->pos >= reader->len) {
+        reader->len = fread(reader->buf, 1, sizeof(reader->buf), reader->file);
+        reader->pos = 0;
+        if (reader->len == 0) {
+            return -1;
+        }
+    }
+
+    return reader->buf[reader->pos++];
+}
+
+/* ---------------------------- JPEG ----------------------------------------- */
+
+static esp_err_t jpg_decode_mem(const uint8_t *data, size_t size, app_img_out_t *out)
+{
+#if CONFIG_APP_JPEG_PARALLEL
+    /* Images with restart markers are decoded by stripes on both cores */
+    esp_err_t par_ret = app_jpeg_par_decode(data, size, out);
+    if (par_ret != ESP_ERR_NOT_SUPPORTED) {
+        return par_ret;
+    }
+#endif
+
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)data,
+        .indata_size = size,
+        .outbuf = out->buf,
+        .outbuf_size = out->buf_size,
+        .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+        .flags = {
+            .swap_color_bytes = out->swap_bytes,
+        }
+    };
+    esp_jpeg_image_output_t outimg;
+
+    esp_err_t ret = esp_jpeg_decode(&jpeg_cfg, &outimg);
+    if (ret == ESP_OK) {
+        out->width = outimg.width;
+        out->height = outimg.height;
+    }
+    return ret;
+}
+
+static esp_err_t jpg_decode(FILE *file, app_img_out_t *out)
+{
+    /* esp_jpeg needs whole input data at once */
+    fseek(file, 0, SEEK_END);
+    long filesize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (filesize <= 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *indata = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, filesize);
+    if (indata == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_ERR_INVALID_SIZE;
+    if (fread(indata, 1, filesize, file) == (size_t)filesize) {
+        ret = jpg_decode_mem(indata, filesize, out);
+    }
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, indata);
+    return ret;
+}
+
+const app_img_decoder_t app_img_dec_jpg = {
+    .name = "JPEG",
+    .type = APP_FILE_TYPE_JPG,
+    .decode = jpg_decode,
+    .decode_mem = jpg_decode_mem,
+};
+
+/* ---------------------------- BMP ------------------------------------------ */
+
+static void bmp_close(void *ctx)
+{
+    bmp_ctx_t *bmp = ctx;
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, bmp->line);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, bmp);
+}
+
+static esp_err_t bmp_open(FILE *file, void **ctx, uint16_t *width, uint16_t *height)
+{
+    uint8_t hdr[66];
+
+    if (fread(hdr, 1, 54, file) != 54 || hdr[0] != 'B' || hdr[1] != 'M') {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t data_offset = rd32le(&hdr[10]);
+    uint32_t dib_size = rd32le(&hdr[14]);
+    int32_t w = (int32_t)rd32le(&hdr[18]);
+    int32_t h = (int32_t)rd32le(&hdr[22]);
+    uint16_t bpp = rd16le(&hdr[28]);
+    uint32_t compression = rd32le(&hdr[30]);
+    uint32_t colors_used = rd32le(&hdr[46]);
+
+    /* Negative height means top-down image, INT32_MIN is rejected by the range check before negating */
+    if (dib_size < 40 || w <= 0 || h == 0 || w > UINT16_MAX || h < -UINT16_MAX || h > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(compression == BMP_BI_RGB || (compression == BMP_BI_BITFIELDS && (bpp == 16 || bpp == 32)))) {
+        ESP_LOGW(TAG, "BMP compression %" PRIu32 " not supported", compression);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    bmp_ctx_t *bmp = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(bmp_ctx_t));
+    if (bmp == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    bmp->file = file;
+    bmp->data_offset = data_offset;
+    bmp->width = w;
+    bmp->height = (h > 0) ? h : -h;
+    bmp->bottom_up = (h > 0);
+    bmp->bpp = bpp;
+    bmp->stride = (((uint32_t)w * bpp + 31) / 32) * 4;
+    /* 16bit default is RGB555, bit masks (after the 40 bytes header or inside V4/V5 header) may select RGB565 */
+    bmp->rgb555 = true;
+    if (compression == BMP_BI_BITFIELDS) {
+        if (fread(&hdr[54], 1, 12, file) != 12) {
+            bmp_close(bmp);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        /* Only the standard layouts are decoded, the rows are not unpacked by the masks */
+        uint32_t r_mask = rd32le(&hdr[54]);
+        uint32_t g_mask = rd32le(&hdr[58]);
+        uint32_t b_mask = rd32le(&hdr[62]);
+        bool supported;
+        if (bpp == 16) {
+            bmp->rgb555 = (r_mask == 0x7C00);
+            supported = (b_mask == 0x001F) &&
+                        ((r_mask == 0x7C00 && g_mask == 0x03E0) || (r_mask == 0xF800 && g_mask == 0x07E0));
+        } else {
+            supported = (r_mask == 0x00FF0000 && g_mask == 0x0000FF00 && b_mask == 0x000000FF);
+        }
+        if (!supported) {
+            ESP_LOGW(TAG, "BMP bit masks %08" PRIX32 "/%08" PRIX32 "/%08" PRIX32 " not supported", r_mask, g_mask, b_mask);
+            bmp_close(bmp);
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    /* Palette (BGRx) */
+    if (bpp <= 8) {
+        uint32_t count = (colors_used && colors_used <= 256) ? colors_used : (1U << bpp);
+        fseek(file, 14 + dib_size, SEEK_SET);
+        for (uint32_t i = 0; i < count; i++) {
+            uint8_t bgrx[4];
+            if (fread(bgrx, 1, 4, file) != 4) {
+                bmp_close(bmp);
+                return ESP_ERR_INVALID_SIZE;
+            }
+            bmp->palette[i] = app_color_rgb565(bgrx[2], bgrx[1], bgrx[0]);
+        }
+    }
+
+    /* All rows within the file, so the row offsets cannot overflow */
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    if (file_size < 0 || (uint64_t)data_offset + (uint64_t)bmp->stride * bmp->height > (uint64_t)file_size) {
+        ESP_LOGW(TAG, "BMP %" PRIu16 "x%" PRIu16 " pixel data beyond the end of the file", bmp->width, bmp->height);
+        bmp_close(bmp);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    bmp->line = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, bmp->stride);
+    if (bmp->line == NULL) {
+        bmp_close(bmp);
+        return ESP_ERR_NO_MEM;
+    }
+
+    *width = bmp->width;
+    *height = bmp->height;
+    *ctx = bmp;
+
+    return ESP_OK;
+}
+
+static esp_err_t bmp_read_row(void *ctx, uint16_t *row)
+{
+    bmp_ctx_t *bmp = ctx;
+
+    if (bmp->y >= bmp->height) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* Bottom-up images are read backwards */
+    uint32_t line = bmp->bottom_up ? (bmp->height - 1 - bmp->y) : bmp->y;
+    bmp->y++;
+    /* Bounded by the file size in bmp_open() */
+    if (fseek(bmp->file, bmp->data_offset + line * bmp->stride, SEEK_SET) != 0 ||
+            fread(bmp->line, 1, bmp->stride, bmp->file) != bmp->stride) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    const uint8_t *src = bmp->line;
+    switch (bmp->bpp) {
+    case 1:
+    case 4:
+    case 8: {
+        uint8_t mask = (1 << bmp->bpp) - 1;
+        for (uint16_t x = 0; x < bmp->width; x++) {
+            uint32_t bit = (uint32_t)x * bmp->bpp;
+            uint8_t idx = (src[bit / 8] >> (8 - bmp->bpp - (bit % 8))) & mask;
+            row[x] = bmp->palette[idx];
+        }
+        break;
+    }
+    case 16:
+        for (uint16_t x = 0; x < bmp->width; x++) {
+            uint16_t px = rd16le(&src[2 * x]);
+            /* RGB555 -> RGB565: shift red and green, replicate green MSB */
+            row[x] = bmp->rgb555 ? (uint16_t)(((px & 0x7FE0) << 1) | ((px >> 4) & 0x20) | (px & 0x1F)) : px;
+        }
+        break;
+    case 24:
+        for (uint16_t x = 0; x < bmp->width; x++, src += 3) {
+            row[x] = app_color_rgb565(src[2], src[1], src[0]);
+        }
+        break;
+    case 32:
+        for (uint16_t x = 0; x < bmp->width; x++, src += 4) {
+            row[x] = app_color_rgb565(src[2], src[1], src[0]);
+        }
+        break;
+    }
+
+    return ESP_OK;
+}
+
+const app_img_decoder_t app_img_dec_bmp = {
+    .name = "BMP",
+    .type = APP_FILE_TYPE_BMP,
+    .open = bmp_open,
+    .read_row = bmp_read_row,
+    .close = bmp_close,
+};
+
+/* ---------------------------- QOI ------------------------------------------ */
+
+static esp_err_t qoi_open(FILE *file, void **ctx, uint16_t *width, uint16_t *height)
+{
+    uint8_t hdr[14];
+
+    if (fread(hdr, 1, sizeof(hdr), file) != sizeof(hdr) || memcmp(hdr, "qoif", 4) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t w = rd32be(&hdr[4]);
+    uint32_t h = rd32be(&hdr[8]);
+    if (w == 0 || h == 0 || w > UINT16_MAX || h > UINT16_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    qoi_ctx_t *qoi = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(qoi_ctx_t));
+    if (qoi == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    qoi->reader.file = file;
+    qoi->width = w;
+    qoi->height = h;
+    qoi->px.a = 255;
+
+    *width = w;
+    *height = h;
+    *ctx = qoi;
+
+    return ESP_OK;
+}
+
+static esp_err_t qoi_read_row(void *ctx, uint16_t *row)
+{
+    qoi_ctx_t *qoi = ctx;
+    img_reader_t *rd = &qoi->reader;
+    qoi_px_t px = qoi->px;
+
+    for (uint16_t x = 0; x < qoi->width; x++) {
+        if (qoi->run > 0) {
+            qoi->run--;
+        } else {
+            int b1 = reader_byte(rd);
+            if (b1 < 0) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+
+            /* A truncated op aborts the decoding instead of producing garbage pixels */
+            if (b1 == 0xFE || b1 == 0xFF) {     /* QOI_OP_RGB, QOI_OP_RGBA */
+                int r = reader_byte(rd);
+                int g = reader_byte(rd);
+                int b = reader_byte(rd);
+                int a = (b1 == 0xFF) ? reader_byte(rd) : px.a;
+                if (r < 0 || g < 0 || b < 0 || a < 0) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                px.r = r;
+                px.g = g;
+                px.b = b;
+                px.a = a;
+            } else if ((b1 & 0xC0) == 0x00) {   /* QOI_OP_INDEX */
+                px = qoi->index[b1];
+            } else if ((b1 & 0xC0) == 0x40) {   /* QOI_OP_DIFF */
+                px.r += ((b1 >> 4) & 0x03) - 2;
+                px.g += ((b1 >> 2) & 0x03) - 2;
+                px.b += (b1 & 0x03) - 2;
+            } else if ((b1 & 0xC0) == 0x80) {   /* QOI_OP_LUMA */
+                int b2 = reader_byte(rd);
+                if (b2 < 0) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                int vg = (b1 & 0x3F) - 32;
+                px.r += vg - 8 + ((b2 >> 4) & 0x0F);
+                px.g += vg;
+                px.b += vg - 8 + (b2 & 0x0F);
+            } else {                    /* QOI_OP_RUN */
+                qoi->run = (b1 & 0x3F);
+            }
+
+            qoi->index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+        }
+
+        row[x] = app_color_rgb565(px.r, px.g, px.b);
+    }
+
+    qoi->px = px;
+    return ESP_OK;
+}
+
+static void qoi_close(void *ctx)
+{
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, ctx);
+}
+
+const app_img_decoder_t app_img_dec_qoi = {
+    .name = "QOI",
+    .type = APP_FILE_TYPE_QOI,
+    .open = qoi_open,
+    .read_row = qoi_read_row,
+    .close = qoi_close,
+};
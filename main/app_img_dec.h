@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "app_file_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximal number of registered image decoders */
+#define APP_IMG_DEC_MAX     (8)
+
+/**
+ * @brief Output of the image decoding (RGB565)
+ */
+typedef struct {
+    uint8_t *buf;               /*!< Output buffer, rows are stored without padding */
+    size_t buf_size;            /*!< Output buffer size in bytes */
+    uint16_t max_width;         /*!< Wider images are cropped */
+    uint16_t max_height;        /*!< Higher images are cropped */
+    bool fit;                   /*!< Downscale larger images to max_width x max_height keeping the aspect ratio
+                                     instead of cropping them (nearest neighbour, streaming decoders only) */
+    bool swap_bytes;            /*!< Swap RGB565 bytes (CONFIG_LV_COLOR_16_SWAP) */
+    uint16_t width;             /*!< Decoded width (filled by decoder) */
+    uint16_t height;            /*!< Decoded height (filled by decoder) */
+} app_img_out_t;
+
+/**
+ * @brief Image decoder plug-in
+ *
+ * Streaming decoders implement open/read_row/close and output one RGB565 row at a time,
+ * the file is read in small chunks. Decoders, which need the whole image at once,
+ * implement only decode. Working buffers are allocated from APP_MEM_ARENA_WINDOW.
+ */
+typedef struct {
+    const char *name;
+    app_file_type_t type;       /*!< File type handled by this decoder */
+
+    esp_err_t (*open)(FILE *file, void **ctx, uint16_t *width, uint16_t *height);
+    /**
+     * @brief Decode next row (from top to bottom) of width RGB565 pixels (not swapped)
+     */
+    esp_err_t (*read_row)(void *ctx, uint16_t *row);
+    void (*close)(void *ctx);
+
+    esp_err_t (*decode)(FILE *file, app_img_out_t *out);
+    /**
+     * @brief Optional: decode image already in memory (e.g. memory-mapped asset) without copying it
+     */
+    esp_err_t (*decode_mem)(const uint8_t *data, size_t size, app_img_out_t *out);
+} app_img_decoder_t;
+
+/**
+ * @brief Register image decoder, the built-in decoders are always available
+ */
+esp_err_t app_img_dec_register(const app_img_decoder_t *decoder);
+
+/**
+ * @brief Decode image file into out->buf by the decoder registered for the file type
+ */
+esp_err_t app_img_dec_decode(app_file_type_t type, FILE *file, app_img_out_t *out);
+
+/**
+ * @brief Decode image in memory into out->buf
+ *
+ * Decoders without decode_mem read the data through a memory stream.
+ */
+esp_err_t app_img_dec_decode_mem(app_file_type_t type, const uint8_t *data, size_t size, app_img_out_t *out);
+
+/* Built-in decoders */
+extern const app_img_decoder_t app_img_dec_jpg;
+extern const app_img_decoder_t app_img_dec_bmp;
+extern const app_img_decoder_t app_img_dec_qoi;
+extern const app_img_decoder_t app_img_dec_png;
+extern const app_img_decoder_t app_img_dec_rgbz;
+
+#ifdef __cplusplus
+}
+#endif
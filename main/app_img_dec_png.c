@@ -0,0 +1,461 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "rom/miniz.h"
+#include "app_mem.h"
+#include "app_color.h"
+#include "app_img_dec.h"
+
+/* Compressed input chunk size, IDAT data is read in pieces of this size */
+#define PNG_READ_CHUNK      (1024)
+/* Inflate output window, tinfl needs the whole LZ dictionary size for wrapping output */
+#define PNG_DICT_SIZE       (TINFL_LZ_DICT_SIZE)
+
+#define PNG_COLOR_GRAY      (0)
+#define PNG_COLOR_RGB       (2)
+#define PNG_COLOR_PALETTE   (3)
+#define PNG_COLOR_GRAY_A    (4)
+#define PNG_COLOR_RGBA      (6)
+
+static const char *TAG = "IMG_PNG";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    FILE *file;
+    uint32_t idat_left;             /*!< Bytes left in current IDAT chunk */
+    bool idat_done;                 /*!< All IDAT chunks were read */
+    bool inflate_done;
+    uint8_t *in;
+    size_t in_pos;
+    size_t in_len;
+    tinfl_decompressor *inflator;
+    uint8_t *dict;                  /*!< Wrapping inflate output */
+    size_t dict_pos;                /*!< Next inflate output position */
+    size_t read_pos;                /*!< Next byte to consume */
+    size_t avail;                   /*!< Inflated bytes not consumed yet */
+    uint16_t width;
+    uint16_t height;
+    uint8_t bit_depth;
+    uint8_t color_type;
+    uint8_t filter_bpp;             /*!< Bytes per complete pixel for filtering (min. 1) */
+    size_t line_bytes;              /*!< Scanline length without filter byte */
+    uint8_t *prev;
+    uint8_t *cur;
+    uint16_t palette[256];          /*!< Blended over black by the tRNS alpha */
+    uint8_t plte[256][4];           /*!< PLTE colors and tRNS alpha (RGBA) */
+    bool has_key;                   /*!< tRNS of gray and RGB: pixels of this value are transparent */
+    uint16_t key[3];
+} png_ctx_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint32_t rd32be(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void png_close(void *ctx)
+{
+    png_ctx_t *png = ctx;
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png->cur);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png->prev);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png->dict);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png->inflator);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png->in);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, png);
+}
+
+/* Read next piece of the compressed stream, IDAT chunks may follow each other */
+static esp_err_t png_fill_input(png_ctx_t *png)
+{
+    uint8_t hdr[12];
+
+    png->in_pos = 0;
+    png->in_len = 0;
+
+    while (png->idat_left == 0) {
+        /* CRC of the previous chunk + next chunk length and type */
+        if (fread(hdr, 1, sizeof(hdr), png->file) != sizeof(hdr)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        if (memcmp(&hdr[8], "IDAT", 4) != 0) {
+            png->idat_done = true;
+            return ESP_OK;
+        }
+        png->idat_left = rd32be(&hdr[4]);
+    }
+
+    size_t len = png->idat_left < PNG_READ_CHUNK ? png->idat_left : PNG_READ_CHUNK;
+    png->in_len = fread(png->in, 1, len, png->file);
+    png->idat_left -= png->in_len;
+
+    return (png->in_len == len) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+/* Get len bytes of the inflated stream */
+static esp_err_t png_inflate(png_ctx_t *png, uint8_t *dst, size_t len)
+{
+    while (len > 0) {
+        if (png->avail > 0) {
+            size_t n = len;
+            if (n > png->avail) {
+                n = png->avail;
+            }
+            if (n > PNG_DICT_SIZE - png->read_pos) {
+                n = PNG_DICT_SIZE - png->read_pos;
+            }
+            memcpy(dst, &png->dict[png->read_pos], n);
+            dst += n;
+            len -= n;
+            png->avail -= n;
+            png->read_pos = (png->read_pos + n) & (PNG_DICT_SIZE - 1);
+            continue;
+        }
+
+        if (png->inflate_done) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        if (png->in_pos >= png->in_len && !png->idat_done) {
+            esp_err_t ret = png_fill_input(png);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        }
+
+        /* All consumed, so the decompressor may fill the window up to its end */
+        size_t in_bytes = png->in_len - png->in_pos;
+        size_t out_bytes = PNG_DICT_SIZE - png->dict_pos;
+        mz_uint32 flags = TINFL_FLAG_PARSE_ZLIB_HEADER | (png->idat_done ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+        tinfl_status status = tinfl_decompress(png->inflator, &png->in[png->in_pos], &in_bytes,
+                                               png->dict, &png->dict[png->dict_pos], &out_bytes, flags);
+        png->in_pos += in_bytes;
+        png->avail += out_bytes;
+        png->dict_pos = (png->dict_pos + out_bytes) & (PNG_DICT_SIZE - 1);
+
+        if (status == TINFL_STATUS_DONE) {
+            png->inflate_done = true;
+        } else if (status < 0) {
+            ESP_LOGW(TAG, "Inflate error %d", status);
+            return ESP_FAIL;
+        } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && png->idat_done && png->in_pos >= png->in_len) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t png_open(FILE *file, void **ctx, uint16_t *width, uint16_t *height)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    uint8_t buf[16];
+
+    if (fread(buf, 1, 8, file) != 8 || memcmp(buf, signature, 8) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    png_ctx_t *png = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(png_ctx_t));
+    if (png == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    png->file = file;
+
+    /* Walk chunks up to the first IDAT */
+    esp_err_t ret = ESP_ERR_INVALID_ARG;
+    uint8_t interlace = 0;
+    for (int i = 0; i < 256; i++) {
+        png->plte[i][3] = 0xFF;
+    }
+    while (fread(buf, 1, 8, file) == 8) {
+        uint32_t len = rd32be(buf);
+
+        if (memcmp(&buf[4], "IHDR", 4) == 0 && len == 13) {
+            if (fread(buf, 1, 13, file) != 13) {
+                break;
+            }
+            uint32_t w = rd32be(&buf[0]);
+            uint32_t h = rd32be(&buf[4]);
+            if (w == 0 || h == 0 || w > UINT16_MAX || h > UINT16_MAX) {
+                break;
+            }
+            png->width = w;
+            png->height = h;
+            png->bit_depth = buf[8];
+            png->color_type = buf[9];
+            interlace = buf[12];
+            fseek(file, 4, SEEK_CUR);
+        } else if (memcmp(&buf[4], "PLTE", 4) == 0) {
+            for (uint32_t i = 0; i < len / 3; i++) {
+                uint8_t rgb[3];
+                if (fread(rgb, 1, 3, file) != 3) {
+                    break;
+                }
+                if (i < 256) {
+                    memcpy(png->plte[i], rgb, 3);
+                }
+            }
+            fseek(file, (len % 3) + 4, SEEK_CUR);
+        } else if (memcmp(&buf[4], "tRNS", 4) == 0) {
+            /* Alpha of the palette entries, or the transparent gray or RGB value (16bit samples) */
+            uint8_t trns[6];
+            uint32_t n = 0;
+            if (png->color_type == PNG_COLOR_PALETTE) {
+                for (; n < len && n < 256; n++) {
+                    if (fread(&png->plte[n][3], 1, 1, file) != 1) {
+                        break;
+                    }
+                }
+            } else if ((png->color_type == PNG_COLOR_GRAY && len == 2) || (png->color_type == PNG_COLOR_RGB && len == 6)) {
+                if (fread(trns, 1, len, file) != len) {
+                    break;
+                }
+                for (n = 0; n < len / 2; n++) {
+                    png->key[n] = ((uint16_t)trns[2 * n] << 8) | trns[2 * n + 1];
+                }
+                n = len;
+                png->has_key = true;
+            }
+            fseek(file, len - n + 4, SEEK_CUR);
+        } else if (memcmp(&buf[4], "IDAT", 4) == 0) {
+            png->idat_left = len;
+            ret = ESP_OK;
+            break;
+        } else {
+            fseek(file, len + 4, SEEK_CUR);
+        }
+    }
+
+    if (ret != ESP_OK || png->width == 0) {
+        png_close(png);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t channels;
+    switch (png->color_type) {
+    case PNG_COLOR_GRAY:
+    case PNG_COLOR_PALETTE:
+        channels = 1;
+        break;
+    case PNG_COLOR_GRAY_A:
+        channels = 2;
+        break;
+    case PNG_COLOR_RGB:
+        channels = 3;
+        break;
+    case PNG_COLOR_RGBA:
+        channels = 4;
+        break;
+    default:
+        channels = 0;
+    }
+    bool depth_ok = (png->bit_depth == 8) ||
+                    (png->bit_depth == 16 && png->color_type != PNG_COLOR_PALETTE) ||
+                    (png->bit_depth < 8 && (png->color_type == PNG_COLOR_GRAY || png->color_type == PNG_COLOR_PALETTE) &&
+                     (png->bit_depth == 1 || png->bit_depth == 2 || png->bit_depth == 4));
+    if (channels == 0 || !depth_ok || interlace != 0) {
+        ESP_LOGW(TAG, "Not supported: color type %d, bit depth %d, interlace %d", png->color_type, png->bit_depth, interlace);
+        png_close(png);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    uint32_t bits_per_pixel = (uint32_t)channels * png->bit_depth;
+    png->line_bytes = ((uint32_t)png->width * bits_per_pixel + 7) / 8;
+    png->filter_bpp = bits_per_pixel < 8 ? 1 : bits_per_pixel / 8;
+
+    png->in = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, PNG_READ_CHUNK);
+    png->inflator = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(tinfl_decompressor));
+    png->dict = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, PNG_DICT_SIZE);
+    png->prev = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, png->line_bytes);
+    png->cur = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, png->line_bytes);
+    if (!png->in || !png->inflator || !png->dict || !png->prev || !png->cur) {
+        png_close(png);
+        return ESP_ERR_NO_MEM;
+    }
+    tinfl_init(png->inflator);
+
+    /* Transparent palette entries over black, like the other alpha */
+    if (png->color_type == PNG_COLOR_PALETTE) {
+        for (int i = 0; i < 256; i++) {
+            png->palette[i] = 0;
+            app_color_blend_rgba8888_to_rgb565(png->plte[i], &png->palette[i], 1);
+        }
+    }
+
+    *width = png->width;
+    *height = png->height;
+    *ctx = png;
+
+    return ESP_OK;
+}
+
+static inline uint8_t paeth(uint8_t a, uint8_t b, uint8_t c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return (pb <= pc) ? b : c;
+}
+
+static esp_err_t png_unfilter(png_ctx_t *png, uint8_t filter)
+{
+    uint8_t *cur = png->cur;
+    const uint8_t *prev = png->prev;
+    size_t bpp = png->filter_bpp;
+    size_t len = png->line_bytes;
+
+    switch (filter) {
+    case 0:
+        break;
+    case 1:
+        for (size_t i = bpp; i < len; i++) {
+            cur[i] += cur[i - bpp];
+        }
+        break;
+    case 2:
+        for (size_t i = 0; i < len; i++) {
+            cur[i] += prev[i];
+        }
+        break;
+    case 3:
+        for (size_t i = 0; i < len; i++) {
+            cur[i] += ((i >= bpp ? cur[i - bpp] : 0) + prev[i]) >> 1;
+        }
+        break;
+    case 4:
+        for (size_t i = 0; i < len; i++) {
+            cur[i] += (i >= bpp) ? paeth(cur[i - bpp], prev[i], prev[i - bpp]) : prev[i];
+        }
+        break;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+/* Sample with bit depth below 8 */
+static inline uint8_t png_packed_sample(const uint8_t *line, uint32_t idx, uint8_t depth)
+{
+    uint32_t bit = idx * depth;
+    return (line[bit / 8] >> (8 - depth - (bit % 8))) & ((1 << depth) - 1);
+}
+
+/* Sample of 8 or 16 bits (big-endian) */
+static inline uint16_t png_sample(const uint8_t *src, size_t step)
+{
+    return (step == 2) ? (((uint16_t)src[0] << 8) | src[1]) : src[0];
+}
+
+static esp_err_t png_read_row(void *ctx, uint16_t *row)
+{
+    png_ctx_t *png = ctx;
+    uint8_t filter;
+
+    esp_err_t ret = png_inflate(png, &filter, 1);
+    if (ret == ESP_OK) {
+        ret = png_inflate(png, png->cur, png->line_bytes);
+    }
+    if (ret == ESP_OK) {
+        ret = png_unfilter(png, filter);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* Transparent pixels are blended over black, the background of the viewer */
+    const uint8_t *src = png->cur;
+    /* 16bit samples: use the most significant byte only */
+    size_t step = (png->bit_depth == 16) ? 2 : 1;
+    switch (png->color_type) {
+    case PNG_COLOR_RGB:
+        if (step == 1) {
+            app_color_rgb888_to_rgb565(src, row, png->width);
+        } else {
+            for (uint16_t x = 0; x < png->width; x++) {
+                row[x] = app_color_rgb565(src[6 * x], src[6 * x + 2], src[6 * x + 4]);
+            }
+        }
+        if (png->has_key) {
+            for (uint16_t x = 0; x < png->width; x++, src += 3 * step) {
+                if (png_sample(src, step) == png->key[0] && png_sample(&src[step], step) == png->key[1] &&
+                        png_sample(&src[2 * step], step) == png->key[2]) {
+                    row[x] = 0;
+                }
+            }
+        }
+        break;
+    case PNG_COLOR_RGBA:
+        memset(row, 0, png->width * sizeof(uint16_t));
+        if (step == 1) {
+            app_color_blend_rgba8888_to_rgb565(src, row, png->width);
+        } else {
+            for (uint16_t x = 0; x < png->width; x++, src += 8) {
+                const uint8_t rgba[4] = { src[0], src[2], src[4], src[6] };
+                app_color_blend_rgba8888_to_rgb565(rgba, &row[x], 1);
+            }
+        }
+        break;
+    case PNG_COLOR_GRAY_A:
+        memset(row, 0, png->width * sizeof(uint16_t));
+        for (uint16_t x = 0; x < png->width; x++, src += 2 * step) {
+            const uint8_t rgba[4] = { src[0], src[0], src[0], src[step] };
+            app_color_blend_rgba8888_to_rgb565(rgba, &row[x], 1);
+        }
+        break;
+    case PNG_COLOR_GRAY:
+        if (png->bit_depth >= 8) {
+            for (uint16_t x = 0; x < png->width; x++, src += step) {
+                bool transparent = png->has_key && png_sample(src, step) == png->key[0];
+                row[x] = transparent ? 0 : app_color_rgb565(src[0], src[0], src[0]);
+            }
+        } else {
+            uint8_t max = (1 << png->bit_depth) - 1;
+            for (uint16_t x = 0; x < png->width; x++) {
+                uint8_t sample = png_packed_sample(src, x, png->bit_depth);
+                uint8_t v = sample * 255 / max;
+                row[x] = (png->has_key && sample == png->key[0]) ? 0 : app_color_rgb565(v, v, v);
+            }
+        }
+        break;
+    case PNG_COLOR_PALETTE:
+        for (uint16_t x = 0; x < png->width; x++) {
+            uint8_t idx = (png->bit_depth == 8) ? src[x] : png_packed_sample(src, x, png->bit_depth);
+            row[x] = png->palette[idx];
+        }
+        break;
+    }
+
+    /* Current line is the previous one for the next row */
+    uint8_t *tmp = png->prev;
+    png->prev = png->cur;
+    png->cur = tmp;
+
+    return ESP_OK;
+}
+
+const app_img_decoder_t app_img_dec_png = {
+    .name = "PNG",
+    .type = APP_FILE_TYPE_PNG,
+    .open = png_open,
+    .read_row = png_read_row,
+    .close = png_close,
+};
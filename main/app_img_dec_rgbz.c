@@ -0,0 +1,326 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Pre-decoded image (*.rgbz), made by tools/mkrgbz.py (little endian):
+ *
+ * header (16 B) | uint32 band_size[bands] | LZ4 blocks
+ *
+ * The image is stored as RGB565 at the display resolution, split into bands of band_rows rows.
+ * Each band is one independent LZ4 block, so it can be decompressed straight into the output.
+ */
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "app_mem.h"
+#include "app_color.h"
+#include "app_img_dec.h"
+
+#define RGBZ_MAGIC          "RGBZ"
+#define RGBZ_VERSION        (1)
+#define RGBZ_HEADER_SIZE    (16)
+/* Pixels are stored byte-swapped (CONFIG_LV_COLOR_16_SWAP) */
+#define RGBZ_FLAG_SWAPPED   (1 << 0)
+
+/* LZ4 block format constants */
+#define LZ4_MIN_MATCH       (4)
+
+static const char *TAG = "IMG_RGBZ";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    uint8_t flags;
+    uint16_t band_rows;
+    uint16_t width;
+    uint16_t height;
+    uint16_t bands;
+} rgbz_info_t;
+
+/* Source of the compressed bands */
+typedef struct {
+    FILE *file;                 /*!< Bands are read from file into buf... */
+    uint8_t *buf;
+    const uint8_t *data;        /*!< ...or taken from memory */
+    size_t data_size;
+    uint32_t offset;            /*!< Offset of the next band */
+} rgbz_src_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint16_t rd16le(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32le(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* Decompress one LZ4 block, which must produce exactly dst_len bytes */
+static esp_err_t lz4_decompress(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const iend = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *const oend = dst + dst_len;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+
+        /* Literals */
+        size_t len = token >> 4;
+        if (len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+        }
+        if (len > (size_t)(iend - ip) || len > (size_t)(oend - op)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(op, ip, len);
+        op += len;
+        ip += len;
+
+        /* The last sequence has only literals */
+        if (ip >= iend) {
+            break;
+        }
+
+        /* Match */
+        if (iend - ip < 2) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        size_t offset = rd16le(ip);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        len = token & 0x0F;
+        if (len == 15) {
+            uint8_t b;
+            do {
+                if (ip >= iend) {
+                    return ESP_ERR_INVALID_SIZE;
+                }
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+        }
+        len += LZ4_MIN_MATCH;
+        if (len > (size_t)(oend - op)) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        const uint8_t *match = op - offset;
+        if (offset >= len) {
+            memcpy(op, match, len);
+            op += len;
+        } else {
+            /* Overlapping copy repeats the last offset bytes, the repeated pattern doubles each step */
+            while (len > 0) {
+                size_t n = (size_t)(op - match) < len ? (size_t)(op - match) : len;
+                memcpy(op, match, n);
+                op += n;
+                len -= n;
+            }
+        }
+    }
+
+    return (op == oend) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+static esp_err_t rgbz_parse_header(const uint8_t *hdr, rgbz_info_t *info)
+{
+    if (memcmp(hdr, RGBZ_MAGIC, 4) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (hdr[4] != RGBZ_VERSION) {
+        ESP_LOGW(TAG, "Unsupported version %d", hdr[4]);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    info->flags = hdr[5];
+    info->band_rows = rd16le(&hdr[6]);
+    info->width = rd16le(&hdr[8]);
+    info->height = rd16le(&hdr[10]);
+    if (info->band_rows == 0 || info->width == 0 || info->height == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    info->bands = (info->height + info->band_rows - 1) / info->band_rows;
+
+    return ESP_OK;
+}
+
+/* Get next compressed band */
+static esp_err_t rgbz_src_band(rgbz_src_t *src, uint32_t size, const uint8_t **band)
+{
+    if (src->file) {
+        if (fread(src->buf, 1, size, src->file) != size) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        *band = src->buf;
+    } else {
+        if (size > src->data_size - src->offset) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        *band = src->data + src->offset;
+    }
+    src->offset += size;
+
+    return ESP_OK;
+}
+
+static esp_err_t rgbz_decode_bands(const rgbz_info_t *info, const uint8_t *sizes, rgbz_src_t *src, app_img_out_t *out)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t *tmp = NULL;
+
+    /* Crop to the output buffer */
+    uint16_t out_width = info->width < out->max_width ? info->width : out->max_width;
+    uint16_t out_height = info->height < out->max_height ? info->height : out->max_height;
+    if ((size_t)out_width * out_height * sizeof(uint16_t) > out->buf_size) {
+        out_height = out->buf_size / (out_width * sizeof(uint16_t));
+    }
+
+    /*
+     * Bands are decompressed directly into the output buffer. A temporary band is needed only
+     * if the image is cropped (made for another display).
+     */
+    const size_t band_bytes = (size_t)info->width * info->band_rows * sizeof(uint16_t);
+    if (out_width != info->width || out_height != info->height) {
+        tmp = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, band_bytes);
+        if (tmp == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    for (uint16_t i = 0; i < info->bands && ret == ESP_OK; i++) {
+        uint16_t y = i * info->band_rows;
+        if (y >= out_height) {
+            break;
+        }
+        uint16_t rows = info->height - y < info->band_rows ? info->height - y : info->band_rows;
+
+        const uint8_t *band;
+        ret = rgbz_src_band(src, rd32le(&sizes[4 * i]), &band);
+        if (ret != ESP_OK) {
+            break;
+        }
+
+        uint8_t *dst = out->buf + (size_t)y * out_width * sizeof(uint16_t);
+        if (tmp == NULL) {
+            ret = lz4_decompress(band, rd32le(&sizes[4 * i]), dst, (size_t)rows * info->width * sizeof(uint16_t));
+        } else {
+            ret = lz4_decompress(band, rd32le(&sizes[4 * i]), tmp, (size_t)rows * info->width * sizeof(uint16_t));
+            for (uint16_t r = 0; r < rows && y + r < out_height && ret == ESP_OK; r++) {
+                memcpy(dst + (size_t)r * out_width * sizeof(uint16_t), tmp + (size_t)r * info->width * sizeof(uint16_t),
+                       out_width * sizeof(uint16_t));
+            }
+        }
+    }
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, tmp);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* The swap variant is chosen at build time, convert only if it does not match */
+    if (out->swap_bytes != !!(info->flags & RGBZ_FLAG_SWAPPED)) {
+        app_color_swap_rgb565((uint16_t *)out->buf, (size_t)out_width * out_height);
+    }
+
+    out->width = out_width;
+    out->height = out_height;
+    return ESP_OK;
+}
+
+static esp_err_t rgbz_decode_mem(const uint8_t *data, size_t size, app_img_out_t *out)
+{
+    rgbz_info_t info;
+
+    if (size < RGBZ_HEADER_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t ret = rgbz_parse_header(data, &info);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint32_t data_offset = RGBZ_HEADER_SIZE + 4 * info.bands;
+    if (size < data_offset) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    rgbz_src_t src = {
+        .data = data,
+        .data_size = size,
+        .offset = data_offset,
+    };
+    return rgbz_decode_bands(&info, &data[RGBZ_HEADER_SIZE], &src, out);
+}
+
+static esp_err_t rgbz_decode(FILE *file, app_img_out_t *out)
+{
+    uint8_t hdr[RGBZ_HEADER_SIZE];
+    rgbz_info_t info;
+
+    if (fread(hdr, 1, sizeof(hdr), file) != sizeof(hdr)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t ret = rgbz_parse_header(hdr, &info);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t *sizes = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, 4 * info.bands);
+    if (sizes == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (fread(sizes, 1, 4 * info.bands, file) != 4 * info.bands) {
+        app_mem_arena_free(APP_MEM_ARENA_WINDOW, sizes);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    /* One compressed band at a time is read from the file */
+    uint32_t max_size = 0;
+    for (uint16_t i = 0; i < info.bands; i++) {
+        uint32_t band_size = rd32le(&sizes[4 * i]);
+        max_size = band_size > max_size ? band_size : max_size;
+    }
+    rgbz_src_t src = {
+        .file = file,
+        .buf = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, max_size),
+    };
+    if (src.buf == NULL) {
+        app_mem_arena_free(APP_MEM_ARENA_WINDOW, sizes);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ret = rgbz_decode_bands(&info, sizes, &src, out);
+
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, src.buf);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, sizes);
+    return ret;
+}
+
+const app_img_decoder_t app_img_dec_rgbz = {
+    .name = "RGB565/LZ4",
+    .type = APP_FILE_TYPE_RGBZ,
+    .decode = rgbz_decode,
+    .decode_mem = rgbz_decode_mem,
+};
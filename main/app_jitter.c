@@ -0,0 +1,715 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Packets are kept in slots indexed by the sequence number. The playout reads them in order
+ * from next_seq; the buffer depth is the audio between the playout position and the end of
+ * the newest received packet, so packets still on the way count as buffered.
+ *
+ *   - Playout delay (target): spread of the packet transit times (arrival minus RTP
+ *     timestamp) over the last windows of packets plus one packet. A packet delayed by the
+ *     spread is still in time, so reordering and delay bursts are covered as well. It grows
+ *     at once (also by a packet for every late one) and shrinks slowly.
+ *   - Depth control: the averaged depth is compared with the target, the difference sets
+ *     the resampling ratio (PI control, +-max_ppm). The integral part settles on the clock
+ *     drift between the sender and the audio output; it integrates only a few ms of error
+ *     and stops while the ratio is saturated, so steps of the depth leave the drift estimate
+ *     alone and are corrected by the proportional part. Depth far over the target (bursts)
+ *     is cut by dropping whole packets. When the buffer runs empty, the next packet is
+ *     awaited while concealing (up to the concealment fade-out), then the playout stops
+ *     until the buffer is refilled to the target.
+ *   - Loss concealment: the last pitch period (normalized autocorrelation of the first
+ *     channel over the played history) is repeated, at full level for 10 ms, then faded
+ *     out to silence at 60 ms. The received audio is crossfaded in after the loss.
+ *   - Resampling: 4-point Catmull-Rom interpolation between the frames of the playout.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "esp_heap_caps.h"
+#include "app_jitter.h"
+
+/* Pitch period search range, in ms / 10 */
+#define JITTER_PITCH_MIN_MS10   (25)
+#define JITTER_PITCH_MAX_MS10   (150)
+/* Sample rate the pitch is searched at first, then refined at the full rate */
+#define JITTER_PITCH_COARSE_HZ  (8000)
+/* Concealment at full level, then faded out until silence */
+#define JITTER_PLC_FULL_MS      (10)
+#define JITTER_PLC_END_MS       (60)
+/* Crossfade from the concealment to the received audio */
+#define JITTER_MERGE_MS         (5)
+/* Depth control: proportional time constant and integral time, in seconds */
+#define JITTER_CONTROL_P_S      (4)
+#define JITTER_CONTROL_I_S      (20)
+/* Largest depth error integrated into the drift estimate (ms) */
+#define JITTER_CONTROL_I_MAX_MS (3)
+/* Averaging of the depth, per read call (shift) */
+#define JITTER_DEPTH_AVG_SHIFT  (5)
+/* Transit spread windows, in packets */
+#define JITTER_SPREAD_PACKETS   (64)
+/* Target decrease per packet (shift of the difference) */
+#define JITTER_TARGET_DECAY     (7)
+/* Resampler input, pulled from the playout in chunks (frames) */
+#define JITTER_IN_CHUNK         (32)
+#define JITTER_IN_KEEP          (3)
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+struct app_jitter_slot_s {
+    uint32_t ts;
+    uint16_t seq;
+    uint16_t frames;
+    bool valid;
+};
+
+typedef struct app_jitter_slot_s jitter_slot_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline int16_t jitter_sat16(int32_t x)
+{
+    if (x > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+static inline uint32_t jitter_ms_to_frames(const app_jitter_t *jitter, uint32_t ms)
+{
+    return (uint32_t)((uint64_t)jitter->config.sample_rate * ms / 1000);
+}
+
+static inline uint32_t jitter_frames_to_ms(const app_jitter_t *jitter, uint32_t frames)
+{
+    return (uint32_t)((uint64_t)frames * 1000 / jitter->config.sample_rate);
+}
+
+static inline jitter_slot_t *jitter_slot(app_jitter_t *jitter, uint16_t seq)
+{
+    return &jitter->slot[seq & (jitter->config.slots - 1)];
+}
+
+static inline int16_t *jitter_slot_pcm(app_jitter_t *jitter, uint16_t seq)
+{
+    size_t i = seq & (jitter->config.slots - 1);
+    return jitter->pcm + i * jitter->config.max_packet_frames * jitter->config.channels;
+}
+
+/* Audio from the playout position to the end of the newest packet, with the resampler input */
+static inline int32_t jitter_depth(const app_jitter_t *jitter)
+{
+    return (int32_t)(jitter->high_end - jitter->play_ts) + (int32_t)(jitter->in_len - jitter->in_pos);
+}
+
+static void jitter_set_target(app_jitter_t *jitter, uint32_t target)
+{
+    uint32_t min = jitter_ms_to_frames(jitter, jitter->config.min_delay_ms);
+    uint32_t max = jitter_ms_to_frames(jitter, jitter->config.max_delay_ms);
+    jitter->target = target < min ? min : (target > max ? max : target);
+}
+
+/* Largest minus smallest transit of the last windows, including this packet */
+static uint32_t jitter_spread(app_jitter_t *jitter, int32_t transit)
+{
+    uint8_t cur = jitter->spread_idx;
+
+    if (jitter->spread_count == 0) {
+        jitter->spread_min[cur] = transit;
+        jitter->spread_max[cur] = transit;
+        jitter->spread_windows += jitter->spread_windows < APP_JITTER_SPREAD_WINDOWS ? 1 : 0;
+    } else if (transit - jitter->spread_min[cur] < 0) {
+        jitter->spread_min[cur] = transit;
+    } else if (transit - jitter->spread_max[cur] > 0) {
+        jitter->spread_max[cur] = transit;
+    }
+
+    int32_t min = jitter->spread_min[cur];
+    int32_t max = jitter->spread_max[cur];
+    for (uint8_t i = 1; i < jitter->spread_windows; i++) {
+        uint8_t w = (cur + APP_JITTER_SPREAD_WINDOWS - i) % APP_JITTER_SPREAD_WINDOWS;
+        min = jitter->spread_min[w] - min < 0 ? jitter->spread_min[w] : min;
+        max = jitter->spread_max[w] - max > 0 ? jitter->spread_max[w] : max;
+    }
+
+    if (++jitter->spread_count == JITTER_SPREAD_PACKETS) {
+        jitter->spread_count = 0;
+        jitter->spread_idx = (cur + 1) % APP_JITTER_SPREAD_WINDOWS;
+    }
+    return (uint32_t)(max - min);
+}
+
+static void jitter_drop_all(app_jitter_t *jitter)
+{
+    for (size_t i = 0; i < jitter->config.slots; i++) {
+        if (jitter->slot[i].valid) {
+            jitter->slot[i].valid = false;
+            jitter->stats.dropped++;
+        }
+    }
+}
+
+/* Sum of x[i] * y[i] and y[i]^2 of the first channel, every step-th frame */
+static void jitter_corr(const app_jitter_t *jitter, const int16_t *x, const int16_t *y, size_t frames,
+                        size_t step, int64_t *xy, int64_t *yy)
+{
+    const size_t ch = jitter->config.channels;
+    int64_t sxy = 0, syy = 0;
+
+    for (size_t i = 0; i < frames; i += step) {
+        sxy += (int32_t)x[i * ch] * y[i * ch];
+        syy += (int32_t)y[i * ch] * y[i * ch];
+    }
+    *xy = sxy;
+    *yy = syy;
+}
+
+/* Is xy1 / sqrt(yy1) larger than xy2 / sqrt(yy2) (normalized correlation, positive only) */
+static bool jitter_corr_better(int64_t xy1, int64_t yy1, int64_t xy2, int64_t yy2)
+{
+    if (xy1 <= 0 || yy1 == 0) {
+        return false;
+    }
+    if (xy2 <= 0 || yy2 == 0) {
+        return true;
+    }
+    /* xy1^2 * yy2 > xy2^2 * yy1, the products do not fit 64 bits */
+    double a = (double)xy1 * (double)xy1 * (double)yy2;
+    double b = (double)xy2 * (double)xy2 * (double)yy1;
+    return a > b;
+}
+
+/* Pitch period of the end of the history, the longest period for noise or silence */
+static uint16_t jitter_find_pitch(const app_jitter_t *jitter)
+{
+    const size_t ch = jitter->config.channels;
+    const size_t window = jitter->pitch_max;
+    const int16_t *end = jitter->history + (jitter->history_len - window) * ch;
+    size_t coarse = jitter->config.sample_rate / JITTER_PITCH_COARSE_HZ;
+    uint16_t best = jitter->pitch_max;
+    int64_t best_xy = 0, best_yy = 0;
+    int64_t xy, yy;
+
+    coarse = coarse > 0 ? coarse : 1;
+
+    /* Coarse search on decimated signal */
+    for (size_t lag = jitter->pitch_min; lag <= jitter->pitch_max; lag += coarse) {
+        jitter_corr(jitter, end, end - lag * ch, window, coarse, &xy, &yy);
+        if (jitter_corr_better(xy, yy, best_xy, best_yy)) {
+            best = lag;
+            best_xy = xy;
+            best_yy = yy;
+        }
+    }
+
+    /* Refine around the best lag */
+    if (coarse > 1 && best_xy > 0) {
+        size_t from = best > jitter->pitch_min + coarse ? best - coarse : jitter->pitch_min;
+        size_t to = best + coarse < jitter->pitch_max ? best + coarse : jitter->pitch_max;
+        best_xy = 0;
+        best_yy = 0;
+        for (size_t lag = from; lag <= to; lag++) {
+            jitter_corr(jitter, end, end - lag * ch, window, 1, &xy, &yy);
+            if (jitter_corr_better(xy, yy, best_xy, best_yy)) {
+                best = lag;
+                best_xy = xy;
+                best_yy = yy;
+            }
+        }
+    }
+    return best;
+}
+
+/* Keep the frames for the pitch search */
+static void jitter_history_add(app_jitter_t *jitter, const int16_t *pcm, size_t frames)
+{
+    const size_t ch = jitter->config.channels;
+    const size_t len = jitter->history_len;
+
+    if (frames >= len) {
+        memcpy(jitter->history, pcm + (frames - len) * ch, len * ch * sizeof(int16_t));
+        return;
+    }
+    memmove(jitter->history, jitter->history + frames * ch, (len - frames) * ch * sizeof(int16_t));
+    memcpy(jitter->history + (len - frames) * ch, pcm, frames * ch * sizeof(int16_t));
+}
+
+/* Next frame of the repeated pitch period, faded out (Q15 gain) */
+static void jitter_plc_frame(app_jitter_t *jitter, int16_t *dst)
+{
+    const size_t ch = jitter->config.channels;
+    const uint32_t full = jitter_ms_to_frames(jitter, JITTER_PLC_FULL_MS);
+    const uint32_t end = jitter_ms_to_frames(jitter, JITTER_PLC_END_MS);
+    int32_t gain;
+
+    if (jitter->plc_pos < full) {
+        gain = 32768;
+    } else if (jitter->plc_pos < end) {
+        gain = (int32_t)((uint64_t)(end - jitter->plc_pos) * 32768 / (end - full));
+    } else {
+        memset(dst, 0, ch * sizeof(int16_t));
+        jitter->plc_pos++;
+        return;
+    }
+
+    const int16_t *src = jitter->history + (jitter->history_len - jitter->pitch + jitter->plc_pos % jitter->pitch) * ch;
+    for (size_t c = 0; c < ch; c++) {
+        dst[c] = (int16_t)((src[c] * gain) >> 15);
+    }
+    jitter->plc_pos++;
+}
+
+/* Generate frames in place of missing audio */
+static void jitter_conceal(app_jitter_t *jitter, int16_t *dst, size_t frames)
+{
+    if (jitter->pitch == 0) {
+        jitter->pitch = jitter_find_pitch(jitter);
+        jitter->plc_pos = 0;
+    }
+    /* A loss during the crossfade continues the concealment */
+    jitter->merge_left = 0;
+
+    for (size_t i = 0; i < frames; i++) {
+        jitter_plc_frame(jitter, dst + i * jitter->config.channels);
+    }
+    /* Lost packets, not the wait for the buffer to fill up */
+    if (jitter->playing) {
+        jitter->concealed += frames;
+    }
+}
+
+/* Copy received frames, crossfaded from the concealment after a loss */
+static void jitter_copy(app_jitter_t *jitter, int16_t *dst, const int16_t *src, size_t frames)
+{
+    const size_t ch = jitter->config.channels;
+    const uint32_t merge = jitter_ms_to_frames(jitter, JITTER_MERGE_MS);
+
+    if (jitter->pitch != 0 && jitter->merge_left == 0) {
+        jitter->merge_left = merge > 0 ? merge : 1;
+    }
+
+    size_t i = 0;
+    for (; i < frames && jitter->merge_left > 0; i++) {
+        int16_t plc[8];
+        int32_t w = (int32_t)((merge - jitter->merge_left) * 32768 / merge);
+        jitter_plc_frame(jitter, plc);
+        for (size_t c = 0; c < ch; c++) {
+            dst[i * ch + c] = (int16_t)((src[i * ch + c] * w + plc[c] * (32768 - w)) >> 15);
+        }
+        if (--jitter->merge_left == 0) {
+            jitter->pitch = 0;
+        }
+    }
+    memcpy(dst + i * ch, src + i * ch, (frames - i) * ch * sizeof(int16_t));
+    jitter_history_add(jitter, dst, frames);
+}
+
+/* Splice out the next packet: the concealment continues the audio played before it */
+static void jitter_skip(app_jitter_t *jitter)
+{
+    jitter_slot_t *slot = jitter_slot(jitter, jitter->next_seq);
+
+    slot->valid = false;
+    jitter->stats.dropped++;
+    jitter->next_seq++;
+    jitter->read_pos = 0;
+    if (jitter->pitch == 0) {
+        jitter->pitch = jitter_find_pitch(jitter);
+        jitter->plc_pos = 0;
+    }
+    jitter->merge_left = 0;
+}
+
+/* Start playing the buffered packets (after start or underrun) */
+static void jitter_resume(app_jitter_t *jitter)
+{
+    /* Skip to the oldest buffered packet, the missing ones were not played */
+    while (jitter->next_seq != jitter->high_seq && !jitter_slot(jitter, jitter->next_seq)->valid) {
+        jitter->stats.lost++;
+        jitter->next_seq++;
+    }
+    jitter_slot_t *slot = jitter_slot(jitter, jitter->next_seq);
+    jitter->play_ts = slot->ts;
+    jitter->read_pos = 0;
+
+    /* A burst after a network stall is played from its end */
+    while (jitter->next_seq != jitter->high_seq &&
+            jitter_depth(jitter) - slot->frames >= (int32_t)(jitter->target + jitter->block)) {
+        slot->valid = false;
+        jitter->stats.dropped++;
+        jitter->next_seq++;
+        while (jitter->next_seq != jitter->high_seq && !jitter_slot(jitter, jitter->next_seq)->valid) {
+            jitter->stats.lost++;
+            jitter->next_seq++;
+        }
+        slot = jitter_slot(jitter, jitter->next_seq);
+        jitter->play_ts = slot->ts;
+    }
+
+    jitter->playing = true;
+    jitter->primed = true;
+    jitter->wait = 0;
+    jitter->depth_q8 = (jitter_depth(jitter) - (int32_t)jitter->block) * 256;
+}
+
+/* Playout: fill frames in stream order, before resampling */
+static void jitter_pull(app_jitter_t *jitter, int16_t *dst, size_t frames)
+{
+    const size_t ch = jitter->config.channels;
+
+    while (frames > 0) {
+        if (!jitter->playing) {
+            if (jitter->started && jitter_depth(jitter) >= (int32_t)(jitter->target + jitter->block) &&
+                    jitter_slot(jitter, jitter->high_seq)->valid) {
+                jitter_resume(jitter);
+            } else {
+                jitter_conceal(jitter, dst, frames);
+                return;
+            }
+        }
+
+        jitter_slot_t *slot = jitter_slot(jitter, jitter->next_seq);
+        size_t n;
+        if (slot->valid && slot->seq == jitter->next_seq) {
+            n = slot->frames - jitter->read_pos;
+            n = n < frames ? n : frames;
+            jitter_copy(jitter, dst, jitter_slot_pcm(jitter, jitter->next_seq) + jitter->read_pos * ch, n);
+            jitter->wait = 0;
+            jitter->read_pos += n;
+            jitter->play_ts = slot->ts + jitter->read_pos;
+            if (jitter->read_pos == slot->frames) {
+                slot->valid = false;
+                jitter->next_seq++;
+                jitter->read_pos = 0;
+            }
+        } else if ((int16_t)(jitter->high_seq - jitter->next_seq) > 0) {
+            /* A newer packet is here, this one is lost (or late) */
+            if (jitter->read_pos == 0) {
+                jitter->stats.lost++;
+                /* Partly concealed already, while it was awaited (a long wait covers the next lost ones too) */
+                jitter->read_pos = jitter->wait < jitter->packet_frames ? jitter->wait : jitter->packet_frames;
+                jitter->play_ts += jitter->read_pos;
+                jitter->wait -= jitter->read_pos;
+            }
+            n = jitter->packet_frames - jitter->read_pos;
+            n = n < frames ? n : frames;
+            jitter_conceal(jitter, dst, n);
+            jitter->read_pos += n;
+            jitter->play_ts += n;
+            if (jitter->read_pos == jitter->packet_frames) {
+                jitter->next_seq++;
+                jitter->read_pos = 0;
+            }
+        } else if (jitter->wait < jitter_ms_to_frames(jitter, JITTER_PLC_END_MS)) {
+            /* Nothing newer yet: conceal while the packet is on its way, it plays late instead of lost */
+            n = jitter_ms_to_frames(jitter, JITTER_PLC_END_MS) - jitter->wait;
+            n = n < frames ? n : frames;
+            jitter_conceal(jitter, dst, n);
+            jitter->wait += n;
+        } else {
+            /* Empty, wait for the target depth again */
+            jitter->stats.underruns++;
+            jitter->playing = false;
+            jitter->read_pos = 0;
+            continue;
+        }
+        dst += n * ch;
+        frames -= n;
+    }
+}
+
+/* Depth control, after each read call */
+static void jitter_control(app_jitter_t *jitter, size_t frames)
+{
+    const int64_t rate = jitter->config.sample_rate;
+    const int32_t max_ppm = jitter->config.max_ppm;
+
+    if (!jitter->playing) {
+        jitter->ratio_ppm = 0;
+        jitter->step = 1ULL << 32;
+        return;
+    }
+
+    int32_t depth = jitter_depth(jitter);
+    jitter->depth_q8 += (depth * 256 - jitter->depth_q8) / (1 << JITTER_DEPTH_AVG_SHIFT);
+
+    /* Far too deep (a burst or the target went down): cut a packet, resampling is too slow */
+    int32_t err = (jitter->depth_q8 >> 8) - (int32_t)jitter->target;
+    int32_t cut = (int32_t)(jitter->target / 2 > 2U * jitter->packet_frames ? jitter->target / 2 : 2U * jitter->packet_frames);
+    if (err > cut && jitter->read_pos == 0) {
+        jitter_slot_t *slot = jitter_slot(jitter, jitter->next_seq);
+        if (slot->valid && slot->seq == jitter->next_seq && jitter->next_seq != jitter->high_seq) {
+            jitter->play_ts = slot->ts + slot->frames;
+            jitter->depth_q8 -= slot->frames * 256;
+            jitter_skip(jitter);
+        }
+    }
+
+    /* Error in ppm, to be corrected in JITTER_CONTROL_P_S */
+    int64_t p = (int64_t)err * 1000000 / (rate * JITTER_CONTROL_P_S);
+    p = p > max_ppm ? max_ppm : (p < -max_ppm ? -max_ppm : p);
+
+    /*
+     * Integral part settles on the clock drift, which shows as a small error growing slowly.
+     * Steps of the depth (losses, bursts, target changes) are left to the proportional part:
+     * the integrated error is limited, and not integrated further into a saturated ratio.
+     */
+    int32_t ratio = (int32_t)p + jitter->drift_q16 / 65536;
+    const int64_t i_max = rate * JITTER_CONTROL_I_MAX_MS / 1000;
+    int64_t i_err = err > i_max ? i_max : (err < -i_max ? -i_max : err);
+    if (!(ratio >= max_ppm && i_err > 0) && !(ratio <= -max_ppm && i_err < 0)) {
+        jitter->drift_q16 += (int32_t)(i_err * 1000000 * 65536 / (rate * JITTER_CONTROL_P_S) * (int64_t)frames /
+                                       (rate * JITTER_CONTROL_I_S));
+    }
+    const int32_t limit = max_ppm * 65536;
+    jitter->drift_q16 = jitter->drift_q16 > limit ? limit : (jitter->drift_q16 < -limit ? -limit : jitter->drift_q16);
+
+    ratio = (int32_t)p + jitter->drift_q16 / 65536;
+    ratio = ratio > max_ppm ? max_ppm : (ratio < -max_ppm ? -max_ppm : ratio);
+    jitter->ratio_ppm = ratio;
+    jitter->step = (uint64_t)((1LL << 32) + (int64_t)ratio * (1LL << 32) / 1000000);
+}
+
+/* Move the last frames to the beginning and pull the next chunk */
+static void jitter_in_refill(app_jitter_t *jitter)
+{
+    const size_t ch = jitter->config.channels;
+    size_t from = jitter->in_pos - 1;
+
+    memmove(jitter->in, jitter->in + from * ch, (jitter->in_len - from) * ch * sizeof(int16_t));
+    jitter->in_len -= from;
+    jitter->in_pos = 1;
+    jitter_pull(jitter, jitter->in + jitter->in_len * ch, JITTER_IN_CHUNK);
+    jitter->in_len += JITTER_IN_CHUNK;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_jitter_init(app_jitter_t *jitter, const app_jitter_config_t *config)
+{
+    if (jitter == NULL || config == NULL || config->sample_rate == 0 || config->channels == 0 ||
+            config->channels > 8 || config->max_packet_frames == 0 || config->slots < 2 ||
+            (config->slots & (config->slots - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(jitter, 0, sizeof(app_jitter_t));
+    jitter->config = *config;
+    jitter->pitch_min = jitter_ms_to_frames(jitter, 1) * JITTER_PITCH_MIN_MS10 / 10;
+    jitter->pitch_max = jitter_ms_to_frames(jitter, 1) * JITTER_PITCH_MAX_MS10 / 10;
+    jitter->pitch_min = jitter->pitch_min > 0 ? jitter->pitch_min : 1;
+    jitter->pitch_max = jitter->pitch_max > jitter->pitch_min ? jitter->pitch_max : jitter->pitch_min;
+    jitter->history_len = 2 * jitter->pitch_max;
+
+    const size_t ch = config->channels;
+    const size_t pcm_size = (size_t)config->slots * config->max_packet_frames * ch * sizeof(int16_t);
+    jitter->pcm = heap_caps_malloc(pcm_size, MALLOC_CAP_SPIRAM);
+    if (jitter->pcm == NULL) {
+        jitter->pcm = heap_caps_malloc(pcm_size, MALLOC_CAP_DEFAULT);
+    }
+    jitter->slot = heap_caps_calloc(config->slots, sizeof(jitter_slot_t), MALLOC_CAP_DEFAULT);
+    jitter->history = heap_caps_calloc(jitter->history_len * ch, sizeof(int16_t), MALLOC_CAP_DEFAULT);
+    jitter->in = heap_caps_calloc((JITTER_IN_CHUNK + JITTER_IN_KEEP + 1) * ch, sizeof(int16_t), MALLOC_CAP_DEFAULT);
+    if (jitter->pcm == NULL || jitter->slot == NULL || jitter->history == NULL || jitter->in == NULL) {
+        app_jitter_deinit(jitter);
+        return ESP_ERR_NO_MEM;
+    }
+
+    app_jitter_reset(jitter);
+    return ESP_OK;
+}
+
+void app_jitter_deinit(app_jitter_t *jitter)
+{
+    heap_caps_free(jitter->pcm);
+    heap_caps_free(jitter->slot);
+    heap_caps_free(jitter->history);
+    heap_caps_free(jitter->in);
+    jitter->pcm = NULL;
+    jitter->slot = NULL;
+    jitter->history = NULL;
+    jitter->in = NULL;
+}
+
+void app_jitter_reset(app_jitter_t *jitter)
+{
+    const size_t ch = jitter->config.channels;
+
+    memset(jitter->slot, 0, jitter->config.slots * sizeof(jitter_slot_t));
+    memset(jitter->history, 0, jitter->history_len * ch * sizeof(int16_t));
+    memset(&jitter->stats, 0, sizeof(jitter->stats));
+    jitter->started = false;
+    jitter->playing = false;
+    jitter->primed = false;
+    jitter->read_pos = 0;
+    jitter->jitter_q4 = 0;
+    jitter->spread_count = 0;
+    jitter->spread_idx = 0;
+    jitter->spread_windows = 0;
+    jitter->depth_q8 = 0;
+    jitter->drift_q16 = 0;
+    jitter->ratio_ppm = 0;
+    jitter->step = 1ULL << 32;
+    jitter->frac = 0;
+    jitter->pitch = 0;
+    jitter->merge_left = 0;
+    jitter->concealed = 0;
+    jitter_set_target(jitter, 0);
+
+    /* One frame before the interpolated position */
+    memset(jitter->in, 0, ch * sizeof(int16_t));
+    jitter->in_len = 1;
+    jitter->in_pos = 1;
+}
+
+esp_err_t app_jitter_put(app_jitter_t *jitter, uint16_t seq, uint32_t ts,
+                         const int16_t *pcm, size_t frames, int64_t now_us)
+{
+    const int16_t slots = (int16_t)jitter->config.slots;
+
+    if (frames == 0 || frames > jitter->config.max_packet_frames) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    if (!jitter->started) {
+        jitter->started = true;
+        jitter->next_seq = seq;
+        jitter->high_seq = seq;
+        jitter->high_end = ts;
+        jitter->play_ts = ts;
+        jitter->packet_frames = frames;
+        jitter->last_transit = (int32_t)((uint32_t)(now_us * jitter->config.sample_rate / 1000000) - ts);
+    }
+
+    int16_t d = (int16_t)(seq - jitter->next_seq);
+    if (d < -slots) {
+        /* Sequence jump backwards, the sender restarted */
+        jitter_drop_all(jitter);
+        jitter->playing = false;
+        jitter->primed = false;
+        jitter->next_seq = seq;
+        jitter->high_seq = seq;
+        jitter->high_end = ts;
+        jitter->play_ts = ts;
+        d = 0;
+    } else if (d < 0 || (d == 0 && jitter->read_pos > 0)) {
+        jitter_slot_t *slot = jitter_slot(jitter, seq);
+        if (!jitter->primed && d < 0 && (int16_t)(jitter->high_seq - seq) < slots) {
+            /* Reordered before the first one played */
+            jitter->next_seq = seq;
+            jitter->play_ts = ts;
+            d = 0;
+        } else if (slot->valid && slot->seq == seq) {
+            jitter->stats.duplicate++;
+            return ESP_ERR_INVALID_STATE;
+        } else {
+            /* Played (concealed) already, more delay is needed */
+            jitter->stats.late++;
+            jitter_set_target(jitter, jitter->target + frames);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    if (d >= slots) {
+        /* Too far ahead (playout stopped or a stall longer than the buffer): start over */
+        jitter_drop_all(jitter);
+        jitter->playing = false;
+        jitter->next_seq = seq;
+        jitter->high_seq = seq;
+        jitter->high_end = ts;
+        jitter->play_ts = ts;
+        jitter->read_pos = 0;
+    }
+
+    jitter_slot_t *slot = jitter_slot(jitter, seq);
+    if (slot->valid && slot->seq == seq) {
+        jitter->stats.duplicate++;
+        return ESP_ERR_INVALID_STATE;
+    }
+    slot->seq = seq;
+    slot->ts = ts;
+    slot->frames = frames;
+    slot->valid = true;
+    memcpy(jitter_slot_pcm(jitter, seq), pcm, frames * jitter->config.channels * sizeof(int16_t));
+    jitter->stats.received++;
+
+    if ((int16_t)(seq - jitter->high_seq) >= 0) {
+        jitter->high_seq = seq;
+        jitter->high_end = ts + frames;
+        jitter->packet_frames = frames;
+    } else {
+        jitter->stats.reordered++;
+    }
+
+    /* Interarrival jitter (RFC 3550 A.8), in frames, only reported */
+    int32_t transit = (int32_t)((uint32_t)(now_us * jitter->config.sample_rate / 1000000) - ts);
+    int32_t delta = transit - jitter->last_transit;
+    jitter->last_transit = transit;
+    delta = delta < 0 ? -delta : delta;
+    jitter->jitter_q4 += delta - ((jitter->jitter_q4 + 8) >> 4);
+
+    /* Playout delay: fast up, slowly down */
+    uint32_t want = jitter_spread(jitter, transit) + jitter->packet_frames;
+    if (want > jitter->target) {
+        jitter_set_target(jitter, want);
+    } else {
+        jitter_set_target(jitter, jitter->target - ((jitter->target - want) >> JITTER_TARGET_DECAY));
+    }
+
+    return ESP_OK;
+}
+
+void app_jitter_read(app_jitter_t *jitter, int16_t *out, size_t frames)
+{
+    const size_t ch = jitter->config.channels;
+
+    /* The target is the depth left after a read, playout starts with the read on top of it */
+    jitter->block = frames;
+
+    for (size_t i = 0; i < frames; i++) {
+        while (jitter->in_pos + 2 >= jitter->in_len) {
+            jitter_in_refill(jitter);
+        }
+
+        /* Catmull-Rom between x0 and x1, t in Q15 */
+        const int16_t *x = jitter->in + (jitter->in_pos - 1) * ch;
+        const int64_t t = jitter->frac >> 17;
+        for (size_t c = 0; c < ch; c++) {
+            int32_t xm1 = x[c], x0 = x[ch + c], x1 = x[2 * ch + c], x2 = x[3 * ch + c];
+            int64_t a = 3 * (x0 - x1) + x2 - xm1;
+            int64_t b = 2 * xm1 - 5 * x0 + 4 * x1 - x2;
+            int64_t v = ((a * t) >> 15) + b;
+            v = ((v * t) >> 15) + (x1 - xm1);
+            out[i * ch + c] = jitter_sat16(x0 + (int32_t)((v * t) >> 16));
+        }
+
+        uint64_t pos = (uint64_t)jitter->frac + jitter->step;
+        jitter->in_pos += pos >> 32;
+        jitter->frac = (uint32_t)pos;
+    }
+
+    /* The depth is lowest after the read, it is the margin for the next packets */
+    jitter_control(jitter, frames);
+}
+
+void app_jitter_get_stats(const app_jitter_t *jitter, app_jitter_stats_t *stats)
+{
+    *stats = jitter->stats;
+    stats->concealed_ms = jitter_frames_to_ms(jitter, jitter->concealed);
+    stats->depth_ms = jitter->playing ? jitter_frames_to_ms(jitter, jitter->depth_q8 > 0 ? jitter->depth_q8 >> 8 : 0) : 0;
+    stats->target_ms = jitter_frames_to_ms(jitter, jitter->target);
+    stats->jitter_ms = jitter_frames_to_ms(jitter, jitter->jitter_q4 >> 4);
+    stats->ratio_ppm = jitter->ratio_ppm;
+    stats->drift_ppm = jitter->drift_q16 / 65536;
+}
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The playout delay covers the transit time spread over this many windows of 64 packets */
+#define APP_JITTER_SPREAD_WINDOWS   (4)
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t max_packet_frames; /*!< Longest packet payload, in frames */
+    uint16_t slots;             /*!< Number of buffered packets, power of two */
+    uint16_t min_delay_ms;      /*!< Range of the adaptive playout delay */
+    uint16_t max_delay_ms;
+    uint16_t max_ppm;           /*!< Largest resampling correction, parts per million */
+} app_jitter_config_t;
+
+/**
+ * @brief Jitter buffer statistics, packet counters are since the last reset
+ */
+typedef struct {
+    uint32_t received;          /*!< Packets buffered in time */
+    uint32_t reordered;         /*!< Of them, received after a newer packet */
+    uint32_t duplicate;         /*!< Packets received twice (dropped) */
+    uint32_t late;              /*!< Packets received after their playout time (dropped) */
+    uint32_t lost;              /*!< Packets not received until their playout time (concealed) */
+    uint32_t dropped;           /*!< Packets discarded to cut the delay (buffer overflow) */
+    uint32_t underruns;         /*!< Times the buffer ran empty and was refilled */
+    uint32_t concealed_ms;      /*!< Audio generated in place of lost packets (not while refilling) */
+    uint16_t depth_ms;          /*!< Buffered audio (averaged), including packets still expected */
+    uint16_t target_ms;         /*!< Adaptive playout delay */
+    uint16_t jitter_ms;         /*!< Interarrival jitter (RFC 3550) */
+    int32_t ratio_ppm;          /*!< Current resampling correction, positive plays faster */
+    int32_t drift_ppm;          /*!< Estimated sender clock drift (sender faster is positive) */
+} app_jitter_stats_t;
+
+/**
+ * @brief Adaptive jitter buffer of 16bit PCM packets
+ *
+ * Packets are stored by sequence number and played in order. A packet missing at its
+ * playout time is concealed from the waveform played before it; if it arrives later, it
+ * is dropped as late. The playout delay follows the measured network jitter, the buffer
+ * depth is kept at it by fine resampling of the output, which also compensates clock
+ * drift between the sender and the local audio output.
+ *
+ * Not thread safe, the caller serializes app_jitter_put() and app_jitter_read().
+ */
+typedef struct {
+    app_jitter_config_t config;
+    int16_t *pcm;               /*!< slots * max_packet_frames frames */
+    struct app_jitter_slot_s *slot;
+
+    /* Receive side */
+    bool started;
+    uint16_t next_seq;          /*!< Next packet to play */
+    uint16_t high_seq;          /*!< Newest received packet */
+    uint32_t high_end;          /*!< RTP timestamp after the newest packet */
+    uint16_t packet_frames;     /*!< Length of the last packet, used for lost ones */
+    int32_t last_transit;
+    uint32_t jitter_q4;         /*!< Interarrival jitter in frames, Q4 (RFC 3550) */
+    int32_t spread_min[APP_JITTER_SPREAD_WINDOWS];  /*!< Transit time range of packet windows */
+    int32_t spread_max[APP_JITTER_SPREAD_WINDOWS];
+    uint8_t spread_idx;
+    uint8_t spread_windows;
+    uint16_t spread_count;
+    uint32_t target;            /*!< Playout delay in frames, the depth after a read */
+
+    /* Playout side */
+    bool playing;               /*!< false while (re)filling the buffer up to the target */
+    bool primed;                /*!< Something was played, older packets are late */
+    uint32_t play_ts;           /*!< RTP timestamp of the next frame to play */
+    uint16_t read_pos;          /*!< Frames of the next packet already played */
+    uint32_t wait;              /*!< Frames concealed while the buffer is empty */
+    uint32_t block;             /*!< Frames of the last read */
+    int32_t depth_q8;           /*!< Averaged depth in frames, Q8 */
+    int32_t drift_q16;          /*!< Integral of the depth control, ppm Q16 */
+    int32_t ratio_ppm;
+    uint64_t step;              /*!< Input frames per output frame, Q32 */
+    uint32_t frac;              /*!< Position between in[1] and in[2], Q32 */
+    int16_t *in;                /*!< Input frames of the resampler, 4 kept for interpolation */
+    size_t in_len;
+    size_t in_pos;
+
+    /* Loss concealment */
+    int16_t *history;           /*!< Last played frames (resampler input) */
+    uint16_t history_len;
+    uint16_t pitch;             /*!< Repeated period, 0 when not concealing */
+    uint32_t plc_pos;           /*!< Frames concealed in this loss */
+    uint16_t merge_left;        /*!< Frames of the crossfade back to the received audio */
+    uint16_t pitch_min;
+    uint16_t pitch_max;
+    uint32_t concealed;         /*!< Concealed frames */
+
+    app_jitter_stats_t stats;
+} app_jitter_t;
+
+/**
+ * @brief Allocate buffers (PSRAM, if available)
+ *
+ * @return ESP_ERR_INVALID_ARG if slots is not a power of two or a parameter is 0
+ */
+esp_err_t app_jitter_init(app_jitter_t *jitter, const app_jitter_config_t *config);
+
+/**
+ * @brief Free buffers
+ */
+void app_jitter_deinit(app_jitter_t *jitter);
+
+/**
+ * @brief Drop all packets and statistics, the next packet starts a new stream
+ */
+void app_jitter_reset(app_jitter_t *jitter);
+
+/**
+ * @brief Buffer received packet
+ *
+ * @param seq RTP sequence number
+ * @param ts RTP timestamp of the first frame (sample rate units)
+ * @param now_us Arrival time, microseconds of the local clock
+ * @return ESP_ERR_INVALID_SIZE if the packet is longer than max_packet_frames,
+ *         ESP_ERR_INVALID_STATE if the packet is late or a duplicate (counted in the statistics)
+ */
+esp_err_t app_jitter_put(app_jitter_t *jitter, uint16_t seq, uint32_t ts,
+                         const int16_t *pcm, size_t frames, int64_t now_us);
+
+/**
+ * @brief Get frames for the audio output, always fills the whole buffer
+ *
+ * Lost packets are concealed, silence is played while the buffer fills up.
+ * Call it at the pace of the audio output, the resampling is controlled per call.
+ */
+void app_jitter_read(app_jitter_t *jitter, int16_t *out, size_t frames);
+
+/**
+ * @brief True if any frame was buffered since the last reset
+ */
+static inline bool app_jitter_started(const app_jitter_t *jitter)
+{
+    return jitter->started;
+}
+
+/**
+ * @brief Get statistics
+ */
+void app_jitter_get_stats(const app_jitter_t *jitter, app_jitter_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,335 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <inttypes.h>
+
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "jpeg_decoder.h"
+#include "app_mem.h"
+#include "app_jpeg_par.h"
+
+/* JPEG markers */
+#define JPEG_SOI            (0xD8)
+#define JPEG_EOI            (0xD9)
+#define JPEG_SOS            (0xDA)
+#define JPEG_DRI            (0xDD)
+#define JPEG_SOF0           (0xC0)
+#define JPEG_SOF1           (0xC1)
+#define JPEG_RST0           (0xD0)
+#define JPEG_RST7           (0xD7)
+
+/* Stack of the stripe decoding task */
+#define JPEG_PAR_STACK      (4096)
+
+static const char *TAG = "JPEG_PAR";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    const uint8_t *in;
+    size_t in_size;
+    uint8_t *out;
+    size_t out_size;
+    bool swap_bytes;
+    esp_err_t ret;
+    SemaphoreHandle_t done;
+} jpeg_par_job_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static inline uint16_t rd16be(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+/* Pick the restart interval (starting a MCU row) closest to the row */
+static uint32_t jpeg_pick_interval(uint32_t row, uint32_t ri, uint32_t mcus_per_row, uint32_t intervals, uint32_t after)
+{
+    uint32_t best = 0;
+    uint32_t best_dist = UINT32_MAX;
+
+    for (uint32_t k = 1; k < intervals; k++) {
+        if (k <= after || (k * ri) % mcus_per_row != 0) {
+            continue;
+        }
+        uint32_t k_row = k * ri / mcus_per_row;
+        uint32_t dist = k_row > row ? k_row - row : row - k_row;
+        if (dist < best_dist) {
+            best = k;
+            best_dist = dist;
+        }
+    }
+
+    return best;
+}
+
+static void jpeg_par_decode_job(jpeg_par_job_t *job)
+{
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)job->in,
+        .indata_size = job->in_size,
+        .outbuf = job->out,
+        .outbuf_size = job->out_size,
+        .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+        .flags = {
+            .swap_color_bytes = job->swap_bytes,
+        }
+    };
+    esp_jpeg_image_output_t outimg;
+
+    job->ret = esp_jpeg_decode(&jpeg_cfg, &outimg);
+}
+
+static void jpeg_par_task(void *arg)
+{
+    jpeg_par_job_t *job = arg;
+
+    jpeg_par_decode_job(job);
+    xSemaphoreGive(job->done);
+
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_jpeg_par_split(const uint8_t *data, size_t size, uint8_t count, app_jpeg_split_t *split)
+{
+    uint32_t ri = 0;
+    uint8_t h_max = 0, v_max = 0;
+    size_t pos = 2;
+
+    memset(split, 0, sizeof(app_jpeg_split_t));
+    if (count > APP_JPEG_PAR_MAX_STRIPES) {
+        count = APP_JPEG_PAR_MAX_STRIPES;
+    }
+    if (size < 4 || data[0] != 0xFF || data[1] != JPEG_SOI) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* Headers up to the start of scan */
+    while (split->header_size == 0) {
+        if (pos + 4 > size || data[pos] != 0xFF) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            pos++;
+            continue;
+        }
+        size_t seg_end = pos + 2 + rd16be(&data[pos + 2]);
+        if (seg_end > size) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        if (marker == JPEG_SOF0 || marker == JPEG_SOF1) {
+            uint8_t comps = data[pos + 9];
+            if (pos + 10 + 3 * comps > seg_end) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            split->sof_height_offset = pos + 5;
+            split->height = rd16be(&data[pos + 5]);
+            split->width = rd16be(&data[pos + 7]);
+            for (uint8_t i = 0; i < comps; i++) {
+                uint8_t hv = data[pos + 10 + 3 * i + 1];
+                h_max = (hv >> 4) > h_max ? (hv >> 4) : h_max;
+                v_max = (hv & 0x0F) > v_max ? (hv & 0x0F) : v_max;
+            }
+        } else if (marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            /* Progressive, lossless or arithmetic coding */
+            return ESP_ERR_NOT_SUPPORTED;
+        } else if (marker == JPEG_DRI) {
+            ri = rd16be(&data[pos + 4]);
+        } else if (marker == JPEG_SOS) {
+            split->header_size = seg_end;
+        }
+        pos = seg_end;
+    }
+
+    if (split->sof_height_offset == 0 || split->width == 0 || split->height == 0 || h_max == 0 || v_max == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ri == 0 || count < 2) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* Stripe boundaries in restart intervals */
+    const uint32_t mcu_height = 8 * v_max;
+    const uint32_t mcus_per_row = (split->width + 8 * h_max - 1) / (8 * h_max);
+    const uint32_t mcu_rows = (split->height + mcu_height - 1) / mcu_height;
+    const uint32_t intervals = (mcus_per_row * mcu_rows + ri - 1) / ri;
+    uint32_t bounds[APP_JPEG_PAR_MAX_STRIPES] = {0};
+    uint8_t stripes = 1;
+    for (uint8_t i = 1; i < count; i++) {
+        uint32_t k = jpeg_pick_interval(mcu_rows * i / count, ri, mcus_per_row, intervals, bounds[stripes - 1]);
+        if (k != 0) {
+            bounds[stripes++] = k;
+        }
+    }
+    if (stripes < 2) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    for (uint8_t i = 0; i < stripes; i++) {
+        split->stripes[i].y = bounds[i] * ri / mcus_per_row * mcu_height;
+        split->stripes[i].first_interval = bounds[i];
+    }
+    for (uint8_t i = 0; i < stripes; i++) {
+        uint16_t end = (i + 1 < stripes) ? split->stripes[i + 1].y : split->height;
+        split->stripes[i].height = end - split->stripes[i].y;
+    }
+
+    /* Find the RST markers at the boundaries in the entropy-coded data */
+    uint32_t interval = 0;
+    uint8_t stripe = 0;
+    split->stripes[0].data_start = split->header_size;
+    for (pos = split->header_size; pos + 1 < size; pos++) {
+        if (data[pos] != 0xFF || data[pos + 1] == 0x00 || data[pos + 1] == 0xFF) {
+            continue;
+        }
+        uint8_t marker = data[pos + 1];
+        if (marker >= JPEG_RST0 && marker <= JPEG_RST7) {
+            if ((marker & 0x07) != (interval & 0x07)) {
+                ESP_LOGW(TAG, "Unexpected RST%d marker", marker & 0x07);
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+            interval++;
+            if (stripe + 1 < stripes && interval == bounds[stripe + 1]) {
+                split->stripes[stripe].data_end = pos;
+                split->stripes[++stripe].data_start = pos + 2;
+            }
+            pos++;
+        } else if (marker == JPEG_EOI) {
+            break;
+        } else {
+            /* Other markers (e.g. next scan) are not expected in baseline image */
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+    }
+    /* Truncated image is left to the sequential decoder, the last stripe must end by EOI */
+    if (stripe + 1 != stripes || pos + 1 >= size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    split->stripes[stripe].data_end = pos;
+    split->count = stripes;
+
+    return ESP_OK;
+}
+
+size_t app_jpeg_par_build_stripe(const uint8_t *data, const app_jpeg_split_t *split, uint8_t index, uint8_t *dst)
+{
+    const app_jpeg_stripe_t *stripe = &split->stripes[index];
+    size_t len = stripe->data_end - stripe->data_start;
+
+    memcpy(dst, data, split->header_size);
+    dst[split->sof_height_offset] = stripe->height >> 8;
+    dst[split->sof_height_offset + 1] = stripe->height & 0xFF;
+    memcpy(&dst[split->header_size], &data[stripe->data_start], len);
+
+    /* Decoders expect RST markers numbered from RST0 */
+    uint8_t shift = stripe->first_interval & 0x07;
+    if (shift != 0) {
+        uint8_t *p = &dst[split->header_size];
+        uint8_t *end = p + len;
+        while ((p = memchr(p, 0xFF, end - p)) != NULL && p + 1 < end) {
+            if (p[1] >= JPEG_RST0 && p[1] <= JPEG_RST7) {
+                p[1] = JPEG_RST0 + ((p[1] - JPEG_RST0 - shift) & 0x07);
+            }
+            /* Fill bytes (0xFF) may precede a marker */
+            p += (p[1] == 0xFF) ? 1 : 2;
+        }
+    }
+
+    dst[split->header_size + len] = 0xFF;
+    dst[split->header_size + len + 1] = JPEG_EOI;
+
+    return split->header_size + len + 2;
+}
+
+esp_err_t app_jpeg_par_decode(const uint8_t *data, size_t size, app_img_out_t *out)
+{
+#if CONFIG_FREERTOS_UNICORE
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    app_jpeg_split_t split;
+    jpeg_par_job_t jobs[APP_JPEG_PAR_MAX_STRIPES];
+    StaticSemaphore_t done_buf;
+
+    esp_err_t ret = app_jpeg_par_split(data, size, portNUM_PROCESSORS, &split);
+    if (ret != ESP_OK) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    /* Cropping and errors are left to the sequential decoder */
+    if (split.width > out->max_width || split.height > out->max_height ||
+            (size_t)split.width * split.height * sizeof(uint16_t) > out->buf_size) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* All stripe JPEGs in one buffer, so it can be returned to the arena at once */
+    size_t buf_size = 0;
+    for (uint8_t i = 0; i < split.count; i++) {
+        buf_size += split.header_size + (split.stripes[i].data_end - split.stripes[i].data_start) + 2;
+    }
+    uint8_t *buf = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, buf_size);
+    if (buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    SemaphoreHandle_t done = xSemaphoreCreateCountingStatic(split.count, 0, &done_buf);
+    uint8_t *in = buf;
+    for (uint8_t i = 0; i < split.count; i++) {
+        const app_jpeg_stripe_t *stripe = &split.stripes[i];
+        jobs[i] = (jpeg_par_job_t) {
+            .in = in,
+            .in_size = app_jpeg_par_build_stripe(data, &split, i, in),
+            .out = out->buf + (size_t)stripe->y * split.width * sizeof(uint16_t),
+            .out_size = (size_t)stripe->height * split.width * sizeof(uint16_t),
+            .swap_bytes = out->swap_bytes,
+            .done = done,
+        };
+        in += jobs[i].in_size;
+    }
+
+    /* Other stripes on the other cores, the first one in this task */
+    const BaseType_t core = xPortGetCoreID();
+    const UBaseType_t priority = uxTaskPriorityGet(NULL);
+    for (uint8_t i = 1; i < split.count; i++) {
+        if (xTaskCreatePinnedToCore(jpeg_par_task, "jpeg_par", JPEG_PAR_STACK, &jobs[i], priority, NULL,
+                                    (core + i) % portNUM_PROCESSORS) != pdPASS) {
+            jpeg_par_decode_job(&jobs[i]);
+            xSemaphoreGive(done);
+        }
+    }
+    jpeg_par_decode_job(&jobs[0]);
+    for (uint8_t i = 1; i < split.count; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+
+    for (uint8_t i = 0; i < split.count && ret == ESP_OK; i++) {
+        ret = jobs[i].ret;
+    }
+    ESP_LOGD(TAG, "Decoded %dx%d in %d stripes", split.width, split.height, split.count);
+
+    vSemaphoreDelete(done);
+    app_mem_arena_free(APP_MEM_ARENA_WINDOW, buf);
+
+    if (ret == ESP_OK) {
+        out->width = split.width;
+        out->height = split.height;
+    }
+    return ret;
+#endif
+}
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "app_img_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximal number of stripes decoded in parallel */
+#define APP_JPEG_PAR_MAX_STRIPES    (4)
+
+/**
+ * @brief Horizontal stripe of a JPEG image, which can be decoded independently
+ *
+ * The stripe is decoded as a standalone JPEG: the image headers (with the image height
+ * replaced by the stripe height) followed by the entropy-coded data of the stripe and EOI.
+ * The RST markers in the stripe are renumbered to start from RST0.
+ */
+typedef struct {
+    size_t data_start;          /*!< Offset of the entropy-coded data of the stripe */
+    size_t data_end;            /*!< Offset of the RST marker after the stripe (or of EOI) */
+    uint32_t first_interval;    /*!< Index of the first restart interval in the stripe */
+    uint16_t y;                 /*!< First row of the stripe */
+    uint16_t height;            /*!< Rows in the stripe */
+} app_jpeg_stripe_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    size_t header_size;         /*!< SOI ... SOS, shared by all stripes */
+    size_t sof_height_offset;   /*!< Offset of the image height in SOF segment */
+    uint8_t count;
+    app_jpeg_stripe_t stripes[APP_JPEG_PAR_MAX_STRIPES];
+} app_jpeg_split_t;
+
+/**
+ * @brief Split baseline JPEG with restart markers into up to count stripes of similar height
+ *
+ * Stripes start at restart intervals, which begin a MCU row. Restart marker after every MCU row
+ * (jpegtran -restart 1) gives the best balance.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the image has no suitable restart
+ *         intervals (it must be decoded sequentially), ESP_ERR_INVALID_ARG if it is malformed
+ */
+esp_err_t app_jpeg_par_split(const uint8_t *data, size_t size, uint8_t count, app_jpeg_split_t *split);
+
+/**
+ * @brief Build standalone JPEG of one stripe into dst
+ *
+ * @return Size of the stripe JPEG, dst must have header_size + (data_end - data_start) + 2 bytes
+ */
+size_t app_jpeg_par_build_stripe(const uint8_t *data, const app_jpeg_split_t *split, uint8_t index, uint8_t *dst);
+
+/**
+ * @brief Decode JPEG into out->buf by stripes on all CPU cores
+ *
+ * Every stripe is decoded into its own disjoint rows of the output buffer. Stripe buffers are
+ * allocated from APP_MEM_ARENA_WINDOW.
+ *
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if the image must be decoded sequentially
+ */
+esp_err_t app_jpeg_par_decode(const uint8_t *data, size_t size, app_img_out_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,491 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "app_mem.h"
+#include "app_audio_dec.h"
+#include "app_spectrum.h"
+#include "app_media.h"
+
+/* Longest audio block, commands are handled between blocks */
+#define MEDIA_BLOCK_MS          (20)
+#define MEDIA_TASK_STACK        (4096)
+#define MEDIA_TASK_PRIORITY     (6)
+
+static const char *TAG = "MEDIA";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef enum {
+    MEDIA_CMD_PLAY,
+    MEDIA_CMD_PLAY_STREAM,
+    MEDIA_CMD_PAUSE,
+    MEDIA_CMD_RESUME,
+    MEDIA_CMD_STOP,
+    MEDIA_CMD_SEEK,
+    MEDIA_CMD_VOLUME,
+    MEDIA_CMD_REPEAT,
+} media_cmd_id_t;
+
+typedef struct {
+    media_cmd_id_t id;
+    int32_t value;                      /*!< Frame, volume or repeat */
+    app_file_type_t type;
+    char path[APP_MEDIA_PATH_MAX];      /*!< Copied, the caller may free its string at once */
+    const app_audio_decoder_t *source;  /*!< Live stream */
+    void *source_ctx;
+    app_audio_info_t info;
+    SemaphoreHandle_t done;             /*!< Given when the command is handled (synchronous stop) */
+} media_cmd_t;
+
+typedef struct {
+    esp_codec_dev_handle_t codec;
+    app_media_state_cb_t state_cb;
+    void *user_data;
+
+    QueueHandle_t queue;
+    StaticQueue_t queue_buf;
+    uint8_t queue_storage[APP_MEDIA_QUEUE_LEN * sizeof(media_cmd_t)];
+    volatile app_media_state_t state;   /*!< Written only by the controller task */
+    /* Synchronous stop, one caller at a time waits for the controller */
+    SemaphoreHandle_t stop_lock;
+    StaticSemaphore_t stop_lock_buf;
+    SemaphoreHandle_t stop_done;
+    StaticSemaphore_t stop_done_buf;
+    bool repeat;
+
+    /* Opened file, owned by the controller task */
+    FILE *file;
+    const app_audio_decoder_t *decoder;
+    void *decoder_ctx;
+    app_audio_info_t info;
+    int16_t *block;
+    size_t block_size;
+    bool arena;
+    bool codec_open;
+    bool played;                        /*!< Something was played since the last seek */
+} media_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static media_t media;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void media_set_state(app_media_state_t state)
+{
+    if (media.state == state) {
+        return;
+    }
+    media.state = state;
+    if (media.state_cb) {
+        media.state_cb(state, media.user_data);
+    }
+}
+
+/* Release everything of the current file, the codec goes silent first */
+static void media_close(void)
+{
+    if (media.codec_open) {
+        esp_codec_dev_close(media.codec);
+        if (media.state == APP_MEDIA_STATE_PAUSED) {
+            esp_codec_dev_set_out_mute(media.codec, false);
+        }
+        media.codec_open = false;
+    }
+
+    if (media.decoder) {
+        media.decoder->close(media.decoder_ctx);
+        media.decoder = NULL;
+    }
+
+    if (media.file) {
+        fclose(media.file);
+        media.file = NULL;
+    }
+
+    if (media.arena) {
+        app_mem_arena_end(APP_MEM_ARENA_PLAY);
+        media.arena = false;
+    }
+    app_mem_pool_free(media.block);
+    media.block = NULL;
+}
+
+/* Block size and speaker format by media.info */
+static esp_err_t media_open_codec(void)
+{
+    ESP_LOGI(TAG, "Number of channels: %" PRIu16 "", media.info.channels);
+    ESP_LOGI(TAG, "Bits per sample: %" PRIu16 "", media.info.bits_per_sample);
+    ESP_LOGI(TAG, "Sample rate: %" PRIu32 "", media.info.sample_rate);
+    ESP_LOGI(TAG, "Length: %" PRIu32 " frames", media.info.total_frames);
+
+    /* Whole frames of at most MEDIA_BLOCK_MS, so the stop latency does not depend on the format */
+    const size_t frame_size = media.info.channels * media.info.bits_per_sample / 8;
+    if (frame_size == 0 || frame_size > APP_MEM_AUDIO_BLOCK_SIZE) {
+        ESP_LOGW(TAG, "Unsupported audio format");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    size_t block_size = (size_t)media.info.sample_rate * MEDIA_BLOCK_MS / 1000 * frame_size;
+    block_size = block_size < APP_MEM_AUDIO_BLOCK_SIZE ? block_size : APP_MEM_AUDIO_BLOCK_SIZE;
+    media.block_size = block_size > frame_size ? block_size / frame_size * frame_size : frame_size;
+
+    esp_codec_dev_sample_info_t fs = {
+        .sample_rate = media.info.sample_rate,
+        .channel = media.info.channels,
+        .bits_per_sample = media.info.bits_per_sample,
+        .mclk_multiple = I2S_MCLK_MULTIPLE_384,
+    };
+    if (esp_codec_dev_open(media.codec, &fs) != ESP_CODEC_DEV_OK) {
+        ESP_LOGE(TAG, "Speaker open failed!");
+        return ESP_FAIL;
+    }
+    media.codec_open = true;
+    media.played = false;
+
+    return ESP_OK;
+}
+
+static esp_err_t media_open(const char *path, app_file_type_t type)
+{
+    media.block = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    if (media.block == NULL) {
+        ESP_LOGE(TAG, "Not enough memory for playing!");
+        return ESP_ERR_NO_MEM;
+    }
+
+    /* Decoder state */
+    if (app_mem_arena_begin(APP_MEM_ARENA_PLAY) != ESP_OK) {
+        ESP_LOGE(TAG, "Playback memory is in use!");
+        return ESP_ERR_INVALID_STATE;
+    }
+    media.arena = true;
+
+    media.file = fopen(path, "rb");
+    if (media.file == NULL) {
+        ESP_LOGE(TAG, "%s file does not exist!", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* Find decoder by file type and stream format */
+    media.decoder = app_audio_dec_open(type, media.file, &media.decoder_ctx, &media.info);
+    if (media.decoder == NULL) {
+        ESP_LOGW(TAG, "Unsupported audio format");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    return media_open_codec();
+}
+
+/* Live source, it has its own state and buffers (no file, no arena) */
+static esp_err_t media_open_stream(const media_cmd_t *cmd)
+{
+    /* Owned from now on, closed by media_close() even if the playback fails */
+    media.decoder = cmd->source;
+    media.decoder_ctx = cmd->source_ctx;
+    media.info = cmd->info;
+    ESP_LOGI(TAG, "Stream: %s", media.decoder->name);
+
+    media.block = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    if (media.block == NULL) {
+        ESP_LOGE(TAG, "Not enough memory for playing!");
+        return ESP_ERR_NO_MEM;
+    }
+
+    return media_open_codec();
+}
+
+/* Decode and play one block */
+static void media_play_block(void)
+{
+    size_t bytes_decoded = 0;
+    esp_err_t ret = media.decoder->decode(media.decoder_ctx, media.block, media.block_size, &bytes_decoded);
+
+    if (bytes_decoded > 0) {
+        esp_codec_dev_write(media.codec, media.block, bytes_decoded);
+        if (media.info.bits_per_sample == 16) {
+            app_spectrum_feed(media.block, bytes_decoded / sizeof(int16_t) / media.info.channels,
+                              media.info.channels, media.info.sample_rate);
+        }
+        media.played = true;
+    }
+
+    if (ret != ESP_OK || bytes_decoded == 0) {
+        /* End of the file (an empty one is not repeated forever), streams are not repeated */
+        if (ret == ESP_OK && media.repeat && media.played && media.file) {
+            media.played = false;
+            media.decoder->seek(media.decoder_ctx, 0);
+            return;
+        }
+        media_close();
+        media_set_state(APP_MEDIA_STATE_IDLE);
+    }
+}
+
+/* State machine, see app_media_state_t */
+static void media_handle(const media_cmd_t *cmd)
+{
+    switch (cmd->id) {
+    case MEDIA_CMD_PLAY:
+        media_close();
+        if (media_open(cmd->path, cmd->type) == ESP_OK) {
+            media_set_state(APP_MEDIA_STATE_PLAYING);
+        } else {
+            media_close();
+            media_set_state(APP_MEDIA_STATE_IDLE);
+        }
+        break;
+    case MEDIA_CMD_PLAY_STREAM:
+        media_close();
+        if (media_open_stream(cmd) == ESP_OK) {
+            media_set_state(APP_MEDIA_STATE_PLAYING);
+        } else {
+            media_close();
+            media_set_state(APP_MEDIA_STATE_IDLE);
+        }
+        break;
+    case MEDIA_CMD_PAUSE:
+        if (media.state == APP_MEDIA_STATE_PLAYING) {
+            esp_codec_dev_set_out_mute(media.codec, true);
+            media_set_state(APP_MEDIA_STATE_PAUSED);
+        }
+        break;
+    case MEDIA_CMD_RESUME:
+        if (media.state == APP_MEDIA_STATE_PAUSED) {
+            esp_codec_dev_set_out_mute(media.codec, false);
+            media_set_state(APP_MEDIA_STATE_PLAYING);
+        }
+        break;
+    case MEDIA_CMD_STOP:
+        if (media.state != APP_MEDIA_STATE_IDLE) {
+            media_close();
+            media_set_state(APP_MEDIA_STATE_IDLE);
+        }
+        if (cmd->done) {
+            xSemaphoreGive(cmd->done);
+        }
+        break;
+    case MEDIA_CMD_SEEK:
+        if (media.state != APP_MEDIA_STATE_IDLE && media.file) {
+            media.played = false;
+            media.decoder->seek(media.decoder_ctx, (uint32_t)cmd->value);
+        }
+        break;
+    case MEDIA_CMD_VOLUME:
+        esp_codec_dev_set_out_vol(media.codec, cmd->value);
+        break;
+    case MEDIA_CMD_REPEAT:
+        media.repeat = (cmd->value != 0);
+        break;
+    }
+}
+
+static void media_task(void *arg)
+{
+    /* Passed in, media.queue is set only after the task is created */
+    QueueHandle_t queue = arg;
+    media_cmd_t cmd;
+
+    while (true) {
+        /* Sleep until a command comes, if nothing is played, otherwise only check the queue */
+        TickType_t wait = (media.state == APP_MEDIA_STATE_PLAYING) ? 0 : portMAX_DELAY;
+        while (xQueueReceive(queue, &cmd, wait) == pdTRUE) {
+            media_handle(&cmd);
+            wait = 0;
+        }
+
+        if (media.state == APP_MEDIA_STATE_PLAYING) {
+            media_play_block();
+        }
+    }
+}
+
+/* Pending commands are overridden by a stop, dropped stream sources are released here */
+static void media_drop_pending(void)
+{
+    media_cmd_t dropped;
+
+    while (xQueueReceive(media.queue, &dropped, 0) == pdTRUE) {
+        if (dropped.id == MEDIA_CMD_PLAY_STREAM) {
+            dropped.source->close(dropped.source_ctx);
+        }
+    }
+}
+
+static esp_err_t media_send(const media_cmd_t *cmd)
+{
+    if (media.queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* Never wait, the caller is usually the LVGL task, which the state callback may wait for */
+    if (xQueueSend(media.queue, cmd, 0) == pdTRUE) {
+        return ESP_OK;
+    }
+    if (cmd->id != MEDIA_CMD_STOP) {
+        ESP_LOGW(TAG, "Command queue is full");
+        return ESP_ERR_TIMEOUT;
+    }
+
+    /* The stop overrides all pending commands */
+    do {
+        media_drop_pending();
+    } while (xQueueSend(media.queue, cmd, 0) != pdTRUE);
+    return ESP_OK;
+}
+
+static esp_err_t media_send_value(media_cmd_id_t id, int32_t value)
+{
+    media_cmd_t cmd = {
+        .id = id,
+        .value = value,
+    };
+    return media_send(&cmd);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_media_init(const app_media_config_t *config)
+{
+    if (config == NULL || config->codec == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (media.queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    media.codec = config->codec;
+    media.state_cb = config->state_cb;
+    media.user_data = config->user_data;
+    media.state = APP_MEDIA_STATE_IDLE;
+    esp_codec_dev_set_out_vol(media.codec, config->volume);
+    media.stop_lock = xSemaphoreCreateMutexStatic(&media.stop_lock_buf);
+    media.stop_done = xSemaphoreCreateBinaryStatic(&media.stop_done_buf);
+
+    QueueHandle_t queue = xQueueCreateStatic(APP_MEDIA_QUEUE_LEN, sizeof(media_cmd_t), media.queue_storage, &media.queue_buf);
+    if (xTaskCreate(media_task, "media", MEDIA_TASK_STACK, queue, MEDIA_TASK_PRIORITY, NULL) != pdPASS) {
+        vQueueDelete(queue);
+        return ESP_ERR_NO_MEM;
+    }
+    /* Commands are accepted from now on */
+    media.queue = queue;
+
+    return ESP_OK;
+}
+
+esp_err_t app_media_play(const char *path, app_file_type_t type)
+{
+    media_cmd_t cmd = {
+        .id = MEDIA_CMD_PLAY,
+        .type = type,
+    };
+
+    if (path == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (strlen(path) >= sizeof(cmd.path)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    strcpy(cmd.path, path);
+
+    return media_send(&cmd);
+}
+
+esp_err_t app_media_play_stream(const app_audio_decoder_t *source, void *ctx, const app_audio_info_t *info)
+{
+    media_cmd_t cmd = {
+        .id = MEDIA_CMD_PLAY_STREAM,
+        .source = source,
+        .source_ctx = ctx,
+    };
+
+    if (source == NULL || source->decode == NULL || source->close == NULL || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    cmd.info = *info;
+
+    return media_send(&cmd);
+}
+
+esp_err_t app_media_pause(void)
+{
+    return media_send_value(MEDIA_CMD_PAUSE, 0);
+}
+
+esp_err_t app_media_resume(void)
+{
+    return media_send_value(MEDIA_CMD_RESUME, 0);
+}
+
+esp_err_t app_media_stop(void)
+{
+    return media_send_value(MEDIA_CMD_STOP, 0);
+}
+
+esp_err_t app_media_stop_sync(uint32_t timeout_ms)
+{
+    media_cmd_t cmd = {
+        .id = MEDIA_CMD_STOP,
+        .done = media.stop_done,
+    };
+    esp_err_t ret = ESP_ERR_TIMEOUT;
+
+    if (media.queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(media.stop_lock, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    /* A previous call may have timed out before the controller gave its completion */
+    xSemaphoreTake(media.stop_done, 0);
+    /* Nothing queued before the stop is started (a PLAY would open its file first) */
+    media_drop_pending();
+    if (media_send(&cmd) == ESP_OK && xSemaphoreTake(media.stop_done, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+        ret = ESP_OK;
+    }
+    xSemaphoreGive(media.stop_lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Stop not completed in %" PRIu32 " ms", timeout_ms);
+    }
+    return ret;
+}
+
+esp_err_t app_media_seek(uint32_t frame)
+{
+    return media_send_value(MEDIA_CMD_SEEK, (int32_t)frame);
+}
+
+esp_err_t app_media_set_volume(int volume)
+{
+    return media_send_value(MEDIA_CMD_VOLUME, volume);
+}
+
+esp_err_t app_media_set_repeat(bool repeat)
+{
+    return media_send_value(MEDIA_CMD_REPEAT, repeat);
+}
+
+app_media_state_t app_media_get_state(void)
+{
+    return media.state;
+}
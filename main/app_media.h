@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_codec_dev.h"
+#include "app_file_type.h"
+#include "app_audio_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximal length of the played file path, including terminating zero */
+#define APP_MEDIA_PATH_MAX      (250)
+/* Maximal number of pending commands */
+#define APP_MEDIA_QUEUE_LEN     (8)
+
+/**
+ * @brief Player state
+ *
+ *   IDLE    --play-->   PLAYING  (IDLE again, if the file cannot be opened)
+ *   PLAYING --pause-->  PAUSED   --resume--> PLAYING
+ *   PLAYING/PAUSED --stop or end of file--> IDLE
+ *   PLAYING/PAUSED --play--> PLAYING (the new file)
+ *
+ * Seek, volume and repeat do not change the state. Commands, which are not valid in the
+ * current state, are ignored.
+ */
+typedef enum {
+    APP_MEDIA_STATE_IDLE,
+    APP_MEDIA_STATE_PLAYING,
+    APP_MEDIA_STATE_PAUSED,
+} app_media_state_t;
+
+/**
+ * @brief State change callback, called from the controller task
+ *
+ * It must not wait for the controller (send commands with wait), the controller does not
+ * process commands until it returns.
+ */
+typedef void (*app_media_state_cb_t)(app_media_state_t state, void *user_data);
+
+typedef struct {
+    esp_codec_dev_handle_t codec;   /*!< Speaker, opened and closed by the controller task around each file */
+    int volume;                     /*!< Initial output volume */
+    app_media_state_cb_t state_cb;  /*!< Optional */
+    void *user_data;
+} app_media_config_t;
+
+/**
+ * @brief Start media controller task
+ *
+ * The controller owns the speaker, the decoder and the playback buffers. Playback is
+ * controlled only by commands (functions below), which are queued and never block the
+ * caller. The controller handles all pending commands between audio blocks of at most
+ * 20 ms of sound (not a fixed byte count), so a stop waits for one short block to be read
+ * and written at most. The queue and the task exist for the whole application lifetime,
+ * so there is no handle a command could use after it is freed.
+ */
+esp_err_t app_media_init(const app_media_config_t *config);
+
+/**
+ * @brief Play file, the current file is stopped first
+ *
+ * @param type File type, selects the audio decoder (app_audio_dec_open())
+ * @return ESP_ERR_INVALID_STATE if the controller is not started,
+ *         ESP_ERR_INVALID_SIZE if the path is too long,
+ *         ESP_ERR_TIMEOUT if the command queue is full
+ */
+esp_err_t app_media_play(const char *path, app_file_type_t type);
+
+/**
+ * @brief Play live stream (network audio), the current file is stopped first
+ *
+ * The source is not opened by the controller, it is already running: decode() fills the
+ * blocks in the info format and returns no data at the end of the stream, close() is called
+ * when the playback stops for any reason, also if this command is dropped by app_media_stop()
+ * (from the task calling it then). It is not repeated, seek does not apply.
+ * The source does not pace itself, the speaker write blocks the controller at the audio rate.
+ *
+ * @param ctx Passed to decode() and close()
+ * @return ESP_ERR_INVALID_ARG if decode or close is missing
+ */
+esp_err_t app_media_play_stream(const app_audio_decoder_t *source, void *ctx, const app_audio_info_t *info);
+
+/**
+ * @brief Pause playback (the output is muted, the codec stays open)
+ */
+esp_err_t app_media_pause(void);
+
+/**
+ * @brief Resume paused playback
+ */
+esp_err_t app_media_resume(void);
+
+/**
+ * @brief Stop playback and close the codec
+ *
+ * Stop is never lost: if the queue is full, the pending commands are dropped
+ * (they would be overridden by the stop) and the stop is queued instead. Streams of
+ * dropped commands are closed by the caller of this function.
+ */
+esp_err_t app_media_stop(void);
+
+/**
+ * @brief Stop playback and wait until the played file or stream is closed
+ *
+ * Pending commands are dropped (a queued play is never started) and the stop is queued.
+ * It returns after the controller has handled the stop: the file, the decoder and the
+ * codec are closed and the audio block is returned. Use it before writing to a file that
+ * may be played or before taking the speaker codec. It must not be called from the state
+ * callback.
+ *
+ * @param timeout_ms Maximal wait for the controller
+ * @return ESP_OK when stopped,
+ *         ESP_ERR_INVALID_STATE if the controller is not started,
+ *         ESP_ERR_TIMEOUT if the stop was not handled in time
+ */
+esp_err_t app_media_stop_sync(uint32_t timeout_ms);
+
+/**
+ * @brief Continue playback from frame (sample per channel)
+ */
+esp_err_t app_media_seek(uint32_t frame);
+
+/**
+ * @brief Set output volume
+ */
+esp_err_t app_media_set_volume(int volume);
+
+/**
+ * @brief Play the file again from the beginning, when its end is reached
+ */
+esp_err_t app_media_set_repeat(bool repeat);
+
+/**
+ * @brief Get the last state reported by the controller
+ */
+app_media_state_t app_media_get_state(void);
+
+#ifdef __cplusplus
+}
+#endif
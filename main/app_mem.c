@@ -0,0 +1,346 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "app_mem.h"
+
+/* Pool blocks are tracked by one bit each */
+#define APP_MEM_POOL_MAX_BLOCKS (32)
+#define APP_MEM_ALIGN(x)        (((x) + 3) & ~((size_t)3))
+/* An arena that cannot be reserved is halved down to this size, then disabled */
+#define APP_MEM_ARENA_MIN_SIZE  (4 * 1024)
+
+_Static_assert(CONFIG_APP_MEM_AUDIO_BLOCKS >= APP_MEM_AUDIO_BLOCK_USERS, "Audio pool smaller than its users");
+
+static const char *TAG = "MEM";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    const char *name;
+    size_t block_size;
+    uint32_t blocks;
+    app_mem_place_t place;
+    uint8_t *base;
+    uint32_t free_mask;         /*!< Set bit = free block */
+    uint32_t used;
+    uint32_t high_water;
+    uint32_t fails;
+} mem_pool_t;
+
+typedef struct {
+    const char *name;
+    size_t size;
+    app_mem_place_t place;
+    uint8_t *base;
+    size_t used;
+    size_t last;                /*!< Offset of the last allocation, SIZE_MAX if not known */
+    size_t high_water;
+    uint32_t fails;
+    bool busy;
+} mem_arena_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static portMUX_TYPE mem_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static mem_pool_t mem_pools[APP_MEM_POOL_MAX] = {
+    [APP_MEM_POOL_AUDIO] = {
+        .name = "audio",
+        .block_size = APP_MEM_AUDIO_BLOCK_SIZE,
+        .blocks = CONFIG_APP_MEM_AUDIO_BLOCKS,
+        .place = APP_MEM_PLACE_DMA,
+    },
+    [APP_MEM_POOL_IO] = {
+        .name = "io",
+        .block_size = APP_MEM_IO_BLOCK_SIZE,
+        .blocks = CONFIG_APP_MEM_IO_BLOCKS,
+        .place = APP_MEM_PLACE_INTERNAL,
+    },
+    [APP_MEM_POOL_FRAME] = {
+        .name = "frame",
+        .block_size = APP_MEM_FRAME_BLOCK_SIZE,
+        .blocks = 1,
+        .place = APP_MEM_PLACE_PSRAM,
+    },
+};
+
+static mem_arena_t mem_arenas[APP_MEM_ARENA_MAX] = {
+    [APP_MEM_ARENA_WINDOW] = {
+        .name = "window",
+        .size = CONFIG_APP_MEM_WINDOW_ARENA_KB * 1024,
+        .place = APP_MEM_PLACE_PSRAM,
+    },
+    [APP_MEM_ARENA_PLAY] = {
+        .name = "play",
+        .size = CONFIG_APP_MEM_PLAY_ARENA_KB * 1024,
+        .place = APP_MEM_PLACE_INTERNAL,
+    },
+    [APP_MEM_ARENA_REC] = {
+        .name = "rec",
+        .size = CONFIG_APP_MEM_REC_ARENA_KB * 1024,
+        .place = APP_MEM_PLACE_PSRAM,
+    },
+};
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void *mem_reserve(size_t size, app_mem_place_t place)
+{
+    void *ptr = NULL;
+
+    switch (place) {
+    case APP_MEM_PLACE_DMA:
+        ptr = heap_caps_malloc(size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        break;
+    case APP_MEM_PLACE_INTERNAL:
+        ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        break;
+    case APP_MEM_PLACE_PSRAM:
+        ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (ptr == NULL) {
+            ptr = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+        }
+        break;
+    }
+
+    return ptr;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_mem_init(void)
+{
+    /* Low memory reduces pools and arenas, the UI must start anyway: their users fail to allocate instead */
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        mem_pool_t *pool = &mem_pools[i];
+        uint32_t blocks = pool->blocks;
+        assert(pool->blocks <= APP_MEM_POOL_MAX_BLOCKS);
+        while (pool->blocks > 0 && (pool->base = mem_reserve(pool->block_size * pool->blocks, pool->place)) == NULL) {
+            pool->blocks--;
+        }
+        if (pool->blocks == 0) {
+            ESP_LOGW(TAG, "Cannot reserve %s pool (%" PRIu32 " x %zu B), disabled", pool->name, blocks, pool->block_size);
+            continue;
+        }
+        if (pool->blocks < blocks) {
+            ESP_LOGW(TAG, "Pool %s reduced to %" PRIu32 " of %" PRIu32 " blocks", pool->name, pool->blocks, blocks);
+        }
+        pool->free_mask = (pool->blocks == 32) ? UINT32_MAX : ((1UL << pool->blocks) - 1);
+    }
+
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        mem_arena_t *arena = &mem_arenas[i];
+        size_t size = arena->size;
+        while (arena->size >= APP_MEM_ARENA_MIN_SIZE && (arena->base = mem_reserve(arena->size, arena->place)) == NULL) {
+            arena->size = APP_MEM_ALIGN(arena->size / 2);
+        }
+        if (arena->base == NULL) {
+            ESP_LOGW(TAG, "Cannot reserve %s arena (%zu B), disabled", arena->name, size);
+            arena->size = 0;
+        } else if (arena->size < size) {
+            ESP_LOGW(TAG, "Arena %s reduced to %zu of %zu B", arena->name, arena->size, size);
+        }
+        arena->last = SIZE_MAX;
+    }
+
+    return ESP_OK;
+}
+
+void *app_mem_pool_alloc(app_mem_pool_id_t id)
+{
+    assert(id < APP_MEM_POOL_MAX);
+    mem_pool_t *pool = &mem_pools[id];
+    void *ptr = NULL;
+
+    taskENTER_CRITICAL(&mem_lock);
+    if (pool->free_mask) {
+        uint32_t block = __builtin_ctz(pool->free_mask);
+        pool->free_mask &= ~(1UL << block);
+        ptr = pool->base + block * pool->block_size;
+        pool->used++;
+        if (pool->used > pool->high_water) {
+            pool->high_water = pool->used;
+        }
+    } else {
+        pool->fails++;
+    }
+    taskEXIT_CRITICAL(&mem_lock);
+
+    if (ptr == NULL) {
+        ESP_LOGW(TAG, "Pool %s is empty", pool->name);
+    }
+
+    return ptr;
+}
+
+void app_mem_pool_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        mem_pool_t *pool = &mem_pools[i];
+        uint8_t *p = ptr;
+        if (pool->base && p >= pool->base && p < pool->base + pool->block_size * pool->blocks) {
+            uint32_t block = (p - pool->base) / pool->block_size;
+            taskENTER_CRITICAL(&mem_lock);
+            assert((pool->free_mask & (1UL << block)) == 0);
+            pool->free_mask |= (1UL << block);
+            pool->used--;
+            taskEXIT_CRITICAL(&mem_lock);
+            return;
+        }
+    }
+
+    ESP_LOGE(TAG, "Block %p is not from any pool", ptr);
+}
+
+esp_err_t app_mem_arena_begin(app_mem_arena_id_t id)
+{
+    assert(id < APP_MEM_ARENA_MAX);
+    mem_arena_t *arena = &mem_arenas[id];
+    esp_err_t ret = ESP_OK;
+
+    taskENTER_CRITICAL(&mem_lock);
+    if (arena->busy) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        arena->busy = true;
+        arena->used = 0;
+        arena->last = SIZE_MAX;
+    }
+    taskEXIT_CRITICAL(&mem_lock);
+
+    return ret;
+}
+
+void app_mem_arena_end(app_mem_arena_id_t id)
+{
+    assert(id < APP_MEM_ARENA_MAX);
+    mem_arena_t *arena = &mem_arenas[id];
+
+    taskENTER_CRITICAL(&mem_lock);
+    arena->busy = false;
+    arena->used = 0;
+    arena->last = SIZE_MAX;
+    taskEXIT_CRITICAL(&mem_lock);
+}
+
+void *app_mem_arena_alloc(app_mem_arena_id_t id, size_t size)
+{
+    assert(id < APP_MEM_ARENA_MAX);
+    mem_arena_t *arena = &mem_arenas[id];
+    void *ptr = NULL;
+
+    size = APP_MEM_ALIGN(size);
+
+    taskENTER_CRITICAL(&mem_lock);
+    if (arena->busy && size <= arena->size - arena->used) {
+        ptr = arena->base + arena->used;
+        arena->last = arena->used;
+        arena->used += size;
+        if (arena->used > arena->high_water) {
+            arena->high_water = arena->used;
+        }
+    } else {
+        arena->fails++;
+    }
+    taskEXIT_CRITICAL(&mem_lock);
+
+    if (ptr) {
+        memset(ptr, 0, size);
+    } else {
+        ESP_LOGW(TAG, "Arena %s: cannot allocate %zu B", arena->name, size);
+    }
+
+    return ptr;
+}
+
+void app_mem_arena_free(app_mem_arena_id_t id, void *ptr)
+{
+    assert(id < APP_MEM_ARENA_MAX);
+    mem_arena_t *arena = &mem_arenas[id];
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL(&mem_lock);
+    if (arena->last != SIZE_MAX && (uint8_t *)ptr == arena->base + arena->last) {
+        arena->used = arena->last;
+        arena->last = SIZE_MAX;
+    }
+    taskEXIT_CRITICAL(&mem_lock);
+}
+
+void app_mem_get_stats(app_mem_stats_t *stats)
+{
+    assert(stats != NULL);
+
+    taskENTER_CRITICAL(&mem_lock);
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        const mem_pool_t *pool = &mem_pools[i];
+        stats->pool[i] = (app_mem_pool_stats_t) {
+            .block_size = pool->block_size,
+            .blocks = pool->base ? pool->blocks : 0,
+            .used = pool->used,
+            .high_water = pool->high_water,
+            .fails = pool->fails,
+        };
+    }
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        const mem_arena_t *arena = &mem_arenas[i];
+        stats->arena[i] = (app_mem_arena_stats_t) {
+            .size = arena->size,
+            .used = arena->used,
+            .high_water = arena->high_water,
+            .fails = arena->fails,
+            .busy = arena->busy,
+        };
+    }
+    taskEXIT_CRITICAL(&mem_lock);
+
+    stats->heap_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    stats->heap_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+    stats->heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    stats->heap_frag = (stats->heap_free > 0) ? (uint8_t)(100 - (uint64_t)stats->heap_largest * 100 / stats->heap_free) : 0;
+}
+
+void app_mem_log_stats(void)
+{
+    app_mem_stats_t stats;
+
+    app_mem_get_stats(&stats);
+
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        const app_mem_pool_stats_t *pool = &stats.pool[i];
+        ESP_LOGI(TAG, "Pool %-6s: %" PRIu32 "/%" PRIu32 " x %zu B, high-water %" PRIu32 ", fails %" PRIu32, mem_pools[i].name,
+                 pool->used, pool->blocks, pool->block_size, pool->high_water, pool->fails);
+    }
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        const app_mem_arena_stats_t *arena = &stats.arena[i];
+        ESP_LOGI(TAG, "Arena %-6s: %zu/%zu B, high-water %zu B, fails %" PRIu32, mem_arenas[i].name,
+                 arena->used, arena->size, arena->high_water, arena->fails);
+    }
+    ESP_LOGI(TAG, "Internal heap: free %zu B (min %zu B), largest block %zu B, fragmentation %u %%",
+             stats.heap_free, stats.heap_min_free, stats.heap_largest, stats.heap_frag);
+}
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Media memory
+ *
+ * All media buffers are reserved once at startup, so opening and closing windows or playing
+ * and recording never allocates from the system heap and cannot fragment it over time.
+ *
+ * Pools hand out fixed-size blocks (audio I/O, file read chunks, the image viewer frame). Arenas are bump allocators
+ * owned by one window or task at a time. Everything allocated from an arena is released
+ * at once by app_mem_arena_end().
+ */
+
+/* Memory placement */
+typedef enum {
+    APP_MEM_PLACE_DMA,          /*!< Internal DMA capable RAM */
+    APP_MEM_PLACE_INTERNAL,     /*!< Internal RAM */
+    APP_MEM_PLACE_PSRAM,        /*!< PSRAM, internal RAM if no PSRAM is available */
+} app_mem_place_t;
+
+/* Fixed-size block pools */
+typedef enum {
+    APP_MEM_POOL_AUDIO,         /*!< Audio I/O blocks (APP_MEM_AUDIO_BLOCK_SIZE), DMA capable */
+    APP_MEM_POOL_IO,            /*!< File read chunks (APP_MEM_IO_BLOCK_SIZE) */
+    APP_MEM_POOL_FRAME,         /*!< Image viewer frame (APP_MEM_FRAME_BLOCK_SIZE), one block in PSRAM */
+    APP_MEM_POOL_MAX,
+} app_mem_pool_id_t;
+
+/* Arenas */
+typedef enum {
+    APP_MEM_ARENA_WINDOW,       /*!< File viewer window: image decoders, text viewer */
+    APP_MEM_ARENA_PLAY,         /*!< Playback task: audio decoders */
+    APP_MEM_ARENA_REC,          /*!< Recording task: VAD pre-roll */
+    APP_MEM_ARENA_MAX,
+} app_mem_arena_id_t;
+
+#define APP_MEM_AUDIO_BLOCK_SIZE    (1024)
+/* Audio blocks held at the same time: media playback, recording, VAD recording, video reader and video audio task */
+#define APP_MEM_AUDIO_BLOCK_USERS   (5)
+#define APP_MEM_IO_BLOCK_SIZE       (4096)
+/* Full screen of the display (320 x 240) in lv_color_t (3 B), the image decoders output into it */
+#define APP_MEM_FRAME_BLOCK_SIZE    (320 * 240 * 3)
+
+typedef struct {
+    size_t block_size;
+    uint32_t blocks;
+    uint32_t used;
+    uint32_t high_water;        /*!< Most blocks used at once */
+    uint32_t fails;             /*!< Allocations failed, because the pool was empty */
+} app_mem_pool_stats_t;
+
+typedef struct {
+    size_t size;
+    size_t used;
+    size_t high_water;          /*!< Most bytes used at once */
+    uint32_t fails;             /*!< Allocations failed, because the arena was full */
+    bool busy;                  /*!< Arena has an owner */
+} app_mem_arena_stats_t;
+
+typedef struct {
+    app_mem_pool_stats_t pool[APP_MEM_POOL_MAX];
+    app_mem_arena_stats_t arena[APP_MEM_ARENA_MAX];
+    size_t heap_free;           /*!< Free internal heap */
+    size_t heap_min_free;       /*!< Lowest free internal heap since boot */
+    size_t heap_largest;        /*!< Largest free internal heap block */
+    uint8_t heap_frag;          /*!< Internal heap fragmentation (0 - 100 %) */
+} app_mem_stats_t;
+
+/**
+ * @brief Reserve memory of all pools and arenas
+ *
+ * A pool or arena that does not fit is reduced (or disabled) with a warning, its users then fail
+ * to allocate instead of the whole UI.
+ *
+ * @return ESP_OK
+ */
+esp_err_t app_mem_init(void);
+
+/**
+ * @brief Take one block from pool
+ *
+ * @return Block or NULL, if the pool is empty
+ */
+void *app_mem_pool_alloc(app_mem_pool_id_t pool);
+
+/**
+ * @brief Return block to its pool, NULL is ignored
+ */
+void app_mem_pool_free(void *ptr);
+
+/**
+ * @brief Take ownership of arena
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the arena is already owned
+ */
+esp_err_t app_mem_arena_begin(app_mem_arena_id_t arena);
+
+/**
+ * @brief Release all arena allocations and give up the ownership
+ */
+void app_mem_arena_end(app_mem_arena_id_t arena);
+
+/**
+ * @brief Allocate zeroed memory (aligned to 4 bytes) from arena
+ *
+ * @return Memory or NULL, if the arena is full or not owned
+ */
+void *app_mem_arena_alloc(app_mem_arena_id_t arena, size_t size);
+
+/**
+ * @brief Free arena memory
+ *
+ * Only the last allocation is given back to the arena, the rest is released by app_mem_arena_end().
+ * NULL is ignored.
+ */
+void app_mem_arena_free(app_mem_arena_id_t arena, void *ptr);
+
+/**
+ * @brief Get usage of pools, arenas and internal heap
+ */
+void app_mem_get_stats(app_mem_stats_t *stats);
+
+/**
+ * @brief Print usage of pools, arenas and internal heap
+ */
+void app_mem_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
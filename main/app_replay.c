@@ -0,0 +1,656 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "bsp/esp-bsp.h"
+#include "lvgl.h"
+#include "sdkconfig.h"
+#include "app_replay.h"
+
+/* Touch is held this long by a tap (and the encoder button by enter) */
+#define REPLAY_PRESS_MS     (60)
+/* The replay task checks the progress of a step this often (timestamps are taken in LVGL) */
+#define REPLAY_POLL_MS      (5)
+/* Recorder samples the state of the input device this often */
+#define REPLAY_REC_MS       (10)
+#define REPLAY_LINE_MAX     (96)
+/* Matches APP_REPLAY_LABEL_MAX */
+#define REPLAY_LABEL_FMT    "%19s"
+#define REPLAY_NO_LABEL     (-1)
+
+static const char *TAG = "REPLAY";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef enum {
+    REPLAY_TAP,
+    REPLAY_ENC,
+    REPLAY_ENTER,
+    REPLAY_WAIT,
+} replay_op_t;
+
+typedef struct {
+    replay_op_t op;
+    int16_t x;
+    int16_t y;
+    int32_t value;              /*!< Encoder steps or pause in ms */
+    int8_t label;               /*!< REPLAY_NO_LABEL if not measured */
+} replay_step_t;
+
+typedef enum {
+    REPLAY_IDLE,
+    REPLAY_PRESS,
+    REPLAY_RELEASE,             /*!< Release (or encoder steps) is the measured input */
+} replay_phase_t;
+
+/* Shared by the replay task and the LVGL task, under the display lock */
+typedef struct {
+    lv_indev_t *indev;          /*!< Virtual input device */
+    lv_indev_t *target;         /*!< Input device of the display, disabled during the replay */
+    lv_display_t *display;
+    const replay_step_t *step;
+    replay_phase_t phase;
+    lv_point_t point;
+    bool pressed;               /*!< Press was read by LVGL */
+    int64_t input;              /*!< Time when LVGL read the input, 0 until then */
+    bool dirty;                 /*!< Areas invalidated since the input or the last frame */
+    uint32_t frames;
+    int64_t first;
+    int64_t last;
+} replay_t;
+
+typedef struct {
+    int8_t label;
+    bool frame;                 /*!< At least one frame was rendered */
+    bool settled;
+    uint32_t first;             /*!< us from the input */
+    uint32_t done;
+} replay_sample_t;
+
+typedef struct {
+    lv_timer_t *timer;
+    char *text;
+    size_t len;
+    bool full;
+    bool pressed;
+    lv_point_t point;
+    int64_t press;
+    int64_t release;
+    uint32_t taps;
+} replay_rec_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static replay_t replay;
+static replay_rec_t replay_rec;
+
+/* ESP32-S3-Box3 layout: tab buttons, the first file of the root list, close button of its window */
+const char app_replay_builtin_script[] =
+    "tap 160 20 tab.record\n"
+    "wait 200\n"
+    "tap 266 20 tab.settings\n"
+    "wait 200\n"
+    "tap 53 20 tab.files\n"
+    "wait 200\n"
+    "tap 160 130 file.open\n"
+    "wait 500\n"
+    "tap 290 30 file.close\n"
+    "wait 200\n";
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static int replay_label(char labels[][APP_REPLAY_LABEL_MAX], size_t *count, const char *label)
+{
+    for (size_t i = 0; i < *count; i++) {
+        if (strcmp(labels[i], label) == 0) {
+            return i;
+        }
+    }
+    if (*count >= APP_REPLAY_MAX_LABELS) {
+        return REPLAY_NO_LABEL;
+    }
+    strcpy(labels[*count], label);
+    return (*count)++;
+}
+
+static esp_err_t replay_parse(const char *script, replay_step_t *steps, size_t *count,
+                              char labels[][APP_REPLAY_LABEL_MAX], size_t *label_count)
+{
+    *count = 0;
+    *label_count = 0;
+
+    for (int line_no = 1; *script != '\0'; line_no++) {
+        char line[REPLAY_LINE_MAX];
+        size_t len = strcspn(script, "\n");
+        if (len >= sizeof(line)) {
+            ESP_LOGE(TAG, "Line %d: too long", line_no);
+            return ESP_ERR_INVALID_ARG;
+        }
+        memcpy(line, script, len);
+        line[len] = '\0';
+        script += len + (script[len] == '\n');
+        line[strcspn(line, "#\r")] = '\0';
+
+        char cmd[8], label[APP_REPLAY_LABEL_MAX] = "";
+        int a = 0, b = 0;
+        if (sscanf(line, "%7s", cmd) != 1) {
+            continue;
+        }
+        if (*count >= APP_REPLAY_MAX_STEPS) {
+            ESP_LOGE(TAG, "Line %d: more than %d steps", line_no, APP_REPLAY_MAX_STEPS);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        replay_step_t *step = &steps[*count];
+        bool valid = true;
+        if (strcmp(cmd, "tap") == 0) {
+            step->op = REPLAY_TAP;
+            valid = sscanf(line, "%*s %d %d " REPLAY_LABEL_FMT, &a, &b, label) >= 2;
+        } else if (strcmp(cmd, "enc") == 0) {
+            step->op = REPLAY_ENC;
+            valid = sscanf(line, "%*s %d " REPLAY_LABEL_FMT, &b, label) >= 1 && b != 0;
+        } else if (strcmp(cmd, "enter") == 0) {
+            step->op = REPLAY_ENTER;
+            sscanf(line, "%*s " REPLAY_LABEL_FMT, label);
+        } else if (strcmp(cmd, "wait") == 0) {
+            step->op = REPLAY_WAIT;
+            valid = sscanf(line, "%*s %d", &b) == 1 && b >= 0;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            ESP_LOGE(TAG, "Line %d: invalid step '%s'", line_no, line);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        step->x = a;
+        step->y = b;
+        step->value = b;
+        step->label = REPLAY_NO_LABEL;
+        if (label[0] != '\0') {
+            step->label = replay_label(labels, label_count, label);
+            if (step->label == REPLAY_NO_LABEL) {
+                ESP_LOGE(TAG, "Line %d: more than %d labels", line_no, APP_REPLAY_MAX_LABELS);
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+        (*count)++;
+    }
+    return ESP_OK;
+}
+
+static void replay_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    const replay_step_t *step = replay.step;
+
+    data->point = replay.point;
+    data->key = LV_KEY_ENTER;
+    data->state = LV_INDEV_STATE_RELEASED;
+    data->enc_diff = 0;
+
+    if (step == NULL) {
+        return;
+    }
+    switch (replay.phase) {
+    case REPLAY_PRESS:
+        data->state = LV_INDEV_STATE_PRESSED;
+        replay.pressed = true;
+        break;
+    case REPLAY_RELEASE:
+        if (step->op == REPLAY_ENC) {
+            data->enc_diff = step->value;
+        }
+        /* LVGL handles the input right after this read */
+        replay.input = esp_timer_get_time();
+        replay.phase = REPLAY_IDLE;
+        break;
+    default:
+        break;
+    }
+}
+
+static void replay_invalidate_cb(lv_event_t *e)
+{
+    if (replay.input != 0) {
+        replay.dirty = true;
+    }
+}
+
+static void replay_refr_cb(lv_event_t *e)
+{
+    if (replay.input != 0 && replay.dirty) {
+        /* The frame is rendered and passed to the panel */
+        int64_t now = esp_timer_get_time();
+        if (replay.frames++ == 0) {
+            replay.first = now;
+        }
+        replay.last = now;
+        replay.dirty = false;
+    }
+}
+
+static bool replay_supported(const replay_step_t *step, lv_indev_type_t type)
+{
+    switch (step->op) {
+    case REPLAY_TAP:
+        return type == LV_INDEV_TYPE_POINTER;
+    case REPLAY_ENC:
+    case REPLAY_ENTER:
+        return type == LV_INDEV_TYPE_ENCODER;
+    default:
+        return true;
+    }
+}
+
+/* Feed the step into LVGL and wait until it handles the input */
+static void replay_input(const replay_step_t *step, uint32_t timeout_ms)
+{
+    bsp_display_lock(0);
+    if (step->op == REPLAY_TAP) {
+        replay.point.x = step->x;
+        replay.point.y = step->y;
+    } else {
+        /* The UI moves the display input device between groups of tabs */
+        lv_indev_set_group(replay.indev, lv_indev_get_group(replay.target));
+    }
+    replay.pressed = false;
+    replay.input = 0;
+    replay.dirty = false;
+    replay.frames = 0;
+    replay.phase = (step->op == REPLAY_ENC) ? REPLAY_RELEASE : REPLAY_PRESS;
+    replay.step = step;
+    bsp_display_unlock();
+
+    if (replay.phase == REPLAY_PRESS) {
+        int64_t start = esp_timer_get_time();
+        bool pressed = false;
+        while (!pressed && esp_timer_get_time() - start < (int64_t)timeout_ms * 1000) {
+            vTaskDelay(pdMS_TO_TICKS(REPLAY_POLL_MS));
+            bsp_display_lock(0);
+            pressed = replay.pressed;
+            bsp_display_unlock();
+        }
+        vTaskDelay(pdMS_TO_TICKS(REPLAY_PRESS_MS));
+
+        bsp_display_lock(0);
+        replay.phase = REPLAY_RELEASE;
+        bsp_display_unlock();
+    }
+}
+
+/* Wait until the display settles after the input */
+static void replay_measure(const app_replay_config_t *config, replay_sample_t *sample)
+{
+    const int64_t start = esp_timer_get_time();
+    const int64_t settle = (int64_t)config->settle_ms * 1000;
+    const int64_t timeout = (int64_t)config->timeout_ms * 1000;
+
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(REPLAY_POLL_MS));
+
+        bsp_display_lock(0);
+        int64_t now = esp_timer_get_time();
+        bool settled = replay.input != 0 && replay.frames > 0 && now - replay.last >= settle;
+        if (settled || now - (replay.input ? replay.input : start) >= timeout) {
+            sample->frame = replay.frames > 0;
+            sample->settled = settled;
+            sample->first = sample->frame ? replay.first - replay.input : 0;
+            sample->done = sample->frame ? replay.last - replay.input : 0;
+            replay.step = NULL;
+            replay.phase = REPLAY_IDLE;
+            replay.input = 0;
+            bsp_display_unlock();
+            return;
+        }
+        bsp_display_unlock();
+    }
+}
+
+static int replay_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentiles of sorted values */
+static void replay_pct(uint32_t *values, size_t count, app_replay_pct_t *pct)
+{
+    memset(pct, 0, sizeof(app_replay_pct_t));
+    if (count == 0) {
+        return;
+    }
+    qsort(values, count, sizeof(uint32_t), replay_compare);
+    pct->p50 = values[(count * 50 + 99) / 100 - 1];
+    pct->p90 = values[(count * 90 + 99) / 100 - 1];
+    pct->p99 = values[(count * 99 + 99) / 100 - 1];
+    pct->max = values[count - 1];
+}
+
+static void replay_stats(const replay_sample_t *samples, size_t count, int label, uint32_t *values, app_replay_stats_t *stats)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (samples[i].label != label) {
+            continue;
+        }
+        if (!samples[i].frame) {
+            stats->no_frame++;
+            continue;
+        }
+        stats->unsettled += !samples[i].settled;
+        values[n++] = samples[i].first;
+    }
+    stats->count = n;
+    replay_pct(values, n, &stats->first);
+
+    n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (samples[i].label == label && samples[i].frame) {
+            values[n++] = samples[i].done;
+        }
+    }
+    replay_pct(values, n, &stats->done);
+}
+
+static void replay_rec_append(const char *fmt, int a, int b, int c)
+{
+    if (replay_rec.full) {
+        return;
+    }
+    int len = snprintf(replay_rec.text + replay_rec.len, APP_REPLAY_SCRIPT_MAX - replay_rec.len, fmt, a, b, c);
+    if (len < 0 || replay_rec.len + len >= APP_REPLAY_SCRIPT_MAX) {
+        ESP_LOGW(TAG, "Script is full, next taps are not recorded");
+        replay_rec.text[replay_rec.len] = '\0';
+        replay_rec.full = true;
+        return;
+    }
+    replay_rec.len += len;
+}
+
+static void replay_rec_timer_cb(lv_timer_t *timer)
+{
+    lv_indev_t *indev = lv_timer_get_user_data(timer);
+    bool pressed = (lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED);
+    int64_t now = esp_timer_get_time();
+
+    if (pressed && !replay_rec.pressed) {
+        lv_indev_get_point(indev, &replay_rec.point);
+        replay_rec.press = now;
+    } else if (!pressed && replay_rec.pressed) {
+        /* Pause since the last tap, the replay itself waits until the display settles */
+        if (replay_rec.release != 0) {
+            replay_rec_append("wait %d\n", (replay_rec.press - replay_rec.release) / 1000, 0, 0);
+        }
+        replay_rec.release = now;
+        replay_rec_append("tap %d %d tap%d\n", replay_rec.point.x, replay_rec.point.y, ++replay_rec.taps);
+    }
+    replay_rec.pressed = pressed;
+}
+
+#if CONFIG_APP_UI_REPLAY
+static void replay_task(void *arg)
+{
+#if CONFIG_APP_UI_REPLAY_RECORD
+    if (app_replay_record_start() == ESP_OK) {
+        ESP_LOGI(TAG, "Recording taps for %d s", CONFIG_APP_UI_REPLAY_RECORD_S);
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_APP_UI_REPLAY_RECORD_S * 1000));
+        app_replay_record_stop(APP_REPLAY_SCRIPT_PATH);
+    }
+#else
+    static app_replay_stats_t stats[APP_REPLAY_MAX_LABELS];
+    const app_replay_config_t config = {
+        .repeat = CONFIG_APP_UI_REPLAY_REPEAT,
+        .settle_ms = CONFIG_APP_UI_REPLAY_SETTLE_MS,
+        .timeout_ms = CONFIG_APP_UI_REPLAY_TIMEOUT_MS,
+        .budget_ms = CONFIG_APP_UI_REPLAY_BUDGET_MS,
+    };
+
+    /* Recorded script, or the built-in one */
+    const char *script = app_replay_builtin_script;
+    char *text = malloc(APP_REPLAY_SCRIPT_MAX);
+    FILE *file = fopen(APP_REPLAY_SCRIPT_PATH, "r");
+    if (text && file) {
+        size_t len = fread(text, 1, APP_REPLAY_SCRIPT_MAX - 1, file);
+        text[len] = '\0';
+        script = text;
+    }
+    if (file) {
+        fclose(file);
+    }
+    ESP_LOGI(TAG, "Replaying %s %" PRIu32 " times", script == text ? APP_REPLAY_SCRIPT_PATH : "built-in script", config.repeat);
+
+    size_t count = 0;
+    esp_err_t ret = app_replay_run(script, &config, stats, APP_REPLAY_MAX_LABELS, &count);
+    if (ret == ESP_OK || ret == ESP_FAIL) {
+        app_replay_log(stats, count);
+    }
+    if (ret == ESP_FAIL) {
+        ESP_LOGE(TAG, "UI latency regression: first frame p90 over %" PRIu32 " ms", config.budget_ms);
+    }
+    free(text);
+#endif
+    vTaskDelete(NULL);
+}
+#endif
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_replay_run(const char *script, const app_replay_config_t *config,
+                         app_replay_stats_t *stats, size_t max_stats, size_t *count)
+{
+    *count = 0;
+    if (replay.indev) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    replay_step_t *steps = malloc(APP_REPLAY_MAX_STEPS * sizeof(replay_step_t));
+    char (*labels)[APP_REPLAY_LABEL_MAX] = malloc(APP_REPLAY_MAX_LABELS * APP_REPLAY_LABEL_MAX);
+    size_t step_count = 0, label_count = 0;
+    if (steps == NULL || labels == NULL) {
+        free(steps);
+        free(labels);
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = replay_parse(script, steps, &step_count, labels, &label_count);
+
+    size_t measured = 0;
+    for (size_t i = 0; i < step_count; i++) {
+        measured += (steps[i].label != REPLAY_NO_LABEL);
+    }
+    const size_t sample_max = measured * config->repeat;
+    replay_sample_t *samples = malloc(sample_max * sizeof(replay_sample_t) + 1);
+    uint32_t *values = malloc(sample_max * sizeof(uint32_t) + 1);
+    if (ret == ESP_OK && (samples == NULL || values == NULL)) {
+        ret = ESP_ERR_NO_MEM;
+    }
+
+    bsp_display_lock(0);
+    replay.target = bsp_display_get_input_dev();
+    replay.display = lv_display_get_default();
+    if (ret == ESP_OK && (replay.target == NULL || replay.display == NULL)) {
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    lv_indev_type_t type = LV_INDEV_TYPE_NONE;
+    if (ret == ESP_OK) {
+        type = lv_indev_get_type(replay.target);
+        replay.step = NULL;
+        replay.phase = REPLAY_IDLE;
+        replay.input = 0;
+        replay.indev = lv_indev_create();
+        lv_indev_set_type(replay.indev, type);
+        lv_indev_set_read_cb(replay.indev, replay_read_cb);
+        lv_indev_set_display(replay.indev, replay.display);
+        lv_indev_enable(replay.target, false);
+        lv_display_add_event_cb(replay.display, replay_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+        lv_display_add_event_cb(replay.display, replay_refr_cb, LV_EVENT_REFR_READY, NULL);
+    }
+    bsp_display_unlock();
+    if (ret != ESP_OK) {
+        free(steps);
+        free(labels);
+        free(samples);
+        free(values);
+        return ret;
+    }
+
+    size_t skipped = 0;
+    for (size_t i = 0; i < step_count; i++) {
+        skipped += !replay_supported(&steps[i], type);
+    }
+    if (skipped) {
+        ESP_LOGW(TAG, "%zu steps for the other input device type are skipped", skipped);
+    }
+
+    size_t sample_count = 0;
+    for (uint32_t run = 0; run < config->repeat; run++) {
+        for (size_t i = 0; i < step_count; i++) {
+            const replay_step_t *step = &steps[i];
+            if (step->op == REPLAY_WAIT) {
+                vTaskDelay(pdMS_TO_TICKS(step->value));
+                continue;
+            }
+            if (!replay_supported(step, type)) {
+                continue;
+            }
+
+            replay_sample_t sample = { .label = step->label };
+            replay_input(step, config->timeout_ms);
+            replay_measure(config, &sample);
+            if (step->label != REPLAY_NO_LABEL) {
+                samples[sample_count++] = sample;
+            }
+        }
+    }
+
+    bsp_display_lock(0);
+    lv_display_remove_event_cb_with_user_data(replay.display, replay_invalidate_cb, NULL);
+    lv_display_remove_event_cb_with_user_data(replay.display, replay_refr_cb, NULL);
+    lv_indev_delete(replay.indev);
+    lv_indev_enable(replay.target, true);
+    replay.indev = NULL;
+    bsp_display_unlock();
+
+    for (size_t i = 0; i < label_count && i < max_stats; i++) {
+        app_replay_stats_t *s = &stats[i];
+        memset(s, 0, sizeof(app_replay_stats_t));
+        strcpy(s->label, labels[i]);
+        replay_stats(samples, sample_count, i, values, s);
+        if (config->budget_ms && s->count && s->first.p90 > config->budget_ms * 1000) {
+            ret = ESP_FAIL;
+        }
+        (*count)++;
+    }
+
+    free(steps);
+    free(labels);
+    free(samples);
+    free(values);
+    return ret;
+}
+
+void app_replay_log(const app_replay_stats_t *stats, size_t count)
+{
+    ESP_LOGI(TAG, "%-20s %5s  %-31s  %-31s", "interaction", "n",
+             "first frame p50/p90/p99/max ms", "settled p50/p90/p99/max ms");
+    for (size_t i = 0; i < count; i++) {
+        const app_replay_stats_t *s = &stats[i];
+        const app_replay_pct_t *f = &s->first, *d = &s->done;
+        ESP_LOGI(TAG, "%-20s %5u  %7.1f %7.1f %7.1f %7.1f  %7.1f %7.1f %7.1f %7.1f%s", s->label, s->count,
+                 f->p50 / 1000.0f, f->p90 / 1000.0f, f->p99 / 1000.0f, f->max / 1000.0f,
+                 d->p50 / 1000.0f, d->p90 / 1000.0f, d->p99 / 1000.0f, d->max / 1000.0f,
+                 s->unsettled ? " (not settled)" : "");
+        if (s->no_frame) {
+            ESP_LOGW(TAG, "%s: %u inputs without a redraw", s->label, s->no_frame);
+        }
+    }
+}
+
+esp_err_t app_replay_record_start(void)
+{
+    if (replay_rec.timer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    replay_rec.text = malloc(APP_REPLAY_SCRIPT_MAX);
+    if (replay_rec.text == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    replay_rec.len = 0;
+    replay_rec.full = false;
+    replay_rec.pressed = false;
+    replay_rec.release = 0;
+    replay_rec.taps = 0;
+    replay_rec_append("# Recorded taps, rename the labels\n", 0, 0, 0);
+
+    esp_err_t ret = ESP_OK;
+    bsp_display_lock(0);
+    lv_indev_t *indev = bsp_display_get_input_dev();
+    if (indev && lv_indev_get_type(indev) == LV_INDEV_TYPE_POINTER) {
+        replay_rec.timer = lv_timer_create(replay_rec_timer_cb, REPLAY_REC_MS, indev);
+    } else {
+        ret = ESP_ERR_NOT_SUPPORTED;
+    }
+    bsp_display_unlock();
+
+    if (ret != ESP_OK) {
+        free(replay_rec.text);
+        replay_rec.text = NULL;
+    }
+    return ret;
+}
+
+esp_err_t app_replay_record_stop(const char *path)
+{
+    if (replay_rec.timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bsp_display_lock(0);
+    lv_timer_del(replay_rec.timer);
+    replay_rec.timer = NULL;
+    bsp_display_unlock();
+
+    ESP_LOGI(TAG, "Recorded %" PRIu32 " taps:\n%s", replay_rec.taps, replay_rec.text);
+    esp_err_t ret = ESP_OK;
+    if (path) {
+        FILE *file = fopen(path, "w");
+        if (file == NULL || fputs(replay_rec.text, file) < 0) {
+            ESP_LOGE(TAG, "Cannot write %s", path);
+            ret = ESP_FAIL;
+        }
+        if (file) {
+            fclose(file);
+        }
+    }
+    free(replay_rec.text);
+    replay_rec.text = NULL;
+    return ret;
+}
+
+esp_err_t app_replay_start(void)
+{
+#if CONFIG_APP_UI_REPLAY
+    if (xTaskCreate(replay_task, "replay", 4096, NULL, tskIDLE_PRIORITY + 2, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
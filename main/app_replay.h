@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "app_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Script replayed at boot (CONFIG_APP_UI_REPLAY_RUN) and written by the recorder */
+#define APP_REPLAY_SCRIPT_PATH  APP_STORAGE_MOUNT_POINT "/replay.txt"
+/* Maximal script size and number of steps */
+#define APP_REPLAY_SCRIPT_MAX   (4096)
+#define APP_REPLAY_MAX_STEPS    (128)
+/* Maximal number of labelled interactions and label length, including terminating zero */
+#define APP_REPLAY_MAX_LABELS   (16)
+#define APP_REPLAY_LABEL_MAX    (20)
+
+/* Built-in script, replayed if there is no recorded one: every tab, open and close a file */
+extern const char app_replay_builtin_script[];
+
+typedef struct {
+    uint32_t repeat;            /*!< Number of script runs */
+    uint32_t settle_ms;         /*!< An interaction is done, when no frame is rendered for this time */
+    uint32_t timeout_ms;        /*!< Maximal time from the input to the end of an interaction */
+    uint32_t budget_ms;         /*!< Maximal p90 of the first frame latency, 0 for no check */
+} app_replay_config_t;
+
+/**
+ * @brief Latency percentiles, in microseconds
+ */
+typedef struct {
+    uint32_t p50;
+    uint32_t p90;
+    uint32_t p99;
+    uint32_t max;
+} app_replay_pct_t;
+
+/**
+ * @brief Latency of one labelled interaction over all runs
+ */
+typedef struct {
+    char label[APP_REPLAY_LABEL_MAX];
+    uint16_t count;             /*!< Measured inputs (with at least one frame) */
+    uint16_t no_frame;          /*!< Inputs, after which nothing was redrawn until the timeout */
+    uint16_t unsettled;         /*!< Inputs, after which frames were still rendered at the timeout */
+    app_replay_pct_t first;     /*!< Input to the first rendered frame with its result */
+    app_replay_pct_t done;      /*!< Input to the last frame before the display settled */
+} app_replay_stats_t;
+
+/**
+ * @brief Replay input script and measure input-to-render latency
+ *
+ * The script is text, one step per line ('#' starts a comment):
+ *
+ *   tap X Y [LABEL]     press and release the touch at X, Y (the release is the input)
+ *   enc N [LABEL]       rotate the encoder by N steps
+ *   enter [LABEL]       press and release the encoder button
+ *   wait MS             pause
+ *
+ * During the replay, the input device of the display is disabled and a virtual one of the
+ * same type feeds the steps into LVGL. Each input is timestamped when LVGL reads it, then
+ * every frame rendered with areas invalidated after the input is timestamped, until no frame
+ * is rendered for settle_ms. Only then the next step starts, so the replay does not depend
+ * on how fast the UI is. Steps of the other input type are skipped.
+ *
+ * It blocks until all runs finish, call it from a task other than the LVGL task.
+ *
+ * @param stats Latency of each label, in the order of first appearance
+ * @param count Number of labels
+ * @return ESP_ERR_INVALID_ARG if the script cannot be parsed,
+ *         ESP_FAIL if a first frame latency p90 is over the budget
+ */
+esp_err_t app_replay_run(const char *script, const app_replay_config_t *config,
+                         app_replay_stats_t *stats, size_t max_stats, size_t *count);
+
+/**
+ * @brief Log latency table
+ */
+void app_replay_log(const app_replay_stats_t *stats, size_t count);
+
+/**
+ * @brief Start recording taps of the display input device into a script
+ *
+ * Taps only, encoder steps are written by hand.
+ */
+esp_err_t app_replay_record_start(void);
+
+/**
+ * @brief Stop recording, log the script and save it to path (if not NULL)
+ */
+esp_err_t app_replay_record_stop(const char *path);
+
+/**
+ * @brief Boot stage: replay APP_REPLAY_SCRIPT_PATH (or the built-in script) or record it,
+ *        as configured by CONFIG_APP_UI_REPLAY_MODE, in a background task
+ */
+esp_err_t app_replay_start(void);
+
+#ifdef __cplusplus
+}
+#endif
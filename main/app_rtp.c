@@ -0,0 +1,443 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "app_media.h"
+#include "app_rtp.h"
+
+#define RTP_VERSION             (2)
+#define RTP_HEADER_SIZE         (12)
+#define RTP_TASK_STACK          (4096)
+/* Above the media task, packets are taken from the socket as soon as they come */
+#define RTP_TASK_PRIORITY       (7)
+/* The receiver checks the stop request and logs statistics this often */
+#define RTP_RECV_TIMEOUT_MS     (100)
+
+static const char *TAG = "RTP";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    app_rtp_config_t config;
+    SemaphoreHandle_t lock;         /*!< Jitter buffer and stream state, shared with the media task */
+    SemaphoreHandle_t done;         /*!< Given by the receiver task, when it exits */
+    volatile bool running;
+    int sock;
+
+    /* Current stream */
+    app_jitter_t jitter;
+    bool jitter_ready;
+    uint32_t session;               /*!< Stream counter, playback context of the stream */
+    bool active;                    /*!< Packets come (within the timeout) */
+    bool attached;                  /*!< Played by the media controller */
+    bool ignored;                   /*!< Stopped by the user, packets are dropped until it ends */
+    uint32_t ssrc;
+    uint32_t sample_rate;
+    uint16_t channels;
+    int64_t last_us;                /*!< Last packet */
+    int64_t stats_us;               /*!< Last statistics log */
+
+    app_rtp_stats_t stats;
+    uint8_t buf[APP_RTP_MAX_PACKET] __attribute__((aligned(4)));
+} rtp_t;
+
+/*******************************************************************************
+* Function definitions
+*******************************************************************************/
+static esp_err_t rtp_source_decode(void *ctx, void *out, size_t len, size_t *out_len);
+static void rtp_source_close(void *ctx);
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static rtp_t rtp = {
+    .sock = -1,
+};
+
+/* Playback of the stream by the media controller */
+static const app_audio_decoder_t rtp_source = {
+    .name = "RTP L16",
+    .type = APP_FILE_TYPE_UNKNOWN,
+    .decode = rtp_source_decode,
+    .close = rtp_source_close,
+};
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void rtp_fill_stats(app_rtp_stats_t *stats)
+{
+    *stats = rtp.stats;
+    if (rtp.jitter_ready) {
+        app_jitter_get_stats(&rtp.jitter, &stats->jitter);
+    }
+    stats->ssrc = rtp.ssrc;
+    stats->playing = rtp.attached;
+}
+
+static bool rtp_timed_out(int64_t now)
+{
+    return now - rtp.last_us > (int64_t)rtp.config.timeout_ms * 1000;
+}
+
+/* Called by the media task at the audio output rate */
+static esp_err_t rtp_source_decode(void *ctx, void *out, size_t len, size_t *out_len)
+{
+    app_rtp_stats_t stats;
+    bool ended = false;
+
+    *out_len = 0;
+    xSemaphoreTake(rtp.lock, portMAX_DELAY);
+    if (rtp.attached && (uint32_t)(uintptr_t)ctx == rtp.session) {
+        if (rtp_timed_out(esp_timer_get_time())) {
+            /* No data, the media controller closes the playback */
+            rtp.active = false;
+            ended = true;
+            rtp_fill_stats(&stats);
+        } else {
+            size_t frames = len / (rtp.channels * sizeof(int16_t));
+            app_jitter_read(&rtp.jitter, out, frames);
+            *out_len = frames * rtp.channels * sizeof(int16_t);
+        }
+    }
+    xSemaphoreGive(rtp.lock);
+
+    if (ended) {
+        ESP_LOGI(TAG, "Stream %08" PRIx32 " ended", stats.ssrc);
+        app_rtp_log_stats(&stats);
+    }
+    return ESP_OK;
+}
+
+/* Playback stopped: the stream ended, the user stopped it or played a file */
+static void rtp_source_close(void *ctx)
+{
+    xSemaphoreTake(rtp.lock, portMAX_DELAY);
+    if (rtp.attached && (uint32_t)(uintptr_t)ctx == rtp.session) {
+        rtp.attached = false;
+        rtp.ignored = rtp.active;
+    }
+    xSemaphoreGive(rtp.lock);
+}
+
+/* Start new stream by its first packet (lock taken) */
+static esp_err_t rtp_new_stream(const app_rtp_packet_t *packet)
+{
+    if (!rtp.jitter_ready || packet->sample_rate != rtp.sample_rate || packet->channels != rtp.channels) {
+        const app_jitter_config_t config = {
+            .sample_rate = packet->sample_rate,
+            .channels = packet->channels,
+            .max_packet_frames = (APP_RTP_MAX_PACKET - RTP_HEADER_SIZE) / (packet->channels * sizeof(int16_t)),
+            .slots = APP_RTP_JITTER_SLOTS,
+            .min_delay_ms = rtp.config.min_delay_ms,
+            .max_delay_ms = rtp.config.max_delay_ms,
+            .max_ppm = rtp.config.max_ppm,
+        };
+        if (rtp.jitter_ready) {
+            app_jitter_deinit(&rtp.jitter);
+            rtp.jitter_ready = false;
+        }
+        esp_err_t ret = app_jitter_init(&rtp.jitter, &config);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Jitter buffer init failed: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        rtp.jitter_ready = true;
+        rtp.sample_rate = packet->sample_rate;
+        rtp.channels = packet->channels;
+    } else {
+        app_jitter_reset(&rtp.jitter);
+    }
+
+    rtp.ssrc = packet->ssrc;
+    rtp.session++;
+    rtp.active = true;
+    rtp.attached = true;
+    rtp.ignored = false;
+    rtp.stats.streams++;
+    return ESP_OK;
+}
+
+static void rtp_receive(const app_rtp_packet_t *packet, int64_t now)
+{
+    bool start = false;
+    bool replaced = false;
+    uint32_t session = 0;
+    app_audio_info_t info = { 0 };
+    app_rtp_stats_t stats;
+
+    xSemaphoreTake(rtp.lock, portMAX_DELAY);
+    if (!rtp.active || rtp_timed_out(now) || packet->ssrc != rtp.ssrc ||
+            packet->sample_rate != rtp.sample_rate || packet->channels != rtp.channels) {
+        /* Not ended by the playback (replaced by another source, or paused) */
+        if (rtp.active) {
+            replaced = true;
+            rtp_fill_stats(&stats);
+        }
+        if (rtp_new_stream(packet) != ESP_OK) {
+            xSemaphoreGive(rtp.lock);
+            return;
+        }
+        start = true;
+        session = rtp.session;
+        info.sample_rate = rtp.sample_rate;
+        info.channels = rtp.channels;
+        info.bits_per_sample = 16;
+        rtp.stats_us = now;
+    }
+    rtp.last_us = now;
+
+    if (rtp.ignored) {
+        rtp.stats.ignored++;
+    } else {
+        app_jitter_put(&rtp.jitter, packet->seq, packet->ts, packet->pcm, packet->frames, now);
+    }
+    xSemaphoreGive(rtp.lock);
+
+    if (replaced) {
+        ESP_LOGI(TAG, "Stream %08" PRIx32 " ended", stats.ssrc);
+        app_rtp_log_stats(&stats);
+    }
+    if (start) {
+        ESP_LOGI(TAG, "Stream %08" PRIx32 ": %" PRIu32 " Hz, %" PRIu16 " channel(s)", packet->ssrc, info.sample_rate, info.channels);
+        /* The previous stream (if any) gets no more data, the file playback is stopped */
+        if (app_media_play_stream(&rtp_source, (void *)(uintptr_t)session, &info) != ESP_OK) {
+            ESP_LOGW(TAG, "Stream cannot be played");
+            xSemaphoreTake(rtp.lock, portMAX_DELAY);
+            rtp.attached = false;
+            rtp.ignored = true;
+            xSemaphoreGive(rtp.lock);
+        }
+    }
+}
+
+static void rtp_task(void *arg)
+{
+    app_rtp_packet_t packet;
+    app_rtp_stats_t stats;
+
+    while (rtp.running) {
+        int len = recv(rtp.sock, rtp.buf, sizeof(rtp.buf), 0);
+        int64_t now = esp_timer_get_time();
+
+        if (len > 0) {
+            rtp.stats.datagrams++;
+            if (app_rtp_parse(rtp.buf, len, &rtp.config, &packet) == ESP_OK) {
+                rtp_receive(&packet, now);
+            } else {
+                rtp.stats.invalid++;
+            }
+        }
+
+        /* Statistics while streaming */
+        bool log = false;
+        xSemaphoreTake(rtp.lock, portMAX_DELAY);
+        if (rtp.config.stats_period_ms > 0 && rtp.attached && !rtp_timed_out(now) &&
+                now - rtp.stats_us >= (int64_t)rtp.config.stats_period_ms * 1000) {
+            rtp.stats_us = now;
+            rtp_fill_stats(&stats);
+            log = true;
+        }
+        xSemaphoreGive(rtp.lock);
+        if (log) {
+            app_rtp_log_stats(&stats);
+        }
+    }
+
+    xSemaphoreGive(rtp.done);
+    vTaskDelete(NULL);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t app_rtp_parse(uint8_t *data, size_t len, const app_rtp_config_t *config, app_rtp_packet_t *packet)
+{
+    if (len < RTP_HEADER_SIZE || (data[0] >> 6) != RTP_VERSION) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    /* CSRC list and header extension */
+    size_t offset = RTP_HEADER_SIZE + (data[0] & 0x0F) * 4;
+    if (data[0] & 0x10) {
+        if (len < offset + 4) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        offset += 4 + (((size_t)data[offset + 2] << 8) | data[offset + 3]) * 4;
+    }
+    if (len < offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* Padding, the last byte is its length */
+    if (data[0] & 0x20) {
+        if (data[len - 1] > len - offset) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        len -= data[len - 1];
+    }
+
+    packet->marker = (data[1] & 0x80) != 0;
+    packet->payload_type = data[1] & 0x7F;
+    packet->seq = ((uint16_t)data[2] << 8) | data[3];
+    packet->ts = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) | ((uint32_t)data[6] << 8) | data[7];
+    packet->ssrc = ((uint32_t)data[8] << 24) | ((uint32_t)data[9] << 16) | ((uint32_t)data[10] << 8) | data[11];
+
+    switch (packet->payload_type) {
+    case APP_RTP_PT_L16_STEREO:
+        packet->sample_rate = 44100;
+        packet->channels = 2;
+        break;
+    case APP_RTP_PT_L16_MONO:
+        packet->sample_rate = 44100;
+        packet->channels = 1;
+        break;
+    default:
+        if (packet->payload_type < APP_RTP_PT_DYNAMIC) {
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        packet->sample_rate = config->sample_rate;
+        packet->channels = config->channels;
+        break;
+    }
+
+    /* Whole frames of big-endian samples, the offset is a multiple of 4 */
+    size_t size = len - offset;
+    size_t frame_size = packet->channels * sizeof(int16_t);
+    if (size == 0 || size % frame_size != 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t *payload = data + offset;
+    packet->pcm = (int16_t *)payload;
+    packet->frames = size / frame_size;
+    for (size_t i = 0; i < size; i += 2) {
+        packet->pcm[i / 2] = (int16_t)(((uint16_t)payload[i] << 8) | payload[i + 1]);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t app_rtp_start(const app_rtp_config_t *config)
+{
+    if (config == NULL || config->sample_rate == 0 || config->channels == 0 || config->channels > 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rtp.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    rtp.config = *config;
+    if (rtp.lock == NULL) {
+        rtp.lock = xSemaphoreCreateMutex();
+        rtp.done = xSemaphoreCreateBinary();
+        if (rtp.lock == NULL || rtp.done == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    rtp.sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (rtp.sock < 0) {
+        ESP_LOGE(TAG, "Socket create failed!");
+        return ESP_FAIL;
+    }
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(config->port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    struct timeval timeout = {
+        .tv_sec = 0,
+        .tv_usec = RTP_RECV_TIMEOUT_MS * 1000,
+    };
+    setsockopt(rtp.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (bind(rtp.sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        ESP_LOGE(TAG, "UDP port %" PRIu16 " bind failed!", config->port);
+        close(rtp.sock);
+        rtp.sock = -1;
+        return ESP_FAIL;
+    }
+
+    rtp.running = true;
+    if (xTaskCreate(rtp_task, "rtp", RTP_TASK_STACK, NULL, RTP_TASK_PRIORITY, NULL) != pdPASS) {
+        rtp.running = false;
+        close(rtp.sock);
+        rtp.sock = -1;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Listening on UDP port %" PRIu16, config->port);
+    return ESP_OK;
+}
+
+esp_err_t app_rtp_stop(void)
+{
+    if (!rtp.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    /* The receiver exits within RTP_RECV_TIMEOUT_MS */
+    rtp.running = false;
+    xSemaphoreTake(rtp.done, portMAX_DELAY);
+    close(rtp.sock);
+    rtp.sock = -1;
+
+    /* The media task may still call decode, it gets no data from now on */
+    xSemaphoreTake(rtp.lock, portMAX_DELAY);
+    bool attached = rtp.attached;
+    rtp.attached = false;
+    rtp.active = false;
+    rtp.session++;
+    if (rtp.jitter_ready) {
+        app_jitter_deinit(&rtp.jitter);
+        rtp.jitter_ready = false;
+    }
+    xSemaphoreGive(rtp.lock);
+
+    if (attached) {
+        app_media_stop();
+    }
+    return ESP_OK;
+}
+
+esp_err_t app_rtp_get_stats(app_rtp_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (rtp.lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(rtp.lock, portMAX_DELAY);
+    rtp_fill_stats(stats);
+    xSemaphoreGive(rtp.lock);
+    return ESP_OK;
+}
+
+void app_rtp_log_stats(const app_rtp_stats_t *stats)
+{
+    const app_jitter_stats_t *j = &stats->jitter;
+
+    ESP_LOGI(TAG, "Stream %08" PRIx32 ": %" PRIu32 " received (%" PRIu32 " reordered), %" PRIu32 " lost, %" PRIu32 " late, "
+             "%" PRIu32 " duplicate, %" PRIu32 " dropped, %" PRIu32 " underruns, %" PRIu32 " ms concealed",
+             stats->ssrc, j->received, j->reordered, j->lost, j->late, j->duplicate, j->dropped, j->underruns, j->concealed_ms);
+    ESP_LOGI(TAG, "Buffer %" PRIu16 " ms (target %" PRIu16 " ms), jitter %" PRIu16 " ms, drift %" PRId32 " ppm (resampling %" PRId32 " ppm)",
+             j->depth_ms, j->target_ms, j->jitter_ms, j->drift_ppm, j->ratio_ppm);
+}
@@ -0,0 +1,110 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "app_jitter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest accepted datagram (one Ethernet MTU, no IP fragments) */
+#define APP_RTP_MAX_PACKET      (1472)
+/* Static payload types of 16bit PCM (RFC 3551), 44.1 kHz */
+#define APP_RTP_PT_L16_STEREO   (10)
+#define APP_RTP_PT_L16_MONO     (11)
+/* Dynamic payload types are L16 in the configured format */
+#define APP_RTP_PT_DYNAMIC      (96)
+/* Buffered packets */
+#define APP_RTP_JITTER_SLOTS    (64)
+
+typedef struct {
+    uint16_t port;              /*!< UDP port to listen on (all interfaces) */
+    uint32_t sample_rate;       /*!< Format of the dynamic payload types */
+    uint16_t channels;
+    uint16_t min_delay_ms;      /*!< Range of the adaptive playout delay */
+    uint16_t max_delay_ms;
+    uint16_t max_ppm;           /*!< Largest resampling correction */
+    uint32_t timeout_ms;        /*!< The stream ends, when no packet comes for this long */
+    uint32_t stats_period_ms;   /*!< Statistics are logged while streaming, 0 for never */
+} app_rtp_config_t;
+
+/**
+ * @brief Receiver statistics
+ */
+typedef struct {
+    app_jitter_stats_t jitter;  /*!< Of the current (or the last) stream */
+    uint32_t datagrams;         /*!< All received datagrams */
+    uint32_t invalid;           /*!< Not RTP, unsupported payload type or odd length */
+    uint32_t ignored;           /*!< Packets of a stream stopped by the user */
+    uint32_t streams;           /*!< Started streams */
+    uint32_t ssrc;              /*!< Source of the current stream */
+    bool playing;
+} app_rtp_stats_t;
+
+/**
+ * @brief RTP packet (RFC 3550) with 16bit PCM payload
+ */
+typedef struct {
+    uint8_t payload_type;
+    uint16_t seq;
+    uint32_t ts;
+    uint32_t ssrc;
+    bool marker;
+    int16_t *pcm;               /*!< Payload converted to host byte order, in place */
+    size_t frames;
+    uint32_t sample_rate;
+    uint16_t channels;
+} app_rtp_packet_t;
+
+/**
+ * @brief Parse RTP packet with L16 payload (big-endian samples) and swap it to host order
+ *
+ * CSRC list, header extension and padding are skipped.
+ *
+ * @param data Datagram, 2-byte aligned, the payload is converted in place
+ * @param config Format of the dynamic payload types
+ * @return ESP_ERR_INVALID_ARG if it is not RTP version 2 or too short,
+ *         ESP_ERR_NOT_SUPPORTED for payload types other than L16,
+ *         ESP_ERR_INVALID_SIZE if the payload is not whole frames
+ */
+esp_err_t app_rtp_parse(uint8_t *data, size_t len, const app_rtp_config_t *config, app_rtp_packet_t *packet);
+
+/**
+ * @brief Start receiver task
+ *
+ * The first packet of a stream (new source, or after timeout_ms without packets) starts its
+ * playback by the media controller (app_media_play_stream()), the current file is stopped.
+ * If the user stops the stream, its packets are ignored until it ends. Packets go through the
+ * adaptive jitter buffer (app_jitter.h), which conceals losses and compensates the clock drift.
+ */
+esp_err_t app_rtp_start(const app_rtp_config_t *config);
+
+/**
+ * @brief Stop receiver task and the stream playback
+ */
+esp_err_t app_rtp_stop(void);
+
+/**
+ * @brief Get receiver statistics
+ *
+ * @return ESP_ERR_INVALID_STATE if the receiver is not started
+ */
+esp_err_t app_rtp_get_stats(app_rtp_stats_t *stats);
+
+/**
+ * @brief Log receiver statistics
+ */
+void app_rtp_log_stats(const app_rtp_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "app_fft.h"
+#include "app_spectrum.h"
+
+#if CONFIG_APP_SPECTRUM
+
+#define SPECTRUM_FFT_SIZE   CONFIG_APP_SPECTRUM_FFT_SIZE
+#define SPECTRUM_BARS       CONFIG_APP_SPECTRUM_BARS
+/* Tap ring (mono samples), holds one display period at 48 kHz and the FFT window */
+#define SPECTRUM_RING_SIZE  (4096)
+/* Display rate */
+#define SPECTRUM_PERIOD_MS  (33)
+/* Lowest bar starts here, the highest ends at Nyquist */
+#define SPECTRUM_MIN_FREQ   (50.0f)
+/* Bars show SPECTRUM_RANGE_DB ... 0 dBFS */
+#define SPECTRUM_RANGE_DB   (72)
+/* Bar fall-off per period, in % of the height */
+#define SPECTRUM_DECAY      (4)
+
+static const char *TAG = "SPECTRUM";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    /* Single producer (audio task), single consumer (analyzer) ring */
+    int16_t *ring;
+    atomic_uint head;           /*!< Written by the feeding task */
+    atomic_uint tail;           /*!< Written by the analyzer, the last FFT window stays unconsumed */
+    atomic_flag feeding;        /*!< Taken by the feeding task, other tasks drop their blocks */
+    atomic_uint sample_rate;
+    atomic_uint dropped;
+    atomic_int views;
+    atomic_bool idle;           /*!< Analyzer sleeps until the next block */
+
+    TaskHandle_t task;
+    app_fft_t fft;
+    int16_t *frame;
+    int16_t *db;
+    uint32_t bands_rate;
+    uint16_t band_start[SPECTRUM_BARS + 1];
+    uint8_t bars[SPECTRUM_BARS];    /*!< 0 ... 100, read by the LVGL timers */
+} spectrum_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static spectrum_t spectrum = {
+    .feeding = ATOMIC_FLAG_INIT,
+};
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+/* Log-spaced bin ranges of the bars, at least one bin each */
+static void spectrum_bands(uint32_t sample_rate)
+{
+    const uint32_t bins = SPECTRUM_FFT_SIZE / 2 + 1;
+    const float max_freq = sample_rate / 2.0f;
+    const float ratio = max_freq / SPECTRUM_MIN_FREQ;
+
+    for (int b = 0; b <= SPECTRUM_BARS; b++) {
+        float freq = SPECTRUM_MIN_FREQ * powf(ratio, (float)b / SPECTRUM_BARS);
+        uint32_t bin = lroundf(freq * SPECTRUM_FFT_SIZE / sample_rate);
+        if (b > 0 && bin <= spectrum.band_start[b - 1]) {
+            bin = spectrum.band_start[b - 1] + 1;
+        }
+        spectrum.band_start[b] = bin < bins ? bin : bins;
+    }
+    spectrum.bands_rate = sample_rate;
+}
+
+/* Analyze the newest window, returns false if there is nothing to show */
+static bool spectrum_update(void)
+{
+    const uint32_t tail = atomic_load_explicit(&spectrum.tail, memory_order_relaxed);
+    const uint32_t head = atomic_load_explicit(&spectrum.head, memory_order_acquire);
+    bool active = false;
+
+    if (head - tail > SPECTRUM_FFT_SIZE) {
+        for (uint32_t i = 0; i < SPECTRUM_FFT_SIZE; i++) {
+            spectrum.frame[i] = spectrum.ring[(head - SPECTRUM_FFT_SIZE + i) & (SPECTRUM_RING_SIZE - 1)];
+        }
+        /* Windows overlap, the newest samples are kept for the next one */
+        atomic_store_explicit(&spectrum.tail, head - SPECTRUM_FFT_SIZE, memory_order_release);
+
+        uint32_t sample_rate = atomic_load_explicit(&spectrum.sample_rate, memory_order_relaxed);
+        if (sample_rate != spectrum.bands_rate) {
+            spectrum_bands(sample_rate);
+        }
+        app_fft_power_db(&spectrum.fft, app_fft_real(&spectrum.fft, spectrum.frame, true), spectrum.db);
+
+        for (int b = 0; b < SPECTRUM_BARS; b++) {
+            int16_t peak = INT16_MIN;
+            for (uint32_t k = spectrum.band_start[b]; k < spectrum.band_start[b + 1]; k++) {
+                peak = spectrum.db[k] > peak ? spectrum.db[k] : peak;
+            }
+            int32_t level = ((int32_t)peak + SPECTRUM_RANGE_DB * 256) * 100 / (SPECTRUM_RANGE_DB * 256);
+            level = level < 0 ? 0 : (level > 100 ? 100 : level);
+            /* Fast attack, slow release */
+            int32_t fall = (int32_t)spectrum.bars[b] - SPECTRUM_DECAY;
+            spectrum.bars[b] = level > fall ? level : fall;
+        }
+        return true;
+    }
+
+    for (int b = 0; b < SPECTRUM_BARS; b++) {
+        spectrum.bars[b] = spectrum.bars[b] > SPECTRUM_DECAY ? spectrum.bars[b] - SPECTRUM_DECAY : 0;
+        active |= (spectrum.bars[b] > 0);
+    }
+    return active;
+}
+
+static void spectrum_task(void *arg)
+{
+    while (true) {
+        if (atomic_load(&spectrum.idle)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        vTaskDelay(pdMS_TO_TICKS(SPECTRUM_PERIOD_MS));
+
+        bool active = (atomic_load(&spectrum.views) > 0) && spectrum_update();
+        atomic_store(&spectrum.idle, !active);
+    }
+}
+
+static esp_err_t spectrum_start(void)
+{
+    esp_err_t ret = app_fft_init(&spectrum.fft, SPECTRUM_FFT_SIZE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    /* Ring, FFT frame and dB of the bins in one block */
+    spectrum.ring = heap_caps_malloc((SPECTRUM_RING_SIZE + SPECTRUM_FFT_SIZE + SPECTRUM_FFT_SIZE / 2 + 1) * sizeof(int16_t),
+                                     MALLOC_CAP_DEFAULT);
+    if (spectrum.ring == NULL) {
+        app_fft_deinit(&spectrum.fft);
+        return ESP_ERR_NO_MEM;
+    }
+    spectrum.frame = spectrum.ring + SPECTRUM_RING_SIZE;
+    spectrum.db = spectrum.frame + SPECTRUM_FFT_SIZE;
+    atomic_store(&spectrum.idle, true);
+
+    /* Below the audio and LVGL tasks, it only takes the idle time */
+    if (xTaskCreate(spectrum_task, "spectrum", 3072, NULL, tskIDLE_PRIORITY + 1, &spectrum.task) != pdPASS) {
+        heap_caps_free(spectrum.ring);
+        spectrum.ring = NULL;
+        app_fft_deinit(&spectrum.fft);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Started, %d point FFT, %d bars", SPECTRUM_FFT_SIZE, SPECTRUM_BARS);
+    return ESP_OK;
+}
+
+/* Copy the bars into the chart, LVGL context */
+static void spectrum_timer_cb(lv_timer_t *timer)
+{
+    lv_obj_t *chart = lv_timer_get_user_data(timer);
+    lv_chart_series_t *ser = lv_chart_get_series_next(chart, NULL);
+    int32_t *values = lv_chart_get_y_array(chart, ser);
+    bool changed = false;
+
+    for (int b = 0; b < SPECTRUM_BARS; b++) {
+        int32_t value = spectrum.bars[b];
+        if (values[b] != value) {
+            values[b] = value;
+            changed = true;
+        }
+    }
+    if (changed) {
+        lv_chart_refresh(chart);
+    }
+}
+
+static void spectrum_delete_cb(lv_event_t *e)
+{
+    lv_timer_del(lv_event_get_user_data(e));
+    atomic_fetch_sub(&spectrum.views, 1);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+void app_spectrum_feed(const int16_t *samples, size_t frames, uint16_t channels, uint32_t sample_rate)
+{
+    if (atomic_load_explicit(&spectrum.views, memory_order_acquire) == 0 || channels == 0) {
+        return;
+    }
+    if (atomic_flag_test_and_set_explicit(&spectrum.feeding, memory_order_acquire)) {
+        return;
+    }
+
+    const uint32_t head = atomic_load_explicit(&spectrum.head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&spectrum.tail, memory_order_acquire);
+    const size_t space = SPECTRUM_RING_SIZE - (head - tail);
+    if (frames > space) {
+        atomic_fetch_add_explicit(&spectrum.dropped, frames - space, memory_order_relaxed);
+        frames = space;
+    }
+
+    for (size_t i = 0; i < frames; i++) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < channels; c++) {
+            sum += samples[i * channels + c];
+        }
+        spectrum.ring[(head + i) & (SPECTRUM_RING_SIZE - 1)] = (int16_t)(sum / channels);
+    }
+
+    atomic_store_explicit(&spectrum.sample_rate, sample_rate, memory_order_relaxed);
+    atomic_store_explicit(&spectrum.head, head + frames, memory_order_release);
+    atomic_flag_clear_explicit(&spectrum.feeding, memory_order_release);
+
+    if (atomic_load_explicit(&spectrum.idle, memory_order_relaxed)) {
+        xTaskNotifyGive(spectrum.task);
+    }
+}
+
+lv_obj_t *app_spectrum_create(lv_obj_t *parent, int32_t width, int32_t height)
+{
+    if (spectrum.task == NULL && spectrum_start() != ESP_OK) {
+        ESP_LOGE(TAG, "Not enough memory for spectrum analyzer!");
+        return NULL;
+    }
+
+    lv_obj_t *chart = lv_chart_create(parent);
+    lv_obj_set_size(chart, width, height);
+    lv_chart_set_type(chart, LV_CHART_TYPE_BAR);
+    lv_chart_set_point_count(chart, SPECTRUM_BARS);
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, 100);
+    lv_chart_set_div_line_count(chart, 0, 0);
+    lv_obj_set_style_bg_color(chart, lv_color_black(), 0);
+    lv_obj_set_style_border_width(chart, 0, 0);
+    lv_obj_set_style_pad_all(chart, 2, 0);
+    lv_obj_set_style_pad_column(chart, 1, 0);
+    lv_obj_clear_flag(chart, LV_OBJ_FLAG_CLICKABLE);
+
+    lv_chart_series_t *ser = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_all_value(chart, ser, 0);
+
+    lv_timer_t *timer = lv_timer_create(spectrum_timer_cb, SPECTRUM_PERIOD_MS, chart);
+    lv_obj_add_event_cb(chart, spectrum_delete_cb, LV_EVENT_DELETE, timer);
+    atomic_fetch_add_explicit(&spectrum.views, 1, memory_order_release);
+
+    return chart;
+}
+
+#else
+
+void app_spectrum_feed(const int16_t *samples, size_t frames, uint16_t channels, uint32_t sample_rate)
+{
+}
+
+lv_obj_t *app_spectrum_create(lv_obj_t *parent, int32_t width, int32_t height)
+{
+    return NULL;
+}
+
+#endif
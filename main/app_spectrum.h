@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Feed PCM block of the audio path into the spectrum analyzer (lock-free tap)
+ *
+ * Called from playback and recording tasks. It never blocks: if no spectrum view is shown,
+ * it returns at once; if the analyzer falls behind or another task is feeding at the same
+ * time, the block is dropped. Channels are mixed down to mono.
+ *
+ * @param samples 16bit interleaved samples
+ * @param frames Number of frames (samples per channel)
+ */
+void app_spectrum_feed(const int16_t *samples, size_t frames, uint16_t channels, uint32_t sample_rate);
+
+/**
+ * @brief Create spectrum analyzer view (log-spaced bars)
+ *
+ * The analyzer task (low priority) is started on the first call. The view is updated at
+ * display rate while it exists, the tap is active only while at least one view exists.
+ *
+ * @return Chart object or NULL, if there is not enough memory or CONFIG_APP_SPECTRUM is disabled
+ */
+lv_obj_t *app_spectrum_create(lv_obj_t *parent, int32_t width, int32_t height);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,933 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_vfs.h"
+#include "esp_spiffs.h"
+#include "sdkconfig.h"
+#if CONFIG_APP_STORAGE_LITTLEFS
+#include "esp_littlefs.h"
+#endif
+#include "app_storage.h"
+
+#define STORAGE_CACHE_BLOCKS    CONFIG_APP_STORAGE_CACHE_BLOCKS
+#define STORAGE_READAHEAD       (CONFIG_APP_STORAGE_READAHEAD_BLOCKS < STORAGE_CACHE_BLOCKS ? \
+                                 CONFIG_APP_STORAGE_READAHEAD_BLOCKS : STORAGE_CACHE_BLOCKS)
+/* Files, which have (or may still have) blocks in the cache */
+#define STORAGE_MAX_NODES       (2 * APP_STORAGE_MAX_FILES)
+/* Files with longer path are not cached */
+#define STORAGE_NODE_PATH_MAX   (64)
+#define STORAGE_PATH_MAX        (sizeof(APP_STORAGE_BACKEND_PATH) + 256)
+#define STORAGE_MAX_DIRS        (2)
+#define STORAGE_NO_NODE         (-1)
+/* Descriptor taken by an open, whose backend file is being opened */
+#define STORAGE_FD_OPENING      (-2)
+/* Benchmark */
+#define STORAGE_BENCH_FILE      "/.bench.bin"
+#define STORAGE_BENCH_READ      (1024)
+#define STORAGE_BENCH_RAND_READ (512)
+
+static const char *TAG = "STORAGE";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    int16_t node;               /*!< STORAGE_NO_NODE if the block is free */
+    uint32_t index;             /*!< Block in the file */
+    uint32_t len;               /*!< Valid bytes, less than the block at the end of the file */
+    uint32_t used;              /*!< LRU stamp */
+    bool busy;                  /*!< Being filled by a backend read, not usable yet */
+} storage_block_t;
+
+typedef struct {
+    char path[STORAGE_NODE_PATH_MAX];   /*!< Relative to the mount point, empty if free */
+    uint8_t refs;               /*!< Open files */
+    uint32_t used;
+    uint32_t gen;               /*!< Incremented when the cached blocks are dropped */
+} storage_node_t;
+
+typedef struct {
+    int fd;                     /*!< Backend file, -1 if the descriptor is free */
+    int16_t node;               /*!< STORAGE_NO_NODE if the file is not cached */
+    bool append;
+    off_t pos;
+    off_t backend_pos;          /*!< Position of the backend file */
+    off_t next;                 /*!< End of the last read, a read from here is sequential */
+    SemaphoreHandle_t lock;     /*!< Operations of the descriptor, held during its backend I/O */
+    StaticSemaphore_t lock_buf;
+} storage_file_t;
+
+typedef struct {
+    DIR dir;                    /*!< Must be first, filled by VFS */
+    DIR *backend;               /*!< NULL if free */
+} storage_dir_t;
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+
+static const app_storage_backend_t *storage_backend = NULL;
+
+#if STORAGE_CACHE_BLOCKS > 0
+/*
+ * Block, node and descriptor tables and the statistics. Backend I/O runs under the lock of the
+ * file only, so a slow read of one file does not stall the cache hits of the others.
+ */
+static SemaphoreHandle_t storage_lock = NULL;
+static StaticSemaphore_t storage_lock_buf;
+static uint8_t *storage_mem = NULL;     /*!< Block data, one contiguous area, so read-ahead is one read */
+static storage_block_t storage_blocks[STORAGE_CACHE_BLOCKS];
+static storage_node_t storage_nodes[STORAGE_MAX_NODES];
+static storage_file_t storage_files[APP_STORAGE_MAX_FILES];
+static storage_dir_t storage_dirs[STORAGE_MAX_DIRS];
+static uint32_t storage_clock = 0;
+static app_storage_stats_t storage_stats;
+#endif
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static esp_err_t storage_spiffs_mount(const char *base_path, const char *partition, size_t max_files)
+{
+    const esp_vfs_spiffs_conf_t conf = {
+        .base_path = base_path,
+        .partition_label = partition,
+        .max_files = max_files,
+        .format_if_mount_failed = false,
+    };
+    return esp_vfs_spiffs_register(&conf);
+}
+
+static void storage_spiffs_unmount(const char *partition)
+{
+    esp_vfs_spiffs_unregister(partition);
+}
+
+static esp_err_t storage_spiffs_info(const char *partition, size_t *total, size_t *used)
+{
+    return esp_spiffs_info(partition, total, used);
+}
+
+#if CONFIG_APP_STORAGE_LITTLEFS
+static esp_err_t storage_littlefs_mount(const char *base_path, const char *partition, size_t max_files)
+{
+    /* Files are allocated on open, there is no limit */
+    const esp_vfs_littlefs_conf_t conf = {
+        .base_path = base_path,
+        .partition_label = partition,
+        .format_if_mount_failed = false,
+    };
+    return esp_vfs_littlefs_register(&conf);
+}
+
+static void storage_littlefs_unmount(const char *partition)
+{
+    esp_vfs_littlefs_unregister(partition);
+}
+
+static esp_err_t storage_littlefs_info(const char *partition, size_t *total, size_t *used)
+{
+    return esp_littlefs_info(partition, total, used);
+}
+#endif
+
+#if STORAGE_CACHE_BLOCKS > 0
+
+static void storage_backend_path(char *real, const char *path)
+{
+    snprintf(real, STORAGE_PATH_MAX, "%s%s", APP_STORAGE_BACKEND_PATH, path);
+}
+
+/* Open file of the descriptor with its lock taken, NULL if the descriptor is not open */
+static storage_file_t *storage_lock_file(int fd)
+{
+    if (fd < 0 || fd >= APP_STORAGE_MAX_FILES) {
+        errno = EBADF;
+        return NULL;
+    }
+
+    storage_file_t *file = &storage_files[fd];
+    xSemaphoreTake(file->lock, portMAX_DELAY);
+    if (file->fd < 0) {
+        xSemaphoreGive(file->lock);
+        errno = EBADF;
+        return NULL;
+    }
+    return file;
+}
+
+/* Forget cached blocks of the file, blocks being filled are not cached when the fill ends */
+static void storage_drop(int node)
+{
+    for (int i = 0; i < STORAGE_CACHE_BLOCKS; i++) {
+        if (storage_blocks[i].node == node) {
+            storage_blocks[i].node = STORAGE_NO_NODE;
+        }
+    }
+    storage_nodes[node].gen++;
+}
+
+/* Drop the cached blocks of an open file after its content changed */
+static void storage_drop_file(storage_file_t *file)
+{
+    if (file->node != STORAGE_NO_NODE) {
+        xSemaphoreTake(storage_lock, portMAX_DELAY);
+        storage_drop(file->node);
+        xSemaphoreGive(storage_lock);
+    }
+}
+
+static int storage_find_node(const char *path)
+{
+    for (int i = 0; i < STORAGE_MAX_NODES; i++) {
+        if (storage_nodes[i].path[0] != '\0' && strcmp(storage_nodes[i].path, path) == 0) {
+            return i;
+        }
+    }
+    return STORAGE_NO_NODE;
+}
+
+/* Node of the file, the least recently used closed file is forgotten if needed */
+static int storage_get_node(const char *path)
+{
+    int node = storage_find_node(path);
+    if (node != STORAGE_NO_NODE || strlen(path) >= STORAGE_NODE_PATH_MAX) {
+        return node;
+    }
+
+    uint32_t oldest = UINT32_MAX;
+    for (int i = 0; i < STORAGE_MAX_NODES; i++) {
+        if (storage_nodes[i].refs == 0 && storage_nodes[i].used < oldest) {
+            oldest = storage_nodes[i].used;
+            node = i;
+        }
+    }
+    if (node != STORAGE_NO_NODE) {
+        storage_drop(node);
+        strcpy(storage_nodes[node].path, path);
+    }
+    return node;
+}
+
+/* Forget the file, its content changed (unlink, rename) */
+static void storage_forget(const char *path)
+{
+    int node = storage_find_node(path);
+    if (node != STORAGE_NO_NODE) {
+        storage_drop(node);
+        if (storage_nodes[node].refs == 0) {
+            storage_nodes[node].path[0] = '\0';
+            storage_nodes[node].used = 0;
+        }
+    }
+}
+
+static ssize_t storage_backend_read(storage_file_t *file, off_t pos, void *dst, size_t size)
+{
+    if (file->backend_pos != pos) {
+        if (lseek(file->fd, pos, SEEK_SET) != pos) {
+            return -1;
+        }
+        file->backend_pos = pos;
+    }
+
+    ssize_t len = read(file->fd, dst, size);
+    if (len > 0) {
+        file->backend_pos += len;
+    }
+    return len;
+}
+
+static storage_block_t *storage_find_block(int node, uint32_t index)
+{
+    for (int i = 0; i < STORAGE_CACHE_BLOCKS; i++) {
+        if (storage_blocks[i].node == node && storage_blocks[i].index == index) {
+            return &storage_blocks[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Claim the run of up to count slots, whose newest block is the oldest, for blocks of the file
+ * from index, which are not in the cache. The run is shortened while other files fill the slots.
+ * Returns the first slot, -1 if all slots are being filled.
+ */
+static int storage_claim(int node, uint32_t index, uint32_t *count)
+{
+    /* Blocks already in the cache are not read again */
+    for (uint32_t k = 1; k < *count; k++) {
+        if (storage_find_block(node, index + k)) {
+            *count = k;
+            break;
+        }
+    }
+
+    for (; *count > 0; (*count)--) {
+        int start = -1;
+        uint32_t best = UINT32_MAX;
+        for (int s = 0; s + (int)*count <= STORAGE_CACHE_BLOCKS; s++) {
+            uint32_t newest = 0;
+            bool busy = false;
+            for (uint32_t k = 0; k < *count; k++) {
+                newest = storage_blocks[s + k].used > newest ? storage_blocks[s + k].used : newest;
+                busy |= storage_blocks[s + k].busy;
+            }
+            if (!busy && newest < best) {
+                best = newest;
+                start = s;
+            }
+        }
+        if (start >= 0) {
+            for (uint32_t k = 0; k < *count; k++) {
+                storage_blocks[start + k].node = STORAGE_NO_NODE;
+                storage_blocks[start + k].used = 0;
+                storage_blocks[start + k].busy = true;
+            }
+            return start;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Read count blocks of the file from index by one backend read into the claimed slots. Called
+ * with storage_lock, which is released during the read. The blocks are not cached if the file
+ * changed meanwhile, the first one is still returned for the current read. Returns the first
+ * block, NULL at the end of the file.
+ */
+static storage_block_t *storage_fill(storage_file_t *file, uint32_t index, int start, uint32_t count, ssize_t *err)
+{
+    const uint32_t gen = storage_nodes[file->node].gen;
+    xSemaphoreGive(storage_lock);
+    ssize_t len = storage_backend_read(file, (off_t)index * APP_STORAGE_BLOCK_SIZE,
+                                       storage_mem + start * APP_STORAGE_BLOCK_SIZE, count * APP_STORAGE_BLOCK_SIZE);
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    storage_stats.backend_reads++;
+
+    const bool valid = (storage_nodes[file->node].gen == gen);
+    for (uint32_t k = 0; k < count; k++) {
+        storage_block_t *block = &storage_blocks[start + k];
+        block->busy = false;
+        if (len > (ssize_t)(k * APP_STORAGE_BLOCK_SIZE)) {
+            block->index = index + k;
+            block->len = len - k * APP_STORAGE_BLOCK_SIZE;
+            block->len = block->len < APP_STORAGE_BLOCK_SIZE ? block->len : APP_STORAGE_BLOCK_SIZE;
+            storage_stats.miss_blocks++;
+            storage_stats.readahead_blocks += (k > 0);
+            /* Another descriptor of the file may have cached the block meanwhile */
+            if (valid && storage_find_block(file->node, index + k) == NULL) {
+                block->node = file->node;
+                block->used = ++storage_clock;
+            }
+        }
+    }
+
+    *err = len < 0 ? len : 0;
+    return len > 0 ? &storage_blocks[start] : NULL;
+}
+
+/* Called with the lock of the file, storage_lock is taken for the cache only */
+static ssize_t storage_read(storage_file_t *file, uint8_t *dst, size_t size)
+{
+    if (file->node == STORAGE_NO_NODE) {
+        ssize_t len = storage_backend_read(file, file->pos, dst, size);
+        file->pos += len > 0 ? len : 0;
+        xSemaphoreTake(storage_lock, portMAX_DELAY);
+        storage_stats.backend_reads++;
+        xSemaphoreGive(storage_lock);
+        return len;
+    }
+
+    const bool sequential = (file->pos == file->next);
+    size_t done = 0;
+    ssize_t err = 0;
+
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    while (done < size) {
+        const uint32_t index = file->pos / APP_STORAGE_BLOCK_SIZE;
+        const uint32_t offset = file->pos % APP_STORAGE_BLOCK_SIZE;
+        /*
+         * Whole blocks go straight to the caller. So does a random read, a block would be
+         * read for a few bytes of it. If the next read continues, it reads ahead.
+         */
+        const bool direct = !sequential || (offset == 0 && size - done >= APP_STORAGE_BLOCK_SIZE);
+        storage_block_t *block = storage_find_block(file->node, index);
+        int start = -1;
+        uint32_t count = STORAGE_READAHEAD;
+
+        if (block == NULL && !direct) {
+            start = storage_claim(file->node, index, &count);
+        }
+        if (block == NULL && start < 0) {
+            /* Also when all slots are being filled by other files */
+            size_t len = direct && sequential ? (size - done) / APP_STORAGE_BLOCK_SIZE * APP_STORAGE_BLOCK_SIZE : size - done;
+            xSemaphoreGive(storage_lock);
+            ssize_t n = storage_backend_read(file, file->pos, dst + done, len);
+            xSemaphoreTake(storage_lock, portMAX_DELAY);
+            storage_stats.backend_reads++;
+            if (n <= 0) {
+                err = n;
+                break;
+            }
+            storage_stats.direct_bytes += n;
+            done += n;
+            file->pos += n;
+            if ((size_t)n < len) {
+                break;
+            }
+            continue;
+        }
+
+        if (block == NULL) {
+            block = storage_fill(file, index, start, count, &err);
+            if (block == NULL) {
+                break;
+            }
+        }
+        if (offset >= block->len) {
+            break;
+        }
+
+        size_t len = block->len - offset;
+        len = len < size - done ? len : size - done;
+        memcpy(dst + done, storage_mem + (block - storage_blocks) * APP_STORAGE_BLOCK_SIZE + offset, len);
+        if (block->node != STORAGE_NO_NODE) {
+            block->used = ++storage_clock;
+        }
+        storage_stats.hit_bytes += len;
+        done += len;
+        file->pos += len;
+    }
+    xSemaphoreGive(storage_lock);
+
+    file->next = file->pos;
+    if (done == 0 && err < 0) {
+        return -1;
+    }
+    return done;
+}
+
+static int storage_vfs_open(const char *path, int flags, int mode)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, path);
+
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    int fd = -1;
+    for (int i = 0; i < APP_STORAGE_MAX_FILES; i++) {
+        if (storage_files[i].fd == -1) {
+            storage_files[i].fd = STORAGE_FD_OPENING;
+            fd = i;
+            break;
+        }
+    }
+    xSemaphoreGive(storage_lock);
+    if (fd < 0) {
+        errno = ENFILE;
+        return -1;
+    }
+
+    storage_file_t *file = &storage_files[fd];
+    int backend_fd = open(real, flags, mode);
+    if (backend_fd < 0) {
+        xSemaphoreTake(storage_lock, portMAX_DELAY);
+        file->fd = -1;
+        xSemaphoreGive(storage_lock);
+        return -1;
+    }
+
+    xSemaphoreTake(file->lock, portMAX_DELAY);
+    file->append = (flags & O_APPEND) != 0;
+    file->pos = 0;
+    file->backend_pos = 0;
+    file->next = 0;
+
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    file->fd = backend_fd;
+    file->node = storage_get_node(path);
+    if (file->node != STORAGE_NO_NODE) {
+        storage_node_t *node = &storage_nodes[file->node];
+        node->refs++;
+        node->used = ++storage_clock;
+        if ((flags & O_ACCMODE) != O_RDONLY || (flags & O_TRUNC)) {
+            storage_drop(file->node);
+        }
+    }
+    xSemaphoreGive(storage_lock);
+    xSemaphoreGive(file->lock);
+
+    return fd;
+}
+
+static ssize_t storage_vfs_read(int fd, void *dst, size_t size)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+    ssize_t len = storage_read(file, dst, size);
+    xSemaphoreGive(file->lock);
+
+    return len;
+}
+
+static ssize_t storage_vfs_write(int fd, const void *data, size_t size)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    ssize_t len = -1;
+    if (file->append || file->backend_pos == file->pos || lseek(file->fd, file->pos, SEEK_SET) == file->pos) {
+        len = write(file->fd, data, size);
+    }
+    if (file->append) {
+        file->pos = lseek(file->fd, 0, SEEK_CUR);
+    } else if (len > 0) {
+        file->pos += len;
+    }
+    file->backend_pos = file->pos;
+    /* After the write, so blocks read meanwhile by other descriptors are not kept */
+    storage_drop_file(file);
+    xSemaphoreGive(file->lock);
+
+    return len;
+}
+
+static off_t storage_vfs_lseek(int fd, off_t offset, int whence)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    off_t pos = -1;
+    struct stat st;
+    switch (whence) {
+    case SEEK_SET:
+        pos = offset;
+        break;
+    case SEEK_CUR:
+        pos = file->pos + offset;
+        break;
+    case SEEK_END:
+        if (fstat(file->fd, &st) == 0) {
+            pos = st.st_size + offset;
+        }
+        break;
+    default:
+        break;
+    }
+    if (pos < 0) {
+        errno = EINVAL;
+        pos = -1;
+    } else {
+        /* The backend file is moved by the next read or write */
+        file->pos = pos;
+    }
+    xSemaphoreGive(file->lock);
+
+    return pos;
+}
+
+static int storage_vfs_close(int fd)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+
+    int ret = close(file->fd);
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    if (file->node != STORAGE_NO_NODE) {
+        storage_nodes[file->node].refs--;
+    }
+    file->fd = -1;
+    xSemaphoreGive(storage_lock);
+    xSemaphoreGive(file->lock);
+
+    return ret;
+}
+
+static int storage_vfs_fstat(int fd, struct stat *st)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+    int ret = fstat(file->fd, st);
+    xSemaphoreGive(file->lock);
+
+    return ret;
+}
+
+static int storage_vfs_fsync(int fd)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+    int ret = fsync(file->fd);
+    xSemaphoreGive(file->lock);
+
+    return ret;
+}
+
+static int storage_vfs_ftruncate(int fd, off_t length)
+{
+    storage_file_t *file = storage_lock_file(fd);
+    if (file == NULL) {
+        return -1;
+    }
+    int ret = ftruncate(file->fd, length);
+    storage_drop_file(file);
+    xSemaphoreGive(file->lock);
+
+    return ret;
+}
+
+static int storage_vfs_stat(const char *path, struct stat *st)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, path);
+    return stat(real, st);
+}
+
+static int storage_vfs_unlink(const char *path)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, path);
+
+    /* Forgotten after the change, so blocks read meanwhile are not kept */
+    int ret = unlink(real);
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    storage_forget(path);
+    xSemaphoreGive(storage_lock);
+
+    return ret;
+}
+
+static int storage_vfs_rename(const char *src, const char *dst)
+{
+    char real_src[STORAGE_PATH_MAX], real_dst[STORAGE_PATH_MAX];
+    storage_backend_path(real_src, src);
+    storage_backend_path(real_dst, dst);
+
+    int ret = rename(real_src, real_dst);
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    storage_forget(src);
+    storage_forget(dst);
+    xSemaphoreGive(storage_lock);
+
+    return ret;
+}
+
+static int storage_vfs_mkdir(const char *name, mode_t mode)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, name);
+    return mkdir(real, mode);
+}
+
+static int storage_vfs_rmdir(const char *name)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, name);
+    return rmdir(real);
+}
+
+static DIR *storage_vfs_opendir(const char *name)
+{
+    char real[STORAGE_PATH_MAX];
+    storage_backend_path(real, name);
+
+    DIR *backend = opendir(real);
+    if (backend == NULL) {
+        return NULL;
+    }
+
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    DIR *dir = NULL;
+    for (int i = 0; i < STORAGE_MAX_DIRS; i++) {
+        if (storage_dirs[i].backend == NULL) {
+            storage_dirs[i].backend = backend;
+            dir = &storage_dirs[i].dir;
+            break;
+        }
+    }
+    xSemaphoreGive(storage_lock);
+
+    if (dir == NULL) {
+        closedir(backend);
+        errno = ENFILE;
+    }
+    return dir;
+}
+
+static struct dirent *storage_vfs_readdir(DIR *pdir)
+{
+    return readdir(((storage_dir_t *)pdir)->backend);
+}
+
+static int storage_vfs_closedir(DIR *pdir)
+{
+    storage_dir_t *dir = (storage_dir_t *)pdir;
+    int ret = closedir(dir->backend);
+    dir->backend = NULL;
+    return ret;
+}
+
+static esp_err_t storage_cache_mount(void)
+{
+    if (storage_mem == NULL) {
+        /* Reserved once, PSRAM is still much faster than the flash behind the file system */
+        storage_mem = heap_caps_malloc(STORAGE_CACHE_BLOCKS * APP_STORAGE_BLOCK_SIZE, MALLOC_CAP_SPIRAM);
+        if (storage_mem == NULL) {
+            storage_mem = heap_caps_malloc(STORAGE_CACHE_BLOCKS * APP_STORAGE_BLOCK_SIZE, MALLOC_CAP_DEFAULT);
+        }
+        if (storage_mem == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        storage_lock = xSemaphoreCreateMutexStatic(&storage_lock_buf);
+        for (int i = 0; i < APP_STORAGE_MAX_FILES; i++) {
+            storage_files[i].lock = xSemaphoreCreateMutexStatic(&storage_files[i].lock_buf);
+        }
+    }
+
+    for (int i = 0; i < STORAGE_CACHE_BLOCKS; i++) {
+        storage_blocks[i].node = STORAGE_NO_NODE;
+        storage_blocks[i].used = 0;
+        storage_blocks[i].busy = false;
+    }
+    for (int i = 0; i < APP_STORAGE_MAX_FILES; i++) {
+        storage_files[i].fd = -1;
+    }
+    memset(storage_nodes, 0, sizeof(storage_nodes));
+    memset(storage_dirs, 0, sizeof(storage_dirs));
+
+    const esp_vfs_t vfs = {
+        .flags = ESP_VFS_FLAG_DEFAULT,
+        .open = storage_vfs_open,
+        .read = storage_vfs_read,
+        .write = storage_vfs_write,
+        .lseek = storage_vfs_lseek,
+        .close = storage_vfs_close,
+        .fstat = storage_vfs_fstat,
+        .fsync = storage_vfs_fsync,
+        .ftruncate = storage_vfs_ftruncate,
+        .stat = storage_vfs_stat,
+        .unlink = storage_vfs_unlink,
+        .rename = storage_vfs_rename,
+        .mkdir = storage_vfs_mkdir,
+        .rmdir = storage_vfs_rmdir,
+        .opendir = storage_vfs_opendir,
+        .readdir = storage_vfs_readdir,
+        .closedir = storage_vfs_closedir,
+    };
+    return esp_vfs_register(APP_STORAGE_MOUNT_POINT, &vfs, NULL);
+}
+
+#endif /* STORAGE_CACHE_BLOCKS > 0 */
+
+/* Read the whole file in reads of chunk bytes, at random offsets if rand_count > 0, returns KB/s */
+static uint32_t storage_bench_read(const char *path, uint8_t *buf, size_t chunk, size_t size, uint32_t rand_count)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return 0;
+    }
+
+    size_t total = 0;
+    uint32_t seed = 1;
+    int64_t start = esp_timer_get_time();
+    if (rand_count == 0) {
+        size_t len;
+        while ((len = fread(buf, 1, chunk, file)) > 0) {
+            total += len;
+        }
+    } else {
+        for (uint32_t i = 0; i < rand_count; i++) {
+            /* Same sequence for every run */
+            seed = seed * 1103515245 + 12345;
+            fseek(file, (seed >> 8) % (size - chunk), SEEK_SET);
+            total += fread(buf, 1, chunk, file);
+        }
+    }
+    int64_t time = esp_timer_get_time() - start;
+    fclose(file);
+
+    return time > 0 ? (uint32_t)((int64_t)total * 1000000 / 1024 / time) : 0;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+const app_storage_backend_t app_storage_spiffs = {
+    .name = "SPIFFS",
+    .mount = storage_spiffs_mount,
+    .unmount = storage_spiffs_unmount,
+    .info = storage_spiffs_info,
+};
+
+#if CONFIG_APP_STORAGE_LITTLEFS
+const app_storage_backend_t app_storage_littlefs = {
+    .name = "LittleFS",
+    .mount = storage_littlefs_mount,
+    .unmount = storage_littlefs_unmount,
+    .info = storage_littlefs_info,
+};
+#endif
+
+esp_err_t app_storage_mount(void)
+{
+#if CONFIG_APP_STORAGE_LITTLEFS
+    return app_storage_mount_backend(&app_storage_littlefs);
+#else
+    return app_storage_mount_backend(&app_storage_spiffs);
+#endif
+}
+
+esp_err_t app_storage_mount_backend(const app_storage_backend_t *backend)
+{
+    if (storage_backend) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+#if STORAGE_CACHE_BLOCKS > 0
+    esp_err_t ret = backend->mount(APP_STORAGE_BACKEND_PATH, APP_STORAGE_PARTITION, APP_STORAGE_MAX_FILES);
+    if (ret == ESP_OK) {
+        ret = storage_cache_mount();
+        if (ret != ESP_OK) {
+            backend->unmount(APP_STORAGE_PARTITION);
+        }
+    }
+#else
+    esp_err_t ret = backend->mount(APP_STORAGE_MOUNT_POINT, APP_STORAGE_PARTITION, APP_STORAGE_MAX_FILES);
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Cannot mount %s (%s), is the storage image of this backend flashed?", backend->name, esp_err_to_name(ret));
+        return ret;
+    }
+    storage_backend = backend;
+
+    size_t total = 0, used = 0;
+    backend->info(APP_STORAGE_PARTITION, &total, &used);
+    ESP_LOGI(TAG, "%s mounted at %s: %zu of %zu KB used, read cache %d KB", backend->name, APP_STORAGE_MOUNT_POINT,
+             used / 1024, total / 1024, STORAGE_CACHE_BLOCKS * APP_STORAGE_BLOCK_SIZE / 1024);
+    return ESP_OK;
+}
+
+void app_storage_unmount(void)
+{
+    if (storage_backend == NULL) {
+        return;
+    }
+
+#if STORAGE_CACHE_BLOCKS > 0
+    esp_vfs_unregister(APP_STORAGE_MOUNT_POINT);
+#endif
+    storage_backend->unmount(APP_STORAGE_PARTITION);
+    storage_backend = NULL;
+}
+
+void app_storage_get_stats(app_storage_stats_t *stats)
+{
+#if STORAGE_CACHE_BLOCKS > 0
+    xSemaphoreTake(storage_lock, portMAX_DELAY);
+    *stats = storage_stats;
+    xSemaphoreGive(storage_lock);
+#else
+    memset(stats, 0, sizeof(app_storage_stats_t));
+#endif
+}
+
+esp_err_t app_storage_bench(size_t size, app_storage_bench_t *result)
+{
+    if (storage_backend == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (size < APP_STORAGE_BLOCK_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *buf = heap_caps_malloc(APP_STORAGE_BLOCK_SIZE, MALLOC_CAP_DEFAULT);
+    if (buf == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < APP_STORAGE_BLOCK_SIZE; i++) {
+        buf[i] = i * 7;
+    }
+    memset(result, 0, sizeof(app_storage_bench_t));
+
+    /* Sustained write, until the data is on the flash */
+    const char *path = APP_STORAGE_MOUNT_POINT STORAGE_BENCH_FILE;
+    esp_err_t ret = ESP_OK;
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        heap_caps_free(buf);
+        return ESP_FAIL;
+    }
+    size_t written = 0;
+    int64_t start = esp_timer_get_time();
+    while (written < size) {
+        size_t len = fwrite(buf, 1, APP_STORAGE_BLOCK_SIZE, file);
+        written += len;
+        if (len != APP_STORAGE_BLOCK_SIZE) {
+            ret = ESP_ERR_NO_MEM;
+            break;
+        }
+    }
+    fflush(file);
+    fsync(fileno(file));
+    int64_t time = esp_timer_get_time() - start;
+    fclose(file);
+
+    if (ret == ESP_OK) {
+        result->write = (uint32_t)((int64_t)written * 1000000 / 1024 / time);
+
+        /* Cache layer and the backend straight */
+        const char *raw = APP_STORAGE_BACKEND_PATH STORAGE_BENCH_FILE;
+        const uint32_t rand_count = size / STORAGE_BENCH_READ;
+        result->seq_read = storage_bench_read(path, buf, STORAGE_BENCH_READ, size, 0);
+        result->rand_read = storage_bench_read(path, buf, STORAGE_BENCH_RAND_READ, size, rand_count);
+#if STORAGE_CACHE_BLOCKS > 0
+        result->seq_read_raw = storage_bench_read(raw, buf, STORAGE_BENCH_READ, size, 0);
+        result->rand_read_raw = storage_bench_read(raw, buf, STORAGE_BENCH_RAND_READ, size, rand_count);
+#else
+        (void)raw;
+        result->seq_read_raw = result->seq_read;
+        result->rand_read_raw = result->rand_read;
+#endif
+
+        ESP_LOGI(TAG, "%s, %zu KB file: write %" PRIu32 " KB/s, sequential read %" PRIu32 " KB/s (%" PRIu32 " uncached), "
+                 "random read %" PRIu32 " KB/s (%" PRIu32 " uncached)", storage_backend->name, size / 1024, result->write,
+                 result->seq_read, result->seq_read_raw, result->rand_read, result->rand_read_raw);
+    } else {
+        ESP_LOGE(TAG, "Not enough space for %zu KB benchmark file", size / 1024);
+    }
+
+    unlink(path);
+    heap_caps_free(buf);
+    return ret;
+}
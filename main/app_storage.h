@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/* Files are accessed here (through the read cache) */
+#define APP_STORAGE_MOUNT_POINT     "/storage"
+/* The backend file system is mounted here, only the cache layer uses it */
+#define APP_STORAGE_BACKEND_PATH    "/.storage"
+/* Storage partition (data, spiffs subtype for both backends) */
+#define APP_STORAGE_PARTITION       "storage"
+/* Files open at once */
+#define APP_STORAGE_MAX_FILES       (8)
+/* Cache block, reads from the backend are aligned to it */
+#define APP_STORAGE_BLOCK_SIZE      (4096)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File system backend of the storage partition
+ */
+typedef struct {
+    const char *name;
+
+    /**
+     * @brief Mount the partition at base_path (registers the file system in VFS)
+     */
+    esp_err_t (*mount)(const char *base_path, const char *partition, size_t max_files);
+
+    void (*unmount)(const char *partition);
+
+    /**
+     * @brief Size of the file system and used bytes
+     */
+    esp_err_t (*info)(const char *partition, size_t *total, size_t *used);
+} app_storage_backend_t;
+
+/* Built-in backends */
+extern const app_storage_backend_t app_storage_spiffs;
+extern const app_storage_backend_t app_storage_littlefs;    /*!< Only with CONFIG_APP_STORAGE_LITTLEFS */
+
+/**
+ * @brief Read cache counters
+ */
+typedef struct {
+    uint32_t hit_bytes;         /*!< Bytes copied from cached blocks */
+    uint32_t miss_blocks;       /*!< Blocks read from the backend into the cache */
+    uint32_t readahead_blocks;  /*!< Of them, read ahead of a sequential reader */
+    uint32_t direct_bytes;      /*!< Bytes of whole block and random reads, which bypass the cache */
+    uint32_t backend_reads;     /*!< Read calls to the backend */
+} app_storage_stats_t;
+
+/**
+ * @brief Throughput of the storage, in KB/s
+ */
+typedef struct {
+    uint32_t write;             /*!< Sustained write (4 KB writes, fsync) */
+    uint32_t seq_read;          /*!< Sequential 1 KB reads (like audio playback) */
+    uint32_t seq_read_raw;      /*!< The same, straight from the backend */
+    uint32_t rand_read;         /*!< 512 B reads at random offsets */
+    uint32_t rand_read_raw;
+} app_storage_bench_t;
+
+/**
+ * @brief Mount the storage partition with the configured backend (CONFIG_APP_STORAGE_BACKEND)
+ *
+ * The backend is mounted at APP_STORAGE_BACKEND_PATH and the cache layer at
+ * APP_STORAGE_MOUNT_POINT. All files opened under the mount point share one read cache
+ * of CONFIG_APP_STORAGE_CACHE_BLOCKS blocks: sequential readers get
+ * CONFIG_APP_STORAGE_READAHEAD_BLOCKS aligned blocks in one backend read, reads of whole
+ * blocks and random reads of blocks not in the cache go straight to the caller. Writes go
+ * through and drop the cached blocks of the file. With no cache blocks, the backend is
+ * mounted at the mount point.
+ */
+esp_err_t app_storage_mount(void);
+
+/**
+ * @brief Mount storage partition with a backend, see app_storage_mount()
+ */
+esp_err_t app_storage_mount_backend(const app_storage_backend_t *backend);
+
+/**
+ * @brief Unmount the storage, no file may be open
+ */
+void app_storage_unmount(void);
+
+/**
+ * @brief Get read cache counters
+ */
+void app_storage_get_stats(app_storage_stats_t *stats);
+
+/**
+ * @brief Measure throughput of the mounted storage
+ *
+ * A temporary file of size bytes is written, read and removed. Results are also logged.
+ *
+ * @return ESP_ERR_NO_MEM if there is no space for the file (or no memory for the buffer)
+ */
+esp_err_t app_storage_bench(size_t size, app_storage_bench_t *result);
+
+#ifdef __cplusplus
+}
+#endif
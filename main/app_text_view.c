@@ -0,0 +1,402 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "app_mem.h"
+#include "app_text_view.h"
+
+#define TEXT_VIEW_ROWS          APP_TEXT_VIEW_ROWS
+/* Longer lines are split (at UTF-8 character boundary) into more rows */
+#define TEXT_VIEW_LINE_MAX      (44)
+/* Row incl. UTF-8 continuation of the last character and CR LF */
+#define TEXT_VIEW_ROW_BYTES     (TEXT_VIEW_LINE_MAX + 8)
+/* Sparse index: start offset of every step-th row, the rows between are found by a local rescan.
+   The step grows with the file size, so the index of any file fits into TEXT_VIEW_INDEX_MAX entries. */
+#define TEXT_VIEW_INDEX_STEP    (16)
+#define TEXT_VIEW_INDEX_MAX     (16384)
+/* File is indexed in pieces of this size */
+#define TEXT_VIEW_READ_CHUNK    APP_MEM_IO_BLOCK_SIZE
+/* Index progress is shown in this period */
+#define TEXT_VIEW_REFRESH_MS    (100)
+
+static const char *TAG = "TEXT_VIEW";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    char path[250];
+    FILE *file;                     /*!< Used by LVGL task for rendering, the indexer has own file */
+    uint32_t file_size;
+    SemaphoreHandle_t mux;          /*!< Protects index and flags */
+    StaticSemaphore_t mux_buf;
+    SemaphoreHandle_t done;         /*!< Given by the indexer task on exit */
+    StaticSemaphore_t done_buf;
+    uint32_t *index;                /*!< Start offsets of rows 0, step, 2 * step... */
+    uint32_t index_step;
+    uint32_t lines;                 /*!< Indexed line starts */
+    bool indexing;                  /*!< Indexer task is running */
+    bool closing;                   /*!< Viewer was deleted, the indexer stops */
+    uint32_t first;                 /*!< First visible row */
+    uint32_t shown_lines;           /*!< Line count of the last refresh */
+    lv_obj_t *label;
+    lv_obj_t *status;
+    lv_obj_t *slider;
+    lv_timer_t *timer;
+    char *raw;                      /*!< Page as read from file */
+    char *page;                     /*!< Page text for label */
+} text_view_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+typedef enum {
+    ROW_BREAK_NONE,
+    ROW_BREAK_BEFORE,               /*!< Long line wrapped, next row starts with this byte */
+    ROW_BREAK_AFTER,                /*!< New line, next row starts after this byte */
+} row_break_t;
+
+/* Splitting of the text into rows, the same for the indexer and the rescan in render */
+static inline row_break_t row_break(uint32_t *line_len, uint8_t b)
+{
+    if (b == '\n') {
+        *line_len = 0;
+        return ROW_BREAK_AFTER;
+    }
+    if (*line_len >= TEXT_VIEW_LINE_MAX && (b & 0xC0) != 0x80 && b != '\r') {
+        /* Wrap long line before this character */
+        *line_len = 1;
+        return ROW_BREAK_BEFORE;
+    }
+    (*line_len)++;
+    return ROW_BREAK_NONE;
+}
+
+/* Called with mutex taken. Every row is at least one byte long, so the index sized in create never overflows. */
+static void index_add(text_view_t *tv, uint32_t offset)
+{
+    if (tv->lines % tv->index_step == 0) {
+        tv->index[tv->lines / tv->index_step] = offset;
+    }
+    tv->lines++;
+}
+
+/* Background task: build line start index */
+static void text_view_indexer(void *arg)
+{
+    text_view_t *tv = arg;
+    uint32_t pos = 0;
+    uint32_t line_len = 0;
+
+    FILE *file = fopen(tv->path, "rb");
+    uint8_t *buf = app_mem_pool_alloc(APP_MEM_POOL_IO);
+
+    if (file && buf) {
+        xSemaphoreTake(tv->mux, portMAX_DELAY);
+        index_add(tv, 0);
+        xSemaphoreGive(tv->mux);
+
+        size_t n;
+        while (!tv->closing && pos < tv->file_size && (n = fread(buf, 1, TEXT_VIEW_READ_CHUNK, file)) > 0) {
+            /* A file growing meanwhile is indexed only up to the size the index was made for */
+            if (n > tv->file_size - pos) {
+                n = tv->file_size - pos;
+            }
+            xSemaphoreTake(tv->mux, portMAX_DELAY);
+            for (size_t i = 0; i < n; i++) {
+                row_break_t brk = row_break(&line_len, buf[i]);
+                if (brk == ROW_BREAK_BEFORE) {
+                    index_add(tv, pos + i);
+                } else if (brk == ROW_BREAK_AFTER && pos + i + 1 < tv->file_size) {
+                    index_add(tv, pos + i + 1);
+                }
+            }
+            xSemaphoreGive(tv->mux);
+            pos += n;
+
+            /* Let the UI run */
+            vTaskDelay(1);
+        }
+    }
+
+    if (file) {
+        fclose(file);
+    }
+    app_mem_pool_free(buf);
+
+    xSemaphoreTake(tv->mux, portMAX_DELAY);
+    tv->indexing = false;
+    ESP_LOGI(TAG, "Indexed %" PRIu32 " rows of %" PRIu32 " bytes, every %" PRIu32 ". row", tv->lines, pos, tv->index_step);
+    xSemaphoreGive(tv->mux);
+    xSemaphoreGive(tv->done);
+
+    vTaskDelete(NULL);
+}
+
+/* Lines with known end offset, called with mutex taken */
+static uint32_t text_view_complete_lines(const text_view_t *tv)
+{
+    if (tv->indexing) {
+        return tv->lines > 0 ? tv->lines - 1 : 0;
+    }
+    return tv->lines;
+}
+
+/*
+ * Start offsets of count + 1 rows from row first (the last one is the end of the page), found by
+ * scanning from the index entry before first. Rows past the end of file start at the file size.
+ */
+static void text_view_find_rows(text_view_t *tv, uint32_t row, uint32_t offset, uint32_t first,
+                                uint32_t count, uint32_t *start)
+{
+    uint32_t line_len = 0;
+    uint32_t pos = offset;
+    uint32_t found = 0;
+
+    if (row == first) {
+        start[found++] = offset;
+    }
+
+    fseek(tv->file, offset, SEEK_SET);
+    while (found <= count && pos < tv->file_size) {
+        /* The page buffer is free until the page is read */
+        size_t n = fread(tv->raw, 1, TEXT_VIEW_ROWS * TEXT_VIEW_ROW_BYTES, tv->file);
+        if (n == 0) {
+            break;
+        }
+        for (size_t i = 0; i < n && found <= count; i++) {
+            row_break_t brk = row_break(&line_len, (uint8_t)tv->raw[i]);
+            uint32_t next = (brk == ROW_BREAK_BEFORE) ? pos + i : pos + i + 1;
+            if (brk == ROW_BREAK_NONE || next >= tv->file_size) {
+                continue;
+            }
+            if (++row >= first) {
+                start[found++] = next;
+            }
+        }
+        pos += n;
+    }
+
+    while (found <= count) {
+        start[found++] = tv->file_size;
+    }
+}
+
+static void text_view_render(text_view_t *tv)
+{
+    uint32_t start[TEXT_VIEW_ROWS + 1];
+    uint32_t rows = 0;
+
+    /* Nearest index entry at or before the first visible row */
+    xSemaphoreTake(tv->mux, portMAX_DELAY);
+    uint32_t lines = text_view_complete_lines(tv);
+    if (tv->first + TEXT_VIEW_ROWS > lines) {
+        tv->first = lines > TEXT_VIEW_ROWS ? lines - TEXT_VIEW_ROWS : 0;
+    }
+    rows = (lines - tv->first < TEXT_VIEW_ROWS) ? lines - tv->first : TEXT_VIEW_ROWS;
+    uint32_t entry = tv->first / tv->index_step;
+    uint32_t entry_offset = (rows > 0) ? tv->index[entry] : 0;
+    tv->shown_lines = lines;
+    xSemaphoreGive(tv->mux);
+
+    /* Offsets of the visible rows and the end of the last one */
+    if (rows > 0) {
+        text_view_find_rows(tv, entry * tv->index_step, entry_offset, tv->first, rows, start);
+    }
+
+    /* One read for the whole page */
+    size_t len = 0;
+    if (rows > 0) {
+        len = start[rows] - start[0];
+        if (len > TEXT_VIEW_ROWS * TEXT_VIEW_ROW_BYTES) {
+            len = TEXT_VIEW_ROWS * TEXT_VIEW_ROW_BYTES;
+        }
+        fseek(tv->file, start[0], SEEK_SET);
+        len = fread(tv->raw, 1, len, tv->file);
+    }
+
+    /* Rows are separated by new line, CR LF and wrapped lines are normalized */
+    char *out = tv->page;
+    for (uint32_t r = 0; r < rows; r++) {
+        size_t from = start[r] - start[0];
+        size_t to = start[r + 1] - start[0];
+        if (to > len) {
+            to = len;
+        }
+        if (to - from > TEXT_VIEW_ROW_BYTES) {
+            to = from + TEXT_VIEW_ROW_BYTES;
+        }
+        while (to > from && (tv->raw[to - 1] == '\n' || tv->raw[to - 1] == '\r')) {
+            to--;
+        }
+        if (to > from) {
+            memcpy(out, &tv->raw[from], to - from);
+            out += to - from;
+        }
+        *out++ = '\n';
+    }
+    *out = '\0';
+
+    lv_label_set_text(tv->label, tv->page);
+
+    lv_slider_set_range(tv->slider, 0, lines > TEXT_VIEW_ROWS ? lines - TEXT_VIEW_ROWS : 0);
+    /* Vertical slider has minimum at bottom */
+    lv_slider_set_value(tv->slider, lv_slider_get_max_value(tv->slider) - tv->first, LV_ANIM_OFF);
+}
+
+static void text_view_update_status(text_view_t *tv)
+{
+    xSemaphoreTake(tv->mux, portMAX_DELAY);
+    uint32_t lines = text_view_complete_lines(tv);
+    bool indexing = tv->indexing;
+    xSemaphoreGive(tv->mux);
+
+    lv_label_set_text_fmt(tv->status, "%" PRIu32 "/%" PRIu32 "%s", tv->first + 1, lines, indexing ? "+" : "");
+}
+
+/* Periodic refresh while the index grows */
+static void text_view_timer_cb(lv_timer_t *timer)
+{
+    text_view_t *tv = lv_timer_get_user_data(timer);
+
+    xSemaphoreTake(tv->mux, portMAX_DELAY);
+    uint32_t lines = text_view_complete_lines(tv);
+    bool indexing = tv->indexing;
+    xSemaphoreGive(tv->mux);
+
+    /* Re-render only when the page was not full or the slider range changed */
+    if (lines != tv->shown_lines) {
+        text_view_render(tv);
+    }
+    text_view_update_status(tv);
+
+    if (!indexing) {
+        lv_timer_del(timer);
+        tv->timer = NULL;
+    }
+}
+
+static void text_view_slider_cb(lv_event_t *e)
+{
+    text_view_t *tv = lv_event_get_user_data(e);
+
+    tv->first = lv_slider_get_max_value(tv->slider) - lv_slider_get_value(tv->slider);
+    text_view_render(tv);
+    text_view_update_status(tv);
+}
+
+static void text_view_delete_cb(lv_event_t *e)
+{
+    text_view_t *tv = lv_event_get_user_data(e);
+
+    if (tv->timer) {
+        lv_timer_del(tv->timer);
+    }
+    fclose(tv->file);
+
+    /* The state lives in the window arena, which is released after the window, so wait for
+       the indexer. It checks the flag after every read chunk. */
+    tv->closing = true;
+    xSemaphoreTake(tv->done, portMAX_DELAY);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+lv_obj_t *app_text_view_create(lv_obj_t *parent, const char *path)
+{
+    /* Released with the window arena */
+    text_view_t *tv = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(text_view_t));
+    if (tv == NULL) {
+        return NULL;
+    }
+
+    strlcpy(tv->path, path, sizeof(tv->path));
+    tv->mux = xSemaphoreCreateMutexStatic(&tv->mux_buf);
+    tv->done = xSemaphoreCreateBinaryStatic(&tv->done_buf);
+    tv->raw = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, TEXT_VIEW_ROWS * TEXT_VIEW_ROW_BYTES);
+    tv->page = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, TEXT_VIEW_ROWS * (TEXT_VIEW_ROW_BYTES + 1) + 1);
+    if (tv->raw == NULL || tv->page == NULL) {
+        return NULL;
+    }
+    tv->file = fopen(path, "rb");
+    if (tv->file == NULL) {
+        return NULL;
+    }
+    fseek(tv->file, 0, SEEK_END);
+    tv->file_size = ftell(tv->file);
+
+    /* Sized for the worst case of one byte rows */
+    tv->index_step = TEXT_VIEW_INDEX_STEP;
+    while (tv->file_size / tv->index_step + 2 > TEXT_VIEW_INDEX_MAX) {
+        tv->index_step *= 2;
+    }
+    tv->index = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, (tv->file_size / tv->index_step + 2) * sizeof(uint32_t));
+    if (tv->index == NULL) {
+        fclose(tv->file);
+        return NULL;
+    }
+
+    tv->indexing = true;
+    if (xTaskCreate(text_view_indexer, "text_index", 3072, tv, 2, NULL) != pdPASS) {
+        fclose(tv->file);
+        return NULL;
+    }
+
+    /* Text on the left, position slider on the right */
+    lv_obj_t *view = lv_obj_create(parent);
+    lv_obj_set_size(view, lv_pct(100), lv_pct(100));
+    lv_obj_set_style_pad_all(view, 2, 0);
+    lv_obj_set_style_border_width(view, 0, 0);
+    lv_obj_clear_flag(view, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_user_data(view, tv);
+
+    tv->label = lv_label_create(view);
+    lv_obj_set_width(tv->label, lv_pct(90));
+    lv_label_set_long_mode(tv->label, LV_LABEL_LONG_CLIP);
+    lv_label_set_text(tv->label, "");
+    lv_obj_align(tv->label, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    tv->slider = lv_slider_create(view);
+    lv_obj_set_size(tv->slider, 8, lv_pct(85));
+    lv_obj_align(tv->slider, LV_ALIGN_TOP_RIGHT, -4, 4);
+    lv_obj_add_event_cb(tv->slider, text_view_slider_cb, LV_EVENT_VALUE_CHANGED, tv);
+
+    tv->status = lv_label_create(view);
+    lv_obj_set_style_text_font(tv->status, &lv_font_montserrat_14, 0);
+    lv_obj_align(tv->status, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_label_set_text(tv->status, "");
+
+    lv_obj_add_event_cb(view, text_view_delete_cb, LV_EVENT_DELETE, tv);
+    tv->timer = lv_timer_create(text_view_timer_cb, TEXT_VIEW_REFRESH_MS, tv);
+
+    return view;
+}
+
+void app_text_view_scroll(lv_obj_t *view, int32_t lines)
+{
+    text_view_t *tv = lv_obj_get_user_data(view);
+
+    if (lines < 0 && (uint32_t)(-lines) > tv->first) {
+        tv->first = 0;
+    } else {
+        tv->first += lines;
+    }
+
+    /* Clamped to the indexed lines by render */
+    text_view_render(tv);
+    text_view_update_status(tv);
+}
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+/* Visible rows of text */
+#define APP_TEXT_VIEW_ROWS  (10)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create paged text file viewer
+ *
+ * Only the visible lines are read from the file and rendered. The line offsets are indexed
+ * by a background task, so the first page is shown right away, also for very large files.
+ * The state is allocated from APP_MEM_ARENA_WINDOW, the indexer stops when the returned object is deleted.
+ *
+ * @return Viewer object or NULL, if the file cannot be opened
+ */
+lv_obj_t *app_text_view_create(lv_obj_t *parent, const char *path);
+
+/**
+ * @brief Scroll the viewer by lines (negative: up)
+ */
+void app_text_view_scroll(lv_obj_t *view, int32_t lines);
+
+#ifdef __cplusplus
+}
+#endif
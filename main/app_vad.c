@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include "app_mem.h"
+#include "app_vad.h"
+
+/* Blocks with more zero crossings (per 1000 samples) are noise-like (fricatives, hiss)
+   and must be twice as loud to be taken as speech */
+#define VAD_NOISY_ZCR           (400)
+/* Noise floor tracking speed, the floor rises by 1/2^VAD_NOISE_SHIFT of the difference per silent block.
+   It must rise slower than a syllable onset (about 1 s at 23 ms blocks), it drops at once. */
+#define VAD_NOISE_SHIFT         (6)
+/* Rise of the noise floor during speech, so a stationary sound louder than the threshold
+   (fan, hum) ends the segment after a few seconds instead of recording forever */
+#define VAD_NOISE_SPEECH_SHIFT  (9)
+/* The first blocks only set the noise floor, the background may be louder than min_energy */
+#define VAD_TRAINING_MS         (200)
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+void app_vad_init(app_vad_t *vad, const app_vad_config_t *cfg)
+{
+    assert(vad != NULL && cfg != NULL);
+    assert(cfg->sample_rate > 0);
+
+    memset(vad, 0, sizeof(app_vad_t));
+    vad->cfg = *cfg;
+    /* Only place with floating point, the per-block path is integer only */
+    vad->threshold_ratio_q4 = (uint32_t)(powf(10.0f, cfg->threshold_db / 10.0f) * 16.0f);
+    vad->noise_floor = cfg->min_energy;
+}
+
+app_vad_event_t app_vad_process(app_vad_t *vad, const int16_t *samples, size_t count)
+{
+    assert(vad != NULL && samples != NULL);
+
+    if (count == 0) {
+        return APP_VAD_EVENT_NONE;
+    }
+
+    /* Block energy and zero crossings in one pass */
+    uint64_t sum = 0;
+    uint32_t crossings = 0;
+    int32_t prev = samples[0];
+    for (size_t i = 0; i < count; i++) {
+        int32_t s = samples[i];
+        sum += (uint32_t)(s * s);
+        crossings += ((s ^ prev) < 0);
+        prev = s;
+    }
+    uint32_t energy = (uint32_t)(sum / count);
+    uint32_t zcr = (uint32_t)((crossings * 1000ULL) / count);
+    uint32_t block_ms = (uint32_t)((count * 1000ULL) / vad->cfg.sample_rate);
+    vad->last_energy = energy;
+    vad->last_zcr = zcr;
+
+    uint64_t threshold = ((uint64_t)vad->noise_floor * vad->threshold_ratio_q4) >> 4;
+    if (zcr > VAD_NOISY_ZCR) {
+        threshold *= 2;
+    }
+    bool speech = (energy >= vad->cfg.min_energy && energy > threshold);
+
+    if (vad->training_ms < VAD_TRAINING_MS) {
+        /* Noise floor is the mean of the training blocks */
+        vad->training_ms += block_ms;
+        vad->noise_floor = vad->training_ms == block_ms ? energy :
+                           (uint32_t)(((uint64_t)vad->noise_floor * (vad->training_ms - block_ms) + (uint64_t)energy * block_ms) / vad->training_ms);
+        if (vad->noise_floor < vad->cfg.min_energy) {
+            vad->noise_floor = vad->cfg.min_energy;
+        }
+        return APP_VAD_EVENT_NONE;
+    }
+
+    /* Follow the background noise, slowly during speech, drop quickly to quieter levels */
+    if (!speech) {
+        if (energy < vad->noise_floor) {
+            vad->noise_floor = energy < vad->cfg.min_energy ? vad->cfg.min_energy : energy;
+        } else {
+            vad->noise_floor += (energy - vad->noise_floor) >> VAD_NOISE_SHIFT;
+        }
+    } else {
+        vad->noise_floor += (energy - vad->noise_floor) >> VAD_NOISE_SPEECH_SHIFT;
+    }
+
+    if (speech) {
+        vad->speech_ms += block_ms;
+        vad->silence_ms = 0;
+        if (!vad->active && vad->speech_ms >= vad->cfg.attack_ms) {
+            vad->active = true;
+            return APP_VAD_EVENT_SPEECH_START;
+        }
+    } else {
+        vad->speech_ms = 0;
+        if (vad->active) {
+            vad->silence_ms += block_ms;
+            if (vad->silence_ms >= vad->cfg.hangover_ms) {
+                vad->active = false;
+                vad->silence_ms = 0;
+                return APP_VAD_EVENT_SPEECH_END;
+            }
+        }
+    }
+
+    return APP_VAD_EVENT_NONE;
+}
+
+bool app_vad_preroll_init(app_vad_preroll_t *preroll, size_t block_size, uint32_t preroll_ms, uint32_t sample_rate)
+{
+    assert(preroll != NULL && block_size > 0);
+
+    memset(preroll, 0, sizeof(app_vad_preroll_t));
+
+    /* 16bit mono samples */
+    size_t bytes = ((size_t)preroll_ms * sample_rate / 1000) * sizeof(int16_t);
+    preroll->block_size = block_size;
+    preroll->block_count = (bytes + block_size - 1) / block_size;
+    if (preroll->block_count == 0) {
+        return true;
+    }
+
+    preroll->buf = app_mem_arena_alloc(APP_MEM_ARENA_REC, preroll->block_count * block_size);
+
+    return (preroll->buf != NULL);
+}
+
+void app_vad_preroll_push(app_vad_preroll_t *preroll, const void *block)
+{
+    assert(preroll != NULL && block != NULL);
+
+    if (preroll->block_count == 0) {
+        return;
+    }
+
+    size_t tail = (preroll->head + preroll->used) % preroll->block_count;
+    memcpy(preroll->buf + tail * preroll->block_size, block, preroll->block_size);
+    if (preroll->used < preroll->block_count) {
+        preroll->used++;
+    } else {
+        /* Full, the oldest block was overwritten */
+        preroll->head = (preroll->head + 1) % preroll->block_count;
+    }
+}
+
+const void *app_vad_preroll_pop(app_vad_preroll_t *preroll)
+{
+    assert(preroll != NULL);
+
+    if (preroll->used == 0) {
+        return NULL;
+    }
+
+    const void *block = preroll->buf + preroll->head * preroll->block_size;
+    preroll->head = (preroll->head + 1) % preroll->block_count;
+    preroll->used--;
+
+    return block;
+}
+
+void app_vad_preroll_deinit(app_vad_preroll_t *preroll)
+{
+    assert(preroll != NULL);
+
+    app_mem_arena_free(APP_MEM_ARENA_REC, preroll->buf);
+    memset(preroll, 0, sizeof(app_vad_preroll_t));
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Voice activity detector configuration
+ */
+typedef struct {
+    uint32_t sample_rate;       /*!< Sample rate of the processed audio (16bit mono) */
+    uint32_t threshold_db;      /*!< Speech frame: block energy this many dB above the noise floor */
+    uint32_t min_energy;        /*!< Absolute minimal mean square energy of a speech frame */
+    uint32_t attack_ms;         /*!< Speech must last at least this long to start a segment */
+    uint32_t hangover_ms;       /*!< Segment is closed after this long period of silence */
+} app_vad_config_t;
+
+/**
+ * @brief Voice activity detector events
+ */
+typedef enum {
+    APP_VAD_EVENT_NONE,
+    APP_VAD_EVENT_SPEECH_START,
+    APP_VAD_EVENT_SPEECH_END,
+} app_vad_event_t;
+
+/**
+ * @brief Voice activity detector state (energy + zero-crossing rate)
+ */
+typedef struct {
+    app_vad_config_t cfg;
+    uint32_t threshold_ratio_q4;  /*!< Energy ratio over noise floor, Q4 fixed point */
+    uint32_t noise_floor;         /*!< Tracked mean square energy of the background noise */
+    uint32_t speech_ms;           /*!< Length of the current run of speech frames */
+    uint32_t silence_ms;          /*!< Length of the current run of silence frames */
+    uint32_t training_ms;         /*!< Audio processed to learn the initial noise floor */
+    uint32_t last_energy;         /*!< Mean square energy of the last processed block */
+    uint32_t last_zcr;            /*!< Zero crossings per 1000 samples of the last processed block */
+    bool active;                  /*!< Speech segment is in progress */
+} app_vad_t;
+
+/**
+ * @brief Pre-roll ring buffer holding the last audio blocks before speech start
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t block_size;
+    size_t block_count;
+    size_t head;                  /*!< Index of the oldest block */
+    size_t used;                  /*!< Number of valid blocks */
+} app_vad_preroll_t;
+
+/**
+ * @brief Initialize voice activity detector
+ */
+void app_vad_init(app_vad_t *vad, const app_vad_config_t *cfg);
+
+/**
+ * @brief Process one block of 16bit mono samples
+ *
+ * @return Event which was triggered by this block
+ */
+app_vad_event_t app_vad_process(app_vad_t *vad, const int16_t *samples, size_t count);
+
+/**
+ * @brief Allocate pre-roll ring buffer from APP_MEM_ARENA_REC for at least preroll_ms of audio
+ *
+ * @return true on success
+ */
+bool app_vad_preroll_init(app_vad_preroll_t *preroll, size_t block_size, uint32_t preroll_ms, uint32_t sample_rate);
+
+/**
+ * @brief Store one block into pre-roll ring, the oldest block is overwritten when full
+ */
+void app_vad_preroll_push(app_vad_preroll_t *preroll, const void *block);
+
+/**
+ * @brief Get the oldest block from pre-roll ring
+ *
+ * @return Pointer to the block data or NULL when the ring is empty
+ */
+const void *app_vad_preroll_pop(app_vad_preroll_t *preroll);
+
+/**
+ * @brief Free pre-roll ring buffer
+ */
+void app_vad_preroll_deinit(app_vad_preroll_t *preroll);
+
+#ifdef __cplusplus
+}
+#endif
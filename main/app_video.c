@@ -0,0 +1,471 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/stream_buffer.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "jpeg_decoder.h"
+#include "app_mem.h"
+#include "app_avi.h"
+#include "app_video.h"
+
+/* Compressed frames in flight between the reader and the decoder */
+#define VIDEO_SLOTS             (2)
+#define VIDEO_SLOT_SIZE         (CONFIG_APP_VIDEO_MAX_FRAME_KB * 1024)
+/* Decoded audio waiting for the codec */
+#define VIDEO_AUDIO_BUF_SIZE    (16 * 1024)
+/* Waits are limited, so all tasks notice the stop request */
+#define VIDEO_WAIT_MS           (20)
+/* Frame presentation period of the LVGL timer */
+#define VIDEO_PRESENT_MS        (5)
+#define VIDEO_STATUS_MS         (500)
+#define VIDEO_TASKS             (3)
+
+static const char *TAG = "VIDEO";
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+typedef struct {
+    uint32_t frame;                 /*!< Frame index, gives the presentation time */
+    uint32_t size;
+} video_slot_t;
+
+typedef struct {
+    char path[250];
+    app_video_config_t config;
+    FILE *file;
+    app_avi_t avi;
+    volatile bool stop;
+    volatile bool eof;              /*!< Reader reached the end of the stream */
+    SemaphoreHandle_t exited;       /*!< Given by each task on exit */
+    StaticSemaphore_t exited_buf;
+
+    /* Reader -> decoder */
+    uint8_t *slot_data[VIDEO_SLOTS];
+    video_slot_t slot[VIDEO_SLOTS];
+    QueueHandle_t filled;           /*!< Slot indexes with a frame */
+    StaticQueue_t filled_buf;
+    uint8_t filled_storage[VIDEO_SLOTS];
+    QueueHandle_t empty;            /*!< Free slot indexes */
+    StaticQueue_t empty_buf;
+    uint8_t empty_storage[VIDEO_SLOTS];
+
+    /* Reader -> audio */
+    StreamBufferHandle_t audio;
+    StaticStreamBuffer_t audio_buf;
+    uint8_t *audio_storage;
+    portMUX_TYPE clock_lock;
+    uint32_t audio_frames;          /*!< Frames written to the codec, this is the clock */
+    uint32_t audio_write_frames;    /*!< Frames of the write in progress */
+    int64_t audio_write_time;       /*!< System time at the end of the last write */
+    volatile bool audio_done;
+    int64_t audio_done_us;          /*!< Clock at the end of the sound */
+    int64_t audio_done_time;        /*!< System time at the end of the sound */
+    int64_t start_us;               /*!< Clock start without sound */
+
+    /* Decoder -> LVGL */
+    uint8_t *fb[2];
+    uint16_t fb_width;              /*!< Allocated size */
+    uint16_t fb_height;
+    uint16_t frame_width[2];        /*!< Decoded size */
+    uint16_t frame_height[2];
+    jpeg_image_scale_t scale;
+    uint8_t back;                   /*!< Buffer for the next frame */
+    SemaphoreHandle_t fb_free;      /*!< Buffers not shown and not waiting */
+    StaticSemaphore_t fb_free_buf;
+    volatile int8_t ready;          /*!< Buffer waiting for presentation, -1 if none */
+    int8_t shown;
+    uint64_t decode_us_sum;
+    uint32_t decoded;
+
+    app_video_stats_t stats;
+    atomic_uint dropped;            /*!< Counted by the reader and the decoder, copied into stats */
+    lv_obj_t *canvas;
+    lv_obj_t *status;
+    lv_timer_t *present_timer;
+    lv_timer_t *status_timer;
+} video_t;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+/* Playback time: samples played, or system time without sound */
+static int64_t video_clock_us(video_t *v)
+{
+    if (v->avi.info.has_audio && v->config.codec) {
+        if (v->audio_done) {
+            /* Sound ended before video, continue by system time */
+            return v->audio_done_us + esp_timer_get_time() - v->audio_done_time;
+        }
+        /* Between the writes, the clock runs by system time up to the end of the write in progress */
+        taskENTER_CRITICAL(&v->clock_lock);
+        uint32_t frames = v->audio_frames;
+        int64_t since_us = (v->audio_write_time > 0) ? esp_timer_get_time() - v->audio_write_time : 0;
+        int64_t write_us = (int64_t)v->audio_write_frames * 1000000 / v->avi.info.sample_rate;
+        taskEXIT_CRITICAL(&v->clock_lock);
+        return (int64_t)frames * 1000000 / v->avi.info.sample_rate + (since_us < write_us ? since_us : write_us);
+    }
+    return esp_timer_get_time() - v->start_us;
+}
+
+/* Demux the file: frames into slots, samples into the audio stream buffer */
+static void video_reader_task(void *arg)
+{
+    video_t *v = arg;
+    uint32_t frame = 0;
+    uint8_t *block = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    app_avi_chunk_t type;
+    uint32_t size;
+
+    while (block && !v->stop && app_avi_next_chunk(&v->avi, &type, &size) == ESP_OK) {
+        if (type == APP_AVI_CHUNK_VIDEO) {
+            uint8_t idx;
+            while (!v->stop && xQueueReceive(v->empty, &idx, pdMS_TO_TICKS(VIDEO_WAIT_MS)) != pdTRUE);
+            if (v->stop) {
+                break;
+            }
+            if (size > VIDEO_SLOT_SIZE) {
+                ESP_LOGW(TAG, "Frame %" PRIu32 " too big (%" PRIu32 " B)", frame, size);
+                atomic_fetch_add(&v->dropped, 1);
+                xQueueSend(v->empty, &idx, 0);
+            } else {
+                v->slot[idx].frame = frame;
+                v->slot[idx].size = app_avi_read(&v->avi, v->slot_data[idx], size);
+                xQueueSend(v->filled, &idx, portMAX_DELAY);
+            }
+            frame++;
+        } else if (v->config.codec) {
+            size_t len;
+            while (!v->stop && (len = app_avi_read(&v->avi, block, APP_MEM_AUDIO_BLOCK_SIZE)) > 0) {
+                size_t sent = 0;
+                while (!v->stop && sent < len) {
+                    sent += xStreamBufferSend(v->audio, block + sent, len - sent, pdMS_TO_TICKS(VIDEO_WAIT_MS));
+                }
+            }
+        }
+    }
+
+    app_mem_pool_free(block);
+    v->eof = true;
+    xSemaphoreGive(v->exited);
+    vTaskDelete(NULL);
+}
+
+/* Feed the codec, the written samples drive the clock */
+static void video_audio_task(void *arg)
+{
+    video_t *v = arg;
+    uint8_t *block = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    const app_avi_info_t *info = &v->avi.info;
+    size_t frame_bytes = info->channels * sizeof(int16_t);
+
+    if (block && v->config.codec && info->has_audio) {
+        esp_codec_dev_sample_info_t fs = {
+            .sample_rate = info->sample_rate,
+            .channel = info->channels,
+            .bits_per_sample = info->bits_per_sample,
+            .mclk_multiple = I2S_MCLK_MULTIPLE_384,
+        };
+        esp_codec_dev_open(v->config.codec, &fs);
+
+        size_t pending = 0;
+        while (!v->stop) {
+            size_t len = xStreamBufferReceive(v->audio, block + pending, APP_MEM_AUDIO_BLOCK_SIZE - pending, pdMS_TO_TICKS(VIDEO_WAIT_MS));
+            if (len == 0 && v->eof && xStreamBufferIsEmpty(v->audio)) {
+                break;
+            }
+            /* Write whole frames only */
+            len += pending;
+            size_t whole = len - len % frame_bytes;
+            if (whole > 0) {
+                taskENTER_CRITICAL(&v->clock_lock);
+                v->audio_write_frames = whole / frame_bytes;
+                taskEXIT_CRITICAL(&v->clock_lock);
+                esp_codec_dev_write(v->config.codec, block, whole);
+                int64_t now = esp_timer_get_time();
+                taskENTER_CRITICAL(&v->clock_lock);
+                v->audio_frames += whole / frame_bytes;
+                v->audio_write_time = now;
+                taskEXIT_CRITICAL(&v->clock_lock);
+            }
+            pending = len - whole;
+            memmove(block, block + whole, pending);
+        }
+
+        esp_codec_dev_close(v->config.codec);
+    }
+
+    /* The clock continues by system time */
+    v->audio_done_time = esp_timer_get_time();
+    v->audio_done_us = video_clock_us(v);
+    v->audio_done = true;
+
+    app_mem_pool_free(block);
+    xSemaphoreGive(v->exited);
+    vTaskDelete(NULL);
+}
+
+/* Decode frames in time, drop the late ones */
+static void video_decoder_task(void *arg)
+{
+    video_t *v = arg;
+    const int64_t frame_us = v->avi.info.frame_us;
+
+    while (!v->stop) {
+        uint8_t idx;
+        if (xQueueReceive(v->filled, &idx, pdMS_TO_TICKS(VIDEO_WAIT_MS)) != pdTRUE) {
+            if (v->eof && uxQueueMessagesWaiting(v->filled) == 0) {
+                break;
+            }
+            continue;
+        }
+
+        if (v->start_us == 0) {
+            v->start_us = esp_timer_get_time();
+        }
+        const int64_t pts = v->slot[idx].frame * frame_us;
+
+        /* Frame would be shown after its successor is due */
+        if (video_clock_us(v) + v->stats.decode_us_avg > pts + frame_us) {
+            atomic_fetch_add(&v->dropped, 1);
+            xQueueSend(v->empty, &idx, 0);
+            continue;
+        }
+
+        while (!v->stop && xSemaphoreTake(v->fb_free, pdMS_TO_TICKS(VIDEO_WAIT_MS)) != pdTRUE);
+        if (v->stop) {
+            break;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        esp_jpeg_image_cfg_t jpeg_cfg = {
+            .indata = v->slot_data[idx],
+            .indata_size = v->slot[idx].size,
+            .outbuf = v->fb[v->back],
+            .outbuf_size = (uint32_t)v->fb_width * v->fb_height * sizeof(uint16_t),
+            .out_format = JPEG_IMAGE_FORMAT_RGB565,
+            .out_scale = v->scale,
+            .flags = {
+                .swap_color_bytes = v->config.swap_bytes,
+            }
+        };
+        esp_jpeg_image_output_t outimg;
+        esp_err_t ret = esp_jpeg_decode(&jpeg_cfg, &outimg);
+        uint32_t decode_us = esp_timer_get_time() - t0;
+        xQueueSend(v->empty, &idx, 0);
+
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Frame %" PRIu32 " decode error", v->slot[idx].frame);
+            atomic_fetch_add(&v->dropped, 1);
+            xSemaphoreGive(v->fb_free);
+            continue;
+        }
+
+        v->decoded++;
+        v->decode_us_sum += decode_us;
+        v->stats.decode_us_avg = v->decode_us_sum / v->decoded;
+        if (decode_us > v->stats.decode_us_max) {
+            v->stats.decode_us_max = decode_us;
+        }
+
+        /* Decoding took longer than expected (the first frames have no average yet) */
+        if (video_clock_us(v) > pts + frame_us) {
+            atomic_fetch_add(&v->dropped, 1);
+            xSemaphoreGive(v->fb_free);
+            continue;
+        }
+
+        /* Hold the frame until its time and until the previous one was taken */
+        int64_t wait_us;
+        while (!v->stop && ((wait_us = pts - video_clock_us(v)) > 0 || v->ready >= 0)) {
+            uint32_t wait_ms = (wait_us > 0) ? (wait_us + 999) / 1000 : 1;
+            vTaskDelay(pdMS_TO_TICKS(wait_ms < VIDEO_WAIT_MS ? wait_ms : VIDEO_WAIT_MS) + 1);
+        }
+
+        int32_t drift = video_clock_us(v) - pts;
+        v->stats.drift_us = drift;
+        if (abs(drift) > v->stats.drift_us_max) {
+            v->stats.drift_us_max = abs(drift);
+        }
+        v->frame_width[v->back] = outimg.width;
+        v->frame_height[v->back] = outimg.height;
+        v->ready = v->back;
+        v->back ^= 1;
+    }
+
+    xSemaphoreGive(v->exited);
+    vTaskDelete(NULL);
+}
+
+/* Show the decoded frame, LVGL context */
+static void video_present_cb(lv_timer_t *timer)
+{
+    video_t *v = lv_timer_get_user_data(timer);
+    int8_t ready = v->ready;
+
+    if (ready < 0) {
+        return;
+    }
+
+    lv_canvas_set_buffer(v->canvas, v->fb[ready], v->frame_width[ready], v->frame_height[ready], LV_COLOR_FORMAT_RGB565);
+    lv_obj_center(v->canvas);
+    lv_obj_invalidate(v->canvas);
+    v->stats.frames_shown++;
+
+    /* The previous frame buffer can be decoded into */
+    if (v->shown >= 0) {
+        xSemaphoreGive(v->fb_free);
+    }
+    v->shown = ready;
+    v->ready = -1;
+}
+
+static void video_status_cb(lv_timer_t *timer)
+{
+    video_t *v = lv_timer_get_user_data(timer);
+
+    v->stats.done = v->eof && uxQueueMessagesWaiting(v->filled) == 0 && v->ready < 0;
+    v->stats.frames_dropped = atomic_load(&v->dropped);
+    lv_label_set_text_fmt(v->status, "%s%" PRIu32 " shown, %" PRIu32 " dropped, decode %" PRIu32 " ms, drift %" PRIi32 " ms",
+                          v->stats.done ? LV_SYMBOL_OK " " : "",
+                          v->stats.frames_shown, v->stats.frames_dropped,
+                          v->stats.decode_us_avg / 1000, v->stats.drift_us / 1000);
+}
+
+static void video_delete_cb(lv_event_t *e)
+{
+    video_t *v = lv_event_get_user_data(e);
+
+    lv_timer_del(v->present_timer);
+    lv_timer_del(v->status_timer);
+
+    /* Buffers live in the window arena, released after the window, so wait for all tasks */
+    v->stop = true;
+    for (int i = 0; i < VIDEO_TASKS; i++) {
+        xSemaphoreTake(v->exited, portMAX_DELAY);
+    }
+    fclose(v->file);
+    v->stats.frames_dropped = atomic_load(&v->dropped);
+
+    ESP_LOGI(TAG, "Shown %" PRIu32 ", dropped %" PRIu32 ", decode avg %" PRIu32 " us max %" PRIu32 " us, drift max %" PRIi32 " us",
+             v->stats.frames_shown, v->stats.frames_dropped, v->stats.decode_us_avg, v->stats.decode_us_max, v->stats.drift_us_max);
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+lv_obj_t *app_video_create(lv_obj_t *parent, const char *path, const app_video_config_t *config)
+{
+    /* Released with the window arena */
+    video_t *v = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, sizeof(video_t));
+    if (v == NULL) {
+        return NULL;
+    }
+
+    strlcpy(v->path, path, sizeof(v->path));
+    v->config = *config;
+    v->file = fopen(path, "rb");
+    if (v->file == NULL) {
+        return NULL;
+    }
+    if (app_avi_open(&v->avi, v->file) != ESP_OK) {
+        fclose(v->file);
+        return NULL;
+    }
+
+    /* Fit the frame to the screen by JPEG scaling */
+    v->scale = JPEG_IMAGE_SCALE_0;
+    v->fb_width = v->avi.info.width;
+    v->fb_height = v->avi.info.height;
+    while ((v->fb_width > config->max_width || v->fb_height > config->max_height) && v->scale < JPEG_IMAGE_SCALE_1_8) {
+        v->scale++;
+        v->fb_width = (v->fb_width + 1) / 2;
+        v->fb_height = (v->fb_height + 1) / 2;
+    }
+    for (int i = 0; i < 2; i++) {
+        v->fb[i] = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, (size_t)v->fb_width * v->fb_height * sizeof(uint16_t));
+    }
+    for (int i = 0; i < VIDEO_SLOTS; i++) {
+        v->slot_data[i] = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, VIDEO_SLOT_SIZE);
+    }
+    v->audio_storage = app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, VIDEO_AUDIO_BUF_SIZE + 1);
+    if (!v->fb[0] || !v->fb[1] || !v->slot_data[VIDEO_SLOTS - 1] || !v->audio_storage) {
+        ESP_LOGE(TAG, "Not enough memory for %" PRIu16 "x%" PRIu16 " video", v->fb_width, v->fb_height);
+        fclose(v->file);
+        return NULL;
+    }
+
+    v->exited = xSemaphoreCreateCountingStatic(VIDEO_TASKS, 0, &v->exited_buf);
+    v->fb_free = xSemaphoreCreateCountingStatic(2, 2, &v->fb_free_buf);
+    v->filled = xQueueCreateStatic(VIDEO_SLOTS, 1, v->filled_storage, &v->filled_buf);
+    v->empty = xQueueCreateStatic(VIDEO_SLOTS, 1, v->empty_storage, &v->empty_buf);
+    v->audio = xStreamBufferCreateStatic(VIDEO_AUDIO_BUF_SIZE, 1, v->audio_storage, &v->audio_buf);
+    for (uint8_t i = 0; i < VIDEO_SLOTS; i++) {
+        xQueueSend(v->empty, &i, 0);
+    }
+    v->ready = -1;
+    v->shown = -1;
+    portMUX_INITIALIZE(&v->clock_lock);
+    atomic_init(&v->dropped, 0);
+
+    /* Frame in the middle, statistics at the bottom */
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_size(obj, lv_pct(100), lv_pct(100));
+    lv_obj_set_style_pad_all(obj, 0, 0);
+    lv_obj_set_style_border_width(obj, 0, 0);
+    lv_obj_set_style_bg_color(obj, lv_color_black(), 0);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_user_data(obj, v);
+
+    v->canvas = lv_canvas_create(obj);
+    lv_canvas_set_buffer(v->canvas, v->fb[0], v->fb_width, v->fb_height, LV_COLOR_FORMAT_RGB565);
+    lv_obj_center(v->canvas);
+
+    v->status = lv_label_create(obj);
+    lv_obj_set_style_text_color(v->status, lv_color_white(), 0);
+    lv_obj_align(v->status, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_label_set_text(v->status, "");
+
+    /* Reader and sound first, the decoder may take the other core */
+    int tasks = 0;
+    tasks += (xTaskCreate(video_reader_task, "avi_read", 3072, v, 6, NULL) == pdPASS);
+    tasks += (xTaskCreate(video_audio_task, "avi_audio", 3072, v, 6, NULL) == pdPASS);
+    tasks += (xTaskCreate(video_decoder_task, "avi_dec", 6144, v, 4, NULL) == pdPASS);
+    for (int i = tasks; i < VIDEO_TASKS; i++) {
+        xSemaphoreGive(v->exited);
+    }
+    if (tasks < VIDEO_TASKS) {
+        ESP_LOGE(TAG, "Cannot create video tasks");
+    }
+
+    v->present_timer = lv_timer_create(video_present_cb, VIDEO_PRESENT_MS, v);
+    v->status_timer = lv_timer_create(video_status_cb, VIDEO_STATUS_MS, v);
+    lv_obj_add_event_cb(obj, video_delete_cb, LV_EVENT_DELETE, v);
+
+    return obj;
+}
+
+void app_video_get_stats(lv_obj_t *video, app_video_stats_t *stats)
+{
+    video_t *v = lv_obj_get_user_data(video);
+
+    *stats = v->stats;
+    stats->frames_dropped = atomic_load(&v->dropped);
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_codec_dev.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    esp_codec_dev_handle_t codec;   /*!< Speaker, NULL to play without sound */
+    uint16_t max_width;             /*!< Larger frames are decoded in 1/2, 1/4 or 1/8 scale */
+    uint16_t max_height;
+    bool swap_bytes;                /*!< Swap RGB565 bytes (CONFIG_LV_COLOR_16_SWAP) */
+} app_video_config_t;
+
+typedef struct {
+    uint32_t frames_shown;
+    uint32_t frames_dropped;        /*!< Frames skipped to keep up with the audio clock */
+    uint32_t decode_us_avg;
+    uint32_t decode_us_max;
+    int32_t drift_us;               /*!< Presentation time of the last frame against the clock (positive: late) */
+    int32_t drift_us_max;           /*!< Largest absolute drift */
+    bool done;                      /*!< End of the stream was reached */
+} app_video_stats_t;
+
+/**
+ * @brief Create MJPEG/AVI player and start playing
+ *
+ * The file is demuxed by one reader task. JPEG frames are decoded by a worker into two canvas
+ * buffers and presented by the audio clock (by the system timer, if the file has no sound).
+ * Late frames are dropped instead of drifting. The player state and buffers are allocated
+ * from APP_MEM_ARENA_WINDOW, the playback stops when the returned object is deleted.
+ *
+ * Clips can be made by: ffmpeg -i in.mp4 -vf scale=320:-2 -c:v mjpeg -q:v 6 -c:a pcm_s16le -ar 22050 -ac 1 out.avi
+ *
+ * @return Player object or NULL, if the file cannot be played
+ */
+lv_obj_t *app_video_create(lv_obj_t *parent, const char *path, const app_video_config_t *config);
+
+/**
+ * @brief Get playback statistics
+ */
+void app_video_get_stats(lv_obj_t *video, app_video_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Connect to the access point as Wi-Fi station and wait for IP address
+ *
+ * NVS (Wi-Fi calibration data) is initialized, erased if it is full or of another version.
+ * Lost connection is re-established in background.
+ *
+ * @return ESP_ERR_TIMEOUT if no IP address was obtained within timeout_ms
+ *         (the connection attempts continue)
+ */
+esp_err_t app_wifi_connect(const char *ssid, const char *password, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
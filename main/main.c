@@ -12,8 +12,18 @@
  */
 
 #include "esp_log.h"
+#include "esp_bit_defs.h"
 #include "bsp/esp-bsp.h"
+#include "lvgl.h"
 #include "app_disp_fs.h"
+#include "app_mem.h"
+#include "app_boot.h"
+#include "app_storage.h"
+#include "app_replay.h"
+#if CONFIG_APP_RTP
+#include "app_wifi.h"
+#include "app_rtp.h"
+#endif
 
 static const char *TAG = "example";
 
@@ -21,29 +31,133 @@ static const char *TAG = "example";
 * Private functions
 *******************************************************************************/
 
-void app_main(void)
+static esp_err_t boot_display(void)
 {
-    /* Initialize and mount SPIFFS */
-    bsp_spiffs_mount();
-
-    /* Initialize I2C (for touch and audio) */
-    bsp_i2c_init();
-
     /* Initialize display and LVGL */
-    bsp_display_start();
+    if (bsp_display_start() == NULL) {
+        return ESP_FAIL;
+    }
 
     /* Set default display brightness */
     bsp_display_brightness_set(APP_DISP_DEFAULT_BRIGHTNESS);
+    return ESP_OK;
+}
+
+static void boot_first_frame_cb(lv_event_t *e)
+{
+    app_boot_mark("first frame");
+
+    /* Only the first frame is measured, the callback would run on every frame otherwise */
+    lv_display_remove_event_cb_with_user_data(lv_display_get_default(), boot_first_frame_cb, NULL);
+}
 
+static esp_err_t boot_ui(void)
+{
     /* Add and show LVGL objects on display */
     app_disp_lvgl_show();
 
-    /* Initialize SPI flash file system and show list of files on display */
+    /* The next rendered frame is the first one with the UI */
+    bsp_display_lock(0);
+    lv_display_add_event_cb(lv_display_get_default(), boot_first_frame_cb, LV_EVENT_RENDER_READY, NULL);
+    bsp_display_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t boot_storage(void)
+{
+    esp_err_t ret = app_storage_mount();
+#if CONFIG_APP_STORAGE_BENCH
+    if (ret == ESP_OK) {
+        app_storage_bench_t bench;
+        app_storage_bench(CONFIG_APP_STORAGE_BENCH_KB * 1024, &bench);
+    }
+#endif
+    return ret;
+}
+
+static esp_err_t boot_files(void)
+{
+    /* Show list of files on display */
     app_disp_fs_init();
+    return ESP_OK;
+}
 
-    /* Initialize audio */
-    app_audio_init();
+#if CONFIG_APP_RTP
+static esp_err_t boot_wifi(void)
+{
+    /* Connection attempts continue in background after the timeout */
+    esp_err_t ret = app_wifi_connect(CONFIG_APP_WIFI_SSID, CONFIG_APP_WIFI_PASSWORD, 15000);
+    return (ret == ESP_ERR_TIMEOUT) ? ESP_OK : ret;
+}
+
+static esp_err_t boot_rtp(void)
+{
+    const app_rtp_config_t config = {
+        .port = CONFIG_APP_RTP_PORT,
+        .sample_rate = CONFIG_APP_RTP_SAMPLE_RATE,
+        .channels = CONFIG_APP_RTP_CHANNELS,
+        .min_delay_ms = CONFIG_APP_RTP_MIN_DELAY_MS,
+        .max_delay_ms = CONFIG_APP_RTP_MAX_DELAY_MS,
+        .max_ppm = CONFIG_APP_RTP_MAX_PPM,
+        .timeout_ms = CONFIG_APP_RTP_TIMEOUT_MS,
+        .stats_period_ms = CONFIG_APP_RTP_STATS_S * 1000,
+    };
+    return app_rtp_start(&config);
+}
+#endif
+
+/*
+ * Init graph: the UI is shown as soon as the display is ready, storage mount, file listing
+ * and audio codec bring-up run in background. I2C is shared by touch and audio codec,
+ * so it is initialized once before both. The table order is the sequential boot order
+ * (CONFIG_APP_BOOT_PARALLEL disabled).
+ */
+enum {
+    BOOT_STORAGE,
+    BOOT_I2C,
+    BOOT_DISPLAY,
+    BOOT_MEM,
+    BOOT_UI,
+    BOOT_FILES,
+    BOOT_AUDIO,
+#if CONFIG_APP_RTP
+    BOOT_WIFI,
+    BOOT_RTP,
+#endif
+#if CONFIG_APP_UI_REPLAY
+    BOOT_REPLAY,
+#endif
+    BOOT_STAGES,
+};
+
+static const app_boot_stage_t boot_stages[BOOT_STAGES] = {
+    [BOOT_STORAGE] = { .name = "storage", .fn = boot_storage, .background = true },
+    [BOOT_I2C] = { .name = "i2c", .fn = bsp_i2c_init },
+    [BOOT_DISPLAY] = { .name = "display", .fn = boot_display, .deps = BIT(BOOT_I2C) },
+    /* Media buffers are reserved once, windows and audio tasks take them from pools and arenas */
+    [BOOT_MEM] = { .name = "mem", .fn = app_mem_init },
+    [BOOT_UI] = { .name = "ui", .fn = boot_ui, .deps = BIT(BOOT_DISPLAY) | BIT(BOOT_MEM) },
+    [BOOT_FILES] = { .name = APP_DISP_STAGE_FILES, .fn = boot_files, .deps = BIT(BOOT_STORAGE) | BIT(BOOT_UI), .background = true },
+    [BOOT_AUDIO] = { .name = APP_DISP_STAGE_AUDIO, .fn = app_audio_init, .deps = BIT(BOOT_I2C), .background = true },
+#if CONFIG_APP_RTP
+    /* Network streams are played through the media controller of the audio stage */
+    [BOOT_WIFI] = { .name = "wifi", .fn = boot_wifi, .background = true },
+    [BOOT_RTP] = { .name = "rtp", .fn = boot_rtp, .deps = BIT(BOOT_WIFI) | BIT(BOOT_AUDIO), .background = true },
+#endif
+#if CONFIG_APP_UI_REPLAY
+    /* Input replay (or recording) starts on the complete UI */
+    [BOOT_REPLAY] = { .name = "replay", .fn = app_replay_start, .deps = BIT(BOOT_FILES) | BIT(BOOT_AUDIO), .background = true },
+#endif
+};
+
+void app_main(void)
+{
+    /* Returns when the UI is shown, the rest continues in background */
+    if (app_boot_run(boot_stages, BOOT_STAGES) != ESP_OK) {
+        ESP_LOGE(TAG, "Example initialization failed!");
+        return;
+    }
 
     ESP_LOGI(TAG, "Example initialization done.");
 
-}
\ No newline at end of file
+}
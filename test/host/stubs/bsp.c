@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: BSP display, touch and audio codecs on the host LVGL (see bsp/esp-bsp.h) */
+
+#include <time.h>
+#include <pthread.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "bsp/esp-bsp.h"
+
+/* The LVGL task runs the timers this often */
+#define BSP_LVGL_TASK_MS    (5)
+
+static pthread_mutex_t bsp_lvgl_lock;
+static lv_display_t *bsp_display;
+static lv_indev_t *bsp_touch;
+/* Codec handles, only compared by the test */
+static int bsp_speaker;
+static int bsp_microphone;
+
+static void bsp_touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    data->state = LV_INDEV_STATE_RELEASED;
+}
+
+static void bsp_lvgl_task(void *arg)
+{
+    for (;;) {
+        bsp_display_lock(0);
+        lv_timer_handler();
+        bsp_display_unlock();
+        vTaskDelay(pdMS_TO_TICKS(BSP_LVGL_TASK_MS));
+    }
+}
+
+lv_display_t *bsp_display_start(void)
+{
+    if (bsp_display) {
+        return bsp_display;
+    }
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&bsp_lvgl_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    bsp_display_lock(0);
+    bsp_display = lv_display_create(BSP_LCD_H_RES, BSP_LCD_V_RES);
+    bsp_touch = lv_indev_create();
+    lv_indev_set_type(bsp_touch, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(bsp_touch, bsp_touch_read_cb);
+    lv_indev_set_display(bsp_touch, bsp_display);
+    bsp_display_unlock();
+
+    if (xTaskCreate(bsp_lvgl_task, "lvgl", 4096, NULL, 5, NULL) != pdPASS) {
+        return NULL;
+    }
+    return bsp_display;
+}
+
+bool bsp_display_lock(uint32_t timeout_ms)
+{
+    if (timeout_ms == 0) {
+        return pthread_mutex_lock(&bsp_lvgl_lock) == 0;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return pthread_mutex_timedlock(&bsp_lvgl_lock, &deadline) == 0;
+}
+
+void bsp_display_unlock(void)
+{
+    pthread_mutex_unlock(&bsp_lvgl_lock);
+}
+
+lv_indev_t *bsp_display_get_input_dev(void)
+{
+    return bsp_touch;
+}
+
+esp_err_t bsp_display_brightness_set(int brightness_percent)
+{
+    return ESP_OK;
+}
+
+esp_codec_dev_handle_t bsp_audio_codec_speaker_init(void)
+{
+    return &bsp_speaker;
+}
+
+esp_codec_dev_handle_t bsp_audio_codec_microphone_init(void)
+{
+    return &bsp_microphone;
+}
@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host build: the display and audio part of the ESP32-S3-Box3 BSP on the host LVGL (stubs/lvgl.h),
+ * a 320x240 display without pixels and a touch panel, which is never touched. The codec handles
+ * are placeholders, the esp_codec_dev functions are provided by the test.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl.h"
+#include "esp_err.h"
+#include "esp_codec_dev.h"
+
+#define BSP_LCD_H_RES               (320)
+#define BSP_LCD_V_RES               (240)
+#define BSP_CAPS_AUDIO_MIC          (1)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create the display and its input device, start the LVGL task
+ */
+lv_display_t *bsp_display_start(void);
+
+/**
+ * @brief Take the LVGL lock (recursive), timeout_ms 0 waits forever
+ */
+bool bsp_display_lock(uint32_t timeout_ms);
+
+void bsp_display_unlock(void);
+
+lv_indev_t *bsp_display_get_input_dev(void);
+
+/**
+ * @brief Backlight is not simulated, always ESP_OK
+ */
+esp_err_t bsp_display_brightness_set(int brightness_percent);
+
+esp_codec_dev_handle_t bsp_audio_codec_speaker_init(void);
+
+esp_codec_dev_handle_t bsp_audio_codec_microphone_init(void);
+
+#ifdef __cplusplus
+}
+#endif
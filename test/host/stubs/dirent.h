@@ -0,0 +1,20 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host build: the C library directory functions, with DIR completed as the newlib header of
+ * ESP-IDF declares it (VFS implementations embed it). The C library never gets such a DIR.
+ */
+
+#pragma once
+
+#include_next <dirent.h>
+#include <stdint.h>
+
+struct __dirstream {
+    uint16_t dd_vfs_idx;
+    uint16_t dd_rsv;
+};
@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: API of the esp_codec_dev component, the codec is provided by the test */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_CODEC_DEV_OK            (0)
+#define ESP_CODEC_DEV_WRITE_FAIL    (-5)
+
+#define I2S_MCLK_MULTIPLE_384       (384)
+
+typedef void *esp_codec_dev_handle_t;
+
+typedef struct {
+    uint8_t bits_per_sample;
+    uint8_t channel;
+    uint16_t channel_mask;
+    uint32_t sample_rate;
+    int mclk_multiple;
+} esp_codec_dev_sample_info_t;
+
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs);
+int esp_codec_dev_close(esp_codec_dev_handle_t dev);
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len);
+int esp_codec_dev_read(esp_codec_dev_handle_t dev, void *data, int len);
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t dev, int volume);
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t dev, bool mute);
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t dev, float db);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: partitions in memory, the VFS registry and SPIFFS (not available) */
+
+#include <string.h>
+
+#include "esp_partition.h"
+#include "esp_vfs.h"
+#include "esp_spiffs.h"
+
+#define HOST_PARTITIONS_MAX     (4)
+#define HOST_VFS_MAX            (4)
+
+typedef struct {
+    esp_partition_t part;
+    uint8_t *data;
+} host_partition_t;
+
+typedef struct {
+    char base_path[16];
+    esp_vfs_t vfs;
+} host_vfs_t;
+
+static host_partition_t partitions[HOST_PARTITIONS_MAX];
+static int partition_count;
+static int partition_maps;
+static host_vfs_t vfs_list[HOST_VFS_MAX];
+
+/* ---------------------------- Partitions ----------------------------------- */
+
+esp_err_t host_partition_add(const char *label, esp_partition_type_t type, esp_partition_subtype_t subtype,
+                             uint8_t *data, size_t size)
+{
+    if (data == NULL) {
+        partition_count = 0;
+        return ESP_OK;
+    }
+    if (partition_count == HOST_PARTITIONS_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    host_partition_t *p = &partitions[partition_count];
+    p->part = (esp_partition_t) {
+        .type = type,
+        .subtype = subtype,
+        .address = 0x100000 * (partition_count + 1),
+        .size = size,
+    };
+    strlcpy(p->part.label, label, sizeof(p->part.label));
+    p->data = data;
+    partition_count++;
+    return ESP_OK;
+}
+
+int host_partition_mapped(void)
+{
+    return partition_maps;
+}
+
+static host_partition_t *partition_of(const esp_partition_t *part)
+{
+    for (int i = 0; i < partition_count; i++) {
+        if (&partitions[i].part == part) {
+            return &partitions[i];
+        }
+    }
+    return NULL;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    for (int i = 0; i < partition_count; i++) {
+        const esp_partition_t *part = &partitions[i].part;
+        if (part->type == type && (subtype == ESP_PARTITION_SUBTYPE_ANY || part->subtype == subtype) &&
+                (label == NULL || strcmp(part->label, label) == 0)) {
+            return part;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *part, size_t offset, void *dst, size_t size)
+{
+    host_partition_t *p = partition_of(part);
+    if (p == NULL || offset > part->size || size > part->size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, p->data + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *part, size_t offset, size_t size, esp_partition_mmap_memory_t memory,
+                             const void **out_ptr, esp_partition_mmap_handle_t *out_handle)
+{
+    host_partition_t *p = partition_of(part);
+    if (p == NULL || offset > part->size || size > part->size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_ptr = p->data + offset;
+    *out_handle = partition_maps++ + 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+    partition_maps--;
+}
+
+/* ---------------------------- VFS ------------------------------------------ */
+
+esp_err_t esp_vfs_register(const char *base_path, const esp_vfs_t *vfs, void *ctx)
+{
+    for (int i = 0; i < HOST_VFS_MAX; i++) {
+        if (vfs_list[i].base_path[0] == '\0') {
+            strlcpy(vfs_list[i].base_path, base_path, sizeof(vfs_list[i].base_path));
+            vfs_list[i].vfs = *vfs;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_vfs_unregister(const char *base_path)
+{
+    for (int i = 0; i < HOST_VFS_MAX; i++) {
+        if (strcmp(vfs_list[i].base_path, base_path) == 0) {
+            vfs_list[i].base_path[0] = '\0';
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+const esp_vfs_t *host_vfs_get(const char *base_path)
+{
+    for (int i = 0; i < HOST_VFS_MAX; i++) {
+        if (vfs_list[i].base_path[0] != '\0' && strcmp(vfs_list[i].base_path, base_path) == 0) {
+            return &vfs_list[i].vfs;
+        }
+    }
+    return NULL;
+}
+
+/* ---------------------------- SPIFFS --------------------------------------- */
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_vfs_spiffs_unregister(const char *partition_label)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_spiffs_info(const char *partition_label, size_t *total_bytes, size_t *used_bytes)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,18 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+/* Host build: warnings and errors are always printed, info only with HOST_LOG_INFO set in the environment */
+extern int host_log_info;
+
+#define ESP_LOGE(tag, format, ...)  printf("E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  printf("W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  do { if (host_log_info) { printf("I %s: " format "\n", tag, ##__VA_ARGS__); } } while (0)
+#define ESP_LOGD(tag, format, ...)  do { } while (0)
+#define ESP_LOGV(tag, format, ...)  do { } while (0)
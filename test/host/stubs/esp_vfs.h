@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host build: the registered file systems are not hooked into the C library, a test calls their
+ * operations through host_vfs_get().
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ESP_VFS_FLAG_DEFAULT        (0)
+
+typedef struct {
+    int flags;
+    ssize_t (*write)(int fd, const void *data, size_t size);
+    off_t (*lseek)(int fd, off_t size, int mode);
+    ssize_t (*read)(int fd, void *dst, size_t size);
+    int (*open)(const char *path, int flags, int mode);
+    int (*close)(int fd);
+    int (*fstat)(int fd, struct stat *st);
+    int (*stat)(const char *path, struct stat *st);
+    int (*unlink)(const char *path);
+    int (*rename)(const char *src, const char *dst);
+    DIR *(*opendir)(const char *name);
+    struct dirent *(*readdir)(DIR *pdir);
+    int (*closedir)(DIR *pdir);
+    int (*mkdir)(const char *name, mode_t mode);
+    int (*rmdir)(const char *name);
+    int (*fsync)(int fd);
+    int (*ftruncate)(int fd, off_t length);
+} esp_vfs_t;
+
+esp_err_t esp_vfs_register(const char *base_path, const esp_vfs_t *vfs, void *ctx);
+esp_err_t esp_vfs_unregister(const char *base_path);
+
+/* Host only: operations registered at base_path, NULL if none */
+const esp_vfs_t *host_vfs_get(const char *base_path);
+
+#ifdef __cplusplus
+}
+#endif
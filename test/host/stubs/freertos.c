@@ -0,0 +1,548 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host build: FreeRTOS API subset on POSIX threads. Tasks are detached threads, all
+ * priorities run at once (as on more cores). Blocking calls wait on condition variables
+ * with the timeout in ticks of 1 ms.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "freertos/stream_buffer.h"
+#include "esp_timer.h"
+
+/*******************************************************************************
+* Types definitions
+*******************************************************************************/
+struct host_task {
+    TaskFunction_t fn;
+    void *arg;
+    UBaseType_t prio;
+    BaseType_t core;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify;
+    struct host_task *next;         /*!< All tasks, the records are kept reachable for the leak checker */
+};
+
+struct host_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t item_size;
+    size_t length;
+    size_t head;
+    size_t count;
+    uint8_t *items;
+    bool own_items;
+};
+
+struct host_event_group {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    EventBits_t bits;
+};
+
+struct host_stream_buffer {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint8_t *data;
+    size_t size;
+    size_t head;
+    size_t count;
+};
+
+/*******************************************************************************
+* Local variables
+*******************************************************************************/
+static pthread_mutex_t critical_lock;
+static pthread_once_t critical_once = PTHREAD_ONCE_INIT;
+static __thread struct host_task *current_task;
+static struct host_task *all_tasks;
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+
+static void critical_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static void sync_init(pthread_mutex_t *lock, pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(lock, NULL);
+}
+
+static struct timespec deadline(TickType_t ticks)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    t.tv_sec += ticks / 1000;
+    t.tv_nsec += (long)(ticks % 1000) * 1000000;
+    if (t.tv_nsec >= 1000000000) {
+        t.tv_sec++;
+        t.tv_nsec -= 1000000000;
+    }
+    return t;
+}
+
+/* Wait on cond with lock held, false on timeout */
+static bool wait(pthread_cond_t *cond, pthread_mutex_t *lock, TickType_t ticks, const struct timespec *until)
+{
+    if (ticks == 0) {
+        return false;
+    }
+    if (ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, until) != ETIMEDOUT;
+}
+
+/* Objects created in static buffers are never deleted, they stay reachable for the leak checker */
+static void *static_keep(void *obj, void **handle)
+{
+    static void **kept;
+    static size_t kept_count;
+
+    if (obj == NULL || handle == NULL) {
+        return obj;
+    }
+    *handle = obj;
+    host_critical_enter();
+    void **grown = realloc(kept, (kept_count + 1) * sizeof(void *));
+    if (grown) {
+        kept = grown;
+        kept[kept_count++] = obj;
+    }
+    host_critical_exit();
+    return obj;
+}
+
+static void task_register(struct host_task *task)
+{
+    host_critical_enter();
+    task->next = all_tasks;
+    all_tasks = task;
+    host_critical_exit();
+}
+
+static void *task_entry(void *arg)
+{
+    current_task = arg;
+    current_task->fn(current_task->arg);
+    return NULL;
+}
+
+static struct host_task *task_self(void)
+{
+    if (current_task == NULL) {
+        /* Main thread or a thread of the test */
+        current_task = calloc(1, sizeof(struct host_task));
+        current_task->prio = 1;
+        sync_init(&current_task->lock, &current_task->cond);
+        task_register(current_task);
+    }
+    return current_task;
+}
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+void host_critical_enter(void)
+{
+    pthread_once(&critical_once, critical_init);
+    pthread_mutex_lock(&critical_lock);
+}
+
+void host_critical_exit(void)
+{
+    pthread_mutex_unlock(&critical_lock);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                                   TaskHandle_t *handle, BaseType_t core)
+{
+    (void)name;
+    (void)stack;
+
+    struct host_task *task = calloc(1, sizeof(struct host_task));
+    if (task == NULL) {
+        return pdFAIL;
+    }
+    task->fn = fn;
+    task->arg = arg;
+    task->prio = prio;
+    task->core = core == tskNO_AFFINITY ? 0 : core;
+    sync_init(&task->lock, &task->cond);
+    if (handle) {
+        *handle = task;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    task_register(task);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    /* Only self-deletion is supported, the handle stays valid (tasks may be notified late) */
+    if (task == NULL || task == current_task) {
+        pthread_exit(NULL);
+    }
+    abort();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec t = {.tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000};
+    while (nanosleep(&t, &t) != 0 && errno == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return task_self();
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+    return (task ? task : task_self())->prio;
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return task_self()->core;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    struct host_task *task = task_self();
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify == 0 && wait(&task->cond, &task->lock, ticks, &until)) {
+    }
+    uint32_t value = task->notify;
+    if (value) {
+        task->notify = clear ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return value;
+}
+
+/* ---------------------------- Queues and semaphores ------------------------ */
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *buffer)
+{
+    struct host_queue *queue = calloc(1, sizeof(struct host_queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    sync_init(&queue->lock, &queue->cond);
+    queue->item_size = item_size;
+    queue->length = length;
+    queue->items = storage;
+    if (storage == NULL && item_size) {
+        queue->items = calloc(length, item_size);
+        queue->own_items = true;
+    }
+    return static_keep(queue, buffer ? &buffer->handle : NULL);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return xQueueCreateStatic(length, item_size, NULL, NULL);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->length) {
+        if (!wait(&queue->cond, &queue->lock, ticks, &until)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFALSE;
+        }
+    }
+    if (queue->item_size && item) {
+        memcpy(&queue->items[((queue->head + queue->count) % queue->length) * queue->item_size], item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0) {
+        if (!wait(&queue->cond, &queue->lock, ticks, &until)) {
+            pthread_mutex_unlock(&queue->lock);
+            return pdFALSE;
+        }
+    }
+    if (queue->item_size) {
+        memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+    }
+    queue->count--;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->head = 0;
+    queue->count = 0;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue->own_items) {
+        free(queue->items);
+    }
+    pthread_cond_destroy(&queue->cond);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t initial, StaticSemaphore_t *buffer)
+{
+    SemaphoreHandle_t sem = xQueueCreateStatic(max, 0, NULL, buffer);
+    if (sem) {
+        sem->count = initial;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    return xSemaphoreCreateCountingStatic(max, initial, NULL);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    return xQueueReceive(sem, NULL, ticks);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    return xQueueSend(sem, NULL, 0);
+}
+
+/* ---------------------------- Event groups --------------------------------- */
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *buffer)
+{
+    struct host_event_group *group = calloc(1, sizeof(struct host_event_group));
+    if (group) {
+        sync_init(&group->lock, &group->cond);
+    }
+    return static_keep(group, buffer ? &buffer->handle : NULL);
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return xEventGroupCreateStatic(NULL);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t value = group->bits;
+    pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    pthread_mutex_lock(&group->lock);
+    EventBits_t value = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear, BaseType_t all, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+
+    pthread_mutex_lock(&group->lock);
+    for (;;) {
+        EventBits_t set = group->bits & bits;
+        if (all ? set == bits : set != 0) {
+            break;
+        }
+        if (!wait(&group->cond, &group->lock, ticks, &until)) {
+            break;
+        }
+    }
+    EventBits_t value = group->bits;
+    EventBits_t set = value & bits;
+    if (clear && (all ? set == bits : set != 0)) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&group->lock);
+    return value;
+}
+
+/* ---------------------------- Stream buffers ------------------------------- */
+
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t size, size_t trigger, uint8_t *storage, StaticStreamBuffer_t *buffer)
+{
+    (void)trigger;
+
+    struct host_stream_buffer *stream = calloc(1, sizeof(struct host_stream_buffer));
+    if (stream) {
+        sync_init(&stream->lock, &stream->cond);
+        stream->data = storage;
+        stream->size = size;
+    }
+    return static_keep(stream, buffer ? &buffer->handle : NULL);
+}
+
+size_t xStreamBufferSend(StreamBufferHandle_t stream, const void *data, size_t len, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+    const uint8_t *src = data;
+    size_t sent = 0;
+
+    pthread_mutex_lock(&stream->lock);
+    while (sent < len) {
+        if (stream->count == stream->size) {
+            if (!wait(&stream->cond, &stream->lock, ticks, &until)) {
+                break;
+            }
+            continue;
+        }
+        stream->data[(stream->head + stream->count) % stream->size] = src[sent++];
+        stream->count++;
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return sent;
+}
+
+size_t xStreamBufferReceive(StreamBufferHandle_t stream, void *data, size_t len, TickType_t ticks)
+{
+    struct timespec until = deadline(ticks);
+    uint8_t *dst = data;
+    size_t received = 0;
+
+    pthread_mutex_lock(&stream->lock);
+    while (stream->count == 0 && wait(&stream->cond, &stream->lock, ticks, &until)) {
+    }
+    while (received < len && stream->count) {
+        dst[received++] = stream->data[stream->head];
+        stream->head = (stream->head + 1) % stream->size;
+        stream->count--;
+    }
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->lock);
+    return received;
+}
+
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    size_t count = stream->count;
+    pthread_mutex_unlock(&stream->lock);
+    return count;
+}
+
+BaseType_t xStreamBufferIsEmpty(StreamBufferHandle_t stream)
+{
+    return xStreamBufferBytesAvailable(stream) == 0;
+}
+
+BaseType_t xStreamBufferReset(StreamBufferHandle_t stream)
+{
+    pthread_mutex_lock(&stream->lock);
+    stream->head = 0;
+    stream->count = 0;
+    pthread_cond_broadcast(&stream->cond);
+    pthread_mutex_unlock(&stream->lock);
+    return pdPASS;
+}
+
+void vStreamBufferDelete(StreamBufferHandle_t stream)
+{
+    pthread_cond_destroy(&stream->cond);
+    pthread_mutex_destroy(&stream->lock);
+    free(stream);
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: FreeRTOS API subset on POSIX threads (stubs/freertos.c), 1 tick = 1 ms */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t StackType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE                          (1)
+#define pdFALSE                         (0)
+#define pdPASS                          (1)
+#define pdFAIL                          (0)
+#define portMAX_DELAY                   ((TickType_t)0xFFFFFFFF)
+#define configTICK_RATE_HZ              (1000)
+#define portTICK_PERIOD_MS              (1)
+#define pdMS_TO_TICKS(ms)               ((TickType_t)(ms))
+#define configMAX_PRIORITIES            (25)
+#define portNUM_PROCESSORS              (2)
+#define tskNO_AFFINITY                  (0x7FFFFFFF)
+#define tskIDLE_PRIORITY                (0)
+
+/* Static objects only reserve memory, the host objects are allocated */
+typedef struct {
+    void *handle;
+} StaticQueue_t, StaticSemaphore_t, StaticEventGroup_t, StaticStreamBuffer_t, StaticTask_t;
+
+/* Critical sections: one recursive lock for all */
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    (0)
+#define portMUX_INITIALIZE(mux)         (*(mux) = portMUX_INITIALIZER_UNLOCKED)
+void host_critical_enter(void);
+void host_critical_exit(void);
+#define taskENTER_CRITICAL(mux)         do { (void)(mux); host_critical_enter(); } while (0)
+#define taskEXIT_CRITICAL(mux)          do { (void)(mux); host_critical_exit(); } while (0)
+#define portENTER_CRITICAL(mux)         taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux)          taskEXIT_CRITICAL(mux)
+
+#ifdef __cplusplus
+}
+#endif
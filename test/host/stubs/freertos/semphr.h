@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Semaphores are queues of zero-size items, as in FreeRTOS */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t initial, StaticSemaphore_t *buffer);
+#define xSemaphoreCreateBinary()                xSemaphoreCreateCounting(1, 0)
+#define xSemaphoreCreateBinaryStatic(buffer)    xSemaphoreCreateCountingStatic(1, 0, buffer)
+#define xSemaphoreCreateMutex()                 xSemaphoreCreateCounting(1, 1)
+#define xSemaphoreCreateMutexStatic(buffer)     xSemaphoreCreateCountingStatic(1, 1, buffer)
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+#define vSemaphoreDelete(sem)                   vQueueDelete(sem)
+
+#ifdef __cplusplus
+}
+#endif
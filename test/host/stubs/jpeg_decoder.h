@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: API of the esp_jpeg component, the decoder is provided by the test */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    JPEG_IMAGE_FORMAT_RGB888 = 0,
+    JPEG_IMAGE_FORMAT_RGB565,
+} esp_jpeg_image_format_t;
+
+typedef enum {
+    JPEG_IMAGE_SCALE_0 = 0,
+    JPEG_IMAGE_SCALE_1_2,
+    JPEG_IMAGE_SCALE_1_4,
+    JPEG_IMAGE_SCALE_1_8,
+} esp_jpeg_image_scale_t;
+
+typedef esp_jpeg_image_scale_t jpeg_image_scale_t;
+
+typedef struct {
+    uint8_t *indata;
+    uint32_t indata_size;
+    uint8_t *outbuf;
+    uint32_t outbuf_size;
+    esp_jpeg_image_format_t out_format;
+    esp_jpeg_image_scale_t out_scale;
+    struct {
+        uint8_t swap_color_bytes: 1;
+    } flags;
+    struct {
+        void *working_buffer;
+        uint32_t working_buffer_size;
+    } advanced;
+} esp_jpeg_image_cfg_t;
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint32_t output_len;
+} esp_jpeg_image_output_t;
+
+esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img);
+esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1209 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: LVGL object tree, layout, events and timers without drawing (see lvgl.h) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "esp_timer.h"
+#include "lvgl.h"
+
+#define LV_HOST_EVENTS_MAX      (8)
+#define LV_HOST_INDEVS_MAX      (4)
+#define LV_HOST_PCT_FLAG        (1 << 29)
+#define LV_HOST_CHAR_W          (8)
+#define LV_HOST_CHAR_H          (16)
+#define LV_HOST_ICON_SIZE       (16)
+#define LV_HOST_BUTTON_W        (60)
+#define LV_HOST_BUTTON_H        (40)
+#define LV_HOST_LIST_TEXT_H     (24)
+#define LV_HOST_TAB_BAR_H       (40)
+#define LV_HOST_WIN_HEADER_H    (40)
+
+/* Widget of an object, for the content size and the widget functions */
+typedef enum {
+    LV_HOST_CLASS_OBJ,
+    LV_HOST_CLASS_LABEL,
+    LV_HOST_CLASS_IMAGE,
+    LV_HOST_CLASS_TEXTAREA,
+} lv_host_class_t;
+
+typedef struct {
+    lv_event_cb_t cb;
+    lv_event_code_t filter;
+    void *user_data;
+} lv_host_event_dsc_t;
+
+struct _lv_obj_t {
+    lv_obj_t *parent;
+    lv_obj_t **children;
+    uint32_t child_cnt;
+    void *user_data;
+    lv_host_class_t cls;
+    uint32_t flags;
+    lv_state_t state;
+    char *text;
+    bool text_static;
+    int32_t min, max, value;    /*!< Slider, value is also the active tab of a tab view */
+    int32_t x, y, w, h;         /*!< Position is the offset from the alignment */
+    int32_t align;
+    bool flex;                  /*!< Children are placed one after another in the flow */
+    lv_flex_flow_t flow;
+    bool grow;                  /*!< Flex item sharing the free space of the container */
+    const void *src;
+    void *buf;
+    lv_host_event_dsc_t events[LV_HOST_EVENTS_MAX];
+    uint32_t event_cnt;
+    bool deleting;
+};
+
+struct _lv_group_t {
+    bool editing;
+};
+
+struct _lv_event_t {
+    lv_event_code_t code;
+    void *target;
+    void *user_data;
+    void *param;
+};
+
+struct _lv_timer_t {
+    lv_timer_t *next;
+    lv_timer_cb_t cb;
+    uint32_t period;
+    int64_t last_run_us;
+    void *user_data;
+};
+
+struct _lv_display_t {
+    int32_t hor_res;
+    int32_t ver_res;
+    lv_display_flush_cb_t flush_cb;
+    lv_area_t inv;              /*!< Union of the invalidated areas */
+    bool dirty;
+    lv_timer_t *refr_timer;
+    lv_host_event_dsc_t events[LV_HOST_EVENTS_MAX];
+    uint32_t event_cnt;
+};
+
+struct _lv_indev_t {
+    lv_indev_type_t type;
+    lv_indev_read_cb_t read_cb;
+    bool enabled;
+    lv_group_t *group;
+    lv_indev_state_t state;
+    lv_point_t point;
+    lv_obj_t *pressed;          /*!< Object under the pointer at the press */
+    lv_timer_t *read_timer;
+};
+
+const lv_font_t lv_font_montserrat_14;
+
+static lv_obj_t *screen;
+static lv_obj_t *top_layer;
+static lv_timer_t *timers;
+static lv_display_t *display;
+static lv_indev_t *indevs[LV_HOST_INDEVS_MAX];
+/* Object, whose event callbacks run, and whether a callback deleted it */
+static lv_obj_t *event_obj;
+static bool event_obj_deleted;
+
+/* ---------------------------- Layout -------------------------------------- */
+
+static int32_t obj_len(int32_t size, int32_t parent_size, int32_t content_size)
+{
+    if (size == LV_SIZE_CONTENT) {
+        return content_size;
+    }
+    return (size & LV_HOST_PCT_FLAG) ? parent_size * (size & ~LV_HOST_PCT_FLAG) / 100 : size;
+}
+
+static int32_t obj_content_w(const lv_obj_t *obj)
+{
+    if (obj->cls == LV_HOST_CLASS_LABEL) {
+        return obj->text ? (int32_t)strlen(obj->text) * LV_HOST_CHAR_W : 0;
+    }
+    return obj->cls == LV_HOST_CLASS_IMAGE ? LV_HOST_ICON_SIZE : 0;
+}
+
+static int32_t obj_content_h(const lv_obj_t *obj)
+{
+    if (obj->cls == LV_HOST_CLASS_LABEL) {
+        return LV_HOST_CHAR_H;
+    }
+    return obj->cls == LV_HOST_CLASS_IMAGE ? LV_HOST_ICON_SIZE : 0;
+}
+
+/* Size in the parent of pw x ph, growing flex items share what the others leave */
+static void obj_size(const lv_obj_t *obj, int32_t pw, int32_t ph, int32_t *w, int32_t *h)
+{
+    *w = obj_len(obj->w, pw, obj_content_w(obj));
+    *h = obj_len(obj->h, ph, obj_content_h(obj));
+
+    const lv_obj_t *parent = obj->parent;
+    if (!obj->grow || parent == NULL || !parent->flex) {
+        return;
+    }
+    const bool row = parent->flow == LV_FLEX_FLOW_ROW;
+    int32_t free_size = row ? pw : ph;
+    int32_t grow_cnt = 0;
+    for (uint32_t i = 0; i < parent->child_cnt; i++) {
+        const lv_obj_t *item = parent->children[i];
+        if (item->flags & LV_OBJ_FLAG_HIDDEN) {
+            continue;
+        }
+        if (item->grow) {
+            grow_cnt++;
+        } else {
+            free_size -= row ? obj_len(item->w, pw, obj_content_w(item)) : obj_len(item->h, ph, obj_content_h(item));
+        }
+    }
+    free_size = free_size > 0 ? free_size / grow_cnt : 0;
+    if (row) {
+        *w = free_size;
+    } else {
+        *h = free_size;
+    }
+}
+
+static int32_t align_x(int32_t align, int32_t pw, int32_t w)
+{
+    switch (align) {
+    case LV_ALIGN_TOP_MID:
+    case LV_ALIGN_BOTTOM_MID:
+    case LV_ALIGN_CENTER:
+        return (pw - w) / 2;
+    case LV_ALIGN_TOP_RIGHT:
+    case LV_ALIGN_BOTTOM_RIGHT:
+        return pw - w;
+    default:
+        return 0;
+    }
+}
+
+static int32_t align_y(int32_t align, int32_t ph, int32_t h)
+{
+    switch (align) {
+    case LV_ALIGN_BOTTOM_MID:
+    case LV_ALIGN_BOTTOM_RIGHT:
+        return ph - h;
+    case LV_ALIGN_LEFT_MID:
+    case LV_ALIGN_CENTER:
+        return (ph - h) / 2;
+    default:
+        return 0;
+    }
+}
+
+/* Area on the display, false if the object is hidden or not on the screen */
+static bool obj_area(const lv_obj_t *obj, lv_area_t *area)
+{
+    if (obj == screen || obj == top_layer) {
+        *area = (lv_area_t) {
+            0, 0, display ? display->hor_res - 1 : -1, display ? display->ver_res - 1 : -1
+        };
+        return display != NULL;
+    }
+    lv_area_t parent_area;
+    if (obj->parent == NULL || (obj->flags & LV_OBJ_FLAG_HIDDEN) || !obj_area(obj->parent, &parent_area)) {
+        return false;
+    }
+    const lv_obj_t *parent = obj->parent;
+    const int32_t pw = parent_area.x2 - parent_area.x1 + 1;
+    const int32_t ph = parent_area.y2 - parent_area.y1 + 1;
+    int32_t w, h;
+    obj_size(obj, pw, ph, &w, &h);
+
+    if (parent->flex) {
+        /* Flex items follow the visible items before them, the alignment is not used */
+        const bool row = parent->flow == LV_FLEX_FLOW_ROW;
+        int32_t pos = 0;
+        for (uint32_t i = 0; i < parent->child_cnt && parent->children[i] != obj; i++) {
+            int32_t item_w, item_h;
+            if (!(parent->children[i]->flags & LV_OBJ_FLAG_HIDDEN)) {
+                obj_size(parent->children[i], pw, ph, &item_w, &item_h);
+                pos += row ? item_w : item_h;
+            }
+        }
+        area->x1 = parent_area.x1 + (row ? pos : 0);
+        area->y1 = parent_area.y1 + (row ? 0 : pos);
+    } else {
+        area->x1 = parent_area.x1 + align_x(obj->align, pw, w) + obj->x;
+        area->y1 = parent_area.y1 + align_y(obj->align, ph, h) + obj->y;
+    }
+    area->x2 = area->x1 + w - 1;
+    area->y2 = area->y1 + h - 1;
+    return area->x2 >= area->x1 && area->y2 >= area->y1;
+}
+
+/* ---------------------------- Invalidation --------------------------------- */
+
+static void display_send_event(lv_event_code_t code, void *param)
+{
+    for (uint32_t i = 0; i < display->event_cnt; i++) {
+        if (display->events[i].filter == LV_EVENT_ALL || display->events[i].filter == code) {
+            lv_event_t e = {
+                .code = code, .target = display, .user_data = display->events[i].user_data, .param = param
+            };
+            display->events[i].cb(&e);
+        }
+    }
+}
+
+/* Like LVGL: the visible part of the object is redrawn by the next refresh */
+static void obj_invalidate(const lv_obj_t *obj)
+{
+    lv_area_t area;
+    if (display == NULL || !obj_area(obj, &area)) {
+        return;
+    }
+    area.x1 = area.x1 < 0 ? 0 : area.x1;
+    area.y1 = area.y1 < 0 ? 0 : area.y1;
+    area.x2 = area.x2 >= display->hor_res ? display->hor_res - 1 : area.x2;
+    area.y2 = area.y2 >= display->ver_res ? display->ver_res - 1 : area.y2;
+    if (area.x2 < area.x1 || area.y2 < area.y1) {
+        return;
+    }
+
+    if (!display->dirty) {
+        display->inv = area;
+    } else {
+        display->inv.x1 = area.x1 < display->inv.x1 ? area.x1 : display->inv.x1;
+        display->inv.y1 = area.y1 < display->inv.y1 ? area.y1 : display->inv.y1;
+        display->inv.x2 = area.x2 > display->inv.x2 ? area.x2 : display->inv.x2;
+        display->inv.y2 = area.y2 > display->inv.y2 ? area.y2 : display->inv.y2;
+    }
+    display->dirty = true;
+    display_send_event(LV_EVENT_INVALIDATE_AREA, &area);
+}
+
+/* Like LVGL: a changed flex item moves the next items, the container is redrawn */
+static void obj_invalidate_layout(const lv_obj_t *obj)
+{
+    obj_invalidate((obj->parent && obj->parent->flex) ? obj->parent : obj);
+}
+
+/* ---------------------------- Objects -------------------------------------- */
+
+lv_obj_t *lv_screen_active(void)
+{
+    if (screen == NULL) {
+        screen = lv_obj_create(NULL);
+    }
+    return screen;
+}
+
+lv_obj_t *lv_layer_top(void)
+{
+    if (top_layer == NULL) {
+        top_layer = lv_obj_create(NULL);
+        top_layer->flags = 0;
+    }
+    return top_layer;
+}
+
+lv_obj_t *lv_obj_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = calloc(1, sizeof(lv_obj_t));
+    if (obj == NULL) {
+        abort();
+    }
+    obj->parent = parent;
+    obj->max = 100;
+    obj->flags = LV_OBJ_FLAG_CLICKABLE;
+    if (parent) {
+        parent->children = realloc(parent->children, (parent->child_cnt + 1) * sizeof(lv_obj_t *));
+        parent->children[parent->child_cnt++] = obj;
+    }
+    return obj;
+}
+
+static void obj_free_text(lv_obj_t *obj)
+{
+    if (!obj->text_static) {
+        free(obj->text);
+    }
+    obj->text = NULL;
+}
+
+void lv_obj_delete(lv_obj_t *obj)
+{
+    if (obj->deleting) {
+        return;
+    }
+    obj->deleting = true;
+    obj_invalidate(obj);
+    if (obj == event_obj) {
+        event_obj_deleted = true;
+    }
+
+    /* Like LVGL: the object gets LV_EVENT_DELETE first, then the children are deleted */
+    lv_obj_send_event(obj, LV_EVENT_DELETE, NULL);
+    lv_obj_clean(obj);
+    for (int i = 0; i < LV_HOST_INDEVS_MAX; i++) {
+        if (indevs[i] && indevs[i]->pressed == obj) {
+            indevs[i]->pressed = NULL;
+        }
+    }
+
+    lv_obj_t *parent = obj->parent;
+    if (parent) {
+        for (uint32_t i = 0; i < parent->child_cnt; i++) {
+            if (parent->children[i] == obj) {
+                memmove(&parent->children[i], &parent->children[i + 1], (parent->child_cnt - i - 1) * sizeof(lv_obj_t *));
+                parent->child_cnt--;
+                break;
+            }
+        }
+    }
+    if (obj == screen) {
+        screen = NULL;
+    } else if (obj == top_layer) {
+        top_layer = NULL;
+    }
+    obj_free_text(obj);
+    free(obj->children);
+    free(obj);
+}
+
+void lv_obj_clean(lv_obj_t *obj)
+{
+    while (obj->child_cnt > 0) {
+        lv_obj_delete(obj->children[obj->child_cnt - 1]);
+    }
+}
+
+lv_obj_t *lv_obj_get_parent(const lv_obj_t *obj)
+{
+    return obj->parent;
+}
+
+lv_obj_t *lv_obj_get_child(const lv_obj_t *obj, int32_t idx)
+{
+    if (idx < 0) {
+        idx += obj->child_cnt;
+    }
+    return (idx >= 0 && (uint32_t)idx < obj->child_cnt) ? obj->children[idx] : NULL;
+}
+
+uint32_t lv_obj_get_child_count(const lv_obj_t *obj)
+{
+    return obj->child_cnt;
+}
+
+void lv_obj_set_user_data(lv_obj_t *obj, void *user_data)
+{
+    obj->user_data = user_data;
+}
+
+void *lv_obj_get_user_data(lv_obj_t *obj)
+{
+    return obj->user_data;
+}
+
+void lv_obj_add_flag(lv_obj_t *obj, uint32_t flag)
+{
+    obj_invalidate_layout(obj);
+    obj->flags |= flag;
+}
+
+void lv_obj_remove_flag(lv_obj_t *obj, uint32_t flag)
+{
+    obj->flags &= ~flag;
+    obj_invalidate_layout(obj);
+}
+
+bool lv_obj_has_flag(const lv_obj_t *obj, uint32_t flag)
+{
+    return (obj->flags & flag) == flag;
+}
+
+void lv_obj_set_size(lv_obj_t *obj, int32_t w, int32_t h)
+{
+    obj_invalidate_layout(obj);
+    obj->w = w;
+    obj->h = h;
+    obj_invalidate_layout(obj);
+}
+
+void lv_obj_set_width(lv_obj_t *obj, int32_t w)
+{
+    lv_obj_set_size(obj, w, obj->h);
+}
+
+void lv_obj_set_pos(lv_obj_t *obj, int32_t x, int32_t y)
+{
+    obj_invalidate(obj);
+    obj->x = x;
+    obj->y = y;
+    obj_invalidate(obj);
+}
+
+void lv_obj_align(lv_obj_t *obj, int32_t align, int32_t x, int32_t y)
+{
+    obj_invalidate(obj);
+    obj->align = align;
+    obj->x = x;
+    obj->y = y;
+    obj_invalidate(obj);
+}
+
+void lv_obj_center(lv_obj_t *obj)
+{
+    lv_obj_align(obj, LV_ALIGN_CENTER, 0, 0);
+}
+
+void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow)
+{
+    obj->flex = true;
+    obj->flow = flow;
+    obj_invalidate(obj);
+}
+
+/* Items start at the beginning of the flow, the flex alignment is not simulated */
+void lv_obj_set_flex_align(lv_obj_t *obj, lv_flex_align_t main_place, lv_flex_align_t cross_place,
+                           lv_flex_align_t track_cross_place) {}
+
+void lv_obj_move_foreground(lv_obj_t *obj)
+{
+    lv_obj_t *parent = obj->parent;
+    for (uint32_t i = 0; parent && i < parent->child_cnt; i++) {
+        if (parent->children[i] == obj) {
+            memmove(&parent->children[i], &parent->children[i + 1], (parent->child_cnt - i - 1) * sizeof(lv_obj_t *));
+            parent->children[parent->child_cnt - 1] = obj;
+            obj_invalidate_layout(obj);
+            break;
+        }
+    }
+}
+
+void lv_obj_add_state(lv_obj_t *obj, lv_state_t state)
+{
+    obj->state |= state;
+    obj_invalidate(obj);
+}
+
+void lv_obj_remove_state(lv_obj_t *obj, lv_state_t state)
+{
+    obj->state &= ~state;
+    obj_invalidate(obj);
+}
+
+lv_state_t lv_obj_get_state(const lv_obj_t *obj)
+{
+    return obj->state;
+}
+
+/* Style and scrolling are not simulated */
+void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t value, uint32_t selector) {}
+void lv_obj_set_style_border_width(lv_obj_t *obj, int32_t value, uint32_t selector) {}
+void lv_obj_set_style_text_font(lv_obj_t *obj, const lv_font_t *value, uint32_t selector) {}
+void lv_obj_set_style_text_color(lv_obj_t *obj, lv_color_t value, uint32_t selector) {}
+void lv_obj_set_style_bg_color(lv_obj_t *obj, lv_color_t value, uint32_t selector) {}
+void lv_obj_set_style_bg_grad_color(lv_obj_t *obj, lv_color_t value, uint32_t selector) {}
+void lv_obj_set_style_bg_grad_dir(lv_obj_t *obj, lv_grad_dir_t value, uint32_t selector) {}
+void lv_obj_set_style_bg_opa(lv_obj_t *obj, uint8_t value, uint32_t selector) {}
+void lv_obj_set_style_border_side(lv_obj_t *obj, uint32_t value, uint32_t selector) {}
+void lv_obj_set_style_pad_top(lv_obj_t *obj, int32_t value, uint32_t selector) {}
+void lv_obj_set_style_pad_bottom(lv_obj_t *obj, int32_t value, uint32_t selector) {}
+void lv_obj_set_style_pad_ver(lv_obj_t *obj, int32_t value, uint32_t selector) {}
+void lv_obj_scroll_to_y(lv_obj_t *obj, int32_t y, lv_anim_enable_t anim) {}
+
+void lv_obj_invalidate(const lv_obj_t *obj)
+{
+    obj_invalidate(obj);
+}
+
+/* ---------------------------- Events --------------------------------------- */
+
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t cb, lv_event_code_t filter, void *user_data)
+{
+    if (obj->event_cnt == LV_HOST_EVENTS_MAX) {
+        fprintf(stderr, "lvgl host: too many event callbacks\n");
+        abort();
+    }
+    obj->events[obj->event_cnt++] = (lv_host_event_dsc_t) {
+        .cb = cb, .filter = filter, .user_data = user_data
+    };
+}
+
+/* A callback may delete the object, the next callbacks are not called then */
+void lv_obj_send_event(lv_obj_t *obj, lv_event_code_t code, void *param)
+{
+    lv_obj_t *outer_obj = event_obj;
+    const bool outer_deleted = event_obj_deleted;
+    event_obj = obj;
+    event_obj_deleted = false;
+
+    for (uint32_t i = 0; !event_obj_deleted && i < obj->event_cnt; i++) {
+        if (obj->events[i].filter == LV_EVENT_ALL || obj->events[i].filter == code) {
+            lv_event_t e = {
+                .code = code, .target = obj, .user_data = obj->events[i].user_data, .param = param
+            };
+            obj->events[i].cb(&e);
+        }
+    }
+
+    event_obj = outer_obj;
+    event_obj_deleted = outer_deleted;
+}
+
+lv_event_code_t lv_event_get_code(lv_event_t *e)
+{
+    return e->code;
+}
+
+void *lv_event_get_target(lv_event_t *e)
+{
+    return e->target;
+}
+
+void *lv_event_get_user_data(lv_event_t *e)
+{
+    return e->user_data;
+}
+
+/* ---------------------------- Label ---------------------------------------- */
+
+lv_obj_t *lv_label_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->cls = LV_HOST_CLASS_LABEL;
+    obj->flags = 0;
+    obj->w = LV_SIZE_CONTENT;
+    obj->h = LV_SIZE_CONTENT;
+    obj->text = strdup("Text");
+    return obj;
+}
+
+/* The old text is invalidated too, the content size changes with the text */
+void lv_label_set_text(lv_obj_t *obj, const char *text)
+{
+    char *copy = strdup(text ? text : "");
+    obj_invalidate(obj);
+    obj_free_text(obj);
+    obj->text = copy;
+    obj->text_static = false;
+    obj_invalidate(obj);
+}
+
+void lv_label_set_text_static(lv_obj_t *obj, const char *text)
+{
+    obj_invalidate(obj);
+    obj_free_text(obj);
+    obj->text = (char *)text;
+    obj->text_static = true;
+    obj_invalidate(obj);
+}
+
+void lv_label_set_text_fmt(lv_obj_t *obj, const char *fmt, ...)
+{
+    va_list args;
+    char *text = NULL;
+
+    va_start(args, fmt);
+    if (vasprintf(&text, fmt, args) < 0) {
+        abort();
+    }
+    va_end(args);
+
+    obj_invalidate(obj);
+    obj_free_text(obj);
+    obj->text = text;
+    obj->text_static = false;
+    obj_invalidate(obj);
+}
+
+char *lv_label_get_text(const lv_obj_t *obj)
+{
+    return obj->text;
+}
+
+void lv_label_set_long_mode(lv_obj_t *obj, uint32_t mode) {}
+
+/* ---------------------------- Button and image ----------------------------- */
+
+lv_obj_t *lv_button_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->w = LV_HOST_BUTTON_W;
+    obj->h = LV_HOST_BUTTON_H;
+    return obj;
+}
+
+lv_obj_t *lv_image_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->cls = LV_HOST_CLASS_IMAGE;
+    obj->flags = 0;
+    obj->w = LV_SIZE_CONTENT;
+    obj->h = LV_SIZE_CONTENT;
+    return obj;
+}
+
+void lv_image_set_src(lv_obj_t *obj, const void *src)
+{
+    obj->src = src;
+    obj_invalidate(obj);
+}
+
+const void *lv_image_get_src(lv_obj_t *obj)
+{
+    return obj->src;
+}
+
+/* ---------------------------- Slider --------------------------------------- */
+
+lv_obj_t *lv_slider_create(lv_obj_t *parent)
+{
+    return lv_obj_create(parent);
+}
+
+void lv_slider_set_range(lv_obj_t *obj, int32_t min, int32_t max)
+{
+    obj->min = min;
+    obj->max = max;
+    obj->value = (obj->value < min) ? min : (obj->value > max) ? max : obj->value;
+}
+
+void lv_slider_set_value(lv_obj_t *obj, int32_t value, lv_anim_enable_t anim)
+{
+    obj->value = (value < obj->min) ? obj->min : (value > obj->max) ? obj->max : value;
+    obj_invalidate(obj);
+}
+
+int32_t lv_slider_get_value(const lv_obj_t *obj)
+{
+    return obj->value;
+}
+
+int32_t lv_slider_get_min_value(const lv_obj_t *obj)
+{
+    return obj->min;
+}
+
+int32_t lv_slider_get_max_value(const lv_obj_t *obj)
+{
+    return obj->max;
+}
+
+/* ---------------------------- Canvas --------------------------------------- */
+
+lv_obj_t *lv_canvas_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->flags = 0;
+    return obj;
+}
+
+/* The canvas gets the size of the buffer */
+void lv_canvas_set_buffer(lv_obj_t *obj, void *buf, int32_t w, int32_t h, lv_color_format_t cf)
+{
+    obj->buf = buf;
+    lv_obj_set_size(obj, w, h);
+}
+
+const void *lv_canvas_get_buf(lv_obj_t *obj)
+{
+    return obj->buf;
+}
+
+/* ---------------------------- Text area and keyboard ----------------------- */
+
+lv_obj_t *lv_textarea_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->cls = LV_HOST_CLASS_TEXTAREA;
+    obj->text = strdup("");
+    return obj;
+}
+
+/* Like a typed text, the change is notified */
+void lv_textarea_set_text(lv_obj_t *obj, const char *text)
+{
+    char *copy = strdup(text ? text : "");
+    obj_free_text(obj);
+    obj->text = copy;
+    obj->text_static = false;
+    obj_invalidate(obj);
+    lv_obj_send_event(obj, LV_EVENT_VALUE_CHANGED, NULL);
+}
+
+const char *lv_textarea_get_text(const lv_obj_t *obj)
+{
+    return obj->text;
+}
+
+void lv_textarea_set_one_line(lv_obj_t *obj, bool en) {}
+void lv_textarea_set_placeholder_text(lv_obj_t *obj, const char *text) {}
+
+/* Lower half of the parent, the keys are not simulated */
+lv_obj_t *lv_keyboard_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    obj->w = lv_pct(100);
+    obj->h = lv_pct(50);
+    obj->align = LV_ALIGN_BOTTOM_MID;
+    return obj;
+}
+
+void lv_keyboard_set_textarea(lv_obj_t *kb, lv_obj_t *ta) {}
+
+/* ---------------------------- List ----------------------------------------- */
+
+lv_obj_t *lv_list_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_COLUMN);
+    return obj;
+}
+
+lv_obj_t *lv_list_add_text(lv_obj_t *list, const char *txt)
+{
+    lv_obj_t *label = lv_label_create(list);
+    lv_label_set_text(label, txt);
+    lv_obj_set_size(label, lv_pct(100), LV_HOST_LIST_TEXT_H);
+    return label;
+}
+
+/* Row of the icon (if any) and the text */
+lv_obj_t *lv_list_add_button(lv_obj_t *list, const void *icon, const char *txt)
+{
+    lv_obj_t *btn = lv_button_create(list);
+    lv_obj_set_size(btn, lv_pct(100), LV_HOST_BUTTON_H);
+    lv_obj_set_flex_flow(btn, LV_FLEX_FLOW_ROW);
+    if (icon) {
+        lv_image_set_src(lv_image_create(btn), icon);
+    }
+    if (txt) {
+        lv_label_set_text(lv_label_create(btn), txt);
+    }
+    return btn;
+}
+
+const char *lv_list_get_button_text(lv_obj_t *list, lv_obj_t *btn)
+{
+    for (uint32_t i = 0; i < btn->child_cnt; i++) {
+        if (btn->children[i]->cls == LV_HOST_CLASS_LABEL) {
+            return btn->children[i]->text;
+        }
+    }
+    return "";
+}
+
+/* ---------------------------- Tab view ------------------------------------- */
+
+/* Children: the tab bar (buttons) and the content (pages) */
+lv_obj_t *lv_tabview_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_size(obj, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_COLUMN);
+
+    lv_obj_t *bar = lv_obj_create(obj);
+    lv_obj_set_size(bar, lv_pct(100), LV_HOST_TAB_BAR_H);
+    lv_obj_set_flex_flow(bar, LV_FLEX_FLOW_ROW);
+
+    lv_obj_t *content = lv_obj_create(obj);
+    lv_obj_set_size(content, lv_pct(100), 0);
+    content->grow = true;
+    return obj;
+}
+
+/* Like LVGL: a clicked tab button shows its page, then the tab view notifies the change */
+static void tabview_button_clicked_cb(lv_event_t *e)
+{
+    lv_obj_t *btn = lv_event_get_target(e);
+    lv_obj_t *tabview = lv_event_get_user_data(e);
+    lv_obj_t *bar = lv_obj_get_parent(btn);
+
+    for (uint32_t i = 0; i < bar->child_cnt; i++) {
+        if (bar->children[i] == btn) {
+            lv_tabview_set_active(tabview, i, LV_ANIM_OFF);
+            lv_obj_send_event(tabview, LV_EVENT_VALUE_CHANGED, NULL);
+            break;
+        }
+    }
+}
+
+/* Tab buttons share the bar, the pages fill the content, the first one is shown */
+lv_obj_t *lv_tabview_add_tab(lv_obj_t *obj, const char *name)
+{
+    lv_obj_t *bar = obj->children[0];
+    lv_obj_t *content = obj->children[1];
+    const bool first = content->child_cnt == 0;
+
+    lv_obj_t *page = lv_obj_create(content);
+    lv_obj_set_size(page, lv_pct(100), lv_pct(100));
+    if (!first) {
+        page->flags |= LV_OBJ_FLAG_HIDDEN;
+    }
+
+    lv_obj_t *btn = lv_button_create(bar);
+    lv_obj_set_size(btn, 0, lv_pct(100));
+    btn->grow = true;
+    btn->state = first ? LV_STATE_CHECKED : LV_STATE_DEFAULT;
+    lv_label_set_text(lv_label_create(btn), name);
+    lv_obj_add_event_cb(btn, tabview_button_clicked_cb, LV_EVENT_CLICKED, obj);
+    return page;
+}
+
+void lv_tabview_set_active(lv_obj_t *obj, uint32_t idx, lv_anim_enable_t anim)
+{
+    lv_obj_t *bar = obj->children[0];
+    lv_obj_t *content = obj->children[1];
+    if (idx >= content->child_cnt || (int32_t)idx == obj->value) {
+        return;
+    }
+    lv_obj_add_flag(content->children[obj->value], LV_OBJ_FLAG_HIDDEN);
+    lv_obj_remove_state(bar->children[obj->value], LV_STATE_CHECKED);
+    obj->value = idx;
+    lv_obj_remove_flag(content->children[idx], LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_state(bar->children[idx], LV_STATE_CHECKED);
+}
+
+uint32_t lv_tabview_get_tab_active(lv_obj_t *obj)
+{
+    return obj->value;
+}
+
+lv_obj_t *lv_tabview_get_tab_bar(lv_obj_t *obj)
+{
+    return obj->children[0];
+}
+
+void lv_tabview_set_tab_bar_size(lv_obj_t *obj, int32_t size)
+{
+    lv_obj_set_size(obj->children[0], lv_pct(100), size);
+}
+
+/* ---------------------------- Window --------------------------------------- */
+
+/* Children: the header (title and buttons in a row) and the content */
+lv_obj_t *lv_win_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_set_size(obj, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_COLUMN);
+
+    lv_obj_t *header = lv_obj_create(obj);
+    lv_obj_set_size(header, lv_pct(100), LV_HOST_WIN_HEADER_H);
+    lv_obj_set_flex_flow(header, LV_FLEX_FLOW_ROW);
+
+    lv_obj_t *content = lv_obj_create(obj);
+    lv_obj_set_size(content, lv_pct(100), 0);
+    content->grow = true;
+    return obj;
+}
+
+/* The title takes the header width left by the buttons */
+lv_obj_t *lv_win_add_title(lv_obj_t *win, const char *txt)
+{
+    lv_obj_t *title = lv_label_create(win->children[0]);
+    lv_label_set_text(title, txt);
+    title->grow = true;
+    return title;
+}
+
+lv_obj_t *lv_win_add_button(lv_obj_t *win, const void *icon, int32_t btn_w)
+{
+    lv_obj_t *btn = lv_button_create(win->children[0]);
+    lv_obj_set_size(btn, btn_w, lv_pct(100));
+    if (icon) {
+        lv_obj_t *image = lv_image_create(btn);
+        lv_image_set_src(image, icon);
+        lv_obj_center(image);
+    }
+    return btn;
+}
+
+lv_obj_t *lv_win_get_content(lv_obj_t *win)
+{
+    return win->children[1];
+}
+
+/* ---------------------------- Groups --------------------------------------- */
+
+lv_group_t *lv_group_create(void)
+{
+    lv_group_t *group = calloc(1, sizeof(lv_group_t));
+    if (group == NULL) {
+        abort();
+    }
+    return group;
+}
+
+/* Focus is not simulated */
+void lv_group_add_obj(lv_group_t *group, lv_obj_t *obj) {}
+void lv_group_remove_obj(lv_obj_t *obj) {}
+
+void lv_group_set_editing(lv_group_t *group, bool edit)
+{
+    group->editing = edit;
+}
+
+/* ---------------------------- Timers --------------------------------------- */
+
+lv_timer_t *lv_timer_create(lv_timer_cb_t cb, uint32_t period, void *user_data)
+{
+    lv_timer_t *timer = calloc(1, sizeof(lv_timer_t));
+    if (timer == NULL) {
+        abort();
+    }
+    timer->cb = cb;
+    timer->period = period;
+    timer->user_data = user_data;
+    timer->last_run_us = esp_timer_get_time();
+    timer->next = timers;
+    timers = timer;
+    return timer;
+}
+
+void lv_timer_delete(lv_timer_t *timer)
+{
+    for (lv_timer_t **t = &timers; *t; t = &(*t)->next) {
+        if (*t == timer) {
+            *t = timer->next;
+            free(timer);
+            return;
+        }
+    }
+}
+
+void *lv_timer_get_user_data(lv_timer_t *timer)
+{
+    return timer->user_data;
+}
+
+/* Run the due timers, a callback may delete its own timer */
+uint32_t lv_timer_handler(void)
+{
+    int64_t now = esp_timer_get_time();
+    lv_timer_t *timer = timers;
+
+    while (timer) {
+        lv_timer_t *next = timer->next;
+        if (now - timer->last_run_us >= (int64_t)timer->period * 1000) {
+            timer->last_run_us = now;
+            timer->cb(timer);
+        }
+        timer = next;
+    }
+    return 1;
+}
+
+/* ---------------------------- Display -------------------------------------- */
+
+static void display_refr_timer_cb(lv_timer_t *timer)
+{
+    if (display->dirty) {
+        lv_area_t area = display->inv;
+        display->dirty = false;
+        if (display->flush_cb) {
+            display->flush_cb(display, &area, NULL);
+        }
+    }
+    /* Like LVGL, also after a refresh with nothing to redraw */
+    display_send_event(LV_EVENT_REFR_READY, NULL);
+}
+
+lv_display_t *lv_display_create(int32_t hor_res, int32_t ver_res)
+{
+    if (display) {
+        fprintf(stderr, "lvgl host: one display only\n");
+        abort();
+    }
+    display = calloc(1, sizeof(lv_display_t));
+    if (display == NULL) {
+        abort();
+    }
+    display->hor_res = hor_res;
+    display->ver_res = ver_res;
+    display->refr_timer = lv_timer_create(display_refr_timer_cb, LV_DEF_REFR_PERIOD, NULL);
+    obj_invalidate(lv_screen_active());
+    return display;
+}
+
+lv_display_t *lv_display_get_default(void)
+{
+    return display;
+}
+
+void lv_display_set_flush_cb(lv_display_t *disp, lv_display_flush_cb_t flush_cb)
+{
+    disp->flush_cb = flush_cb;
+}
+
+/* The flush callback is synchronous */
+void lv_display_flush_ready(lv_display_t *disp) {}
+
+void lv_display_add_event_cb(lv_display_t *disp, lv_event_cb_t cb, lv_event_code_t filter, void *user_data)
+{
+    if (disp->event_cnt == LV_HOST_EVENTS_MAX) {
+        fprintf(stderr, "lvgl host: too many display event callbacks\n");
+        abort();
+    }
+    disp->events[disp->event_cnt++] = (lv_host_event_dsc_t) {
+        .cb = cb, .filter = filter, .user_data = user_data
+    };
+}
+
+uint32_t lv_display_remove_event_cb_with_user_data(lv_display_t *disp, lv_event_cb_t cb, void *user_data)
+{
+    uint32_t removed = 0;
+    for (uint32_t i = 0; i < disp->event_cnt;) {
+        if (disp->events[i].cb == cb && disp->events[i].user_data == user_data) {
+            memmove(&disp->events[i], &disp->events[i + 1], (disp->event_cnt - i - 1) * sizeof(lv_host_event_dsc_t));
+            disp->event_cnt--;
+            removed++;
+        } else {
+            i++;
+        }
+    }
+    return removed;
+}
+
+/* ---------------------------- Input devices -------------------------------- */
+
+/* Topmost visible, clickable and enabled object under the point, children are clipped by the parent */
+static lv_obj_t *obj_at(lv_obj_t *obj, const lv_point_t *point)
+{
+    lv_area_t area;
+    if (!obj_area(obj, &area) ||
+            point->x < area.x1 || point->x > area.x2 || point->y < area.y1 || point->y > area.y2) {
+        return NULL;
+    }
+    for (int32_t i = obj->child_cnt - 1; i >= 0; i--) {
+        lv_obj_t *found = obj_at(obj->children[i], point);
+        if (found) {
+            return found;
+        }
+    }
+    return ((obj->flags & LV_OBJ_FLAG_CLICKABLE) && !(obj->state & LV_STATE_DISABLED)) ? obj : NULL;
+}
+
+/* The top layer is over the screen */
+static lv_obj_t *indev_obj_at(const lv_point_t *point)
+{
+    lv_obj_t *obj = top_layer ? obj_at(top_layer, point) : NULL;
+    return obj ? obj : obj_at(screen, point);
+}
+
+/* Pointers press and click objects, other types are only read */
+static void indev_read_timer_cb(lv_timer_t *timer)
+{
+    lv_indev_t *indev = lv_timer_get_user_data(timer);
+    if (!indev->enabled || indev->read_cb == NULL) {
+        return;
+    }
+
+    lv_indev_data_t data = { .point = indev->point };
+    indev->read_cb(indev, &data);
+    const lv_indev_state_t prev = indev->state;
+    indev->state = data.state;
+    indev->point = data.point;
+    if (indev->type != LV_INDEV_TYPE_POINTER || screen == NULL) {
+        return;
+    }
+
+    if (data.state == LV_INDEV_STATE_PRESSED && prev == LV_INDEV_STATE_RELEASED) {
+        indev->pressed = indev_obj_at(&data.point);
+        if (indev->pressed) {
+            lv_obj_send_event(indev->pressed, LV_EVENT_PRESSED, indev);
+        }
+    } else if (data.state == LV_INDEV_STATE_RELEASED && prev == LV_INDEV_STATE_PRESSED && indev->pressed) {
+        lv_obj_t *obj = indev->pressed;
+        lv_obj_send_event(obj, LV_EVENT_RELEASED, indev);
+        /* Unless the released callback deleted it (lv_obj_delete() clears pressed) */
+        if (indev->pressed == obj && indev_obj_at(&data.point) == obj) {
+            /* Like LVGL: a checkable object toggles before the click */
+            if (obj->flags & LV_OBJ_FLAG_CHECKABLE) {
+                obj->state ^= LV_STATE_CHECKED;
+                obj_invalidate(obj);
+                lv_obj_send_event(obj, LV_EVENT_VALUE_CHANGED, indev);
+            }
+            if (indev->pressed == obj) {
+                lv_obj_send_event(obj, LV_EVENT_CLICKED, indev);
+            }
+        }
+        indev->pressed = NULL;
+    }
+}
+
+lv_indev_t *lv_indev_create(void)
+{
+    int slot = 0;
+    while (slot < LV_HOST_INDEVS_MAX && indevs[slot]) {
+        slot++;
+    }
+    lv_indev_t *indev = slot < LV_HOST_INDEVS_MAX ? calloc(1, sizeof(lv_indev_t)) : NULL;
+    if (indev == NULL) {
+        fprintf(stderr, "lvgl host: too many input devices\n");
+        abort();
+    }
+    indev->enabled = true;
+    indev->read_timer = lv_timer_create(indev_read_timer_cb, LV_DEF_REFR_PERIOD, indev);
+    indevs[slot] = indev;
+    return indev;
+}
+
+void lv_indev_delete(lv_indev_t *indev)
+{
+    for (int i = 0; i < LV_HOST_INDEVS_MAX; i++) {
+        if (indevs[i] == indev) {
+            indevs[i] = NULL;
+        }
+    }
+    lv_timer_delete(indev->read_timer);
+    free(indev);
+}
+
+void lv_indev_set_type(lv_indev_t *indev, lv_indev_type_t type)
+{
+    indev->type = type;
+}
+
+lv_indev_type_t lv_indev_get_type(const lv_indev_t *indev)
+{
+    return indev->type;
+}
+
+void lv_indev_set_read_cb(lv_indev_t *indev, lv_indev_read_cb_t read_cb)
+{
+    indev->read_cb = read_cb;
+}
+
+/* One display */
+void lv_indev_set_display(lv_indev_t *indev, lv_display_t *disp) {}
+
+void lv_indev_enable(lv_indev_t *indev, bool enable)
+{
+    indev->enabled = enable;
+}
+
+void lv_indev_set_group(lv_indev_t *indev, lv_group_t *group)
+{
+    indev->group = group;
+}
+
+lv_group_t *lv_indev_get_group(const lv_indev_t *indev)
+{
+    return indev->group;
+}
+
+lv_indev_state_t lv_indev_get_state(const lv_indev_t *indev)
+{
+    return indev->state;
+}
+
+void lv_indev_get_point(const lv_indev_t *indev, lv_point_t *point)
+{
+    *point = indev->point;
+}
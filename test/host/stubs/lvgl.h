@@ -0,0 +1,375 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Host build: the subset of the LVGL 9 API used by the tested widgets. Objects only keep what
+ * a test can check (text, slider range and value, user data, event callbacks, position and size),
+ * nothing is drawn. Timers run from lv_timer_handler(), called by the test or the LVGL task of
+ * bsp_display_start().
+ *
+ * With a display, changed objects invalidate their area and the refresh timer passes the
+ * invalidated area to the flush callback (without pixels), so the time of a frame is modeled by
+ * the test. Pointer input devices press and click the topmost clickable object under the point.
+ *
+ * Geometry is modeled coarsely, enough to hit the widgets of the UI by coordinates: alignment to
+ * the parent, flex rows and columns (the items one after another, no wrap or grow), labels of
+ * 8 x 16 px characters and the fixed parts of the tab view, list and window (tab bar, list
+ * buttons, window header with the buttons on the right). Only the active tab page is shown.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_timer_t lv_timer_t;
+typedef struct _lv_event_t lv_event_t;
+typedef struct _lv_display_t lv_display_t;
+typedef struct _lv_indev_t lv_indev_t;
+typedef struct _lv_group_t lv_group_t;
+typedef struct {
+    int dummy;
+} lv_font_t;
+typedef struct {
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+} lv_color_t;
+
+typedef enum {
+    LV_EVENT_ALL = 0,
+    LV_EVENT_PRESSED,
+    LV_EVENT_CLICKED,
+    LV_EVENT_VALUE_CHANGED,
+    LV_EVENT_DELETE,
+    LV_EVENT_RELEASED,
+    LV_EVENT_INVALIDATE_AREA,
+    LV_EVENT_REFR_READY,
+    LV_EVENT_READY,
+    LV_EVENT_CANCEL,
+    LV_EVENT_DEFOCUSED,
+} lv_event_code_t;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+} lv_point_t;
+
+typedef struct {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} lv_area_t;
+
+typedef enum {
+    LV_INDEV_TYPE_NONE,
+    LV_INDEV_TYPE_POINTER,
+    LV_INDEV_TYPE_KEYPAD,
+    LV_INDEV_TYPE_BUTTON,
+    LV_INDEV_TYPE_ENCODER,
+} lv_indev_type_t;
+
+typedef enum {
+    LV_INDEV_STATE_RELEASED = 0,
+    LV_INDEV_STATE_PRESSED,
+} lv_indev_state_t;
+
+typedef struct {
+    lv_point_t point;
+    uint32_t key;
+    uint32_t btn_id;
+    int16_t enc_diff;
+    lv_indev_state_t state;
+    bool continue_reading;
+} lv_indev_data_t;
+
+typedef void (*lv_event_cb_t)(lv_event_t *e);
+typedef void (*lv_timer_cb_t)(lv_timer_t *timer);
+typedef void (*lv_display_flush_cb_t)(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+typedef void (*lv_indev_read_cb_t)(lv_indev_t *indev, lv_indev_data_t *data);
+
+typedef enum {
+    LV_ANIM_OFF,
+    LV_ANIM_ON,
+} lv_anim_enable_t;
+
+typedef enum {
+    LV_COLOR_FORMAT_RGB565 = 0x12,
+} lv_color_format_t;
+
+typedef enum {
+    LV_FLEX_FLOW_ROW = 0x00,
+    LV_FLEX_FLOW_COLUMN = 0x01,
+} lv_flex_flow_t;
+
+typedef enum {
+    LV_FLEX_ALIGN_START,
+    LV_FLEX_ALIGN_END,
+    LV_FLEX_ALIGN_CENTER,
+} lv_flex_align_t;
+
+typedef enum {
+    LV_GRAD_DIR_NONE,
+    LV_GRAD_DIR_VER,
+    LV_GRAD_DIR_HOR,
+} lv_grad_dir_t;
+
+typedef enum {
+    LV_PALETTE_GREEN = 9,
+    LV_PALETTE_GREY = 18,
+} lv_palette_t;
+
+typedef uint16_t lv_state_t;
+
+#define LV_STATE_DEFAULT            (0x0000)
+#define LV_STATE_CHECKED            (0x0001)
+#define LV_STATE_DISABLED           (0x0080)
+
+#define LV_PART_MAIN                (0x000000)
+#define LV_PART_ITEMS               (0x050000)
+
+#define LV_BORDER_SIDE_BOTTOM       (0x01)
+
+#define LV_SYMBOL_AUDIO             "\xEF\x80\x81"
+#define LV_SYMBOL_VIDEO             "\xEF\x80\x88"
+#define LV_SYMBOL_LIST              "\xEF\x80\x8B"
+#define LV_SYMBOL_OK                "\xEF\x80\x8C"
+#define LV_SYMBOL_CLOSE             "\xEF\x80\x8D"
+#define LV_SYMBOL_SETTINGS          "\xEF\x80\x93"
+#define LV_SYMBOL_IMAGE             "\xEF\x80\xBE"
+#define LV_SYMBOL_PLAY              "\xEF\x81\x8B"
+#define LV_SYMBOL_PAUSE             "\xEF\x81\x8C"
+#define LV_SYMBOL_STOP              "\xEF\x81\x8D"
+#define LV_SYMBOL_LEFT              "\xEF\x81\x93"
+#define LV_SYMBOL_UP                "\xEF\x81\xB7"
+#define LV_SYMBOL_DOWN              "\xEF\x81\xB8"
+#define LV_SYMBOL_LOOP              "\xEF\x81\xB9"
+#define LV_SYMBOL_DIRECTORY         "\xEF\x81\xBB"
+#define LV_SYMBOL_FILE              "\xEF\x85\x9B"
+
+#define LV_LABEL_LONG_WRAP          (0)
+#define LV_LABEL_LONG_CLIP          (4)
+
+#define LV_KEY_ENTER                (10)
+
+/* Refresh and input read period (LV_DEF_REFR_PERIOD) */
+#define LV_DEF_REFR_PERIOD          (33)
+
+#define LV_OBJ_FLAG_HIDDEN          (1 << 0)
+#define LV_OBJ_FLAG_CLICKABLE       (1 << 1)
+#define LV_OBJ_FLAG_CHECKABLE       (1 << 3)
+#define LV_OBJ_FLAG_SCROLLABLE      (1 << 4)
+
+#define LV_ALIGN_CENTER             (9)
+#define LV_ALIGN_TOP_LEFT           (1)
+#define LV_ALIGN_TOP_MID            (2)
+#define LV_ALIGN_TOP_RIGHT          (3)
+#define LV_ALIGN_BOTTOM_MID         (5)
+#define LV_ALIGN_BOTTOM_RIGHT       (6)
+#define LV_ALIGN_LEFT_MID           (7)
+
+/* Size of the content: text of 8 x 16 px characters, 16 x 16 px images */
+#define LV_SIZE_CONTENT             (1 << 30)
+
+extern const lv_font_t lv_font_montserrat_14;
+
+static inline int32_t lv_pct(int32_t x)
+{
+    return x | (1 << 29);
+}
+
+static inline lv_color_t lv_color_black(void)
+{
+    return (lv_color_t) {
+        0, 0, 0
+    };
+}
+
+static inline lv_color_t lv_color_white(void)
+{
+    return (lv_color_t) {
+        0xFF, 0xFF, 0xFF
+    };
+}
+
+static inline lv_color_t lv_color_make(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (lv_color_t) {
+        b, g, r
+    };
+}
+
+/* Palette shades are not kept */
+static inline lv_color_t lv_palette_darken(lv_palette_t p, uint8_t lvl)
+{
+    return lv_color_black();
+}
+
+static inline lv_color_t lv_palette_lighten(lv_palette_t p, uint8_t lvl)
+{
+    return lv_color_white();
+}
+
+/* Objects */
+lv_obj_t *lv_obj_create(lv_obj_t *parent);
+void lv_obj_delete(lv_obj_t *obj);
+#define lv_obj_del lv_obj_delete
+void lv_obj_clean(lv_obj_t *obj);
+lv_obj_t *lv_obj_get_parent(const lv_obj_t *obj);
+lv_obj_t *lv_obj_get_child(const lv_obj_t *obj, int32_t idx);
+uint32_t lv_obj_get_child_count(const lv_obj_t *obj);
+void lv_obj_set_user_data(lv_obj_t *obj, void *user_data);
+void *lv_obj_get_user_data(lv_obj_t *obj);
+void lv_obj_add_flag(lv_obj_t *obj, uint32_t flag);
+void lv_obj_remove_flag(lv_obj_t *obj, uint32_t flag);
+#define lv_obj_clear_flag lv_obj_remove_flag
+bool lv_obj_has_flag(const lv_obj_t *obj, uint32_t flag);
+void lv_obj_set_size(lv_obj_t *obj, int32_t w, int32_t h);
+void lv_obj_set_width(lv_obj_t *obj, int32_t w);
+void lv_obj_set_pos(lv_obj_t *obj, int32_t x, int32_t y);
+void lv_obj_align(lv_obj_t *obj, int32_t align, int32_t x, int32_t y);
+void lv_obj_center(lv_obj_t *obj);
+void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t value, uint32_t selector);
+void lv_obj_set_style_border_width(lv_obj_t *obj, int32_t value, uint32_t selector);
+void lv_obj_set_style_text_font(lv_obj_t *obj, const lv_font_t *value, uint32_t selector);
+void lv_obj_set_style_text_color(lv_obj_t *obj, lv_color_t value, uint32_t selector);
+void lv_obj_set_style_bg_color(lv_obj_t *obj, lv_color_t value, uint32_t selector);
+void lv_obj_set_style_bg_grad_color(lv_obj_t *obj, lv_color_t value, uint32_t selector);
+void lv_obj_set_style_bg_grad_dir(lv_obj_t *obj, lv_grad_dir_t value, uint32_t selector);
+void lv_obj_set_style_bg_opa(lv_obj_t *obj, uint8_t value, uint32_t selector);
+void lv_obj_set_style_border_side(lv_obj_t *obj, uint32_t value, uint32_t selector);
+void lv_obj_set_style_pad_top(lv_obj_t *obj, int32_t value, uint32_t selector);
+void lv_obj_set_style_pad_bottom(lv_obj_t *obj, int32_t value, uint32_t selector);
+void lv_obj_set_style_pad_ver(lv_obj_t *obj, int32_t value, uint32_t selector);
+void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow);
+void lv_obj_set_flex_align(lv_obj_t *obj, lv_flex_align_t main_place, lv_flex_align_t cross_place,
+                           lv_flex_align_t track_cross_place);
+void lv_obj_add_state(lv_obj_t *obj, lv_state_t state);
+void lv_obj_remove_state(lv_obj_t *obj, lv_state_t state);
+#define lv_obj_clear_state lv_obj_remove_state
+lv_state_t lv_obj_get_state(const lv_obj_t *obj);
+void lv_obj_move_foreground(lv_obj_t *obj);
+void lv_obj_scroll_to_y(lv_obj_t *obj, int32_t y, lv_anim_enable_t anim);
+void lv_obj_invalidate(const lv_obj_t *obj);
+
+/* Events */
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t cb, lv_event_code_t filter, void *user_data);
+void lv_obj_send_event(lv_obj_t *obj, lv_event_code_t code, void *param);
+lv_event_code_t lv_event_get_code(lv_event_t *e);
+void *lv_event_get_target(lv_event_t *e);
+void *lv_event_get_user_data(lv_event_t *e);
+
+/* Label */
+lv_obj_t *lv_label_create(lv_obj_t *parent);
+void lv_label_set_text(lv_obj_t *obj, const char *text);
+void lv_label_set_text_static(lv_obj_t *obj, const char *text);
+void lv_label_set_text_fmt(lv_obj_t *obj, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+char *lv_label_get_text(const lv_obj_t *obj);
+void lv_label_set_long_mode(lv_obj_t *obj, uint32_t mode);
+
+/* Button and image (the source is kept, not copied) */
+lv_obj_t *lv_button_create(lv_obj_t *parent);
+#define lv_btn_create lv_button_create
+lv_obj_t *lv_image_create(lv_obj_t *parent);
+void lv_image_set_src(lv_obj_t *obj, const void *src);
+const void *lv_image_get_src(lv_obj_t *obj);
+
+/* Slider */
+lv_obj_t *lv_slider_create(lv_obj_t *parent);
+void lv_slider_set_range(lv_obj_t *obj, int32_t min, int32_t max);
+void lv_slider_set_value(lv_obj_t *obj, int32_t value, lv_anim_enable_t anim);
+int32_t lv_slider_get_value(const lv_obj_t *obj);
+int32_t lv_slider_get_min_value(const lv_obj_t *obj);
+int32_t lv_slider_get_max_value(const lv_obj_t *obj);
+
+/* Canvas: only the buffer is kept, the size is the buffer size */
+lv_obj_t *lv_canvas_create(lv_obj_t *parent);
+void lv_canvas_set_buffer(lv_obj_t *obj, void *buf, int32_t w, int32_t h, lv_color_format_t cf);
+const void *lv_canvas_get_buf(lv_obj_t *obj);
+
+/* Text area and keyboard (no keys) */
+lv_obj_t *lv_textarea_create(lv_obj_t *parent);
+void lv_textarea_set_text(lv_obj_t *obj, const char *text);
+const char *lv_textarea_get_text(const lv_obj_t *obj);
+void lv_textarea_set_one_line(lv_obj_t *obj, bool en);
+void lv_textarea_set_placeholder_text(lv_obj_t *obj, const char *text);
+lv_obj_t *lv_keyboard_create(lv_obj_t *parent);
+void lv_keyboard_set_textarea(lv_obj_t *kb, lv_obj_t *ta);
+
+/* List: a column of text labels and buttons with an icon and a label */
+lv_obj_t *lv_list_create(lv_obj_t *parent);
+lv_obj_t *lv_list_add_text(lv_obj_t *list, const char *txt);
+lv_obj_t *lv_list_add_button(lv_obj_t *list, const void *icon, const char *txt);
+#define lv_list_add_btn lv_list_add_button
+const char *lv_list_get_button_text(lv_obj_t *list, lv_obj_t *btn);
+#define lv_list_get_btn_text lv_list_get_button_text
+
+/* Tab view: tab bar on top, the content below shows the active tab page */
+lv_obj_t *lv_tabview_create(lv_obj_t *parent);
+lv_obj_t *lv_tabview_add_tab(lv_obj_t *obj, const char *name);
+void lv_tabview_set_active(lv_obj_t *obj, uint32_t idx, lv_anim_enable_t anim);
+#define lv_tabview_set_act lv_tabview_set_active
+uint32_t lv_tabview_get_tab_active(lv_obj_t *obj);
+#define lv_tabview_get_tab_act lv_tabview_get_tab_active
+lv_obj_t *lv_tabview_get_tab_bar(lv_obj_t *obj);
+#define lv_tabview_get_tab_btns lv_tabview_get_tab_bar
+void lv_tabview_set_tab_bar_size(lv_obj_t *obj, int32_t size);
+
+/* Window: header with the title and buttons, content below */
+lv_obj_t *lv_win_create(lv_obj_t *parent);
+lv_obj_t *lv_win_add_title(lv_obj_t *win, const char *txt);
+lv_obj_t *lv_win_add_button(lv_obj_t *win, const void *icon, int32_t btn_w);
+lv_obj_t *lv_win_get_content(lv_obj_t *win);
+
+/* Groups are only kept */
+lv_group_t *lv_group_create(void);
+void lv_group_add_obj(lv_group_t *group, lv_obj_t *obj);
+void lv_group_remove_obj(lv_obj_t *obj);
+void lv_group_set_editing(lv_group_t *group, bool edit);
+
+/* Timers */
+lv_timer_t *lv_timer_create(lv_timer_cb_t cb, uint32_t period, void *user_data);
+void lv_timer_delete(lv_timer_t *timer);
+#define lv_timer_del lv_timer_delete
+void *lv_timer_get_user_data(lv_timer_t *timer);
+uint32_t lv_timer_handler(void);
+
+/* Display: one, the default */
+lv_display_t *lv_display_create(int32_t hor_res, int32_t ver_res);
+lv_display_t *lv_display_get_default(void);
+void lv_display_set_flush_cb(lv_display_t *disp, lv_display_flush_cb_t flush_cb);
+void lv_display_flush_ready(lv_display_t *disp);
+void lv_display_add_event_cb(lv_display_t *disp, lv_event_cb_t cb, lv_event_code_t filter, void *user_data);
+uint32_t lv_display_remove_event_cb_with_user_data(lv_display_t *disp, lv_event_cb_t cb, void *user_data);
+
+/* Input devices, groups are only kept */
+lv_indev_t *lv_indev_create(void);
+void lv_indev_delete(lv_indev_t *indev);
+void lv_indev_set_type(lv_indev_t *indev, lv_indev_type_t type);
+lv_indev_type_t lv_indev_get_type(const lv_indev_t *indev);
+void lv_indev_set_read_cb(lv_indev_t *indev, lv_indev_read_cb_t read_cb);
+void lv_indev_set_display(lv_indev_t *indev, lv_display_t *disp);
+void lv_indev_enable(lv_indev_t *indev, bool enable);
+void lv_indev_set_group(lv_indev_t *indev, lv_group_t *group);
+lv_group_t *lv_indev_get_group(const lv_indev_t *indev);
+lv_indev_state_t lv_indev_get_state(const lv_indev_t *indev);
+void lv_indev_get_point(const lv_indev_t *indev, lv_point_t *point);
+
+/* Host only: screen object, parent of the tested widgets */
+lv_obj_t *lv_screen_active(void);
+#define lv_scr_act lv_screen_active
+/* Drawn and clicked over the screen */
+lv_obj_t *lv_layer_top(void);
+
+#ifdef __cplusplus
+}
+#endif
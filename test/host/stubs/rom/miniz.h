@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: the tinfl subset of the ROM miniz used by the PNG decoder, on top of zlib */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <zlib.h>
+
+typedef uint8_t mz_uint8;
+typedef uint32_t mz_uint32;
+
+#define TINFL_LZ_DICT_SIZE      (32768)
+
+enum {
+    TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+    TINFL_FLAG_HAS_MORE_INPUT = 2,
+};
+
+typedef enum {
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+/*
+ * zlib keeps its own window, so the output may go anywhere in the caller's buffer. The zlib state is
+ * not in the decompressor (freed by the arena without any call), one stream is decoded at a time.
+ */
+typedef struct {
+    int inited;
+} tinfl_decompressor;
+
+static z_stream tinfl_zs;
+static int tinfl_zs_live;
+
+static inline void tinfl_zs_end(void)
+{
+    if (tinfl_zs_live) {
+        inflateEnd(&tinfl_zs);
+        tinfl_zs_live = 0;
+    }
+}
+
+static inline void tinfl_init(tinfl_decompressor *r)
+{
+    tinfl_zs_end();
+    r->inited = 0;
+}
+
+static inline tinfl_status tinfl_decompress(tinfl_decompressor *r, const mz_uint8 *in, size_t *in_size,
+                                            mz_uint8 *start, mz_uint8 *next, size_t *out_size, mz_uint32 flags)
+{
+    (void)start;
+    (void)flags;
+    if (!r->inited) {
+        tinfl_zs_end();
+        memset(&tinfl_zs, 0, sizeof(tinfl_zs));
+        if (inflateInit(&tinfl_zs) != Z_OK) {
+            return TINFL_STATUS_FAILED;
+        }
+        tinfl_zs_live = 1;
+        r->inited = 1;
+    }
+    tinfl_zs.next_in = (Bytef *)in;
+    tinfl_zs.avail_in = *in_size;
+    tinfl_zs.next_out = next;
+    tinfl_zs.avail_out = *out_size;
+    int z = inflate(&tinfl_zs, Z_NO_FLUSH);
+    *in_size -= tinfl_zs.avail_in;
+    *out_size -= tinfl_zs.avail_out;
+    if (z == Z_STREAM_END || (z != Z_OK && z != Z_BUF_ERROR)) {
+        tinfl_zs_end();
+        return (z == Z_STREAM_END) ? TINFL_STATUS_DONE : TINFL_STATUS_FAILED;
+    }
+    return (tinfl_zs.avail_out == 0) ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Host build: defaults of main/Kconfig.projbuild, a test may override them by compile definitions */
+
+#pragma once
+
+/* Voice activity triggered recording */
+#ifndef CONFIG_APP_VAD_PREROLL_MS
+#define CONFIG_APP_VAD_PREROLL_MS           500
+#endif
+#ifndef CONFIG_APP_VAD_HANGOVER_MS
+#define CONFIG_APP_VAD_HANGOVER_MS          800
+#endif
+#ifndef CONFIG_APP_VAD_ATTACK_MS
+#define CONFIG_APP_VAD_ATTACK_MS            40
+#endif
+#ifndef CONFIG_APP_VAD_THRESHOLD_DB
+#define CONFIG_APP_VAD_THRESHOLD_DB         9
+#endif
+#ifndef CONFIG_APP_VAD_MIN_ENERGY
+#define CONFIG_APP_VAD_MIN_ENERGY           20000
+#endif
+
+/* Media memory */
+#ifndef CONFIG_APP_MEM_AUDIO_BLOCKS
+#define CONFIG_APP_MEM_AUDIO_BLOCKS         5
+#endif
+#ifndef CONFIG_APP_MEM_IO_BLOCKS
+#define CONFIG_APP_MEM_IO_BLOCKS            2
+#endif
+#ifndef CONFIG_APP_MEM_WINDOW_ARENA_KB
+#define CONFIG_APP_MEM_WINDOW_ARENA_KB      512
+#endif
+#ifndef CONFIG_APP_MEM_PLAY_ARENA_KB
+#define CONFIG_APP_MEM_PLAY_ARENA_KB        16
+#endif
+#ifndef CONFIG_APP_MEM_REC_ARENA_KB
+#define CONFIG_APP_MEM_REC_ARENA_KB         64
+#endif
+
+/* Image decoding */
+#ifndef CONFIG_APP_COLOR_OPTIMIZED
+#define CONFIG_APP_COLOR_OPTIMIZED          1
+#endif
+#ifndef CONFIG_APP_COLOR_OPTIMIZED_BLEND
+#define CONFIG_APP_COLOR_OPTIMIZED_BLEND    0
+#endif
+
+/* Video player */
+#ifndef CONFIG_APP_VIDEO_MAX_FRAME_KB
+#define CONFIG_APP_VIDEO_MAX_FRAME_KB       48
+#endif
+
+/* Boot */
+#ifndef CONFIG_APP_BOOT_PARALLEL
+#define CONFIG_APP_BOOT_PARALLEL            1
+#endif
+
+/* Storage */
+#ifndef CONFIG_APP_STORAGE_CACHE_BLOCKS
+#define CONFIG_APP_STORAGE_CACHE_BLOCKS     16
+#endif
+#ifndef CONFIG_APP_STORAGE_READAHEAD_BLOCKS
+#define CONFIG_APP_STORAGE_READAHEAD_BLOCKS 4
+#endif
@@ -0,0 +1,274 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Asset pack (app_assets): round trip of a pack built by tools/mkassetpack.py, every file read back
+ * through the VFS and app_assets_get() must equal its source; corrupt headers and indexes must be
+ * rejected without reading outside the image.
+ *
+ *   test_assets <pack.bin> <source dir>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_vfs.h"
+#include "app_assets.h"
+#include "test_util.h"
+
+#define PARTITION_SIZE      (4 * 1024 * 1024)
+
+static uint8_t *load(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    *size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *data = malloc(*size + 1);
+    if (fread(data, 1, *size, f) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(f);
+    return data;
+}
+
+/* Reads the file in random pieces with random seeks back, compares with the source */
+static void check_file(const esp_vfs_t *vfs, const char *name, const uint8_t *expected, size_t size, uint32_t *rnd)
+{
+    char path[300];
+    snprintf(path, sizeof(path), "/%s", name);
+
+    struct stat st;
+    TEST_CHECK(vfs->stat(path, &st) == 0 && (size_t)st.st_size == size && S_ISREG(st.st_mode), "stat %s", name);
+
+    int fd = vfs->open(path, O_RDONLY, 0);
+    TEST_CHECK(fd >= 0, "open %s", name);
+    if (fd < 0) {
+        return;
+    }
+    TEST_CHECK(vfs->fstat(fd, &st) == 0 && (size_t)st.st_size == size, "fstat %s", name);
+
+    uint8_t *buf = malloc(size + 1);
+    size_t pos = 0;
+    bool same = true;
+    while (pos < size) {
+        size_t len = 1 + test_rand(rnd) % 5000;
+        ssize_t got = vfs->read(fd, &buf[pos], len);
+        if (got <= 0 || memcmp(&buf[pos], &expected[pos], got) != 0) {
+            same = false;
+            break;
+        }
+        pos += got;
+        if (test_rand(rnd) % 8 == 0) {
+            /* Back a little, relative to the start, the position and the end */
+            size_t back = test_rand(rnd) % ((pos < 4096 ? pos : 4096) + 1);
+            int whence = test_rand(rnd) % 3;
+            off_t offset = (whence == SEEK_SET) ? (off_t)(pos - back) : (whence == SEEK_CUR) ? -(off_t)back :
+                           (off_t)(pos - back) - (off_t)size;
+            TEST_CHECK(vfs->lseek(fd, offset, whence) == (off_t)(pos - back), "%s: seek %d %jd", name, whence, (intmax_t)offset);
+            pos -= back;
+        }
+    }
+    TEST_CHECK(same && vfs->read(fd, buf, 1) == 0, "%s: content differs at %zu", name, pos);
+    TEST_CHECK(vfs->lseek(fd, -1, SEEK_SET) < 0 && errno == EINVAL, "%s: seek before start", name);
+    TEST_CHECK(vfs->close(fd) == 0, "close %s", name);
+
+    /* Mapped data without copying */
+    const uint8_t *data;
+    size_t data_size;
+    snprintf(path, sizeof(path), APP_ASSETS_MOUNT_POINT "/%s", name);
+    TEST_CHECK(app_assets_get(path, &data, &data_size) == ESP_OK && data_size == size && memcmp(data, expected, size) == 0,
+               "app_assets_get %s", name);
+    free(buf);
+}
+
+static void test_round_trip(const char *dir_path)
+{
+    const esp_vfs_t *vfs = host_vfs_get(APP_ASSETS_MOUNT_POINT);
+    TEST_CHECK(vfs != NULL, "pack not mounted");
+    if (vfs == NULL) {
+        return;
+    }
+
+    /* Every source file is in the pack with the same content */
+    uint32_t rnd = 5, sources = 0;
+    DIR *dir = opendir(dir_path);
+    struct dirent *de;
+    while (dir && (de = readdir(dir)) != NULL) {
+        char path[600];
+        size_t size;
+        snprintf(path, sizeof(path), "%s/%s", dir_path, de->d_name);
+        uint8_t *expected = (de->d_type == DT_REG) ? load(path, &size) : NULL;
+        if (expected) {
+            check_file(vfs, de->d_name, expected, size, &rnd);
+            free(expected);
+            sources++;
+        }
+    }
+    if (dir) {
+        closedir(dir);
+    }
+
+    /* And nothing else */
+    uint32_t listed = 0;
+    DIR *pack_dir = vfs->opendir("/");
+    TEST_CHECK(pack_dir != NULL, "opendir");
+    TEST_CHECK(vfs->opendir("/") == NULL, "one directory stream at a time");
+    while (pack_dir && vfs->readdir(pack_dir) != NULL) {
+        listed++;
+    }
+    if (pack_dir) {
+        vfs->closedir(pack_dir);
+    }
+    TEST_CHECK(sources > 0 && listed == sources, "%" PRIu32 " files listed, %" PRIu32 " in the source", listed, sources);
+    printf("%" PRIu32 " files read back\n", sources);
+
+    /* Read-only, missing files, descriptor limit */
+    TEST_CHECK(vfs->open("/new.txt", O_WRONLY | O_CREAT, 0) < 0 && errno == EROFS, "write open");
+    TEST_CHECK(vfs->open("/missing", O_RDONLY, 0) < 0 && errno == ENOENT, "missing file");
+    pack_dir = vfs->opendir("/");
+    de = vfs->readdir(pack_dir);
+    char first[300];
+    snprintf(first, sizeof(first), "/%s", de->d_name);
+    vfs->closedir(pack_dir);
+    int fds[16], opened = 0;
+    while (opened < 16 && (fds[opened] = vfs->open(first, O_RDONLY, 0)) >= 0) {
+        opened++;
+    }
+    TEST_CHECK(opened > 0 && opened < 16 && errno == ENFILE, "%d files opened", opened);
+    while (opened > 0) {
+        vfs->close(fds[--opened]);
+    }
+}
+
+/* Header and index corruption: rejected with the right error, no read outside (ASan) */
+static void test_corrupt(const uint8_t *pack, size_t pack_size)
+{
+    const app_assets_header_t *orig = (const app_assets_header_t *)pack;
+    size_t image_size = orig->image_size;
+    uint8_t *image = malloc(image_size);
+    app_assets_header_t *header = (app_assets_header_t *)image;
+    app_assets_entry_t *entries = (app_assets_entry_t *)(image + sizeof(app_assets_header_t));
+
+#define RESET() memcpy(image, pack, image_size)
+#define REINDEX() header->index_crc = esp_rom_crc32_le(0, (const uint8_t *)entries, header->count * sizeof(app_assets_entry_t))
+
+    RESET();
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_OK, "valid pack");
+
+    /* Truncated images, also shorter than the header */
+    for (size_t size = 0; size < sizeof(app_assets_header_t) + header->count * sizeof(app_assets_entry_t) + 64; size++) {
+        uint8_t *copy = malloc(size ? size : 1);
+        memcpy(copy, pack, size);
+        TEST_CHECK(app_assets_check(copy, size) != ESP_OK, "truncated to %zu B", size);
+        free(copy);
+    }
+
+    RESET();
+    header->magic ^= 1;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_NOT_FOUND, "magic");
+    RESET();
+    header->version++;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_VERSION, "version");
+    RESET();
+    header->entry_size--;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_VERSION, "entry size");
+
+    /* Counts whose index size wraps 32 bits, or exceeds the image */
+    static const uint32_t counts[] = { UINT32_MAX, 0x80000001, 0x04000001, 0x04000000 };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        RESET();
+        header->count = counts[i];
+        TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "count 0x%08" PRIx32, counts[i]);
+    }
+    RESET();
+    header->count = (image_size - sizeof(app_assets_header_t)) / sizeof(app_assets_entry_t) + 1;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "index past the image");
+
+    RESET();
+    header->image_size = sizeof(app_assets_header_t) - 1;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "image smaller than the header");
+    RESET();
+    header->image_size = image_size + 1;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "image larger than the data");
+
+    RESET();
+    entries[0].name[0] ^= 1;
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_CRC, "index CRC");
+
+    /* Entries outside the image, with a valid index CRC */
+    RESET();
+    entries[0].offset = image_size - entries[0].size + 1;
+    REINDEX();
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "entry past the end");
+    RESET();
+    entries[0].offset = 16;
+    entries[0].size = UINT32_MAX - 8;
+    REINDEX();
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "entry size wraps");
+    RESET();
+    memset(entries[0].name, 'x', APP_ASSETS_NAME_LEN);
+    REINDEX();
+    TEST_CHECK(app_assets_check(image, image_size) == ESP_ERR_INVALID_SIZE, "name without NUL");
+
+    /* A corrupt pack is not mounted and not left mapped */
+    RESET();
+    header->count = 0x04000001;
+    uint8_t *part = calloc(1, PARTITION_SIZE);
+    memcpy(part, image, image_size);
+    host_partition_add(NULL, 0, 0, NULL, 0);
+    host_partition_add(APP_ASSETS_PARTITION, ESP_PARTITION_TYPE_DATA, APP_ASSETS_SUBTYPE, part, PARTITION_SIZE);
+    TEST_CHECK(app_assets_init() == ESP_ERR_NOT_FOUND && host_partition_mapped() == 0, "corrupt pack mounted");
+    host_partition_add(NULL, 0, 0, NULL, 0);
+    TEST_CHECK(app_assets_init() == ESP_ERR_NOT_FOUND, "no partition");
+    host_partition_add(APP_ASSETS_PARTITION, ESP_PARTITION_TYPE_DATA, APP_ASSETS_SUBTYPE, (uint8_t *)pack, image_size - 1);
+    TEST_CHECK(app_assets_init() == ESP_ERR_NOT_FOUND && host_partition_mapped() == 0, "pack larger than partition");
+    host_partition_add(NULL, 0, 0, NULL, 0);
+
+    free(part);
+    free(image);
+    (void)pack_size;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("usage: test_assets <pack.bin> <source dir>\n");
+        return 2;
+    }
+
+    size_t pack_size;
+    uint8_t *pack = load(argv[1], &pack_size);
+    TEST_CHECK(pack != NULL && pack_size >= sizeof(app_assets_header_t), "read %s", argv[1]);
+    if (pack == NULL || pack_size < sizeof(app_assets_header_t)) {
+        return test_result("test_assets");
+    }
+
+    /* Corrupt packs first, the valid one stays mounted */
+    test_corrupt(pack, pack_size);
+
+    uint8_t *part = calloc(1, PARTITION_SIZE);
+    TEST_CHECK(pack_size <= PARTITION_SIZE, "pack of %zu B", pack_size);
+    memcpy(part, pack, pack_size < PARTITION_SIZE ? pack_size : PARTITION_SIZE);
+    host_partition_add(APP_ASSETS_PARTITION, ESP_PARTITION_TYPE_DATA, APP_ASSETS_SUBTYPE, part, PARTITION_SIZE);
+    TEST_CHECK(app_assets_init() == ESP_OK, "app_assets_init");
+    test_round_trip(argv[2]);
+
+    free(part);
+    free(pack);
+    return test_result("test_assets");
+}
@@ -0,0 +1,426 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Audio decoders (app_audio_dec): accepted and rejected WAV variants, IMA ADPCM decode against
+ * the encoder's reconstruction, seeking, and decode CPU time per second of audio.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "app_mem.h"
+#include "app_audio_dec.h"
+#include "test_util.h"
+
+#define WAV_FORMAT_PCM          (0x0001)
+#define WAV_FORMAT_IEEE_FLOAT   (0x0003)
+#define WAV_FORMAT_IMA_ADPCM    (0x0011)
+#define WAV_FORMAT_EXTENSIBLE   (0xFFFE)
+
+/* Output block of the media controller */
+#define OUT_BLOCK_BYTES         (1024)
+
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* ---------------------------- WAV writers ---------------------------------- */
+
+static void put16(FILE *f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put32(FILE *f, uint32_t v)
+{
+    put16(f, v & 0xFFFF);
+    put16(f, v >> 16);
+}
+
+/* Test signal: two tones and a little noise, at about -12 dBFS */
+static int16_t *make_signal(size_t frames, uint16_t channels, uint32_t sample_rate)
+{
+    uint32_t rnd = 12345;
+    int16_t *pcm = malloc(frames * channels * sizeof(int16_t));
+    for (size_t i = 0; i < frames; i++) {
+        for (uint16_t c = 0; c < channels; c++) {
+            double t = (double)i / sample_rate;
+            double v = 5000 * sin(2 * M_PI * (440 + 110 * c) * t) + 3000 * sin(2 * M_PI * 2500 * t) +
+                       (int)(test_rand(&rnd) % 401) - 200;
+            pcm[i * channels + c] = (int16_t)v;
+        }
+    }
+    return pcm;
+}
+
+/* RIFF WAV with a LIST chunk of odd size before "fmt " (padding) and "data" */
+static FILE *wav_write(uint16_t format, uint16_t channels, uint32_t sample_rate, uint16_t bits, uint16_t block_align,
+                       const uint8_t *ext, size_t ext_len, const void *data, uint32_t data_size)
+{
+    FILE *f = tmpfile();
+    const uint32_t fmt_size = 16 + (ext_len ? 2 + ext_len : 0);
+
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 4 + (8 + 5 + 1) + (8 + fmt_size) + (8 + data_size));
+    fwrite("WAVE", 1, 4, f);
+    fwrite("LIST", 1, 4, f);
+    put32(f, 5);
+    fwrite("INFOx\0", 1, 6, f);
+    fwrite("fmt ", 1, 4, f);
+    put32(f, fmt_size);
+    put16(f, format);
+    put16(f, channels);
+    put32(f, sample_rate);
+    put32(f, sample_rate * block_align);
+    put16(f, block_align);
+    put16(f, bits);
+    if (ext_len) {
+        put16(f, ext_len);
+        fwrite(ext, 1, ext_len, f);
+    }
+    fwrite("data", 1, 4, f);
+    put32(f, data_size);
+    fwrite(data, 1, data_size, f);
+    fflush(f);
+    return f;
+}
+
+/* WAVE_FORMAT_EXTENSIBLE extension: valid bits, channel mask, SubFormat GUID of the format tag */
+static FILE *wav_write_extensible(uint16_t sub_format, uint16_t channels, uint32_t sample_rate, uint16_t bits,
+                                  const void *data, uint32_t data_size)
+{
+    uint8_t ext[22] = {
+        (uint8_t)bits, 0, 0x03, 0, 0, 0,
+        (uint8_t)sub_format, (uint8_t)(sub_format >> 8), 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+        0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+    };
+    return wav_write(WAV_FORMAT_EXTENSIBLE, channels, sample_rate, bits, channels * bits / 8, ext, sizeof(ext),
+                     data, data_size);
+}
+
+/* Header of older firmware recordings (dumb_wav_header_t in app_disp_fs.c) */
+static FILE *wav_write_legacy(uint16_t channels, uint32_t sample_rate, uint16_t bits, const void *data, uint32_t data_size)
+{
+    FILE *f = tmpfile();
+    uint8_t zero[22] = { 0 };
+
+    fwrite(zero, 1, 22, f);
+    put16(f, channels);
+    put32(f, sample_rate);
+    fwrite(zero, 1, 6, f);
+    put16(f, bits);
+    fwrite(zero, 1, 4, f);
+    put32(f, data_size);
+    fwrite(data, 1, data_size, f);
+    fflush(f);
+    return f;
+}
+
+/* IMA ADPCM encoder with the decoder's reconstruction (as tools/wav2ima.py) */
+static uint8_t ima_encode(int32_t *predictor, int32_t *index, int16_t sample)
+{
+    int32_t step = step_table[*index];
+    int32_t diff = sample - *predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    int32_t delta = step >> 3;
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+        delta += step;
+    }
+    if (diff >= step >> 1) {
+        nibble |= 2;
+        diff -= step >> 1;
+        delta += step >> 1;
+    }
+    if (diff >= step >> 2) {
+        nibble |= 1;
+        delta += step >> 2;
+    }
+    *predictor += (nibble & 8) ? -delta : delta;
+    *predictor = *predictor > 32767 ? 32767 : (*predictor < -32768 ? -32768 : *predictor);
+    *index += index_table[nibble];
+    *index = *index < 0 ? 0 : (*index > 88 ? 88 : *index);
+    return nibble;
+}
+
+/* Encode frames into IMA ADPCM blocks, recon gets the samples the decoder must output */
+static uint8_t *ima_encode_stream(const int16_t *pcm, size_t frames, uint16_t channels, uint16_t block_align,
+                                  uint32_t *data_size, int16_t *recon)
+{
+    const size_t spb = (block_align - 4 * channels) * 2 / channels + 1;
+    const size_t blocks = (frames + spb - 1) / spb;
+    uint8_t *data = calloc(blocks, block_align);
+    int32_t pred[2] = { 0 }, idx[2] = { 0 };
+
+    for (size_t b = 0; b < blocks; b++) {
+        uint8_t *blk = &data[b * block_align];
+        size_t f0 = b * spb;
+        for (uint16_t c = 0; c < channels; c++) {
+            int16_t first = f0 < frames ? pcm[f0 * channels + c] : 0;
+            pred[c] = first;
+            blk[4 * c] = first & 0xFF;
+            blk[4 * c + 1] = (uint16_t)first >> 8;
+            blk[4 * c + 2] = (uint8_t)idx[c];
+            blk[4 * c + 3] = 0;
+            if (f0 < frames) {
+                recon[f0 * channels + c] = first;
+            }
+        }
+        uint8_t *out = &blk[4 * channels];
+        for (size_t g = 0; g < (spb - 1) / 8; g++) {
+            for (uint16_t c = 0; c < channels; c++) {
+                for (int k = 0; k < 8; k += 2) {
+                    size_t fa = f0 + 1 + g * 8 + k;
+                    int16_t sa = fa < frames ? pcm[fa * channels + c] : 0;
+                    int16_t sb = fa + 1 < frames ? pcm[(fa + 1) * channels + c] : 0;
+                    uint8_t lo = ima_encode(&pred[c], &idx[c], sa);
+                    if (fa < frames) {
+                        recon[fa * channels + c] = (int16_t)pred[c];
+                    }
+                    uint8_t hi = ima_encode(&pred[c], &idx[c], sb);
+                    if (fa + 1 < frames) {
+                        recon[(fa + 1) * channels + c] = (int16_t)pred[c];
+                    }
+                    *out++ = lo | (hi << 4);
+                }
+            }
+        }
+    }
+    *data_size = blocks * block_align;
+    return data;
+}
+
+static FILE *wav_write_ima(uint16_t channels, uint32_t sample_rate, uint16_t block_align, const uint8_t *data,
+                           uint32_t data_size)
+{
+    uint16_t spb = (block_align - 4 * channels) * 2 / channels + 1;
+    uint8_t ext[2] = { spb & 0xFF, spb >> 8 };
+    return wav_write(WAV_FORMAT_IMA_ADPCM, channels, sample_rate, 4, block_align, ext, sizeof(ext), data, data_size);
+}
+
+/* ---------------------------- Decoding ------------------------------------- */
+
+/* Decode the whole stream, returns number of samples or -1 if not accepted */
+static long decode_all(FILE *f, int16_t *out, size_t max_samples, app_audio_info_t *info, const char **name)
+{
+    void *ctx = NULL;
+    const app_audio_decoder_t *dec = app_audio_dec_open(APP_FILE_TYPE_WAV, f, &ctx, info);
+    if (dec == NULL) {
+        return -1;
+    }
+    if (name) {
+        *name = dec->name;
+    }
+
+    size_t total = 0;
+    uint8_t block[OUT_BLOCK_BYTES];
+    for (;;) {
+        size_t len = 0;
+        TEST_CHECK(dec->decode(ctx, block, sizeof(block), &len) == ESP_OK, "decode error");
+        if (len == 0) {
+            break;
+        }
+        size_t n = len / sizeof(int16_t);
+        if (out && total + n <= max_samples) {
+            memcpy(&out[total], block, len);
+        }
+        total += n;
+    }
+    dec->close(ctx);
+    return (long)total;
+}
+
+static void expect_rejected(const char *name, FILE *f)
+{
+    app_audio_info_t info;
+    TEST_CHECK(decode_all(f, NULL, 0, &info, NULL) < 0, "%s accepted", name);
+    fclose(f);
+}
+
+/* A frame past the end is rejected, also when its byte offset wraps around 32 bits */
+static void expect_seek_rejected(const char *name, FILE *f, uint32_t frame)
+{
+    void *ctx;
+    app_audio_info_t info;
+    const app_audio_decoder_t *dec = app_audio_dec_open(APP_FILE_TYPE_WAV, f, &ctx, &info);
+    TEST_CHECK(dec != NULL, "%s reopen", name);
+    if (dec) {
+        TEST_CHECK(dec->seek(ctx, frame) == ESP_ERR_INVALID_ARG, "%s seek to %" PRIu32 " accepted", name, frame);
+        dec->close(ctx);
+    }
+}
+
+static void test_pcm_variants(void)
+{
+    const size_t frames = 4000;
+    int16_t *pcm = make_signal(frames, 2, 16000);
+    int16_t *out = malloc(frames * 2 * sizeof(int16_t));
+    app_audio_info_t info;
+    const char *name = NULL;
+    long n;
+
+    /* Plain PCM, stereo, with padded foreign chunk */
+    FILE *f = wav_write(WAV_FORMAT_PCM, 2, 16000, 16, 4, NULL, 0, pcm, frames * 4);
+    n = decode_all(f, out, frames * 2, &info, &name);
+    TEST_CHECK(n == (long)frames * 2 && memcmp(out, pcm, frames * 4) == 0, "PCM stereo: %ld samples", n);
+    TEST_CHECK(info.channels == 2 && info.sample_rate == 16000 && info.total_frames == frames, "PCM info");
+    expect_seek_rejected("PCM", f, 0x40000000);
+    fclose(f);
+
+    /* EXTENSIBLE with KSDATAFORMAT_SUBTYPE_PCM */
+    f = wav_write_extensible(WAV_FORMAT_PCM, 2, 16000, 16, pcm, frames * 4);
+    n = decode_all(f, out, frames * 2, &info, &name);
+    TEST_CHECK(n == (long)frames * 2 && memcmp(out, pcm, frames * 4) == 0, "EXTENSIBLE PCM: %ld samples", n);
+    fclose(f);
+
+    /* Legacy recording header, mono */
+    f = wav_write_legacy(1, 22050, 16, pcm, frames * 2);
+    n = decode_all(f, out, frames * 2, &info, &name);
+    TEST_CHECK(n == (long)frames && memcmp(out, pcm, frames * 2) == 0, "legacy: %ld samples", n);
+    TEST_CHECK(info.sample_rate == 22050 && info.channels == 1, "legacy info");
+    fclose(f);
+
+    /* Float, EXTENSIBLE float and unknown SubFormat, non-PCM block alignment */
+    expect_rejected("float", wav_write(WAV_FORMAT_IEEE_FLOAT, 1, 16000, 32, 4, NULL, 0, pcm, frames * 4));
+    expect_rejected("EXTENSIBLE float", wav_write_extensible(WAV_FORMAT_IEEE_FLOAT, 1, 16000, 32, pcm, frames * 4));
+    expect_rejected("EXTENSIBLE unknown", wav_write_extensible(0x1234, 1, 16000, 16, pcm, frames * 2));
+    uint8_t short_ext[2] = { 16, 0 };
+    expect_rejected("EXTENSIBLE without GUID",
+                    wav_write(WAV_FORMAT_EXTENSIBLE, 1, 16000, 16, 2, short_ext, sizeof(short_ext), pcm, frames * 2));
+    expect_rejected("PCM bad block align", wav_write(WAV_FORMAT_PCM, 2, 16000, 16, 3, NULL, 0, pcm, frames * 4));
+
+    /* Files without RIFF header other than the legacy recording header */
+    f = tmpfile();
+    for (int i = 0; i < 200; i++) {
+        fprintf(f, "Not a WAV file, line %d\n", i);
+    }
+    fflush(f);
+    expect_rejected("text file", f);
+    f = tmpfile();
+    fwrite(pcm, 1, frames * 2, f);
+    fflush(f);
+    expect_rejected("raw PCM", f);
+    f = tmpfile();
+    fwrite("RIFF", 1, 4, f);
+    fflush(f);
+    expect_rejected("truncated", f);
+
+    free(out);
+    free(pcm);
+}
+
+static void test_ima(uint16_t channels, uint16_t block_align)
+{
+    const uint32_t rate = 22050;
+    const size_t frames = rate * 2 + 123;
+    int16_t *pcm = make_signal(frames, channels, rate);
+    int16_t *recon = calloc(frames * channels, sizeof(int16_t));
+    int16_t *out = calloc(frames * channels + 4096, sizeof(int16_t));
+    uint32_t data_size;
+    uint8_t *data = ima_encode_stream(pcm, frames, channels, block_align, &data_size, recon);
+    FILE *f = wav_write_ima(channels, rate, block_align, data, data_size);
+    app_audio_info_t info;
+    const char *name = NULL;
+
+    long n = decode_all(f, out, frames * channels + 4096, &info, &name);
+    const size_t spb = (block_align - 4 * channels) * 2 / channels + 1;
+    const size_t padded = ((frames + spb - 1) / spb) * spb;
+    TEST_CHECK(name && strcmp(name, "WAV IMA ADPCM") == 0, "decoder %s", name ? name : "none");
+    TEST_CHECK(n == (long)(padded * channels), "IMA %u ch: %ld samples, expected %zu", channels, n, padded * channels);
+    TEST_CHECK(memcmp(out, recon, frames * channels * sizeof(int16_t)) == 0, "IMA %u ch: differs from the encoder",
+               channels);
+
+    /* Quality against the original */
+    double sig = 0, err = 0;
+    for (size_t i = 0; i < frames * channels; i++) {
+        sig += (double)pcm[i] * pcm[i];
+        err += (double)(out[i] - pcm[i]) * (out[i] - pcm[i]);
+    }
+    double snr = 10 * log10(sig / (err + 1));
+    printf("IMA ADPCM %u ch, block %u: %ld samples, SNR %.1f dB\n", channels, block_align, n, snr);
+    TEST_CHECK(snr > 20, "IMA SNR %.1f dB", snr);
+
+    /* Seek into the middle of a block gives the same samples */
+    void *ctx;
+    const app_audio_decoder_t *dec = app_audio_dec_open(APP_FILE_TYPE_WAV, f, &ctx, &info);
+    TEST_CHECK(dec != NULL, "reopen");
+    if (dec) {
+        const uint32_t frame = (uint32_t)(spb * 7 + 100);
+        int16_t block[256];
+        size_t len;
+        TEST_CHECK(dec->seek(ctx, frame) == ESP_OK, "seek");
+        TEST_CHECK(dec->decode(ctx, block, sizeof(block), &len) == ESP_OK && len == sizeof(block), "decode after seek");
+        TEST_CHECK(memcmp(block, &recon[frame * channels], sizeof(block)) == 0, "seek to %" PRIu32 " differs", frame);
+        dec->close(ctx);
+    }
+    const uint64_t wrap_frame = (((uint64_t)1 << 32) / block_align) * spb;
+    if (wrap_frame <= UINT32_MAX) {
+        expect_seek_rejected("IMA", f, (uint32_t)wrap_frame);
+    }
+
+    fclose(f);
+    free(data);
+    free(out);
+    free(recon);
+    free(pcm);
+}
+
+/* Decode time per second of audio, over a 60 s file */
+static void bench(const char *name, FILE *f, uint32_t sample_rate, uint32_t frames)
+{
+    app_audio_info_t info;
+    double t0 = test_now_us();
+    long n = decode_all(f, NULL, 0, &info, NULL);
+    double us = test_now_us() - t0;
+    TEST_CHECK(n > 0, "%s not decoded", name);
+    printf("bench %-22s %7.1f us per second of audio (%.3f%% of one core)\n", name, us / (frames / (double)sample_rate),
+           us / (frames / (double)sample_rate) / 1e4);
+    fclose(f);
+}
+
+int main(void)
+{
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    TEST_CHECK(app_mem_arena_begin(APP_MEM_ARENA_PLAY) == ESP_OK, "PLAY arena busy");
+
+    test_pcm_variants();
+    test_ima(1, 256);
+    test_ima(1, 512);
+    test_ima(2, 1024);
+    test_ima(2, 256);
+
+    const uint32_t rate = 22050, frames = rate * 60;
+    int16_t *pcm = make_signal(frames, 1, rate);
+    int16_t *recon = malloc(frames * sizeof(int16_t));
+    uint32_t data_size;
+    uint8_t *data = ima_encode_stream(pcm, frames, 1, 512, &data_size, recon);
+    bench("PCM 22.05 kHz mono", wav_write(WAV_FORMAT_PCM, 1, rate, 16, 2, NULL, 0, pcm, frames * 2), rate, frames);
+    bench("IMA ADPCM 22.05 kHz mono", wav_write_ima(1, rate, 512, data, data_size), rate, frames);
+    free(data);
+    free(recon);
+    free(pcm);
+
+    app_mem_arena_end(APP_MEM_ARENA_PLAY);
+    return test_result("test_audio_dec");
+}
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Boot init graph (app_boot) on a modeled board: the stages of main.c sleep for their typical
+ * duration. Every stage must start after its dependencies, the parallel boot must overlap the
+ * background stages, the sequential one (CONFIG_APP_BOOT_PARALLEL=0) must keep the table order.
+ * A failed stage skips its dependents.
+ *
+ *   test_boot           boot of the modeled board
+ *   test_boot fail      boot with failing I2C
+ */
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_bit_defs.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "app_boot.h"
+#include "test_util.h"
+
+/* Modeled durations (ms) of the stages, in main.c order */
+enum {
+    BOOT_STORAGE,
+    BOOT_I2C,
+    BOOT_DISPLAY,
+    BOOT_MEM,
+    BOOT_UI,
+    BOOT_FILES,
+    BOOT_AUDIO,
+    BOOT_STAGES,
+};
+
+static const int stage_ms[BOOT_STAGES] = {
+    [BOOT_STORAGE] = 150,
+    [BOOT_I2C] = 2,
+    [BOOT_DISPLAY] = 60,
+    [BOOT_MEM] = 3,
+    [BOOT_UI] = 20,
+    [BOOT_FILES] = 30,
+    [BOOT_AUDIO] = 40,
+};
+
+static volatile int64_t stage_start[BOOT_STAGES];
+static volatile int64_t stage_end[BOOT_STAGES];
+static volatile bool stage_ran[BOOT_STAGES];
+static bool fail_i2c;
+
+static esp_err_t stage_run(int index)
+{
+    stage_start[index] = esp_timer_get_time();
+    stage_ran[index] = true;
+    vTaskDelay(pdMS_TO_TICKS(stage_ms[index]));
+    stage_end[index] = esp_timer_get_time();
+    return (index == BOOT_I2C && fail_i2c) ? ESP_FAIL : ESP_OK;
+}
+
+/* LVGL task of the display: the first frame is rendered after the UI is built */
+static void lvgl_task(void *arg)
+{
+    while (stage_end[BOOT_UI] == 0) {
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    vTaskDelay(pdMS_TO_TICKS(15));
+    app_boot_mark("first frame");
+    /* Later frames do not move the milestone */
+    app_boot_mark("first frame");
+    vTaskDelete(NULL);
+}
+
+static esp_err_t boot_storage(void)
+{
+    return stage_run(BOOT_STORAGE);
+}
+
+static esp_err_t boot_i2c(void)
+{
+    return stage_run(BOOT_I2C);
+}
+
+static esp_err_t boot_display(void)
+{
+    esp_err_t ret = stage_run(BOOT_DISPLAY);
+    xTaskCreate(lvgl_task, "lvgl", 4096, NULL, 5, NULL);
+    return ret;
+}
+
+static esp_err_t boot_mem(void)
+{
+    return stage_run(BOOT_MEM);
+}
+
+static esp_err_t boot_ui(void)
+{
+    return stage_run(BOOT_UI);
+}
+
+static esp_err_t boot_files(void)
+{
+    return stage_run(BOOT_FILES);
+}
+
+static esp_err_t boot_audio(void)
+{
+    return stage_run(BOOT_AUDIO);
+}
+
+static const app_boot_stage_t boot_stages[BOOT_STAGES] = {
+    [BOOT_STORAGE] = { .name = "storage", .fn = boot_storage, .background = true },
+    [BOOT_I2C] = { .name = "i2c", .fn = boot_i2c },
+    [BOOT_DISPLAY] = { .name = "display", .fn = boot_display, .deps = BIT(BOOT_I2C) },
+    [BOOT_MEM] = { .name = "mem", .fn = boot_mem },
+    [BOOT_UI] = { .name = "ui", .fn = boot_ui, .deps = BIT(BOOT_DISPLAY) | BIT(BOOT_MEM) },
+    [BOOT_FILES] = { .name = "files", .fn = boot_files, .deps = BIT(BOOT_STORAGE) | BIT(BOOT_UI), .background = true },
+    [BOOT_AUDIO] = { .name = "audio", .fn = boot_audio, .deps = BIT(BOOT_I2C), .background = true },
+};
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_invalid(void)
+{
+    /* Dependency on a later stage (it could be a cycle) */
+    static const app_boot_stage_t forward[] = {
+        { .name = "a", .fn = boot_mem, .deps = BIT(1) },
+        { .name = "b", .fn = boot_mem },
+    };
+    TEST_CHECK(app_boot_run(forward, 2) == ESP_ERR_INVALID_ARG, "forward dependency accepted");
+    TEST_CHECK(app_boot_run(boot_stages, 0) == ESP_ERR_INVALID_ARG, "empty table accepted");
+    TEST_CHECK(app_boot_run(boot_stages, APP_BOOT_MAX_STAGES + 1) == ESP_ERR_INVALID_ARG, "too many stages accepted");
+    TEST_CHECK(app_boot_wait("storage", 0) == ESP_ERR_NOT_FOUND, "wait before boot");
+    TEST_CHECK(!stage_ran[BOOT_MEM], "stage of an invalid table ran");
+}
+
+static void test_boot(void)
+{
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = app_boot_run(boot_stages, BOOT_STAGES);
+    int64_t returned = esp_timer_get_time();
+    TEST_CHECK(ret == ESP_OK, "app_boot_run: 0x%x", ret);
+
+#if CONFIG_APP_BOOT_PARALLEL
+    /* Storage mount is still running, the UI is up */
+    TEST_CHECK(stage_end[BOOT_UI] != 0 && app_boot_wait("storage", 0) == ESP_ERR_TIMEOUT,
+               "foreground stages waited for the storage");
+#endif
+    TEST_CHECK(app_boot_wait("files", portMAX_DELAY) == ESP_OK, "files stage");
+    TEST_CHECK(app_boot_wait("audio", pdMS_TO_TICKS(1000)) == ESP_OK, "audio stage");
+    TEST_CHECK(app_boot_wait("wifi", 0) == ESP_ERR_NOT_FOUND, "unknown stage found");
+    TEST_CHECK(app_boot_run(boot_stages, BOOT_STAGES) == ESP_ERR_INVALID_ARG, "second boot accepted");
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    int total_ms = 0;
+    int64_t end = start;
+    for (int i = 0; i < BOOT_STAGES; i++) {
+        total_ms += stage_ms[i];
+        end = stage_end[i] > end ? stage_end[i] : end;
+        for (int d = 0; d < BOOT_STAGES; d++) {
+            if (boot_stages[i].deps & BIT(d)) {
+                TEST_CHECK(stage_start[i] >= stage_end[d], "%s started before %s finished", boot_stages[i].name,
+                           boot_stages[d].name);
+            }
+        }
+#if !CONFIG_APP_BOOT_PARALLEL
+        TEST_CHECK(i == 0 || stage_start[i] >= stage_end[i - 1], "%s started before %s finished",
+                   boot_stages[i].name, boot_stages[i - 1].name);
+#endif
+    }
+
+    int boot_ms = (end - start) / 1000;
+    int ui_ms = (stage_end[BOOT_UI] - start) / 1000;
+    printf("boot %d ms (stages %d ms), UI at %d ms, app_boot_run returned at %d ms\n", boot_ms, total_ms, ui_ms,
+           (int)((returned - start) / 1000));
+#if CONFIG_APP_BOOT_PARALLEL
+    /* Critical path: display, UI and files after the storage */
+    TEST_CHECK(boot_ms < total_ms * 3 / 4, "parallel boot took %d ms of %d ms", boot_ms, total_ms);
+    TEST_CHECK(ui_ms < stage_ms[BOOT_STORAGE], "UI waited for the storage (%d ms)", ui_ms);
+#else
+    TEST_CHECK(boot_ms >= total_ms, "sequential boot took %d ms of %d ms", boot_ms, total_ms);
+#endif
+}
+
+/* I2C fails: display, UI, files and audio are skipped, storage and mem run */
+static void test_fail(void)
+{
+    fail_i2c = true;
+    esp_err_t ret = app_boot_run(boot_stages, BOOT_STAGES);
+    TEST_CHECK(ret == ESP_FAIL, "app_boot_run: 0x%x", ret);
+
+    TEST_CHECK(app_boot_wait("audio", portMAX_DELAY) == ESP_ERR_INVALID_STATE, "audio not skipped");
+    TEST_CHECK(app_boot_wait("files", portMAX_DELAY) == ESP_ERR_INVALID_STATE, "files not skipped");
+    TEST_CHECK(app_boot_wait("storage", portMAX_DELAY) == ESP_OK, "storage failed");
+    TEST_CHECK(app_boot_wait("mem", 0) == ESP_OK, "mem failed");
+    TEST_CHECK(app_boot_wait("i2c", 0) == ESP_FAIL, "i2c did not fail");
+
+    static const int skipped[] = { BOOT_DISPLAY, BOOT_UI, BOOT_FILES, BOOT_AUDIO };
+    for (size_t i = 0; i < sizeof(skipped) / sizeof(skipped[0]); i++) {
+        TEST_CHECK(!stage_ran[skipped[i]], "%s ran", boot_stages[skipped[i]].name);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    test_invalid();
+    if (argc > 1 && strcmp(argv[1], "fail") == 0) {
+        test_fail();
+    } else {
+        test_boot();
+    }
+    return test_result("test_boot");
+}
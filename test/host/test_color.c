@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Color kernels (app_color): the optimized variants must be bit-exact with the reference ones for
+ * every source/destination alignment and length, plus throughput of both in megapixels per second.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "app_color.h"
+#include "test_util.h"
+
+#define FRAME_W     (320)
+#define FRAME_H     (240)
+#define FRAME_PX    (FRAME_W * FRAME_H)
+
+/* Canary around the written range, detects writes past the end */
+#define GUARD       (8)
+
+static uint8_t src_bytes[FRAME_PX * 4 + 16] __attribute__((aligned(4)));
+static uint16_t dst_ansi[640 * 480 + 2 + 2 * GUARD];
+static uint16_t dst_opt[640 * 480 + 2 + 2 * GUARD];
+
+static void fill_random(void *buf, size_t size, uint32_t seed)
+{
+    uint8_t *p = buf;
+    for (size_t i = 0; i < size; i++) {
+        p[i] = test_rand(&seed) >> 24;
+    }
+}
+
+/* Both destinations start with the same random content (the blend reads it) */
+static void reset_dst(size_t pixels)
+{
+    fill_random(dst_ansi, (pixels + 2 * GUARD) * sizeof(uint16_t), 99);
+    memcpy(dst_opt, dst_ansi, (pixels + 2 * GUARD) * sizeof(uint16_t));
+}
+
+static bool same_dst(size_t pixels)
+{
+    return memcmp(dst_ansi, dst_opt, (pixels + 2 * GUARD) * sizeof(uint16_t)) == 0;
+}
+
+static void test_exact(void)
+{
+    /* Byte offsets of the source and pixel offsets of the destination cover all alignments */
+    for (int src_off = 0; src_off < 4; src_off++) {
+        for (int dst_off = 0; dst_off < 2; dst_off++) {
+            for (size_t n = 0; n < 67; n++) {
+                const uint8_t *src = &src_bytes[src_off];
+
+                reset_dst(n + dst_off);
+                app_color_rgb888_to_rgb565_ansi(src, &dst_ansi[GUARD + dst_off], n);
+                app_color_rgb888_to_rgb565_opt(src, &dst_opt[GUARD + dst_off], n);
+                TEST_CHECK(same_dst(n + dst_off), "rgb888_to_rgb565 src+%d dst+%d n=%zu", src_off, dst_off, n);
+
+                reset_dst(n + dst_off);
+                app_color_swap_rgb565_ansi(&dst_ansi[GUARD + dst_off], n);
+                app_color_swap_rgb565_opt(&dst_opt[GUARD + dst_off], n);
+                TEST_CHECK(same_dst(n + dst_off), "swap_rgb565 dst+%d n=%zu", dst_off, n);
+
+                reset_dst(n + dst_off);
+                app_color_blend_rgba8888_to_rgb565_ansi(src, &dst_ansi[GUARD + dst_off], n);
+                app_color_blend_rgba8888_to_rgb565_opt(src, &dst_opt[GUARD + dst_off], n);
+                TEST_CHECK(same_dst(n + dst_off), "blend_rgba8888 src+%d dst+%d n=%zu", src_off, dst_off, n);
+            }
+        }
+    }
+
+    /* Every alpha value over every channel extreme */
+    uint8_t rgba[256 * 4];
+    for (int a = 0; a < 256; a++) {
+        rgba[4 * a] = a;
+        rgba[4 * a + 1] = 255 - a;
+        rgba[4 * a + 2] = (a & 1) ? 255 : 0;
+        rgba[4 * a + 3] = a;
+    }
+    for (int bg = 0; bg < 2; bg++) {
+        for (int i = 0; i < 256 + 2 * GUARD; i++) {
+            dst_ansi[i] = dst_opt[i] = bg ? 0xFFFF : 0x0000;
+        }
+        app_color_blend_rgba8888_to_rgb565_ansi(rgba, &dst_ansi[GUARD], 256);
+        app_color_blend_rgba8888_to_rgb565_opt(rgba, &dst_opt[GUARD], 256);
+        TEST_CHECK(same_dst(256), "blend alpha ramp over 0x%04x", bg ? 0xFFFF : 0);
+    }
+
+    /* Downscale, upscale, odd sizes and an odd destination start */
+    static const uint16_t sizes[][4] = {
+        { 320, 240, 100, 75 }, { 320, 240, 640, 480 }, { 37, 23, 13, 7 }, { 100, 100, 33, 99 },
+        { 5, 5, 320, 240 }, { 320, 240, 319, 239 }, { 1, 1, 3, 1 }, { 3, 1, 1, 1 },
+    };
+    const uint16_t *src = (const uint16_t *)src_bytes;
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        const uint16_t *s = sizes[k];
+        size_t pixels = (size_t)s[2] * s[3];
+        for (int dst_off = 0; dst_off < 2; dst_off++) {
+            reset_dst(pixels + dst_off);
+            app_color_scale_nearest_rgb565_ansi(src, s[0], s[1], &dst_ansi[GUARD + dst_off], s[2], s[3]);
+            app_color_scale_nearest_rgb565_opt(src, s[0], s[1], &dst_opt[GUARD + dst_off], s[2], s[3]);
+            TEST_CHECK(same_dst(pixels + dst_off), "scale_nearest %ux%u -> %ux%u dst+%d", s[0], s[1], s[2], s[3], dst_off);
+
+            reset_dst(pixels + dst_off);
+            app_color_scale_bilinear_rgb565_ansi(src, s[0], s[1], &dst_ansi[GUARD + dst_off], s[2], s[3]);
+            app_color_scale_bilinear_rgb565_opt(src, s[0], s[1], &dst_opt[GUARD + dst_off], s[2], s[3]);
+            TEST_CHECK(same_dst(pixels + dst_off), "scale_bilinear %ux%u -> %ux%u dst+%d", s[0], s[1], s[2], s[3], dst_off);
+        }
+    }
+
+    /* Bilinear halving of a 2x2 pattern gives the average of each pixel quad */
+    const uint16_t quad[4] = { 0xF800, 0x07E0, 0x001F, 0xFFFF };
+    uint16_t avg[2];
+    app_color_scale_bilinear_rgb565_ansi(quad, 2, 2, avg, 1, 1);
+    app_color_scale_bilinear_rgb565_opt(quad, 2, 2, &avg[1], 1, 1);
+    TEST_CHECK(avg[0] == 0x7BEF && avg[1] == 0x7BEF, "bilinear 2x2 average: %04x %04x", avg[0], avg[1]);
+
+    /* Reference values */
+    TEST_CHECK(app_color_rgb565(0xFF, 0x80, 0x08) == 0xFC01, "rgb565 packing");
+    uint16_t px[2] = { 0xFFFF, 0x1234 };
+    const uint8_t opaque_clear[8] = { 0, 0, 0, 255, 0xFF, 0xFF, 0xFF, 0 };
+    app_color_blend_rgba8888_to_rgb565_opt(opaque_clear, px, 2);
+    TEST_CHECK(px[0] == 0x0000 && px[1] == 0x1234, "opaque/transparent blend: %04x %04x", px[0], px[1]);
+}
+
+#define BENCH(name, pixels, call_ansi, call_opt) do {                                   \
+        double t0 = test_now_us();                                                      \
+        for (int i = 0; i < rounds; i++) { call_ansi; }                                 \
+        double t1 = test_now_us();                                                      \
+        for (int i = 0; i < rounds; i++) { call_opt; }                                  \
+        double t2 = test_now_us();                                                      \
+        printf("%-20s ansi %7.1f Mpx/s   opt %7.1f Mpx/s\n", name,                      \
+               (double)rounds * (pixels) / (t1 - t0), (double)rounds * (pixels) / (t2 - t1)); \
+    } while (0)
+
+static void bench(void)
+{
+    const int rounds = 100;
+    const uint16_t *src = (const uint16_t *)src_bytes;
+    uint16_t *a = &dst_ansi[GUARD];
+    uint16_t *o = &dst_opt[GUARD];
+
+    BENCH("rgb888_to_rgb565", FRAME_PX, app_color_rgb888_to_rgb565_ansi(src_bytes, a, FRAME_PX),
+          app_color_rgb888_to_rgb565_opt(src_bytes, o, FRAME_PX));
+    BENCH("swap_rgb565", FRAME_PX, app_color_swap_rgb565_ansi(a, FRAME_PX), app_color_swap_rgb565_opt(o, FRAME_PX));
+    BENCH("scale_nearest 1/2", FRAME_PX / 4, app_color_scale_nearest_rgb565_ansi(src, FRAME_W, FRAME_H, a, FRAME_W / 2, FRAME_H / 2),
+          app_color_scale_nearest_rgb565_opt(src, FRAME_W, FRAME_H, o, FRAME_W / 2, FRAME_H / 2));
+    BENCH("scale_bilinear 1/2", FRAME_PX / 4, app_color_scale_bilinear_rgb565_ansi(src, FRAME_W, FRAME_H, a, FRAME_W / 2, FRAME_H / 2),
+          app_color_scale_bilinear_rgb565_opt(src, FRAME_W, FRAME_H, o, FRAME_W / 2, FRAME_H / 2));
+    BENCH("blend_rgba8888", FRAME_PX, app_color_blend_rgba8888_to_rgb565_ansi(src_bytes, a, FRAME_PX),
+          app_color_blend_rgba8888_to_rgb565_opt(src_bytes, o, FRAME_PX));
+}
+
+int main(void)
+{
+    fill_random(src_bytes, sizeof(src_bytes), 3);
+
+    test_exact();
+    bench();
+
+    return test_result("test_color");
+}
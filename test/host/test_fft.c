@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Fixed-point FFT (app_fft): the real and complex transforms of all sizes are compared with a
+ * double precision DFT on sines, noise, a two-tone signal with a weak tone and a full-scale
+ * square wave, with and without the Hann window. The dB scale is checked on sines of known
+ * level. The transform time is printed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "app_fft.h"
+#include "test_util.h"
+
+/* Minimal signal to error ratio of the bins */
+#define FFT_MIN_SNR_DB      (50.0)
+/* Tolerance of the dB scale */
+#define FFT_DB_TOLERANCE    (0.3)
+
+typedef enum {
+    SIG_SINE,
+    SIG_NOISE,
+    SIG_TWO_TONE,
+    SIG_SQUARE,
+    SIG_COUNT,
+} signal_t;
+
+static const char *const signal_names[SIG_COUNT] = { "sine", "noise", "two-tone", "full-scale square" };
+
+static double cos_table[APP_FFT_MAX_SIZE];
+static double sin_table[APP_FFT_MAX_SIZE];
+
+/* ---------------------------- Reference ------------------------------------ */
+
+static void ref_init(int n)
+{
+    for (int i = 0; i < n; i++) {
+        cos_table[i] = cos(2 * M_PI * i / n);
+        sin_table[i] = sin(2 * M_PI * i / n);
+    }
+}
+
+/* DFT of n complex samples (im may be NULL), bins 0 ... count - 1, scaled by 1 / n (tables of n) */
+static void ref_dft(const double *re_in, const double *im_in, int n, int count, double *re, double *im)
+{
+    for (int k = 0; k < count; k++) {
+        double sr = 0;
+        double si = 0;
+        for (int t = 0; t < n; t++) {
+            int a = (int)(((long)k * t) % n);
+            double xi = im_in ? im_in[t] : 0;
+            sr += re_in[t] * cos_table[a] + xi * sin_table[a];
+            si += xi * cos_table[a] - re_in[t] * sin_table[a];
+        }
+        re[k] = sr / n;
+        im[k] = si / n;
+    }
+}
+
+/* Signal to error ratio of Q15 bins against the reference */
+static double snr_db(const app_fft_cpx_t *bins, const double *re, const double *im, int count, double scale)
+{
+    double err = 0;
+    double sig = 0;
+    for (int k = 0; k < count; k++) {
+        double er = bins[k].re / 32768.0 - re[k] * scale;
+        double ei = bins[k].im / 32768.0 - im[k] * scale;
+        err += er * er + ei * ei;
+        sig += re[k] * re[k] * scale * scale + im[k] * im[k] * scale * scale;
+    }
+    return err > 0 ? 10 * log10(sig / err) : 200;
+}
+
+static void make_signal(signal_t sig, int size, int16_t *in, uint32_t *seed)
+{
+    for (int n = 0; n < size; n++) {
+        double v;
+        switch (sig) {
+        case SIG_SINE:
+            v = 0.9 * sin(2 * M_PI * 37.3 * n / size);
+            break;
+        case SIG_NOISE:
+            v = ((int32_t)(test_rand(seed) & 0xFFFF) - 32768) / 32768.0;
+            break;
+        case SIG_TWO_TONE:
+            v = 0.5 * sin(2 * M_PI * 10 * n / size) + 0.001 * sin(2 * M_PI * (size / 5) * n / size);
+            break;
+        default:
+            v = ((n / 8) & 1) ? 32767.0 / 32768 : -1.0;
+            break;
+        }
+        in[n] = (int16_t)lround(fmin(32767, v * 32768));
+    }
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_init(void)
+{
+    static const uint16_t bad_sizes[] = { 0, 100, 128, 384, 4096 };
+    app_fft_t fft;
+
+    for (size_t i = 0; i < sizeof(bad_sizes) / sizeof(bad_sizes[0]); i++) {
+        TEST_CHECK(app_fft_init(&fft, bad_sizes[i]) == ESP_ERR_INVALID_ARG, "size %u accepted", bad_sizes[i]);
+    }
+}
+
+static void test_real(app_fft_t *fft, int size)
+{
+    static int16_t in[APP_FFT_MAX_SIZE];
+    static double x[APP_FFT_MAX_SIZE];
+    static double re[APP_FFT_MAX_SIZE / 2 + 1];
+    static double im[APP_FFT_MAX_SIZE / 2 + 1];
+    uint32_t seed = 1;
+
+    for (int sig = 0; sig < SIG_COUNT; sig++) {
+        make_signal(sig, size, in, &seed);
+        for (int windowed = 0; windowed < 2; windowed++) {
+            for (int n = 0; n < size; n++) {
+                x[n] = in[n] / 32768.0 * (windowed ? fft->window[n] / 32768.0 : 1.0);
+            }
+            ref_dft(x, NULL, size, size / 2 + 1, re, im);
+            const app_fft_cpx_t *bins = app_fft_real(fft, in, windowed);
+            double snr = snr_db(bins, re, im, size / 2 + 1, 1.0);
+            printf("N=%4d %-18s %s SNR %5.1f dB\n", size, signal_names[sig], windowed ? "hann" : "rect", snr);
+            TEST_CHECK(snr >= FFT_MIN_SNR_DB, "N=%d %s %s: SNR %.1f dB", size, signal_names[sig],
+                       windowed ? "hann" : "rect", snr);
+        }
+    }
+}
+
+/* Complex FFT of size / 2 points, scaled by 2 / size */
+static void test_cpx(app_fft_t *fft, int size)
+{
+    const int half = size / 2;
+    app_fft_cpx_t *data = malloc(half * sizeof(app_fft_cpx_t));
+    double *xr = malloc(half * sizeof(double));
+    double *xi = malloc(half * sizeof(double));
+    double *re = malloc(half * sizeof(double));
+    double *im = malloc(half * sizeof(double));
+    uint32_t seed = 7;
+
+    /* Inputs up to 23170, the limit of the complex transform */
+    for (int n = 0; n < half; n++) {
+        data[n].re = (int16_t)((int32_t)(test_rand(&seed) % 46341) - 23170);
+        data[n].im = (int16_t)lround(16000 * sin(2 * M_PI * 5 * n / half));
+        xr[n] = data[n].re / 32768.0;
+        xi[n] = data[n].im / 32768.0;
+    }
+    ref_init(half);
+    ref_dft(xr, xi, half, half, re, im);
+    app_fft_cpx(fft, data);
+
+    double snr = snr_db(data, re, im, half, 1.0);
+    printf("N=%4d complex %d points SNR %5.1f dB\n", size, half, snr);
+    TEST_CHECK(snr >= FFT_MIN_SNR_DB, "N=%d complex: SNR %.1f dB", size, snr);
+
+    free(data);
+    free(xr);
+    free(xi);
+    free(re);
+    free(im);
+}
+
+/* Full-scale sine on a bin center reads 0 dB with the Hann window, quieter ones their level */
+static void test_db(app_fft_t *fft, int size)
+{
+    static int16_t in[APP_FFT_MAX_SIZE];
+    static int16_t db[APP_FFT_MAX_SIZE / 2 + 1];
+
+    for (int level = 0; level <= 60; level += 20) {
+        double amp = pow(10, -level / 20.0);
+        for (int n = 0; n < size; n++) {
+            in[n] = (int16_t)lround(fmin(32767, amp * 32768 * sin(2 * M_PI * 32 * n / size)));
+        }
+        app_fft_power_db(fft, app_fft_real(fft, in, true), db);
+        TEST_CHECK(fabs(db[32] / 256.0 + level) <= FFT_DB_TOLERANCE, "N=%d sine at -%d dBFS reads %.2f dB", size, level,
+                   db[32] / 256.0);
+    }
+
+    memset(in, 0, size * sizeof(int16_t));
+    app_fft_power_db(fft, app_fft_real(fft, in, true), db);
+    int empty = 0;
+    for (int k = 0; k <= size / 2; k++) {
+        empty += (db[k] == -120 * 256);
+    }
+    TEST_CHECK(empty == size / 2 + 1, "N=%d silence: %d of %d bins at -120 dB", size, empty, size / 2 + 1);
+}
+
+static void bench(app_fft_t *fft, int size)
+{
+    static int16_t in[APP_FFT_MAX_SIZE];
+    uint32_t seed = 3;
+    const int runs = 200000 / size;
+
+    make_signal(SIG_NOISE, size, in, &seed);
+    double start = test_now_us();
+    for (int i = 0; i < runs; i++) {
+        app_fft_real(fft, in, true);
+    }
+    printf("N=%4d real FFT %.1f us per transform\n", size, (test_now_us() - start) / runs);
+}
+
+int main(void)
+{
+    test_init();
+
+    for (int size = APP_FFT_MIN_SIZE; size <= APP_FFT_MAX_SIZE; size *= 2) {
+        app_fft_t fft;
+        TEST_CHECK(app_fft_init(&fft, size) == ESP_OK, "app_fft_init(%d)", size);
+
+        ref_init(size);
+        test_real(&fft, size);
+        test_db(&fft, size);
+        test_cpx(&fft, size);
+        bench(&fft, size);
+
+        app_fft_deinit(&fft);
+    }
+
+    return test_result("test_fft");
+}
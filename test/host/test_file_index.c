@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * File name index of the file browser search (app_file_index) on a directory of 10k names:
+ * the order and every prefix query typed character by character are compared with a linear
+ * scan, new recordings are inserted in place. The build time, the memory per entry and the
+ * query latency are printed, a query must fit well within a frame.
+ */
+
+#include <string.h>
+#include <strings.h>
+
+#include "app_file_index.h"
+#include "test_util.h"
+
+#define INDEX_NAMES         (10000)
+#define INDEX_ADDED         (100)
+#define INDEX_NAME_MAX      (48)
+/* A search keystroke must leave the frame (33 ms) to LVGL */
+#define INDEX_MAX_QUERY_US  (100.0)
+
+static const char *const words[] = {
+    "vad", "recording", "Death Star", "imperial", "march", "IMG", "photo", "song",
+    "note", "readme", "Millenium", "esp", "logo", "clip", "voice",
+};
+static const char *const exts[] = { ".wav", ".jpg", ".txt", ".png", ".avi", ".rgbz" };
+
+/* Directory, added recordings and the two names of the push after sort */
+static char names[INDEX_NAMES + INDEX_ADDED + 2][INDEX_NAME_MAX];
+static int names_count;
+
+#define COUNT_OF(a) (sizeof(a) / sizeof((a)[0]))
+
+/* Directory of VAD recordings and mixed media */
+static void make_names(void)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < INDEX_NAMES; i++) {
+        if (i % 3 == 0) {
+            snprintf(names[i], INDEX_NAME_MAX, "vad_%03d.wav", i / 3);
+        } else {
+            snprintf(names[i], INDEX_NAME_MAX, "%s %s_%u%s", words[test_rand(&seed) % COUNT_OF(words)],
+                     words[test_rand(&seed) % COUNT_OF(words)], (unsigned)(test_rand(&seed) % 100000),
+                     exts[test_rand(&seed) % COUNT_OF(exts)]);
+        }
+    }
+    names_count = INDEX_NAMES;
+}
+
+/* Query result equals the linear scan of the names */
+static void check_find(const app_file_index_t *index, const char *prefix)
+{
+    const size_t n = strlen(prefix);
+    size_t expected = 0;
+    for (int i = 0; i < names_count; i++) {
+        expected += strncasecmp(names[i], prefix, n) == 0;
+    }
+
+    size_t first = 0;
+    size_t count = app_file_index_find(index, prefix, &first);
+    TEST_CHECK(count == expected, "'%s': %zu matches, expected %zu", prefix, count, expected);
+    for (size_t i = first; i < first + count && i < index->count; i++) {
+        TEST_CHECK(strncasecmp(app_file_index_name(index, i), prefix, n) == 0, "'%s' matched %s", prefix,
+                   app_file_index_name(index, i));
+    }
+}
+
+static void check_sorted(const app_file_index_t *index)
+{
+    int unordered = 0;
+    for (size_t i = 1; i < index->count; i++) {
+        const char *a = app_file_index_name(index, i - 1);
+        const char *b = app_file_index_name(index, i);
+        int cmp = strcasecmp(a, b);
+        unordered += cmp > 0 || (cmp == 0 && strcmp(a, b) >= 0);
+    }
+    TEST_CHECK(unordered == 0, "%d entries out of order", unordered);
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_empty(void)
+{
+    app_file_index_t index;
+    size_t first = 1;
+
+    app_file_index_init(&index);
+    TEST_CHECK(app_file_index_find(&index, "", &first) == 0 && first == 0, "empty index matches");
+    TEST_CHECK(app_file_index_find(&index, "a", &first) == 0, "empty index matches 'a'");
+    TEST_CHECK(app_file_index_add(&index, "a.wav", 0) == ESP_OK && index.count == 1, "add to empty index");
+    app_file_index_deinit(&index);
+    TEST_CHECK(index.count == 0 && app_file_index_memory(&index) == 0, "memory kept after deinit");
+}
+
+static void test_build(app_file_index_t *index)
+{
+    size_t name_bytes = 0;
+    for (int i = 0; i < names_count; i++) {
+        name_bytes += strlen(names[i]) + 1;
+    }
+
+    /* The second build reuses the memory of the first, like the next directory */
+    double build_us = 0;
+    for (int run = 0; run < 2; run++) {
+        app_file_index_clear(index);
+        double start = test_now_us();
+        for (int i = 0; i < names_count; i++) {
+            TEST_CHECK(app_file_index_push(index, names[i], i & 1) == ESP_OK, "push %s", names[i]);
+        }
+        app_file_index_sort(index);
+        build_us = test_now_us() - start;
+    }
+    check_sorted(index);
+    TEST_CHECK(index->count == (size_t)names_count, "%zu of %d names indexed", index->count, names_count);
+
+    const size_t memory = app_file_index_memory(index);
+    printf("build %d names %.2f ms, memory %zu B = %.1f B per entry (%zu B entry, %.1f B name)\n", names_count,
+           build_us / 1000, memory, (double)memory / names_count, sizeof(app_file_index_entry_t),
+           (double)name_bytes / names_count);
+    TEST_CHECK(memory <= 2 * (names_count * sizeof(app_file_index_entry_t) + name_bytes) + 2048,
+               "%zu B allocated", memory);
+}
+
+/* Search typed character by character, and other prefixes */
+static void test_find(const app_file_index_t *index)
+{
+    static const char *const prefixes[] = { "death", "DEATH STAR", "i", "Mill", "zzz", "esp logo_9", "photo " };
+    const char *typed = "vad_012";
+    char prefix[16];
+    double worst_us = 0;
+
+    for (size_t n = 0; n <= strlen(typed); n++) {
+        memcpy(prefix, typed, n);
+        prefix[n] = '\0';
+        check_find(index, prefix);
+
+        const int runs = 10000;
+        size_t first = 0;
+        size_t count = 0;
+        double start = test_now_us();
+        for (int r = 0; r < runs; r++) {
+            count = app_file_index_find(index, prefix, &first);
+        }
+        double query_us = (test_now_us() - start) / runs;
+        worst_us = query_us > worst_us ? query_us : worst_us;
+        printf("query '%-7s' %5zu matches %.2f us\n", prefix, count, query_us);
+    }
+    TEST_CHECK(worst_us < INDEX_MAX_QUERY_US, "query took %.1f us", worst_us);
+
+    for (size_t i = 0; i < COUNT_OF(prefixes); i++) {
+        check_find(index, prefixes[i]);
+    }
+}
+
+/* New recordings are inserted in order, a rewritten one only updates its tag */
+static void test_add(app_file_index_t *index)
+{
+    double start = test_now_us();
+    for (int i = 0; i < INDEX_ADDED; i++) {
+        snprintf(names[names_count], INDEX_NAME_MAX, "vad_%03d.wav", 5000 + i);
+        TEST_CHECK(app_file_index_add(index, names[names_count], 0) == ESP_OK, "add %s", names[names_count]);
+        names_count++;
+    }
+    printf("add into %d names %.2f us per name\n", INDEX_NAMES, (test_now_us() - start) / INDEX_ADDED);
+    check_sorted(index);
+
+    size_t first = 0;
+    TEST_CHECK(app_file_index_add(index, "vad_5000.wav", 1) == ESP_OK, "add existing name");
+    TEST_CHECK(index->count == (size_t)names_count, "existing name added again");
+    TEST_CHECK(app_file_index_find(index, "vad_5000.wav", &first) == 1 && app_file_index_tag(index, first) == 1,
+               "tag of existing name not updated");
+    check_find(index, "vad_50");
+    check_find(index, "VAD_");
+    check_find(index, "");
+
+    /* Pushed names are sorted by the next insert */
+    TEST_CHECK(app_file_index_push(index, "aaa.txt", 0) == ESP_OK, "push after sort");
+    strcpy(names[names_count++], "aaa.txt");
+    TEST_CHECK(app_file_index_add(index, "AAB.txt", 0) == ESP_OK, "add after push");
+    strcpy(names[names_count++], "AAB.txt");
+    check_sorted(index);
+    check_find(index, "aa");
+}
+
+int main(void)
+{
+    app_file_index_t index;
+
+    test_empty();
+
+    make_names();
+    app_file_index_init(&index);
+    test_build(&index);
+    test_find(&index);
+    test_add(&index);
+    app_file_index_deinit(&index);
+
+    return test_result("test_file_index");
+}
@@ -0,0 +1,622 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Image decoders (app_img_dec): BMP, QOI and PNG variants decoded against the RGB565 reference,
+ * cropping, fitting, PNG alpha and tRNS transparency, and malformed or truncated files, which
+ * must be rejected without reading out of bounds.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <zlib.h>
+
+#include "app_mem.h"
+#include "app_color.h"
+#include "app_img_dec.h"
+#include "jpeg_decoder.h"
+#include "test_util.h"
+
+#define IMG_W   (37)
+#define IMG_H   (23)
+
+typedef struct {
+    uint8_t r, g, b, a;
+} rgba_t;
+
+typedef struct {
+    char *data;
+    size_t size;
+    FILE *f;
+} mem_file_t;
+
+static rgba_t img[IMG_H][IMG_W];
+static uint16_t ref[IMG_H][IMG_W];
+static uint16_t out_buf[IMG_H * IMG_W];
+
+/* JPEG is covered by the parallel decoder test, here only the dispatch is checked */
+static int jpeg_calls;
+
+esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
+{
+    (void)cfg;
+    (void)img;
+    jpeg_calls++;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+/* ---------------------------- Helpers -------------------------------------- */
+
+static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+/* Gradients with flat blocks, the last pixel differs from its neighbours */
+static void make_image(void)
+{
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            rgba_t *p = &img[y][x];
+            if ((x / 4 + y / 4) % 3) {
+                *p = (rgba_t) { (x * 7) & 255, (y * 11) & 255, ((x + y) * 5) & 255, 255 };
+            } else {
+                *p = (rgba_t) { 200, 10, 30, 255 };
+            }
+        }
+    }
+    img[IMG_H - 1][IMG_W - 1] = (rgba_t) { 1, 222, 77, 255 };
+
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            ref[y][x] = rgb565(img[y][x].r, img[y][x].g, img[y][x].b);
+        }
+    }
+}
+
+static void mf_open(mem_file_t *mf)
+{
+    mf->data = NULL;
+    mf->size = 0;
+    mf->f = open_memstream(&mf->data, &mf->size);
+}
+
+static void mf_close(mem_file_t *mf)
+{
+    fclose(mf->f);
+}
+
+static void put8(FILE *f, uint8_t v)
+{
+    fputc(v, f);
+}
+
+static void put16le(FILE *f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put32le(FILE *f, uint32_t v)
+{
+    put16le(f, v & 0xFFFF);
+    put16le(f, v >> 16);
+}
+
+static void put32be(FILE *f, uint32_t v)
+{
+    fputc(v >> 24, f);
+    fputc((v >> 16) & 0xFF, f);
+    fputc((v >> 8) & 0xFF, f);
+    fputc(v & 0xFF, f);
+}
+
+static esp_err_t decode_out(app_file_type_t type, const void *data, size_t size, app_img_out_t *out)
+{
+    out->buf = (uint8_t *)out_buf;
+    out->buf_size = sizeof(out_buf);
+
+    memset(out_buf, 0, sizeof(out_buf));
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    esp_err_t ret = app_img_dec_decode_mem(type, data, size, out);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    return ret;
+}
+
+static esp_err_t decode(app_file_type_t type, const void *data, size_t size, uint16_t max_w, uint16_t max_h)
+{
+    app_img_out_t out = {
+        .max_width = max_w,
+        .max_height = max_h,
+    };
+
+    esp_err_t ret = decode_out(type, data, size, &out);
+
+    if (ret == ESP_OK && (out.width != max_w || out.height != max_h)) {
+        printf("decoded %ux%u, expected %ux%u\n", out.width, out.height, max_w, max_h);
+        return ESP_FAIL;
+    }
+    return ret;
+}
+
+/* Compare the decoded image (cropped to w x h) with the expected pixels */
+static int compare(const uint16_t *expected, uint16_t w, uint16_t h)
+{
+    int diff = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            diff += (out_buf[y * w + x] != expected[y * IMG_W + x]);
+        }
+    }
+    return diff;
+}
+
+/* ---------------------------- BMP ------------------------------------------ */
+
+typedef struct {
+    uint16_t bpp;
+    uint32_t compression;
+    int32_t height;                 /*!< Negative: top-down */
+    uint32_t masks[3];              /*!< BI_BITFIELDS masks */
+} bmp_cfg_t;
+
+static uint32_t bmp_pixel(const bmp_cfg_t *cfg, const rgba_t *p, uint8_t palette_idx)
+{
+    switch (cfg->bpp) {
+    case 8:
+        return palette_idx;
+    case 16:
+        if (cfg->compression == 3 && cfg->masks[0] == 0xF800) {
+            return rgb565(p->r, p->g, p->b);
+        }
+        return ((p->r >> 3) << 10) | ((p->g >> 3) << 5) | (p->b >> 3);
+    default:
+        return ((uint32_t)p->r << 16) | ((uint32_t)p->g << 8) | p->b;
+    }
+}
+
+static void bmp_write(mem_file_t *mf, const bmp_cfg_t *cfg, uint16_t *expected)
+{
+    uint32_t stride = ((IMG_W * cfg->bpp + 31) / 32) * 4;
+    uint32_t palette_size = (cfg->bpp == 8) ? 256 * 4 : 0;
+    uint32_t masks_size = (cfg->compression == 3) ? 12 : 0;
+    uint32_t offset = 54 + masks_size + palette_size;
+    int rows = IMG_H;
+
+    mf_open(mf);
+    FILE *f = mf->f;
+    fputs("BM", f);
+    put32le(f, offset + stride * rows);
+    put32le(f, 0);
+    put32le(f, offset);
+    put32le(f, 40);
+    put32le(f, IMG_W);
+    put32le(f, (uint32_t)cfg->height);
+    put16le(f, 1);
+    put16le(f, cfg->bpp);
+    put32le(f, cfg->compression);
+    put32le(f, stride * rows);
+    put32le(f, 2835);
+    put32le(f, 2835);
+    put32le(f, (cfg->bpp == 8) ? 256 : 0);
+    put32le(f, 0);
+    for (int i = 0; i < 3 && masks_size; i++) {
+        put32le(f, cfg->masks[i]);
+    }
+
+    /* 8bit: palette of 256 distinct colors, the pixels are mapped by index */
+    for (uint32_t i = 0; i < palette_size / 4; i++) {
+        put8(f, (i * 3) & 0xFF);
+        put8(f, (i * 5) & 0xFF);
+        put8(f, i);
+        put8(f, 0);
+    }
+
+    for (int r = 0; r < rows; r++) {
+        int y = (cfg->height > 0) ? (rows - 1 - r) : r;
+        uint32_t written = 0;
+        for (int x = 0; x < IMG_W; x++) {
+            const rgba_t *p = &img[y][x];
+            uint8_t idx = (p->r + p->g * 3 + p->b * 7) & 0xFF;
+            uint32_t v = bmp_pixel(cfg, p, idx);
+            uint16_t exp;
+            switch (cfg->bpp) {
+            case 8:
+                put8(f, v);
+                exp = rgb565(idx, (idx * 5) & 0xFF, (idx * 3) & 0xFF);
+                break;
+            case 16:
+                put16le(f, v);
+                exp = (cfg->compression == 3 && cfg->masks[0] == 0xF800) ? v :
+                      (uint16_t)(((v & 0x7FE0) << 1) | ((v >> 4) & 0x20) | (v & 0x1F));
+                break;
+            case 24:
+                put8(f, v & 0xFF);
+                put8(f, (v >> 8) & 0xFF);
+                put8(f, v >> 16);
+                exp = ref[y][x];
+                break;
+            default:
+                put32le(f, v | 0xFF000000);
+                exp = ref[y][x];
+                break;
+            }
+            written += cfg->bpp / 8;
+            expected[y * IMG_W + x] = exp;
+        }
+        for (; written < stride; written++) {
+            put8(f, 0);
+        }
+    }
+    mf_close(mf);
+}
+
+static void test_bmp(void)
+{
+    static const struct {
+        const char *name;
+        bmp_cfg_t cfg;
+        esp_err_t ret;
+    } cases[] = {
+        { "24bit bottom-up", { 24, 0, IMG_H, { 0 } }, ESP_OK },
+        { "24bit top-down", { 24, 0, -IMG_H, { 0 } }, ESP_OK },
+        { "32bit", { 32, 0, IMG_H, { 0 } }, ESP_OK },
+        { "32bit bitfields", { 32, 3, IMG_H, { 0x00FF0000, 0x0000FF00, 0x000000FF } }, ESP_OK },
+        { "32bit bitfields RGBA", { 32, 3, IMG_H, { 0xFF000000, 0x00FF0000, 0x0000FF00 } }, ESP_ERR_NOT_SUPPORTED },
+        { "32bit bitfields BGR", { 32, 3, IMG_H, { 0x000000FF, 0x0000FF00, 0x00FF0000 } }, ESP_ERR_NOT_SUPPORTED },
+        { "16bit RGB555", { 16, 0, IMG_H, { 0 } }, ESP_OK },
+        { "16bit bitfields 555", { 16, 3, -IMG_H, { 0x7C00, 0x03E0, 0x001F } }, ESP_OK },
+        { "16bit bitfields 565", { 16, 3, IMG_H, { 0xF800, 0x07E0, 0x001F } }, ESP_OK },
+        { "16bit bitfields 444", { 16, 3, IMG_H, { 0x0F00, 0x00F0, 0x000F } }, ESP_ERR_NOT_SUPPORTED },
+        { "8bit palette", { 8, 0, IMG_H, { 0 } }, ESP_OK },
+    };
+    static uint16_t expected[IMG_H * IMG_W];
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        mem_file_t mf;
+        bmp_write(&mf, &cases[i].cfg, expected);
+        esp_err_t ret = decode(APP_FILE_TYPE_BMP, mf.data, mf.size, IMG_W, IMG_H);
+        TEST_CHECK(ret == cases[i].ret, "BMP %s: ret 0x%x, expected 0x%x", cases[i].name, ret, cases[i].ret);
+        if (ret == ESP_OK) {
+            int diff = compare(expected, IMG_W, IMG_H);
+            TEST_CHECK(diff == 0, "BMP %s: %d pixels differ", cases[i].name, diff);
+        }
+        free(mf.data);
+    }
+
+    /* Height INT32_MIN and other out of range sizes */
+    static const int32_t bad_heights[] = { INT32_MIN, -65536, 65536, 0 };
+    for (size_t i = 0; i < sizeof(bad_heights) / sizeof(bad_heights[0]); i++) {
+        mem_file_t mf;
+        bmp_cfg_t cfg = { 24, 0, IMG_H, { 0 } };
+        bmp_write(&mf, &cfg, expected);
+        for (int b = 0; b < 4; b++) {
+            mf.data[22 + b] = ((uint32_t)bad_heights[i] >> (8 * b)) & 0xFF;
+        }
+        esp_err_t ret = decode(APP_FILE_TYPE_BMP, mf.data, mf.size, IMG_W, IMG_H);
+        TEST_CHECK(ret == ESP_ERR_INVALID_ARG, "BMP height %" PRId32 ": ret 0x%x", bad_heights[i], ret);
+        free(mf.data);
+    }
+
+    /* Pixel data offset and size beyond the end of the file, also where the row offsets wrap */
+    static const struct {
+        uint32_t data_offset;
+        uint32_t width;
+        uint32_t height;
+    } bad_sizes[] = {
+        { 0xFFFFFF00, IMG_W, IMG_H },
+        { 54, 65535, 65535 },
+        { 54, IMG_W, IMG_H + 1 },
+    };
+    for (size_t i = 0; i < sizeof(bad_sizes) / sizeof(bad_sizes[0]); i++) {
+        mem_file_t mf;
+        bmp_cfg_t cfg = { 32, 0, IMG_H, { 0 } };
+        bmp_write(&mf, &cfg, expected);
+        for (int b = 0; b < 4; b++) {
+            mf.data[10 + b] = (bad_sizes[i].data_offset >> (8 * b)) & 0xFF;
+            mf.data[18 + b] = (bad_sizes[i].width >> (8 * b)) & 0xFF;
+            mf.data[22 + b] = (bad_sizes[i].height >> (8 * b)) & 0xFF;
+        }
+        esp_err_t ret = decode(APP_FILE_TYPE_BMP, mf.data, mf.size, IMG_W, IMG_H);
+        TEST_CHECK(ret == ESP_ERR_INVALID_SIZE, "BMP %" PRIu32 "x%" PRIu32 " at %" PRIu32 ": ret 0x%x",
+                   bad_sizes[i].width, bad_sizes[i].height, bad_sizes[i].data_offset, ret);
+        free(mf.data);
+    }
+
+    /* Truncated pixel data */
+    mem_file_t mf;
+    bmp_cfg_t cfg = { 24, 0, IMG_H, { 0 } };
+    bmp_write(&mf, &cfg, expected);
+    for (size_t len = 0; len < mf.size; len += 7) {
+        esp_err_t ret = decode(APP_FILE_TYPE_BMP, mf.data, len, IMG_W, IMG_H);
+        TEST_CHECK(ret != ESP_OK, "BMP truncated to %zu bytes decoded", len);
+    }
+    free(mf.data);
+}
+
+/* ---------------------------- QOI ------------------------------------------ */
+
+static void qoi_write(mem_file_t *mf)
+{
+    rgba_t idx[64] = { 0 };
+    rgba_t prev = { 0, 0, 0, 255 };
+    int run = 0;
+
+    mf_open(mf);
+    FILE *f = mf->f;
+    fputs("qoif", f);
+    put32be(f, IMG_W);
+    put32be(f, IMG_H);
+    put8(f, 3);
+    put8(f, 0);
+
+    for (int i = 0; i < IMG_W * IMG_H; i++) {
+        rgba_t p = img[i / IMG_W][i % IMG_W];
+        if (memcmp(&p, &prev, sizeof(p)) == 0) {
+            run++;
+            if (run == 62 || i == IMG_W * IMG_H - 1) {
+                put8(f, 0xC0 | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run) {
+            put8(f, 0xC0 | (run - 1));
+            run = 0;
+        }
+        int h = (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) % 64;
+        if (memcmp(&idx[h], &p, sizeof(p)) == 0) {
+            put8(f, h);
+        } else {
+            idx[h] = p;
+            int dr = (int8_t)(p.r - prev.r);
+            int dg = (int8_t)(p.g - prev.g);
+            int db = (int8_t)(p.b - prev.b);
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                put8(f, 0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+            } else if (dg >= -32 && dg <= 31 && dr - dg >= -8 && dr - dg <= 7 && db - dg >= -8 && db - dg <= 7) {
+                put8(f, 0x80 | (dg + 32));
+                put8(f, ((dr - dg + 8) << 4) | (db - dg + 8));
+            } else {
+                put8(f, 0xFE);
+                put8(f, p.r);
+                put8(f, p.g);
+                put8(f, p.b);
+            }
+        }
+        prev = p;
+    }
+    for (int i = 0; i < 7; i++) {
+        put8(f, 0);
+    }
+    put8(f, 1);
+    mf_close(mf);
+}
+
+static void test_qoi(void)
+{
+    mem_file_t mf;
+    qoi_write(&mf);
+
+    esp_err_t ret = decode(APP_FILE_TYPE_QOI, mf.data, mf.size, IMG_W, IMG_H);
+    TEST_CHECK(ret == ESP_OK, "QOI: ret 0x%x", ret);
+    TEST_CHECK(compare(&ref[0][0], IMG_W, IMG_H) == 0, "QOI: pixels differ");
+
+    /* Cropped to the top-left corner */
+    ret = decode(APP_FILE_TYPE_QOI, mf.data, mf.size, 20, 10);
+    TEST_CHECK(ret == ESP_OK && compare(&ref[0][0], 20, 10) == 0, "QOI cropped: ret 0x%x", ret);
+
+    /* Scaled down to fit 20x10 keeping the aspect ratio: 16x10, nearest pixels */
+    app_img_out_t out = { .max_width = 20, .max_height = 10, .fit = true };
+    ret = decode_out(APP_FILE_TYPE_QOI, mf.data, mf.size, &out);
+    TEST_CHECK(ret == ESP_OK && out.width == 16 && out.height == 10, "QOI fit: ret 0x%x, %ux%u", ret, out.width, out.height);
+    int diff = 0;
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            uint32_t step_x = (IMG_W << 16) / out.width;
+            diff += (out_buf[y * out.width + x] != ref[y * IMG_H / out.height][(x * step_x) >> 16]);
+        }
+    }
+    TEST_CHECK(diff == 0, "QOI fit: %d pixels differ", diff);
+
+    /* Any truncation of the pixel data, also inside the last QOI_OP_RGB, fails */
+    size_t end = mf.size - 8;
+    TEST_CHECK((uint8_t)mf.data[end - 4] == 0xFE, "QOI: last op is not QOI_OP_RGB");
+    for (size_t len = 0; len < end; len++) {
+        ret = decode(APP_FILE_TYPE_QOI, mf.data, len, IMG_W, IMG_H);
+        TEST_CHECK(ret != ESP_OK, "QOI truncated to %zu of %zu bytes decoded", len, end);
+    }
+    free(mf.data);
+
+    /* 1x2 image ending by a truncated QOI_OP_LUMA or QOI_OP_RGBA */
+    static const uint8_t ops[][6] = {
+        { 0xFE, 10, 20, 30, 0x80 | 34, },
+        { 0xFE, 10, 20, 30, 0xFF, 1, },
+    };
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        uint8_t buf[14 + sizeof(ops[0])] = { 'q', 'o', 'i', 'f', 0, 0, 0, 2, 0, 0, 0, 1, 4, 0 };
+        size_t len = 14 + ((i == 0) ? 5 : 6);
+        memcpy(&buf[14], ops[i], len - 14);
+        ret = decode(APP_FILE_TYPE_QOI, buf, len, 2, 1);
+        TEST_CHECK(ret == ESP_ERR_INVALID_SIZE, "QOI truncated op %zu: ret 0x%x", i, ret);
+    }
+}
+
+/* ---------------------------- PNG ------------------------------------------ */
+
+static void png_chunk(FILE *f, const char *type, const uint8_t *data, uint32_t len)
+{
+    put32be(f, len);
+    fwrite(type, 1, 4, f);
+    uint32_t crc = crc32(0, (const Bytef *)type, 4);
+    if (len > 0) {
+        fwrite(data, 1, len, f);
+        crc = crc32(crc, data, len);
+    }
+    put32be(f, crc);
+}
+
+static int paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+}
+
+/* RGB565 blended over black in 1/32 steps */
+static uint16_t blend565(uint16_t c, uint8_t alpha)
+{
+    uint32_t w = (alpha + 4) >> 3;
+    return (((c >> 11) * w >> 5) << 11) | ((((c >> 5) & 0x3F) * w >> 5) << 5) | ((c & 0x1F) * w >> 5);
+}
+
+/* Palette of the indexed image, the tRNS alpha covers only the first PNG_TRNS_ENTRIES */
+#define PNG_PALETTE_SIZE    (64)
+#define PNG_TRNS_ENTRIES    (48)
+
+static void png_palette_color(int i, uint8_t rgba[4])
+{
+    rgba[0] = i * 4;
+    rgba[1] = 255 - i * 4;
+    rgba[2] = (i * 13) & 255;
+    rgba[3] = (i >= PNG_TRNS_ENTRIES || i % 4 == 1) ? 255 : (i % 4 == 0) ? 0 : (uint8_t)(i * 29);
+}
+
+/*
+ * 8bit gray (0), RGB (2), palette (3) or RGBA (6), filter type changes every row, IDAT split into
+ * small chunks. With trns, gray and RGB have a transparent color and the palette alpha values.
+ */
+static void png_write(mem_file_t *mf, uint8_t color_type, bool trns, uint16_t *expected)
+{
+    const int bpp = (color_type == 0 || color_type == 3) ? 1 : (color_type == 2) ? 3 : 4;
+    const size_t line = IMG_W * bpp;
+    uint8_t *raw = malloc((line + 1) * IMG_H);
+    uint8_t prev[IMG_W * 4] = { 0 };
+    uint8_t cur[IMG_W * 4];
+    /* The color of the flat blocks is the transparent one */
+    const rgba_t key = { 200, 10, 30, 255 };
+
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            const rgba_t *p = &img[y][x];
+            /* Transparent, opaque and translucent pixels, blended over black in 1/32 steps */
+            uint8_t alpha = (x % 3 == 0) ? 0 : (x % 3 == 1) ? 255 : (uint8_t)(x * 37 + y * 11);
+            uint8_t px[4] = { p->r, p->g, p->b, alpha };
+            uint16_t *e = &expected[y * IMG_W + x];
+            if (color_type == 3) {
+                uint8_t idx = (x * 3 + y * 5) % PNG_PALETTE_SIZE;
+                uint8_t rgba[4];
+                png_palette_color(idx, rgba);
+                cur[x] = idx;
+                *e = blend565(rgb565(rgba[0], rgba[1], rgba[2]), trns ? rgba[3] : 255);
+                continue;
+            }
+            memcpy(&cur[x * bpp], (color_type == 0) ? &p->r : px, bpp);
+            *e = (color_type == 0) ? rgb565(p->r, p->r, p->r) : ref[y][x];
+            if (color_type == 6) {
+                *e = blend565(ref[y][x], alpha);
+            } else if (trns && p->r == key.r && (color_type == 0 || (p->g == key.g && p->b == key.b))) {
+                *e = 0;
+            }
+        }
+        uint8_t filter = y % 5;
+        uint8_t *dst = &raw[y * (line + 1)];
+        dst[0] = filter;
+        for (size_t i = 0; i < line; i++) {
+            int a = (i >= (size_t)bpp) ? cur[i - bpp] : 0;
+            int b = prev[i];
+            int c = (i >= (size_t)bpp) ? prev[i - bpp] : 0;
+            int pred = (filter == 1) ? a : (filter == 2) ? b : (filter == 3) ? (a + b) / 2 : (filter == 4) ? paeth(a, b, c) : 0;
+            dst[1 + i] = (uint8_t)(cur[i] - pred);
+        }
+        memcpy(prev, cur, line);
+    }
+
+    uLongf z_size = compressBound((line + 1) * IMG_H);
+    uint8_t *z = malloc(z_size);
+    compress2(z, &z_size, raw, (line + 1) * IMG_H, 9);
+
+    mf_open(mf);
+    FILE *f = mf->f;
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, f);
+    uint8_t ihdr[13] = { 0, 0, 0, IMG_W, 0, 0, 0, IMG_H, 8, color_type, 0, 0, 0 };
+    png_chunk(f, "IHDR", ihdr, sizeof(ihdr));
+    if (color_type == 3) {
+        uint8_t plte[PNG_PALETTE_SIZE * 3];
+        uint8_t alpha[PNG_TRNS_ENTRIES];
+        for (int i = 0; i < PNG_PALETTE_SIZE; i++) {
+            uint8_t rgba[4];
+            png_palette_color(i, rgba);
+            memcpy(&plte[i * 3], rgba, 3);
+            if (i < PNG_TRNS_ENTRIES) {
+                alpha[i] = rgba[3];
+            }
+        }
+        png_chunk(f, "PLTE", plte, sizeof(plte));
+        if (trns) {
+            png_chunk(f, "tRNS", alpha, sizeof(alpha));
+        }
+    } else if (trns) {
+        /* 16bit sample values */
+        const uint8_t gray[2] = { 0, key.r };
+        const uint8_t rgb[6] = { 0, key.r, 0, key.g, 0, key.b };
+        png_chunk(f, "tRNS", color_type == 0 ? gray : rgb, color_type == 0 ? sizeof(gray) : sizeof(rgb));
+    }
+    /* The zlib checksum in its own chunk, the rows are complete without it */
+    for (uLongf i = 0; i < z_size - 4; i += 50) {
+        png_chunk(f, "IDAT", &z[i], (z_size - 4 - i < 50) ? z_size - 4 - i : 50);
+    }
+    png_chunk(f, "IDAT", &z[z_size - 4], 4);
+    png_chunk(f, "IEND", NULL, 0);
+    mf_close(mf);
+
+    free(z);
+    free(raw);
+}
+
+static void test_png(void)
+{
+    static const struct {
+        uint8_t type;
+        bool trns;
+    } cases[] = { { 0, false }, { 2, false }, { 3, false }, { 6, false }, { 0, true }, { 2, true }, { 3, true } };
+    static uint16_t expected[IMG_H * IMG_W];
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        mem_file_t mf;
+        png_write(&mf, cases[i].type, cases[i].trns, expected);
+        esp_err_t ret = decode(APP_FILE_TYPE_PNG, mf.data, mf.size, IMG_W, IMG_H);
+        TEST_CHECK(ret == ESP_OK, "PNG type %d tRNS %d: ret 0x%x", cases[i].type, cases[i].trns, ret);
+        int diff = compare(expected, IMG_W, IMG_H);
+        TEST_CHECK(diff == 0, "PNG type %d tRNS %d: %d pixels differ", cases[i].type, cases[i].trns, diff);
+
+        /* Truncated inside the image data (before the CRC of its last chunk, the checksum chunk and
+           IEND), the chunk CRCs are not checked */
+        for (size_t len = 0; len < mf.size - 12 - 16 - 4; len++) {
+            ret = decode(APP_FILE_TYPE_PNG, mf.data, len, IMG_W, IMG_H);
+            TEST_CHECK(ret != ESP_OK, "PNG type %d truncated to %zu bytes decoded", cases[i].type, len);
+        }
+        free(mf.data);
+    }
+}
+
+int main(void)
+{
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    make_image();
+
+    test_bmp();
+    test_qoi();
+    test_png();
+
+    uint8_t jpeg[4] = { 0xFF, 0xD8, 0xFF, 0xD9 };
+    TEST_CHECK(decode(APP_FILE_TYPE_JPG, jpeg, sizeof(jpeg), IMG_W, IMG_H) == ESP_ERR_NOT_SUPPORTED && jpeg_calls == 1,
+               "JPEG not dispatched to esp_jpeg");
+
+    return test_result("test_img_dec");
+}
@@ -0,0 +1,331 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Adaptive jitter buffer (app_jitter) in virtual time: a sender with a drifting clock, a
+ * network with random delay (which reorders), loss, duplicates and a stall, and an audio
+ * output reading blocks at its own clock. The counters must match the simulated network,
+ * the depth must follow the target without saturating the resampling, and the drift estimate
+ * must settle on the clock drift. The concealment of a lost packet is compared with the
+ * original audio.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "app_jitter.h"
+#include "test_util.h"
+
+#define SIM_BLOCK_MS        (20)
+#define SIM_BASE_DELAY_MS   (10)
+#define SIM_SLOTS           (64)
+#define SIM_MAX_PPM         (5000)
+/* Concealment while a packet is awaited, before the buffer is refilled (JITTER_PLC_END_MS) */
+#define SIM_WAIT_MS         (60)
+/* Largest error of the drift estimate, in ppm */
+#define SIM_DRIFT_TOLERANCE (60)
+
+typedef struct {
+    const char *name;
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t ptime_ms;          /*!< Packet length */
+    uint16_t jitter_ms;         /*!< Network delay is SIM_BASE_DELAY_MS plus up to this */
+    uint16_t loss_pm;           /*!< Lost and duplicated packets, per mille */
+    uint16_t dup_pm;
+    int16_t drift_ppm;          /*!< Sender clock faster than the output */
+    uint16_t seconds;
+    uint16_t stall_ms;          /*!< Network stall at one third of the stream */
+} scenario_t;
+
+static const scenario_t scenarios[] = {
+    { "clean",                  16000, 1, 20,   0,   0,  0,    0,  60,   0 },
+    { "jitter 40 ms",           16000, 1, 20,  40,   0,  0,    0,  60,   0 },
+    { "jitter 40 ms, loss 5%",  16000, 1, 20,  40,  50, 10,    0,  60,   0 },
+    { "jitter 10 ms, loss 10%", 16000, 1, 20,  10, 100,  0,    0,  60,   0 },
+    { "drift +300 ppm",         16000, 1, 20,  10,   0,  0,  300, 120,   0 },
+    { "drift -300 ppm",         16000, 1, 20,  10,   0,  0, -300, 120,   0 },
+    { "drift +100, jitter 40",  16000, 1, 20,  40,  50,  0,  100, 180,   0 },
+    { "drift -200, jitter 80",  16000, 1, 20,  80, 100,  0, -200, 180,   0 },
+    { "48k stereo 5 ms",        48000, 2,  5,  60,  20,  0,  100, 120,   0 },
+    { "stall 500 ms",           16000, 1, 20,  10,   0,  0,    0,  60, 500 },
+};
+
+typedef struct {
+    int64_t arrive_us;
+    uint16_t seq;
+    uint32_t ts;
+} packet_t;
+
+/* Two tones, not a multiple of the packet length */
+static int16_t signal_at(const scenario_t *s, uint32_t frame, uint16_t channel)
+{
+    double t = (double)frame / s->sample_rate;
+    return (int16_t)(8000 * sin(2 * M_PI * 220 * t + channel) + 3000 * sin(2 * M_PI * 660 * t));
+}
+
+static int packet_compare(const void *a, const void *b)
+{
+    const packet_t *x = a;
+    const packet_t *y = b;
+    return x->arrive_us < y->arrive_us ? -1 : x->arrive_us > y->arrive_us;
+}
+
+/* Arrivals of the stream, sorted by time, returns their count. Losses are counted between the
+   delivered packets, the receiver cannot know of the others. */
+static size_t make_arrivals(const scenario_t *s, packet_t *packets, size_t count, uint32_t *seed, uint32_t *lost,
+                            uint32_t *dups)
+{
+    const uint32_t frames = s->sample_rate * s->ptime_ms / 1000;
+    const int64_t stall_us = (int64_t)s->seconds * 1000000 / 3;
+    uint32_t lost_run = 0;
+    size_t n = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        int64_t sent = (int64_t)((double)i * s->ptime_ms * 1000 / (1 + s->drift_ppm * 1e-6));
+        int64_t delay = SIM_BASE_DELAY_MS * 1000 + (s->jitter_ms ? test_rand(seed) % (s->jitter_ms * 1000) : 0);
+        if (s->stall_ms && sent >= stall_us && sent < stall_us + s->stall_ms * 1000) {
+            /* Queued in the network until the end of the stall */
+            delay += stall_us + s->stall_ms * 1000 - sent;
+        }
+        if (test_rand(seed) % 1000 < s->loss_pm) {
+            lost_run += n > 0;
+            continue;
+        }
+        *lost += lost_run;
+        lost_run = 0;
+        packets[n++] = (packet_t) {
+            sent + delay, (uint16_t)(40000 + i), (uint32_t)(123456 + i * frames)
+        };
+        if (test_rand(seed) % 1000 < s->dup_pm) {
+            packets[n] = packets[n - 1];
+            packets[n++].arrive_us += test_rand(seed) % 20000;
+            (*dups)++;
+        }
+    }
+    qsort(packets, n, sizeof(packet_t), packet_compare);
+    return n;
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_config(void)
+{
+    app_jitter_t jitter;
+    app_jitter_config_t config = { 16000, 1, 320, 48, 20, 300, 500 };
+    int16_t pcm[321] = { 0 };
+
+    TEST_CHECK(app_jitter_init(&jitter, &config) == ESP_ERR_INVALID_ARG, "slots not a power of two accepted");
+    config.slots = 64;
+    config.sample_rate = 0;
+    TEST_CHECK(app_jitter_init(&jitter, &config) == ESP_ERR_INVALID_ARG, "sample rate 0 accepted");
+    config.sample_rate = 16000;
+    TEST_CHECK(app_jitter_init(&jitter, &config) == ESP_OK, "app_jitter_init");
+    TEST_CHECK(app_jitter_put(&jitter, 1, 0, pcm, 321, 0) == ESP_ERR_INVALID_SIZE, "long packet accepted");
+    TEST_CHECK(!app_jitter_started(&jitter), "started by a rejected packet");
+
+    /* A duplicate is dropped, so is a packet after its playout time */
+    TEST_CHECK(app_jitter_put(&jitter, 1, 0, pcm, 320, 0) == ESP_OK, "put");
+    TEST_CHECK(app_jitter_put(&jitter, 1, 0, pcm, 320, 1000) == ESP_ERR_INVALID_STATE, "duplicate accepted");
+    for (int i = 3; i < 8; i++) {
+        app_jitter_put(&jitter, i, (i - 1) * 320, pcm, 320, (i - 1) * 20000);
+    }
+    int16_t out[320];
+    for (int i = 0; i < 6; i++) {
+        app_jitter_read(&jitter, out, 320);
+    }
+    TEST_CHECK(app_jitter_put(&jitter, 2, 320, pcm, 320, 120000) == ESP_ERR_INVALID_STATE, "late packet accepted");
+
+    app_jitter_stats_t stats;
+    app_jitter_get_stats(&jitter, &stats);
+    TEST_CHECK(stats.received == 6 && stats.duplicate == 1 && stats.late == 1 && stats.lost == 1,
+               "received %u, duplicate %u, late %u, lost %u", stats.received, stats.duplicate, stats.late, stats.lost);
+
+    app_jitter_reset(&jitter);
+    app_jitter_get_stats(&jitter, &stats);
+    TEST_CHECK(!app_jitter_started(&jitter) && stats.received == 0, "statistics after reset");
+    app_jitter_deinit(&jitter);
+}
+
+static void test_scenario(const scenario_t *s)
+{
+    const app_jitter_config_t config = {
+        .sample_rate = s->sample_rate,
+        .channels = s->channels,
+        .max_packet_frames = 1460 / (2 * s->channels),
+        .slots = SIM_SLOTS,
+        .min_delay_ms = 20,
+        .max_delay_ms = 300,
+        .max_ppm = SIM_MAX_PPM,
+    };
+    const uint32_t frames = s->sample_rate * s->ptime_ms / 1000;
+    const uint32_t block = s->sample_rate * SIM_BLOCK_MS / 1000;
+    const size_t count = s->seconds * 1000 / s->ptime_ms;
+    uint32_t seed = 1;
+    uint32_t net_lost = 0;
+    uint32_t net_dups = 0;
+    app_jitter_t jitter;
+
+    TEST_CHECK(app_jitter_init(&jitter, &config) == ESP_OK, "app_jitter_init");
+    packet_t *packets = malloc(2 * count * sizeof(packet_t));
+    int16_t *pcm = malloc(frames * s->channels * sizeof(int16_t));
+    int16_t *out = malloc(block * s->channels * sizeof(int16_t));
+    size_t arrivals = make_arrivals(s, packets, count, &seed, &net_lost, &net_dups);
+
+    /* Steady state: second half of the stream, after the stall settled. The output runs on after
+       the end, until the buffer is empty. */
+    const int64_t end_us = packets[arrivals - 1].arrive_us;
+    const int64_t from_us = end_us / 2;
+    int depth_min = INT32_MAX, depth_max = 0, depth_end = 0, target = 0, saturated = 0, reads = 0;
+    double drift_sum = 0;
+    size_t k = 0;
+
+    for (int64_t now = 0; now <= end_us + 1000000; now += SIM_BLOCK_MS * 1000) {
+        for (; k < arrivals && packets[k].arrive_us <= now; k++) {
+            for (uint32_t f = 0; f < frames; f++) {
+                for (uint16_t c = 0; c < s->channels; c++) {
+                    pcm[f * s->channels + c] = signal_at(s, packets[k].ts + f, c);
+                }
+            }
+            app_jitter_put(&jitter, packets[k].seq, packets[k].ts, pcm, frames, packets[k].arrive_us);
+        }
+        app_jitter_read(&jitter, out, block);
+
+        app_jitter_stats_t stats;
+        app_jitter_get_stats(&jitter, &stats);
+        if (now >= from_us && now <= end_us) {
+            depth_min = stats.depth_ms < depth_min ? stats.depth_ms : depth_min;
+            depth_max = stats.depth_ms > depth_max ? stats.depth_ms : depth_max;
+            depth_end = stats.depth_ms;
+            target = stats.target_ms;
+            saturated += stats.ratio_ppm == SIM_MAX_PPM || stats.ratio_ppm == -SIM_MAX_PPM;
+            drift_sum += stats.drift_ppm;
+            reads++;
+        }
+    }
+
+    app_jitter_stats_t stats;
+    app_jitter_get_stats(&jitter, &stats);
+    const int drift = (int)lround(drift_sum / reads);
+    printf("%-24s recv %5u reord %4u dup %2u late %u lost %3u drop %2u under %u conc %5u ms | jitter %2u ms "
+           "target %3d ms depth %3d..%3d ms | drift %4d ppm, saturated %d%%\n", s->name, stats.received,
+           stats.reordered, stats.duplicate, stats.late, stats.lost, stats.dropped, stats.underruns,
+           stats.concealed_ms, stats.jitter_ms, target, depth_min, depth_max, drift, 100 * saturated / reads);
+
+    /* The counters match the network */
+    TEST_CHECK(stats.received + stats.late + stats.duplicate == arrivals, "%s: %u + %u + %u of %zu arrivals",
+               s->name, stats.received, stats.late, stats.duplicate, arrivals);
+    TEST_CHECK(stats.duplicate == net_dups, "%s: %u duplicates of %u", s->name, stats.duplicate, net_dups);
+    /* Only a delay spike over the transit spread of the last windows is late */
+    TEST_CHECK(stats.late <= stats.received / 1000, "%s: %u late", s->name, stats.late);
+    /* A late packet was lost at its playout time, the end of the stream is awaited while concealing */
+    TEST_CHECK(stats.lost == net_lost + stats.late, "%s: %u lost of %u", s->name, stats.lost, net_lost);
+    const int concealed_ms = (net_lost + stats.late) * s->ptime_ms + stats.underruns * SIM_WAIT_MS;
+    TEST_CHECK(abs((int)stats.concealed_ms - concealed_ms) <= 2 * s->ptime_ms + concealed_ms / 100,
+               "%s: %u ms concealed, expected %d ms", s->name, stats.concealed_ms, concealed_ms);
+    TEST_CHECK(s->jitter_ms < 2 * s->ptime_ms || stats.reordered > 0, "%s: nothing reordered", s->name);
+
+    if (s->stall_ms) {
+        /* The burst after the stall is cut, the delay comes back */
+        TEST_CHECK(stats.dropped > 0 && stats.underruns == 2, "%s: %u dropped, %u underruns", s->name,
+                   stats.dropped, stats.underruns);
+        TEST_CHECK(depth_end <= target + s->ptime_ms, "%s: depth %d ms at the end, target %d ms", s->name,
+                   depth_end, target);
+    } else {
+        TEST_CHECK(stats.underruns == 1 && stats.dropped <= 10, "%s: %u underruns, %u dropped", s->name,
+                   stats.underruns, stats.dropped);
+        TEST_CHECK(depth_min >= target - s->ptime_ms - 5 && depth_max <= target + s->ptime_ms + 5,
+                   "%s: depth %d..%d ms, target %d ms", s->name, depth_min, depth_max, target);
+        TEST_CHECK(saturated == 0, "%s: resampling saturated in %d of %d reads", s->name, saturated, reads);
+        TEST_CHECK(abs(drift - s->drift_ppm) <= SIM_DRIFT_TOLERANCE, "%s: drift %d ppm estimated as %d ppm",
+                   s->name, s->drift_ppm, drift);
+    }
+
+    free(packets);
+    free(pcm);
+    free(out);
+    app_jitter_deinit(&jitter);
+}
+
+/* Periodic signal of the concealment test: 200 Hz with harmonics, at 16 kHz */
+static double plc_signal(int n)
+{
+    double t = n / 16000.0;
+    return 6000 * sin(2 * M_PI * 200 * t) + 3000 * sin(2 * M_PI * 400 * t + 1) + 1500 * sin(2 * M_PI * 1000 * t + 2);
+}
+
+/* Squared error of the output against the signal delayed by delay frames */
+static double plc_error(const int16_t *out, int from, int to, int delay)
+{
+    double err = 0;
+    for (int n = from; n < to; n++) {
+        double e = out[n] - plc_signal(n - delay);
+        err += e * e;
+    }
+    return err;
+}
+
+/* One packet lost: the first 10 ms of its concealment are close to the original */
+static void test_concealment(void)
+{
+    const app_jitter_config_t config = { 16000, 1, 320, SIM_SLOTS, 40, 300, SIM_MAX_PPM };
+    const int packets = 100;
+    const int lost = 60;
+    static int16_t out[100 * 320];
+    int16_t pcm[320];
+    app_jitter_t jitter;
+
+    TEST_CHECK(app_jitter_init(&jitter, &config) == ESP_OK, "app_jitter_init");
+    for (int i = 0; i < packets; i++) {
+        /* Two packets ahead of the output */
+        for (int p = i == 0 ? 0 : i + 2; p <= i + 2; p++) {
+            for (int n = 0; n < 320; n++) {
+                pcm[n] = (int16_t)lround(plc_signal(p * 320 + n));
+            }
+            if (p != lost) {
+                app_jitter_put(&jitter, p, p * 320, pcm, 320, p * 20000LL);
+            }
+        }
+        app_jitter_read(&jitter, out + i * 320, 320);
+    }
+
+    /* Delay of the output, from the packet before the loss */
+    const int from = (lost - 1) * 320;
+    int delay = 0;
+    double best = INFINITY;
+    for (int d = 0; d < 8 * 320; d++) {
+        double err = plc_error(out, from, from + 320, d);
+        if (err < best) {
+            best = err;
+            delay = d;
+        }
+    }
+
+    const int start = lost * 320 + delay;
+    double sig = 0;
+    for (int n = start; n < start + 160; n++) {
+        sig += plc_signal(n - delay) * plc_signal(n - delay);
+    }
+    const double snr = 10 * log10(sig / fmax(plc_error(out, start, start + 160, delay), 1));
+
+    app_jitter_stats_t stats;
+    app_jitter_get_stats(&jitter, &stats);
+    printf("concealment: delay %d frames, first 10 ms of the lost packet SNR %.1f dB (silence 0 dB)\n", delay, snr);
+    TEST_CHECK(stats.lost == 1 && stats.concealed_ms == 20, "lost %u, concealed %u ms", stats.lost, stats.concealed_ms);
+    TEST_CHECK(snr >= 15, "concealment SNR %.1f dB", snr);
+    app_jitter_deinit(&jitter);
+}
+
+int main(void)
+{
+    test_config();
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        test_scenario(&scenarios[i]);
+    }
+    test_concealment();
+    return test_result("test_jitter");
+}
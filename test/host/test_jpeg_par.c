@@ -0,0 +1,336 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Parallel JPEG decoder (app_jpeg_par): images with restart markers are decoded by stripes and
+ * must be bit-identical to the sequential decode, images without them are left to the sequential
+ * decoder. The split is checked on truncated and corrupted images. The speedup is printed.
+ *
+ * esp_jpeg is replaced by libjpeg without fancy upsampling (like TJpgDec), so every MCU is
+ * decoded independently of its neighbours and the stripes join without seams.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <jpeglib.h>
+
+#include "app_mem.h"
+#include "app_jpeg_par.h"
+#include "jpeg_decoder.h"
+#include "test_util.h"
+
+typedef struct {
+    struct jpeg_error_mgr mgr;
+    jmp_buf jmp;
+} jpeg_error_t;
+
+typedef struct {
+    const char *name;
+    uint16_t width;
+    uint16_t height;
+    bool subsample;             /*!< 4:2:0, otherwise 4:4:4 */
+    int restart_rows;           /*!< Restart interval in MCU rows... */
+    int restart_mcus;           /*!< ...or in MCUs */
+    bool parallel;              /*!< Expected to be decoded in parallel */
+} jpeg_case_t;
+
+/* ---------------------------- esp_jpeg on libjpeg -------------------------- */
+
+static void jpeg_error_exit(j_common_ptr cinfo)
+{
+    jpeg_error_t *err = (jpeg_error_t *)cinfo->err;
+    longjmp(err->jmp, 1);
+}
+
+static void jpeg_output_message(j_common_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
+{
+    struct jpeg_decompress_struct d;
+    jpeg_error_t err;
+    uint8_t *row = NULL;
+
+    d.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpeg_error_exit;
+    err.mgr.output_message = jpeg_output_message;
+    if (setjmp(err.jmp)) {
+        jpeg_destroy_decompress(&d);
+        free(row);
+        return ESP_FAIL;
+    }
+
+    jpeg_create_decompress(&d);
+    jpeg_mem_src(&d, cfg->indata, cfg->indata_size);
+    jpeg_read_header(&d, TRUE);
+    d.out_color_space = JCS_RGB;
+    d.do_fancy_upsampling = FALSE;
+    jpeg_start_decompress(&d);
+
+    if ((size_t)d.output_width * d.output_height * 2 > cfg->outbuf_size) {
+        jpeg_destroy_decompress(&d);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    row = malloc(d.output_width * 3);
+    uint16_t *out = (uint16_t *)cfg->outbuf;
+    while (d.output_scanline < d.output_height) {
+        JSAMPROW rows[1] = { row };
+        jpeg_read_scanlines(&d, rows, 1);
+        for (unsigned x = 0; x < d.output_width; x++) {
+            uint16_t p = ((row[3 * x] & 0xF8) << 8) | ((row[3 * x + 1] & 0xFC) << 3) | (row[3 * x + 2] >> 3);
+            *out++ = cfg->flags.swap_color_bytes ? (uint16_t)((p >> 8) | (p << 8)) : p;
+        }
+    }
+    free(row);
+
+    img->width = d.output_width;
+    img->height = d.output_height;
+    img->output_len = d.output_width * d.output_height * 2;
+    /* Corrupt data is only a warning for libjpeg */
+    bool warnings = err.mgr.num_warnings != 0;
+    jpeg_finish_decompress(&d);
+    jpeg_destroy_decompress(&d);
+    return warnings ? ESP_FAIL : ESP_OK;
+}
+
+/* ---------------------------- Helpers -------------------------------------- */
+
+/* Gradients with sharp edges, so the stripe seams would show */
+static uint8_t *make_rgb(uint16_t w, uint16_t h)
+{
+    uint8_t *rgb = malloc((size_t)w * h * 3);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+            p[0] = x * 255 / w;
+            p[1] = y * 255 / h;
+            p[2] = ((x ^ y) & 31) * 8;
+        }
+    }
+    return rgb;
+}
+
+static uint8_t *encode(const jpeg_case_t *c, size_t *size)
+{
+    struct jpeg_compress_struct e;
+    struct jpeg_error_mgr err;
+    uint8_t *out = NULL;
+    unsigned long len = 0;
+
+    uint8_t *rgb = make_rgb(c->width, c->height);
+    e.err = jpeg_std_error(&err);
+    jpeg_create_compress(&e);
+    jpeg_mem_dest(&e, &out, &len);
+    e.image_width = c->width;
+    e.image_height = c->height;
+    e.input_components = 3;
+    e.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&e);
+    jpeg_set_quality(&e, 90, TRUE);
+    if (!c->subsample) {
+        e.comp_info[0].h_samp_factor = 1;
+        e.comp_info[0].v_samp_factor = 1;
+    }
+    e.restart_in_rows = c->restart_rows;
+    e.restart_interval = c->restart_mcus;
+    jpeg_start_compress(&e, TRUE);
+    while (e.next_scanline < e.image_height) {
+        JSAMPROW row = &rgb[(size_t)e.next_scanline * c->width * 3];
+        jpeg_write_scanlines(&e, &row, 1);
+    }
+    jpeg_finish_compress(&e);
+    jpeg_destroy_compress(&e);
+    free(rgb);
+
+    *size = len;
+    return out;
+}
+
+static esp_err_t decode_seq(const uint8_t *jpeg, size_t size, uint16_t *buf, size_t buf_size, bool swap)
+{
+    esp_jpeg_image_cfg_t cfg = {
+        .indata = (uint8_t *)jpeg,
+        .indata_size = size,
+        .outbuf = (uint8_t *)buf,
+        .outbuf_size = buf_size,
+        .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        .flags.swap_color_bytes = swap,
+    };
+    esp_jpeg_image_output_t img;
+    return esp_jpeg_decode(&cfg, &img);
+}
+
+static esp_err_t decode_par(const uint8_t *jpeg, size_t size, uint16_t *buf, size_t buf_size, bool swap)
+{
+    app_img_out_t out = {
+        .buf = (uint8_t *)buf,
+        .buf_size = buf_size,
+        .max_width = 4096,
+        .max_height = 4096,
+        .swap_bytes = swap,
+    };
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    esp_err_t ret = app_jpeg_par_decode(jpeg, size, &out);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    return ret;
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+/* Stripes must cover the image in order, start on a row and end on a restart marker or EOI */
+static void check_split(const char *name, const uint8_t *jpeg, size_t size, uint8_t count)
+{
+    app_jpeg_split_t split;
+    esp_err_t ret = app_jpeg_par_split(jpeg, size, count, &split);
+    TEST_CHECK(ret == ESP_OK && split.count > 1 && split.count <= count, "%s split by %u: ret 0x%x, %u stripes",
+               name, count, ret, split.count);
+    if (ret != ESP_OK) {
+        return;
+    }
+
+    uint16_t y = 0;
+    for (uint8_t i = 0; i < split.count; i++) {
+        const app_jpeg_stripe_t *s = &split.stripes[i];
+        TEST_CHECK(s->y == y && s->height > 0, "%s stripe %u: y %u height %u, expected y %u", name, i, s->y, s->height, y);
+        TEST_CHECK(s->data_start >= split.header_size && s->data_start < s->data_end && s->data_end + 2 <= size,
+                   "%s stripe %u: data %zu..%zu of %zu", name, i, s->data_start, s->data_end, size);
+        TEST_CHECK(jpeg[s->data_end] == 0xFF && (jpeg[s->data_end + 1] == 0xD9 || (jpeg[s->data_end + 1] & 0xF8) == 0xD0),
+                   "%s stripe %u: no marker at the end", name, i);
+        y += s->height;
+    }
+    TEST_CHECK(y == split.height, "%s: stripes cover %u of %u rows", name, y, split.height);
+}
+
+static void test_case(const jpeg_case_t *c)
+{
+    size_t size;
+    uint8_t *jpeg = encode(c, &size);
+    size_t buf_size = (size_t)c->width * c->height * sizeof(uint16_t);
+    uint16_t *seq = malloc(buf_size);
+    uint16_t *par = malloc(buf_size);
+
+    for (int swap = 0; swap < 2; swap++) {
+        TEST_CHECK(decode_seq(jpeg, size, seq, buf_size, swap) == ESP_OK, "%s: sequential decode failed", c->name);
+        memset(par, 0x55, buf_size);
+        esp_err_t ret = decode_par(jpeg, size, par, buf_size, swap);
+        if (!c->parallel) {
+            TEST_CHECK(ret == ESP_ERR_NOT_SUPPORTED, "%s: ret 0x%x, expected not supported", c->name, ret);
+            break;
+        }
+        TEST_CHECK(ret == ESP_OK, "%s swap %d: ret 0x%x", c->name, swap, ret);
+        TEST_CHECK(memcmp(seq, par, buf_size) == 0, "%s swap %d: parallel decode differs", c->name, swap);
+    }
+
+    if (c->parallel) {
+        check_split(c->name, jpeg, size, 2);
+        check_split(c->name, jpeg, size, APP_JPEG_PAR_MAX_STRIPES);
+
+        /* Larger than the output: left to the sequential decoder, which crops */
+        app_img_out_t out = { .buf = (uint8_t *)par, .buf_size = buf_size, .max_width = c->width - 1, .max_height = c->height };
+        TEST_CHECK(app_jpeg_par_decode(jpeg, size, &out) == ESP_ERR_NOT_SUPPORTED, "%s: cropped image decoded", c->name);
+    }
+
+    free(seq);
+    free(par);
+    free(jpeg);
+}
+
+/* The split parses the markers, it must stay in the data of any length */
+static void test_malformed(void)
+{
+    const jpeg_case_t c = { "malformed", 160, 96, true, 1, 0, true };
+    size_t size;
+    uint8_t *jpeg = encode(&c, &size);
+    uint32_t seed = 0xACE1;
+
+    for (size_t len = 0; len < size; len++) {
+        uint8_t *part = malloc(len ? len : 1);
+        memcpy(part, jpeg, len);
+        app_jpeg_split_t split;
+        esp_err_t ret = app_jpeg_par_split(part, len, 2, &split);
+        /* Stripes found in a truncated image must lie inside it */
+        for (uint8_t i = 0; ret == ESP_OK && i < split.count; i++) {
+            TEST_CHECK(split.stripes[i].data_end + 2 <= len, "truncated to %zu: stripe %u ends at %zu", len, i,
+                       split.stripes[i].data_end);
+        }
+        free(part);
+    }
+
+    int rejected = 0;
+    for (int i = 0; i < 2000; i++) {
+        uint8_t *bad = malloc(size);
+        memcpy(bad, jpeg, size);
+        /* Mostly the headers, which the split parses */
+        size_t range = (test_rand(&seed) & 1) ? 700 : size;
+        for (int f = 0; f < 3; f++) {
+            bad[test_rand(&seed) % range] ^= 1 << (test_rand(&seed) % 8);
+        }
+        app_jpeg_split_t split;
+        rejected += app_jpeg_par_split(bad, size, 2, &split) != ESP_OK;
+        free(bad);
+    }
+    printf("corrupted: %d of 2000 rejected by the split\n", rejected);
+
+    free(jpeg);
+}
+
+static void bench(const jpeg_case_t *c)
+{
+    size_t size;
+    uint8_t *jpeg = encode(c, &size);
+    size_t buf_size = (size_t)c->width * c->height * sizeof(uint16_t);
+    uint16_t *buf = malloc(buf_size);
+    const int runs = 10;
+
+    double start = test_now_us();
+    for (int i = 0; i < runs; i++) {
+        decode_seq(jpeg, size, buf, buf_size, false);
+    }
+    double seq_us = (test_now_us() - start) / runs;
+
+    start = test_now_us();
+    for (int i = 0; i < runs; i++) {
+        decode_par(jpeg, size, buf, buf_size, false);
+    }
+    double par_us = (test_now_us() - start) / runs;
+
+    /* Not checked, it depends on the host CPUs (and the sanitizers) */
+    printf("%s %ux%u: sequential %.0f us, parallel %.0f us, speedup %.2fx on %ld CPUs\n", c->name, c->width, c->height,
+           seq_us, par_us, seq_us / par_us, sysconf(_SC_NPROCESSORS_ONLN));
+    free(buf);
+    free(jpeg);
+}
+
+int main(void)
+{
+    static const jpeg_case_t cases[] = {
+        { "320x240 4:2:0 restart every row", 320, 240, true, 1, 0, true },
+        { "320x240 4:4:4 restart every 5 MCUs", 320, 240, false, 0, 5, true },
+        { "317x203 4:2:0 restart every row", 317, 203, true, 1, 0, true },
+        { "640x480 4:2:0 restart every 7 MCUs", 640, 480, true, 0, 7, true },
+        { "320x240 4:2:0 restart every 3 rows", 320, 240, true, 3, 0, true },
+        { "320x240 no restart", 320, 240, true, 0, 0, false },
+        { "16x16 single MCU row", 16, 16, true, 1, 0, false },
+    };
+
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        test_case(&cases[i]);
+    }
+    test_malformed();
+
+    const jpeg_case_t large = { "bench", 800, 480, true, 1, 0, true };
+    bench(&large);
+
+    return test_result("test_jpeg_par");
+}
@@ -0,0 +1,421 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Media controller (app_media) under a random command storm: play of WAV files (also missing
+ * and empty ones) and live streams, pause, resume, stop, seek, volume and repeat, at human pace
+ * and in bursts which fill the command queue. The speaker is checked to be opened and closed in
+ * pairs and written only while open, every stop must silence it, and all blocks, the arena and
+ * the stream sources must be released at the end. The stop-to-silence latency is printed.
+ * The synchronous stop must drop a queued play and return only after the file is closed.
+ *
+ *   test_media [commands]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_codec_dev.h"
+#include "app_mem.h"
+#include "app_audio_dec.h"
+#include "app_media.h"
+#include "test_util.h"
+
+#define COMMANDS_DEFAULT    (600)
+/* A stop must silence the speaker within this time */
+#define STOP_TIMEOUT_US     (500 * 1000)
+/* Longer than a block of the controller, nothing may play after it */
+#define STOP_SETTLE_MS      (40)
+#define FILES               (5)
+
+/* ---------------------------- Speaker -------------------------------------- */
+
+static pthread_mutex_t codec_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool codec_open;
+static bool codec_mute;
+static int codec_opens;
+static int codec_violations;
+static int codec_bytes_per_s;
+static int64_t codec_silent_us;     /*!< Last change to silence (close or mute) */
+
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs)
+{
+    pthread_mutex_lock(&codec_lock);
+    codec_violations += codec_open;
+    codec_open = true;
+    codec_opens++;
+    codec_bytes_per_s = fs->sample_rate * fs->channel * fs->bits_per_sample / 8;
+    pthread_mutex_unlock(&codec_lock);
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t dev)
+{
+    pthread_mutex_lock(&codec_lock);
+    codec_violations += !codec_open;
+    if (!codec_mute) {
+        codec_silent_us = esp_timer_get_time();
+    }
+    codec_open = false;
+    pthread_mutex_unlock(&codec_lock);
+    return ESP_CODEC_DEV_OK;
+}
+
+/* The I2S DMA takes the data at the sample rate */
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    pthread_mutex_lock(&codec_lock);
+    codec_violations += !codec_open;
+    int rate = codec_bytes_per_s;
+    pthread_mutex_unlock(&codec_lock);
+
+    /* The block must be alive (ASan) */
+    volatile uint8_t last = ((uint8_t *)data)[len - 1];
+    (void)last;
+    if (rate > 0) {
+        usleep((int64_t)len * 1000000 / rate);
+    }
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t dev, bool mute)
+{
+    pthread_mutex_lock(&codec_lock);
+    if (mute && codec_open && !codec_mute) {
+        codec_silent_us = esp_timer_get_time();
+    }
+    codec_mute = mute;
+    pthread_mutex_unlock(&codec_lock);
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t dev, int volume)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_read(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t dev, float db)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+static bool codec_audible(int64_t *silent_us)
+{
+    pthread_mutex_lock(&codec_lock);
+    bool audible = codec_open && !codec_mute;
+    *silent_us = codec_silent_us;
+    pthread_mutex_unlock(&codec_lock);
+    return audible;
+}
+
+/* Number of opens, -1 if the speaker is open now */
+static int codec_closed_opens(void)
+{
+    pthread_mutex_lock(&codec_lock);
+    int opens = codec_open ? -1 : codec_opens;
+    pthread_mutex_unlock(&codec_lock);
+    return opens;
+}
+
+/* ---------------------------- Live stream ---------------------------------- */
+
+static atomic_int stream_opened;
+static atomic_int stream_closed;
+
+typedef struct {
+    uint32_t left;              /*!< Bytes until the end of the stream */
+} stream_t;
+
+static esp_err_t stream_decode(void *ctx, void *out, size_t len, size_t *out_len)
+{
+    stream_t *s = ctx;
+    *out_len = len < s->left ? len : s->left;
+    memset(out, 0, *out_len);
+    s->left -= *out_len;
+    return ESP_OK;
+}
+
+static void stream_close(void *ctx)
+{
+    /* Poisoned, a use after close is caught by ASan */
+    free(ctx);
+    atomic_fetch_add(&stream_closed, 1);
+}
+
+static const app_audio_decoder_t stream_source = {
+    .name = "test stream",
+    .decode = stream_decode,
+    .close = stream_close,
+};
+
+static esp_err_t play_stream(uint32_t *seed)
+{
+    const app_audio_info_t info = {
+        .sample_rate = 16000,
+        .channels = 1,
+        .bits_per_sample = 16,
+    };
+    stream_t *s = malloc(sizeof(stream_t));
+    s->left = test_rand(seed) % 32000;
+    atomic_fetch_add(&stream_opened, 1);
+
+    esp_err_t ret = app_media_play_stream(&stream_source, s, &info);
+    if (ret != ESP_OK) {
+        /* Not queued, the source stays with the caller */
+        stream_close(s);
+    }
+    return ret;
+}
+
+/* ---------------------------- Files ---------------------------------------- */
+
+static void put16(FILE *f, uint16_t v)
+{
+    fwrite(&v, 2, 1, f);
+}
+
+static void put32(FILE *f, uint32_t v)
+{
+    fwrite(&v, 4, 1, f);
+}
+
+static void write_wav(const char *path, uint32_t rate, uint16_t channels, uint32_t frames)
+{
+    FILE *f = fopen(path, "wb");
+    uint32_t data_size = frames * channels * 2;
+
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + data_size);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, channels);
+    put32(f, rate);
+    put32(f, rate * channels * 2);
+    put16(f, channels * 2);
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, data_size);
+    for (uint32_t i = 0; i < frames * channels; i++) {
+        put16(f, (uint16_t)(i * 37));
+    }
+    fclose(f);
+}
+
+/* ---------------------------- UI ------------------------------------------- */
+
+static _Atomic app_media_state_t cb_state;
+static atomic_int cb_count;
+/* The next PLAYING callback blocks the controller until the gate is given */
+static SemaphoreHandle_t cb_gate;
+static atomic_bool cb_gated;
+static atomic_bool cb_blocked;
+
+static void state_cb(app_media_state_t state, void *user_data)
+{
+    /* The LVGL display lock, held by rendering */
+    uint32_t *seed = user_data;
+    usleep(test_rand(seed) % 2000);
+    if (state == APP_MEDIA_STATE_PLAYING && atomic_exchange(&cb_gated, false)) {
+        atomic_store(&cb_blocked, true);
+        xSemaphoreTake(cb_gate, portMAX_DELAY);
+        atomic_store(&cb_blocked, false);
+    }
+    atomic_store(&cb_state, state);
+    atomic_fetch_add(&cb_count, 1);
+}
+
+/* ---------------------------- Test ----------------------------------------- */
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Stop and wait until the speaker is silent, return the stop-to-silence latency */
+static int64_t stop_and_check(void)
+{
+    int64_t start = esp_timer_get_time();
+    esp_err_t ret = app_media_stop();
+    TEST_CHECK(ret == ESP_OK, "stop: 0x%x", ret);
+
+    int64_t silent_us;
+    while (codec_audible(&silent_us) || app_media_get_state() != APP_MEDIA_STATE_IDLE) {
+        if (esp_timer_get_time() - start > STOP_TIMEOUT_US) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    /* Commands sent before the stop may still be handled first, nothing plays after the stop */
+    vTaskDelay(pdMS_TO_TICKS(STOP_SETTLE_MS));
+    bool audible = codec_audible(&silent_us);
+    TEST_CHECK(!audible && app_media_get_state() == APP_MEDIA_STATE_IDLE, "playing after stop (state %d)",
+               app_media_get_state());
+    int64_t latency = silent_us > start ? silent_us - start : 0;
+    TEST_CHECK(latency < STOP_TIMEOUT_US, "stop-to-silence %" PRId64 " us", latency);
+    return latency;
+}
+
+static void gate_task(void *arg)
+{
+    vTaskDelay(pdMS_TO_TICKS(STOP_SETTLE_MS));
+    xSemaphoreGive(cb_gate);
+    vTaskDelete(NULL);
+}
+
+/* Play held in the controller, a second play queued behind it: the synchronous stop drops the queued one */
+static void test_stop_sync(const char *playing, const char *queued)
+{
+    cb_gate = xSemaphoreCreateBinary();
+    atomic_store(&cb_gated, true);
+    TEST_CHECK(app_media_play(playing, APP_FILE_TYPE_WAV) == ESP_OK, "play");
+    for (int i = 0; i < 1000 && !atomic_load(&cb_blocked); i++) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    TEST_CHECK(atomic_load(&cb_blocked), "controller not held");
+    pthread_mutex_lock(&codec_lock);
+    int opens = codec_opens;
+    pthread_mutex_unlock(&codec_lock);
+    TEST_CHECK(app_media_play(queued, APP_FILE_TYPE_WAV) == ESP_OK, "queued play");
+
+    /* The controller cannot handle the stop in time */
+    TEST_CHECK(app_media_stop_sync(STOP_SETTLE_MS / 4) == ESP_ERR_TIMEOUT, "stop while held");
+
+    int64_t start = esp_timer_get_time();
+    xTaskCreate(gate_task, "gate", 4096, NULL, 5, NULL);
+    esp_err_t ret = app_media_stop_sync(1000);
+    int64_t waited_us = esp_timer_get_time() - start;
+    TEST_CHECK(ret == ESP_OK, "stop_sync: 0x%x", ret);
+    TEST_CHECK(waited_us >= STOP_SETTLE_MS * 1000 / 2, "stop_sync returned in %" PRId64 " us, before the controller", waited_us);
+
+    /* Closed on return, the queued file is never opened */
+    TEST_CHECK(codec_closed_opens() == opens, "speaker open after stop_sync");
+    TEST_CHECK(app_media_get_state() == APP_MEDIA_STATE_IDLE, "state %d after stop_sync", app_media_get_state());
+    vTaskDelay(pdMS_TO_TICKS(STOP_SETTLE_MS));
+    TEST_CHECK(codec_closed_opens() == opens, "queued play opened after stop_sync");
+
+    vSemaphoreDelete(cb_gate);
+}
+
+int main(int argc, char **argv)
+{
+    const int commands = argc > 1 ? atoi(argv[1]) : COMMANDS_DEFAULT;
+    char dir[] = "/tmp/test_mediaXXXXXX";
+    char files[FILES][64];
+    uint32_t seed = 12345;
+    uint32_t cb_seed = 777;
+
+    TEST_CHECK(mkdtemp(dir) != NULL, "mkdtemp");
+    for (int i = 0; i < FILES; i++) {
+        snprintf(files[i], sizeof(files[i]), "%s/%d.wav", dir, i);
+    }
+    write_wav(files[0], 8000, 1, 4000);
+    write_wav(files[1], 22050, 1, 22050);
+    write_wav(files[2], 44100, 2, 14700);
+    write_wav(files[3], 22050, 1, 0);
+    /* files[4] is missing */
+
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    app_media_config_t cfg = { .codec = (esp_codec_dev_handle_t)&codec_open, .volume = 70, .state_cb = state_cb, .user_data = &cb_seed };
+    TEST_CHECK(app_media_init(&cfg) == ESP_OK, "app_media_init");
+    TEST_CHECK(app_media_init(&cfg) == ESP_ERR_INVALID_STATE, "second app_media_init");
+    TEST_CHECK(app_media_play_stream(&stream_source, NULL, NULL) == ESP_ERR_INVALID_ARG, "stream without info");
+
+    int64_t *latency = calloc(commands, sizeof(int64_t));
+    int stops = 0;
+    int full = 0;
+    int counts[8] = { 0 };
+
+    for (int i = 0; i < commands; i++) {
+        unsigned r = test_rand(&seed) % 100;
+        esp_err_t ret;
+        if (r < 20) {
+            /* The controller must copy the path */
+            char *path = strdup(files[test_rand(&seed) % FILES]);
+            ret = app_media_play(path, APP_FILE_TYPE_WAV);
+            free(path);
+            counts[0]++;
+        } else if (r < 25) {
+            ret = play_stream(&seed);
+            counts[1]++;
+        } else if (r < 35) {
+            ret = app_media_pause();
+            counts[2]++;
+        } else if (r < 45) {
+            ret = app_media_resume();
+            counts[3]++;
+        } else if (r < 60) {
+            latency[stops++] = stop_and_check();
+            ret = ESP_OK;
+            counts[4]++;
+        } else if (r < 75) {
+            ret = app_media_seek(test_rand(&seed) % 20000);
+            counts[5]++;
+        } else if (r < 90) {
+            ret = app_media_set_volume(test_rand(&seed) % 90);
+            counts[6]++;
+        } else {
+            ret = app_media_set_repeat(test_rand(&seed) & 1);
+            counts[7]++;
+        }
+        full += (ret == ESP_ERR_TIMEOUT);
+        TEST_CHECK(ret == ESP_OK || ret == ESP_ERR_TIMEOUT, "command %d: 0x%x", i, ret);
+
+        /* Mostly human pace, sometimes bursts which fill the queue */
+        unsigned gap = test_rand(&seed) % 100;
+        if (gap < 50) {
+            usleep(test_rand(&seed) % 5000);
+        } else if (gap < 80) {
+            usleep(test_rand(&seed) % 500);
+        }
+    }
+    stop_and_check();
+    test_stop_sync(files[1], files[2]);
+
+    app_mem_stats_t stats;
+    app_mem_get_stats(&stats);
+    TEST_CHECK(codec_violations == 0, "%d speaker open/close/write violations", codec_violations);
+    TEST_CHECK(stats.pool[APP_MEM_POOL_AUDIO].used == 0, "%" PRIu32 " audio blocks not returned",
+               stats.pool[APP_MEM_POOL_AUDIO].used);
+    TEST_CHECK(!stats.arena[APP_MEM_ARENA_PLAY].busy, "playback arena not released");
+    TEST_CHECK(atomic_load(&stream_opened) == atomic_load(&stream_closed), "streams: %d opened, %d closed",
+               atomic_load(&stream_opened), atomic_load(&stream_closed));
+    TEST_CHECK(atomic_load(&cb_state) == APP_MEDIA_STATE_IDLE, "last state callback %d", atomic_load(&cb_state));
+
+    qsort(latency, stops, sizeof(int64_t), cmp_i64);
+    printf("commands %d (play %d, stream %d, pause %d, resume %d, stop %d, seek %d, volume %d, repeat %d), "
+           "queue full %d\n", commands, counts[0], counts[1], counts[2], counts[3], counts[4], counts[5], counts[6],
+           counts[7], full);
+    printf("speaker opens %d, state callbacks %d, streams %d\n", codec_opens, atomic_load(&cb_count),
+           atomic_load(&stream_opened));
+    if (stops > 0) {
+        printf("stop-to-silence: p50 %.1f ms, p99 %.1f ms, max %.1f ms\n", latency[stops / 2] / 1000.0,
+               latency[stops * 99 / 100] / 1000.0, latency[stops - 1] / 1000.0);
+    }
+
+    free(latency);
+    for (int i = 0; i < FILES; i++) {
+        unlink(files[i]);
+    }
+    rmdir(dir);
+    return test_result("test_media");
+}
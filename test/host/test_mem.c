@@ -0,0 +1,273 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Media memory (app_mem): soak of the pools and arenas by as many concurrent tasks as the firmware
+ * has users, each checking that its memory is not touched by the others; and the start on low
+ * memory, where pools and arenas are reduced or disabled but app_mem_init() still succeeds.
+ *
+ *   test_mem           soak
+ *   test_mem low       init with failing large and DMA allocations
+ *   test_mem none      init with all allocations failing
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "app_mem.h"
+#include "test_util.h"
+
+#define SOAK_MS             (1500)
+
+typedef struct {
+    int id;
+    app_mem_pool_id_t pool;
+    app_mem_arena_id_t arena;
+    bool is_arena;
+    uint32_t rounds;
+    uint32_t errors;
+} soak_task_t;
+
+static SemaphoreHandle_t done;
+static volatile bool soak_stop;
+
+static void fill(void *ptr, size_t size, uint8_t tag)
+{
+    memset(ptr, tag, size);
+}
+
+static bool filled(const void *ptr, size_t size, uint8_t tag)
+{
+    const uint8_t *p = ptr;
+    for (size_t i = 0; i < size; i++) {
+        if (p[i] != tag) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Holds one pool block at a time, like the audio and file tasks */
+static void pool_task(soak_task_t *t)
+{
+    size_t size = (t->pool == APP_MEM_POOL_AUDIO) ? APP_MEM_AUDIO_BLOCK_SIZE : APP_MEM_IO_BLOCK_SIZE;
+    uint32_t rnd = t->id + 1;
+
+    while (!soak_stop) {
+        uint8_t *block = app_mem_pool_alloc(t->pool);
+        if (block == NULL) {
+            t->errors++;
+            vTaskDelay(1);
+            continue;
+        }
+        fill(block, size, t->id);
+        if (test_rand(&rnd) % 4 == 0) {
+            vTaskDelay(1);
+        }
+        t->errors += !filled(block, size, t->id);
+        app_mem_pool_free(block);
+        t->rounds++;
+    }
+}
+
+/* Owns its arena for one "window", allocates until full, frees the last block back */
+static void arena_task(soak_task_t *t)
+{
+    app_mem_stats_t stats;
+    uint32_t rnd = t->id + 1;
+    void *ptrs[64];
+    size_t sizes[64];
+
+    app_mem_get_stats(&stats);
+    size_t max = stats.arena[t->arena].size / 8;
+
+    while (!soak_stop) {
+        if (app_mem_arena_begin(t->arena) != ESP_OK) {
+            t->errors++;
+            break;
+        }
+        int n = 0;
+        while (n < 64) {
+            sizes[n] = 1 + test_rand(&rnd) % max;
+            ptrs[n] = app_mem_arena_alloc(t->arena, sizes[n]);
+            if (ptrs[n] == NULL) {
+                break;
+            }
+            t->errors += !filled(ptrs[n], sizes[n], 0);
+            fill(ptrs[n], sizes[n], t->id + n);
+            if (n > 0 && test_rand(&rnd) % 3 == 0) {
+                /* Freeing the last allocation returns its space */
+                app_mem_arena_free(t->arena, ptrs[n]);
+                void *again = app_mem_arena_alloc(t->arena, sizes[n]);
+                t->errors += (again != ptrs[n]);
+                fill(again, sizes[n], t->id + n);
+            }
+            n++;
+        }
+        for (int i = 0; i < n; i++) {
+            t->errors += !filled(ptrs[i], sizes[i], t->id + i);
+        }
+        app_mem_arena_end(t->arena);
+        t->rounds++;
+        vTaskDelay(test_rand(&rnd) % 2);
+    }
+}
+
+static void soak_task(void *arg)
+{
+    soak_task_t *t = arg;
+
+    if (t->is_arena) {
+        arena_task(t);
+    } else {
+        pool_task(t);
+    }
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+static void test_soak(void)
+{
+    app_mem_stats_t stats;
+    soak_task_t tasks[APP_MEM_AUDIO_BLOCK_USERS + 1 + APP_MEM_ARENA_MAX];
+    int count = 0;
+
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    app_mem_get_stats(&stats);
+    TEST_CHECK(stats.pool[APP_MEM_POOL_AUDIO].blocks == CONFIG_APP_MEM_AUDIO_BLOCKS, "audio blocks %" PRIu32,
+               stats.pool[APP_MEM_POOL_AUDIO].blocks);
+    TEST_CHECK(stats.pool[APP_MEM_POOL_FRAME].blocks == 1 &&
+               stats.pool[APP_MEM_POOL_FRAME].block_size == APP_MEM_FRAME_BLOCK_SIZE, "frame block");
+
+    /* Every audio block user at once, the text indexer and one owner per arena */
+    for (int i = 0; i < APP_MEM_AUDIO_BLOCK_USERS; i++) {
+        tasks[count++] = (soak_task_t) {
+            .pool = APP_MEM_POOL_AUDIO
+        };
+    }
+    tasks[count++] = (soak_task_t) {
+        .pool = APP_MEM_POOL_IO
+    };
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        tasks[count++] = (soak_task_t) {
+            .arena = i, .is_arena = true
+        };
+    }
+
+    done = xSemaphoreCreateCounting(count, 0);
+    for (int i = 0; i < count; i++) {
+        tasks[i].id = 0x10 + i;
+        xTaskCreate(soak_task, "soak", 4096, &tasks[i], 5, NULL);
+    }
+    vTaskDelay(pdMS_TO_TICKS(SOAK_MS));
+    soak_stop = true;
+    for (int i = 0; i < count; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+
+    for (int i = 0; i < count; i++) {
+        TEST_CHECK(tasks[i].errors == 0 && tasks[i].rounds > 0, "task %d: %" PRIu32 " errors in %" PRIu32 " rounds",
+                   i, tasks[i].errors, tasks[i].rounds);
+    }
+    app_mem_get_stats(&stats);
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        TEST_CHECK(stats.pool[i].used == 0, "pool %d: %" PRIu32 " blocks not returned", i, stats.pool[i].used);
+    }
+    TEST_CHECK(stats.pool[APP_MEM_POOL_AUDIO].fails == 0 &&
+               stats.pool[APP_MEM_POOL_AUDIO].high_water == APP_MEM_AUDIO_BLOCK_USERS,
+               "audio pool: %" PRIu32 " fails, high-water %" PRIu32, stats.pool[APP_MEM_POOL_AUDIO].fails,
+               stats.pool[APP_MEM_POOL_AUDIO].high_water);
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        TEST_CHECK(!stats.arena[i].busy && stats.arena[i].used == 0, "arena %d not released", i);
+    }
+    app_mem_log_stats();
+
+    /* One block more than the pool has, a second owner of an arena */
+    void *blocks[CONFIG_APP_MEM_AUDIO_BLOCKS];
+    for (int i = 0; i < CONFIG_APP_MEM_AUDIO_BLOCKS; i++) {
+        blocks[i] = app_mem_pool_alloc(APP_MEM_POOL_AUDIO);
+    }
+    TEST_CHECK(app_mem_pool_alloc(APP_MEM_POOL_AUDIO) == NULL, "empty audio pool");
+    for (int i = 0; i < CONFIG_APP_MEM_AUDIO_BLOCKS; i++) {
+        app_mem_pool_free(blocks[i]);
+    }
+    /* The viewer frame counts in the pool statistics like any other block */
+    void *frame = app_mem_pool_alloc(APP_MEM_POOL_FRAME);
+    TEST_CHECK(frame != NULL && app_mem_pool_alloc(APP_MEM_POOL_FRAME) == NULL, "one frame block");
+    app_mem_pool_free(frame);
+    app_mem_get_stats(&stats);
+    TEST_CHECK(stats.pool[APP_MEM_POOL_FRAME].used == 0 && stats.pool[APP_MEM_POOL_FRAME].high_water == 1 &&
+               stats.pool[APP_MEM_POOL_FRAME].fails == 1, "frame pool stats");
+    TEST_CHECK(app_mem_arena_begin(APP_MEM_ARENA_WINDOW) == ESP_OK, "arena begin");
+    TEST_CHECK(app_mem_arena_begin(APP_MEM_ARENA_WINDOW) == ESP_ERR_INVALID_STATE, "arena owned twice");
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+}
+
+/* Allocations larger than 64 KB fail, the DMA capable ones too */
+static void test_low(void)
+{
+    app_mem_stats_t stats;
+
+    host_heap_fail_size = 64 * 1024 + 1;
+    host_heap_fail_caps = MALLOC_CAP_DMA;
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init on low memory");
+    host_heap_fail_size = 0;
+    host_heap_fail_caps = 0;
+
+    app_mem_get_stats(&stats);
+    TEST_CHECK(stats.pool[APP_MEM_POOL_AUDIO].blocks == 0, "audio pool disabled");
+    TEST_CHECK(stats.pool[APP_MEM_POOL_IO].blocks == CONFIG_APP_MEM_IO_BLOCKS, "io pool kept");
+    TEST_CHECK(stats.pool[APP_MEM_POOL_FRAME].blocks == 0, "frame pool disabled");
+    TEST_CHECK(stats.arena[APP_MEM_ARENA_WINDOW].size == 64 * 1024, "window arena reduced to %zu B",
+               stats.arena[APP_MEM_ARENA_WINDOW].size);
+    TEST_CHECK(stats.arena[APP_MEM_ARENA_REC].size == CONFIG_APP_MEM_REC_ARENA_KB * 1024, "rec arena kept");
+
+    TEST_CHECK(app_mem_pool_alloc(APP_MEM_POOL_AUDIO) == NULL, "disabled pool alloc");
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    TEST_CHECK(app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, 60 * 1024) != NULL, "reduced arena alloc");
+    TEST_CHECK(app_mem_arena_alloc(APP_MEM_ARENA_WINDOW, 8 * 1024) == NULL, "reduced arena full");
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+}
+
+static void test_none(void)
+{
+    app_mem_stats_t stats;
+
+    host_heap_fail_caps = UINT32_MAX;
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init without memory");
+    host_heap_fail_caps = 0;
+
+    app_mem_get_stats(&stats);
+    for (int i = 0; i < APP_MEM_POOL_MAX; i++) {
+        TEST_CHECK(stats.pool[i].blocks == 0 && app_mem_pool_alloc(i) == NULL, "pool %d disabled", i);
+    }
+    for (int i = 0; i < APP_MEM_ARENA_MAX; i++) {
+        TEST_CHECK(stats.arena[i].size == 0, "arena %d disabled", i);
+        TEST_CHECK(app_mem_arena_begin(i) == ESP_OK, "arena %d begin", i);
+        TEST_CHECK(app_mem_arena_alloc(i, 4) == NULL, "arena %d alloc", i);
+        app_mem_arena_end(i);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "low") == 0) {
+        test_low();
+    } else if (argc > 1 && strcmp(argv[1], "none") == 0) {
+        test_none();
+    } else {
+        test_soak();
+    }
+
+    return test_result("test_mem");
+}
@@ -0,0 +1,299 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Headless UI latency benchmark: app_replay replays a script on the UI of app_disp_fs (tab view,
+ * file list, image window), running on the host LVGL and BSP stubs. The storage is a temporary
+ * directory with an image and a text file, the image is really decoded into the frame buffer.
+ * Only the display is modeled: a frame takes the time of the SPI transfer of its area.
+ *
+ * The latency table is printed like on the device. When a first frame p90 is over the budget,
+ * the run prints "UI latency regression" and exits with REPLAY_EXIT_OVER_BUDGET, so a UI latency
+ * regression fails the run and is told apart from a failed check (exit 1).
+ *
+ *   test_replay <budget_ms> <repeat> [script]      built-in script if none
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <inttypes.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_codec_dev.h"
+#include "jpeg_decoder.h"
+#include "bsp/esp-bsp.h"
+#include "lvgl.h"
+#include "app_mem.h"
+#include "app_storage.h"
+#include "app_disp_fs.h"
+#include "app_replay.h"
+#include "test_util.h"
+
+/* Modeled frame: RGB565 over SPI at 40 MHz, plus rendering, per pixel */
+#define UI_FLUSH_NS_PER_PX  (500)
+
+#define REPLAY_SETTLE_MS    (60)
+#define REPLAY_TIMEOUT_MS   (2000)
+/* Exit status of a run over the budget */
+#define REPLAY_EXIT_OVER_BUDGET     (3)
+
+/* The image is first in the list, the built-in script opens it */
+#define STORAGE_IMAGE       "image.bmp"
+#define STORAGE_TEXT        "notes.txt"
+
+static char storage_dir[32];
+static uint32_t frames;
+static uint64_t frame_pixels;
+
+/* ---------------------------- Storage -------------------------------------- */
+
+FILE *__real_fopen(const char *path, const char *mode);
+int __real_stat(const char *path, struct stat *st);
+DIR *__real_opendir(const char *path);
+struct dirent *__real_readdir(DIR *dir);
+
+/* Path of the mount point in the temporary directory */
+static const char *storage_path(char *real, const char *path)
+{
+    const size_t len = strlen(APP_STORAGE_MOUNT_POINT);
+    if (strncmp(path, APP_STORAGE_MOUNT_POINT, len) != 0) {
+        return path;
+    }
+    snprintf(real, PATH_MAX, "%s%s", storage_dir, path + len);
+    return real;
+}
+
+FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    char real[PATH_MAX];
+    return __real_fopen(storage_path(real, path), mode);
+}
+
+int __wrap_stat(const char *path, struct stat *st)
+{
+    char real[PATH_MAX];
+    return __real_stat(storage_path(real, path), st);
+}
+
+DIR *__wrap_opendir(const char *path)
+{
+    char real[PATH_MAX];
+    return __real_opendir(storage_path(real, path));
+}
+
+/* Like the flash file systems, no "." and ".." entries */
+struct dirent *__wrap_readdir(DIR *dir)
+{
+    struct dirent *de;
+    do {
+        de = __real_readdir(dir);
+    } while (de && (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0));
+    return de;
+}
+
+static void put16le(FILE *f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put32le(FILE *f, uint32_t v)
+{
+    put16le(f, v & 0xFFFF);
+    put16le(f, v >> 16);
+}
+
+/* Full screen 24 bit BMP (bottom-up) and a text file */
+static void storage_create(void)
+{
+    const uint32_t stride = BSP_LCD_H_RES * 3;
+    char path[PATH_MAX];
+
+    strcpy(storage_dir, "/tmp/test_replay_XXXXXX");
+    if (mkdtemp(storage_dir) == NULL) {
+        printf("Cannot create the storage directory\n");
+        exit(2);
+    }
+
+    FILE *f = fopen(storage_path(path, APP_STORAGE_MOUNT_POINT "/" STORAGE_IMAGE), "wb");
+    fputs("BM", f);
+    put32le(f, 54 + stride * BSP_LCD_V_RES);
+    put32le(f, 0);
+    put32le(f, 54);
+    put32le(f, 40);
+    put32le(f, BSP_LCD_H_RES);
+    put32le(f, BSP_LCD_V_RES);
+    put16le(f, 1);
+    put16le(f, 24);
+    put32le(f, 0);
+    put32le(f, stride * BSP_LCD_V_RES);
+    put32le(f, 2835);
+    put32le(f, 2835);
+    put32le(f, 0);
+    put32le(f, 0);
+    for (int y = 0; y < BSP_LCD_V_RES; y++) {
+        for (int x = 0; x < BSP_LCD_H_RES; x++) {
+            fputc(x, f);
+            fputc(y, f);
+            fputc(x ^ y, f);
+        }
+    }
+    fclose(f);
+
+    f = fopen(storage_path(path, APP_STORAGE_MOUNT_POINT "/" STORAGE_TEXT), "w");
+    fputs("Replayed on the host\n", f);
+    fclose(f);
+}
+
+static void storage_remove(void)
+{
+    char path[PATH_MAX];
+    unlink(storage_path(path, APP_STORAGE_MOUNT_POINT "/" STORAGE_IMAGE));
+    unlink(storage_path(path, APP_STORAGE_MOUNT_POINT "/" STORAGE_TEXT));
+    rmdir(storage_dir);
+}
+
+/* ---------------------------- Decoder, codec and display ------------------- */
+
+/* No JPEG files in the storage */
+esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+/* Nothing is played or recorded by the replay */
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t dev)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_read(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    memset(data, 0, len);
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t dev, int volume)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t dev, bool mute)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t dev, float db)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+static void ui_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    const uint32_t pixels = (area->x2 - area->x1 + 1) * (area->y2 - area->y1 + 1);
+    frames++;
+    frame_pixels += pixels;
+    usleep(pixels * UI_FLUSH_NS_PER_PX / 1000);
+    lv_display_flush_ready(disp);
+}
+
+/* ---------------------------- Replay --------------------------------------- */
+
+static char *read_script(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    char *text = malloc(APP_REPLAY_SCRIPT_MAX);
+    if (f == NULL || text == NULL) {
+        printf("Cannot read %s\n", path);
+        exit(2);
+    }
+    size_t len = fread(text, 1, APP_REPLAY_SCRIPT_MAX - 1, f);
+    text[len] = '\0';
+    fclose(f);
+    return text;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("usage: test_replay <budget_ms> <repeat> [script]\n");
+        return 2;
+    }
+    const app_replay_config_t config = {
+        .repeat = atoi(argv[2]),
+        .settle_ms = REPLAY_SETTLE_MS,
+        .timeout_ms = REPLAY_TIMEOUT_MS,
+        .budget_ms = atoi(argv[1]),
+    };
+    /* The latency table is logged */
+    host_log_info = 1;
+    char *text = argc > 3 ? read_script(argv[3]) : NULL;
+    const char *script = text ? text : app_replay_builtin_script;
+
+    /* Boot of main.c: memory, display, audio, then the UI with the files of the storage */
+    storage_create();
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    lv_display_t *disp = bsp_display_start();
+    bsp_display_lock(0);
+    lv_display_set_flush_cb(disp, ui_flush_cb);
+    bsp_display_unlock();
+    TEST_CHECK(app_audio_init() == ESP_OK, "app_audio_init");
+    app_disp_lvgl_show();
+    app_disp_fs_init();
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    static app_replay_stats_t stats[APP_REPLAY_MAX_LABELS];
+    size_t count = 0;
+    esp_err_t ret = app_replay_run(script, &config, stats, APP_REPLAY_MAX_LABELS, &count);
+    TEST_CHECK(ret == ESP_OK || ret == ESP_FAIL, "app_replay_run: 0x%x", ret);
+    app_replay_log(stats, count);
+    printf("%u frames, %.1f full screens\n", (unsigned)frames, (double)frame_pixels / (BSP_LCD_H_RES * BSP_LCD_V_RES));
+
+    /* Every measured input redrew something */
+    for (size_t i = 0; i < count; i++) {
+        TEST_CHECK(stats[i].count == config.repeat && stats[i].no_frame == 0 && stats[i].unsettled == 0,
+                   "%s: %u measured, %u without a frame, %u not settled", stats[i].label, stats[i].count,
+                   stats[i].no_frame, stats[i].unsettled);
+    }
+
+    /* The built-in script opened the image into the frame buffer and closed its window */
+    if (text == NULL) {
+        app_mem_stats_t mem;
+        app_mem_get_stats(&mem);
+        const app_mem_pool_stats_t *frame = &mem.pool[APP_MEM_POOL_FRAME];
+        TEST_CHECK(frame->high_water == 1 && frame->used == 0 && frame->fails == 0,
+                   "frame pool: high water %" PRIu32 ", used %" PRIu32 ", fails %" PRIu32,
+                   frame->high_water, frame->used, frame->fails);
+        TEST_CHECK(!mem.arena[APP_MEM_ARENA_WINDOW].busy, "window arena still in use");
+        bsp_display_lock(0);
+        TEST_CHECK(lv_obj_get_child_count(lv_screen_active()) == 1, "image window not closed");
+        bsp_display_unlock();
+    }
+    free(text);
+    storage_remove();
+
+    if (ret == ESP_FAIL && test_failures == 0) {
+        printf("UI latency regression: first frame p90 over %u ms\n", (unsigned)config.budget_ms);
+        return REPLAY_EXIT_OVER_BUDGET;
+    }
+    return test_result("test_replay");
+}
@@ -0,0 +1,273 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Pre-decoded images (app_img_dec_rgbz): a PPM image is converted by tools/mkrgbz.py (plain and
+ * byte-swapped) and decoded back from memory and from file against the RGB565 of the source,
+ * cropped, into a short buffer, truncated and corrupted. The decode throughput is printed.
+ *
+ *   test_rgbz ppm <image.ppm>                      write the source image (fixture setup)
+ *   test_rgbz <image.rgbz> <swapped.rgbz>
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "app_mem.h"
+#include "app_img_dec.h"
+#include "test_util.h"
+
+/* Not a multiple of the band rows, the last band is partial */
+#define IMG_W   (300)
+#define IMG_H   (200)
+
+#define BENCH_RUNS  (200)
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+} blob_t;
+
+static uint8_t rgb[IMG_H][IMG_W][3];
+static uint16_t ref[IMG_H][IMG_W];
+static uint16_t out_buf[IMG_H * IMG_W];
+
+/* ---------------------------- Helpers -------------------------------------- */
+
+static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+static inline uint16_t bswap16(uint16_t v)
+{
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+/*
+ * Flat areas (long LZ4 matches), gradients (short matches, repeated rows) and noise (long
+ * literal runs), so all length encodings of the LZ4 blocks are used
+ */
+static void make_image(void)
+{
+    uint32_t seed = 0x2545F491;
+
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            uint8_t *p = rgb[y][x];
+            if (y < 50) {
+                p[0] = 30;
+                p[1] = 120;
+                p[2] = 200;
+            } else if (y < 120 || x < 100) {
+                p[0] = x * 255 / IMG_W;
+                p[1] = y;
+                p[2] = (x + y) & 0xFF;
+            } else {
+                uint32_t r = test_rand(&seed);
+                p[0] = r;
+                p[1] = r >> 8;
+                p[2] = r >> 16;
+            }
+            ref[y][x] = rgb565(p[0], p[1], p[2]);
+        }
+    }
+}
+
+static int write_ppm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        printf("Cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(f, "P6\n# test_rgbz\n%d %d\n255\n", IMG_W, IMG_H);
+    fwrite(rgb, 1, sizeof(rgb), f);
+    fclose(f);
+    return 0;
+}
+
+static bool read_file(const char *path, blob_t *blob)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        printf("Cannot open %s\n", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    blob->size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    blob->data = malloc(blob->size);
+    bool ok = blob->data != NULL && fread(blob->data, 1, blob->size, f) == blob->size;
+    fclose(f);
+    return ok;
+}
+
+static esp_err_t decode_mem(const uint8_t *data, size_t size, app_img_out_t *out)
+{
+    out->buf = (uint8_t *)out_buf;
+    if (out->buf_size == 0) {
+        out->buf_size = sizeof(out_buf);
+    }
+
+    memset(out_buf, 0, sizeof(out_buf));
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    esp_err_t ret = app_img_dec_rgbz.decode_mem(data, size, out);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    return ret;
+}
+
+static esp_err_t decode_file(const char *path, app_img_out_t *out)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    out->buf = (uint8_t *)out_buf;
+    out->buf_size = sizeof(out_buf);
+
+    memset(out_buf, 0, sizeof(out_buf));
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    esp_err_t ret = app_img_dec_rgbz.decode(f, out);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    fclose(f);
+    return ret;
+}
+
+/* Pixels of the decoded w x h image which differ from the top-left corner of the source */
+static int compare(uint16_t w, uint16_t h, bool swapped)
+{
+    int diff = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint16_t exp = swapped ? bswap16(ref[y][x]) : ref[y][x];
+            diff += (out_buf[y * w + x] != exp);
+        }
+    }
+    return diff;
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_decode(const char *name, const char *path, const blob_t *blob)
+{
+    /* Both byte orders of the output, from memory and from file */
+    for (int swap = 0; swap < 2; swap++) {
+        app_img_out_t out = { .max_width = 320, .max_height = 240, .swap_bytes = swap };
+        esp_err_t ret = decode_mem(blob->data, blob->size, &out);
+        TEST_CHECK(ret == ESP_OK && out.width == IMG_W && out.height == IMG_H,
+                   "%s swap %d: ret 0x%x, %ux%u", name, swap, ret, out.width, out.height);
+        int diff = compare(IMG_W, IMG_H, swap);
+        TEST_CHECK(diff == 0, "%s swap %d: %d pixels differ", name, swap, diff);
+
+        out = (app_img_out_t) { .max_width = 320, .max_height = 240, .swap_bytes = swap };
+        ret = decode_file(path, &out);
+        TEST_CHECK(ret == ESP_OK && out.width == IMG_W && out.height == IMG_H,
+                   "%s file swap %d: ret 0x%x, %ux%u", name, swap, ret, out.width, out.height);
+        diff = compare(IMG_W, IMG_H, swap);
+        TEST_CHECK(diff == 0, "%s file swap %d: %d pixels differ", name, swap, diff);
+    }
+
+    /* Made for a larger display: cropped to the top-left corner, through the temporary band */
+    app_img_out_t out = { .max_width = 100, .max_height = 50 };
+    esp_err_t ret = decode_mem(blob->data, blob->size, &out);
+    TEST_CHECK(ret == ESP_OK && out.width == 100 && out.height == 50, "%s cropped: ret 0x%x, %ux%u",
+               name, ret, out.width, out.height);
+    TEST_CHECK(compare(100, 50, false) == 0, "%s cropped: pixels differ", name);
+
+    /* Output buffer shorter than the image: rows which fit (not on a band boundary) */
+    out = (app_img_out_t) { .max_width = IMG_W, .max_height = IMG_H, .buf_size = IMG_W * 2 * 37 + 5 };
+    ret = decode_mem(blob->data, blob->size, &out);
+    TEST_CHECK(ret == ESP_OK && out.width == IMG_W && out.height == 37, "%s short buffer: ret 0x%x, %ux%u",
+               name, ret, out.width, out.height);
+    TEST_CHECK(compare(IMG_W, 37, false) == 0, "%s short buffer: pixels differ", name);
+}
+
+/* Truncated and corrupted images must be rejected (or decoded) without reading out of bounds */
+static void test_malformed(const blob_t *blob)
+{
+    uint8_t *data = malloc(blob->size);
+    uint32_t seed = 0x1234567;
+
+    /* Copied into a buffer of the truncated size, so reads past it are caught by ASan */
+    for (size_t len = 0; len < blob->size; len += (len < 64 || blob->size - len < 64) ? 1 : 97) {
+        uint8_t *part = malloc(len ? len : 1);
+        memcpy(part, blob->data, len);
+        app_img_out_t out = { .max_width = 320, .max_height = 240 };
+        esp_err_t ret = decode_mem(part, len, &out);
+        TEST_CHECK(ret != ESP_OK, "truncated to %zu of %zu bytes decoded", len, blob->size);
+        free(part);
+    }
+
+    /* Band sizes and data corrupted, only memory safety is checked */
+    int rejected = 0;
+    for (int i = 0; i < 500; i++) {
+        memcpy(data, blob->data, blob->size);
+        int flips = 1 + test_rand(&seed) % 4;
+        for (int f = 0; f < flips; f++) {
+            size_t pos = 6 + test_rand(&seed) % (blob->size - 6);
+            data[pos] ^= 1 << (test_rand(&seed) % 8);
+        }
+        app_img_out_t out = { .max_width = 320, .max_height = 240 };
+        rejected += decode_mem(data, blob->size, &out) != ESP_OK;
+    }
+    printf("corrupted: %d of 500 rejected\n", rejected);
+
+    /* Bad magic and version */
+    memcpy(data, blob->data, blob->size);
+    data[0] = 'X';
+    app_img_out_t out = { .max_width = 320, .max_height = 240 };
+    TEST_CHECK(decode_mem(data, blob->size, &out) == ESP_ERR_INVALID_ARG, "bad magic accepted");
+    data[0] = blob->data[0];
+    data[4] = 2;
+    TEST_CHECK(decode_mem(data, blob->size, &out) == ESP_ERR_NOT_SUPPORTED, "bad version accepted");
+
+    free(data);
+}
+
+static void bench(const blob_t *blob)
+{
+    double start = test_now_us();
+    for (int i = 0; i < BENCH_RUNS; i++) {
+        app_img_out_t out = { .max_width = 320, .max_height = 240 };
+        decode_mem(blob->data, blob->size, &out);
+    }
+    double us = (test_now_us() - start) / BENCH_RUNS;
+
+    printf("rgbz %dx%d: %zu bytes (%.0f%% of RGB565), %.0f us per image, %.0f MB/s out\n", IMG_W, IMG_H,
+           blob->size, 100.0 * blob->size / (IMG_W * IMG_H * 2), us, IMG_W * IMG_H * 2 / us);
+}
+
+int main(int argc, char **argv)
+{
+    make_image();
+
+    if (argc == 3 && strcmp(argv[1], "ppm") == 0) {
+        return write_ppm(argv[2]);
+    }
+    if (argc != 3) {
+        printf("usage: test_rgbz ppm <image.ppm> | test_rgbz <image.rgbz> <swapped.rgbz>\n");
+        return 2;
+    }
+
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+
+    blob_t plain = { 0 };
+    blob_t swapped = { 0 };
+    if (!read_file(argv[1], &plain) || !read_file(argv[2], &swapped)) {
+        return 1;
+    }
+
+    test_decode("plain", argv[1], &plain);
+    test_decode("swapped", argv[2], &swapped);
+    test_malformed(&plain);
+    bench(&plain);
+
+    free(plain.data);
+    free(swapped.data);
+    return test_result("test_rgbz");
+}
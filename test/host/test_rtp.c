@@ -0,0 +1,396 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * RTP receiver (app_rtp) over UDP loopback, in real time: a sender on 127.0.0.1 plays a tone
+ * as L16 packets with network jitter (so reordered), losses, duplicates and invalid datagrams,
+ * through the jitter buffer and the media controller to the speaker stub, which takes the data
+ * at the sample rate. The receiver counters must add up with what was sent, the stream must end
+ * after the timeout and the speaker must have played the tone. A second source in another
+ * format is then stopped by the user, its remaining packets are ignored.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_codec_dev.h"
+#include "app_mem.h"
+#include "app_media.h"
+#include "app_rtp.h"
+#include "test_util.h"
+
+#define RTP_TEST_PORT       (15004)
+#define RTP_TIMEOUT_MS      (300)
+#define TONE_HZ             (440)
+#define TONE_AMPLITUDE      (8000)
+
+typedef struct {
+    uint8_t payload_type;
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t ptime_ms;
+    uint16_t jitter_ms;         /*!< Network delay range */
+    uint16_t loss_pm;           /*!< Losses and duplicates per mille */
+    uint16_t dup_pm;
+    uint16_t packets;
+    uint32_t ssrc;
+} stream_t;
+
+typedef struct {
+    int64_t send_us;
+    uint16_t index;
+} datagram_t;
+
+typedef struct {
+    uint32_t delivered;         /*!< Sent datagrams, duplicates included */
+    uint32_t lost;              /*!< Not sent, between sent packets (visible to the receiver) */
+    uint32_t dups;
+} sent_t;
+
+/* ---------------------------- Speaker -------------------------------------- */
+
+static pthread_mutex_t codec_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool codec_open;
+static int codec_bytes_per_s;
+static int codec_channels;
+static double codec_energy;         /*!< Of the written samples, since the last reset */
+static uint64_t codec_samples;
+
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs)
+{
+    pthread_mutex_lock(&codec_lock);
+    codec_open = true;
+    codec_channels = fs->channel;
+    codec_bytes_per_s = fs->sample_rate * fs->channel * fs->bits_per_sample / 8;
+    pthread_mutex_unlock(&codec_lock);
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t dev)
+{
+    pthread_mutex_lock(&codec_lock);
+    codec_open = false;
+    pthread_mutex_unlock(&codec_lock);
+    return ESP_CODEC_DEV_OK;
+}
+
+/* The I2S DMA takes the data at the sample rate */
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    const int16_t *pcm = data;
+    double energy = 0;
+    for (int i = 0; i < len / 2; i++) {
+        energy += (double)pcm[i] * pcm[i];
+    }
+
+    pthread_mutex_lock(&codec_lock);
+    codec_energy += energy;
+    codec_samples += len / 2;
+    int rate = codec_bytes_per_s;
+    pthread_mutex_unlock(&codec_lock);
+    if (rate > 0) {
+        usleep((int64_t)len * 1000000 / rate);
+    }
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_mute(esp_codec_dev_handle_t dev, bool mute)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_out_vol(esp_codec_dev_handle_t dev, int volume)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_read(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_set_in_gain(esp_codec_dev_handle_t dev, float db)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+/* Played milliseconds and RMS level since the last call */
+static void codec_take(uint32_t sample_rate, double *played_ms, double *rms)
+{
+    pthread_mutex_lock(&codec_lock);
+    *played_ms = codec_channels ? (double)codec_samples / codec_channels * 1000 / sample_rate : 0;
+    *rms = codec_samples ? sqrt(codec_energy / codec_samples) : 0;
+    codec_energy = 0;
+    codec_samples = 0;
+    pthread_mutex_unlock(&codec_lock);
+}
+
+/* ---------------------------- Sender --------------------------------------- */
+
+static int sender_sock = -1;
+static struct sockaddr_in sender_addr;
+
+static void send_datagram(const uint8_t *data, size_t len)
+{
+    sendto(sender_sock, data, len, 0, (const struct sockaddr *)&sender_addr, sizeof(sender_addr));
+}
+
+static size_t build_packet(uint8_t *buf, const stream_t *s, uint16_t index)
+{
+    const uint32_t frames = s->sample_rate * s->ptime_ms / 1000;
+    const uint16_t seq = 60000 + index;
+    const uint32_t ts = 0xFFFF0000u + index * frames;
+
+    buf[0] = 0x80;
+    buf[1] = s->payload_type | (index == 0 ? 0x80 : 0);
+    buf[2] = seq >> 8;
+    buf[3] = seq & 0xFF;
+    for (int i = 0; i < 4; i++) {
+        buf[4 + i] = ts >> (24 - 8 * i);
+        buf[8 + i] = s->ssrc >> (24 - 8 * i);
+    }
+
+    size_t len = 12;
+    for (uint32_t f = 0; f < frames; f++) {
+        const uint32_t n = index * frames + f;
+        const int16_t v = (int16_t)(TONE_AMPLITUDE * sin(2 * M_PI * TONE_HZ * n / s->sample_rate));
+        for (uint16_t c = 0; c < s->channels; c++) {
+            buf[len++] = (uint16_t)v >> 8;
+            buf[len++] = (uint16_t)v & 0xFF;
+        }
+    }
+    return len;
+}
+
+/* Not RTP, unsupported payload type, odd payload and padding longer than the payload */
+static uint32_t send_invalid(void)
+{
+    static const uint8_t invalid[][16] = {
+        { 'h', 'e', 'l', 'l', 'o', ' ', 'r', 't', 'p', ' ', 'p', 'o', 'r', 't', '!', '\n' },
+        { 0x80, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0xFF, 0xFF, 0xFF, 0xFF },
+        { 0x80, 96, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0x12, 0x34, 0x56, 0 },
+        { 0xA0, 96, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0x12, 0x34, 0x56, 8 },
+    };
+    send_datagram(invalid[0], sizeof(invalid[0]));
+    send_datagram(invalid[1], sizeof(invalid[1]));
+    send_datagram(invalid[2], sizeof(invalid[2]) - 1);
+    send_datagram(invalid[3], sizeof(invalid[3]));
+    return 4;
+}
+
+static int datagram_compare(const void *a, const void *b)
+{
+    int64_t x = ((const datagram_t *)a)->send_us;
+    int64_t y = ((const datagram_t *)b)->send_us;
+    return (x > y) - (x < y);
+}
+
+/* Packets at their nominal time plus a random network delay, so reordered by the jitter */
+static sent_t send_stream(const stream_t *s, uint32_t *seed, uint16_t stop_after)
+{
+    datagram_t *schedule = calloc(2 * s->packets, sizeof(datagram_t));
+    uint8_t buf[APP_RTP_MAX_PACKET];
+    sent_t sent = { 0 };
+    uint32_t lost_run = 0;
+    size_t n = 0;
+
+    for (uint16_t i = 0; i < s->packets; i++) {
+        int64_t send_us = (int64_t)i * s->ptime_ms * 1000 + test_rand(seed) % (s->jitter_ms * 1000 + 1);
+        if (test_rand(seed) % 1000 < s->loss_pm) {
+            lost_run += n > 0;
+            continue;
+        }
+        sent.lost += lost_run;
+        lost_run = 0;
+        schedule[n++] = (datagram_t) {
+            send_us, i
+        };
+        if (test_rand(seed) % 1000 < s->dup_pm) {
+            schedule[n] = schedule[n - 1];
+            schedule[n++].send_us += test_rand(seed) % (s->ptime_ms * 1000);
+            sent.dups++;
+        }
+    }
+    qsort(schedule, n, sizeof(datagram_t), datagram_compare);
+
+    const int64_t start = esp_timer_get_time();
+    for (size_t k = 0; k < n; k++) {
+        if (k == stop_after) {
+            TEST_CHECK(app_media_stop() == ESP_OK, "stop");
+        }
+        int64_t wait = start + schedule[k].send_us - esp_timer_get_time();
+        if (wait > 0) {
+            usleep(wait);
+        }
+        send_datagram(buf, build_packet(buf, s, schedule[k].index));
+    }
+    sent.delivered = n;
+    free(schedule);
+    return sent;
+}
+
+/* Until the stream ended by the timeout and its playback is closed */
+static void wait_stream_end(app_rtp_stats_t *stats)
+{
+    const int64_t start = esp_timer_get_time();
+    do {
+        vTaskDelay(pdMS_TO_TICKS(20));
+        app_rtp_get_stats(stats);
+    } while ((stats->playing || app_media_get_state() != APP_MEDIA_STATE_IDLE) &&
+             esp_timer_get_time() - start < 5 * RTP_TIMEOUT_MS * 1000);
+    vTaskDelay(pdMS_TO_TICKS(RTP_TIMEOUT_MS));
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_parse(const app_rtp_config_t *config)
+{
+    /* CSRC, extension of one word, two samples, padding of 2 bytes */
+    uint8_t data[40] __attribute__((aligned(4))) = {
+        0xB1, 0xE0, 0x12, 0x34, 0xDE, 0xAD, 0xBE, 0xEF, 0x01, 0x02, 0x03, 0x04,
+        0xAA, 0xAA, 0xAA, 0xAA,
+        0xBE, 0xDE, 0x00, 0x01, 0x55, 0x55, 0x55, 0x55,
+        0x12, 0x34, 0xFE, 0xDC, 0x00, 0x02,
+    };
+    app_rtp_packet_t packet;
+
+    TEST_CHECK(app_rtp_parse(data, 30, config, &packet) == ESP_OK, "parse");
+    TEST_CHECK(packet.marker && packet.payload_type == 96 && packet.seq == 0x1234 && packet.ts == 0xDEADBEEF &&
+               packet.ssrc == 0x01020304, "header: pt %u seq %u ts %08" PRIx32 " ssrc %08" PRIx32,
+               packet.payload_type, packet.seq, packet.ts, packet.ssrc);
+    TEST_CHECK(packet.frames == 2 && packet.pcm[0] == 0x1234 && packet.pcm[1] == (int16_t)0xFEDC,
+               "payload: %zu frames, %04x %04x", packet.frames, (uint16_t)packet.pcm[0], (uint16_t)packet.pcm[1]);
+    TEST_CHECK(packet.sample_rate == config->sample_rate && packet.channels == config->channels, "dynamic format");
+
+    uint8_t header[16] __attribute__((aligned(4))) = { 0x80, APP_RTP_PT_L16_STEREO, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 3, 4 };
+    TEST_CHECK(app_rtp_parse(header, 16, config, &packet) == ESP_OK && packet.sample_rate == 44100 &&
+               packet.channels == 2 && packet.frames == 1, "static stereo payload type");
+    TEST_CHECK(app_rtp_parse(header, 14, config, &packet) == ESP_ERR_INVALID_SIZE, "half frame accepted");
+    TEST_CHECK(app_rtp_parse(header, 12, config, &packet) == ESP_ERR_INVALID_SIZE, "empty payload accepted");
+    TEST_CHECK(app_rtp_parse(header, 11, config, &packet) == ESP_ERR_INVALID_ARG, "short packet accepted");
+    header[1] = 0;
+    TEST_CHECK(app_rtp_parse(header, 16, config, &packet) == ESP_ERR_NOT_SUPPORTED, "PCMU accepted");
+    header[0] = 0x40;
+    TEST_CHECK(app_rtp_parse(header, 16, config, &packet) == ESP_ERR_INVALID_ARG, "version 1 accepted");
+    header[0] = 0x90;
+    header[1] = 96;
+    TEST_CHECK(app_rtp_parse(header, 16, config, &packet) == ESP_ERR_INVALID_ARG, "truncated extension accepted");
+}
+
+/* Mono tone with jitter, reorder, loss and duplicates, ended by the timeout */
+static void test_stream(uint32_t *seed)
+{
+    const stream_t s = { 96, 16000, 1, 20, 50, 30, 20, 200, 0x5EED0001 };
+    app_rtp_stats_t stats;
+    double played_ms, rms;
+
+    const uint32_t invalid = send_invalid();
+    codec_take(s.sample_rate, &played_ms, &rms);
+    const sent_t sent = send_stream(&s, seed, UINT16_MAX);
+    wait_stream_end(&stats);
+    codec_take(s.sample_rate, &played_ms, &rms);
+    app_rtp_log_stats(&stats);
+
+    const app_jitter_stats_t *j = &stats.jitter;
+    const double duration_ms = s.packets * s.ptime_ms;
+    printf("mono: sent %" PRIu32 " (%" PRIu32 " lost, %" PRIu32 " duplicate), played %.0f of %.0f ms, rms %.0f\n",
+           sent.delivered, sent.lost, sent.dups, played_ms, duration_ms, rms);
+
+    TEST_CHECK(stats.datagrams == sent.delivered + invalid, "%" PRIu32 " datagrams", stats.datagrams);
+    TEST_CHECK(stats.invalid == invalid && stats.ignored == 0, "%" PRIu32 " invalid, %" PRIu32 " ignored",
+               stats.invalid, stats.ignored);
+    TEST_CHECK(stats.streams == 1 && stats.ssrc == s.ssrc && !stats.playing, "%" PRIu32 " streams, ssrc %08" PRIx32,
+               stats.streams, stats.ssrc);
+    TEST_CHECK(app_media_get_state() == APP_MEDIA_STATE_IDLE, "playback not closed at the end of the stream");
+    TEST_CHECK(j->received + j->late + j->duplicate == sent.delivered, "%" PRIu32 " received, %" PRIu32 " late, %"
+               PRIu32 " duplicate", j->received, j->late, j->duplicate);
+    TEST_CHECK(j->duplicate + j->late >= sent.dups && j->late <= sent.delivered / 20, "%" PRIu32 " duplicate, %"
+               PRIu32 " late of %" PRIu32 " duplicates", j->duplicate, j->late, sent.dups);
+    TEST_CHECK(j->lost >= sent.lost && j->lost <= sent.lost + j->late, "%" PRIu32 " lost", j->lost);
+    TEST_CHECK(j->reordered > 0, "no reordered packet");
+    TEST_CHECK(j->concealed_ms >= j->lost * s.ptime_ms / 2, "%" PRIu32 " ms concealed", j->concealed_ms);
+
+    /* All the audio is played (the concealment included), at the level of the tone */
+    TEST_CHECK(played_ms >= duration_ms * 0.9 && played_ms <= duration_ms + 2 * RTP_TIMEOUT_MS,
+               "%.0f ms played", played_ms);
+    TEST_CHECK(rms > TONE_AMPLITUDE / M_SQRT2 * 0.7, "rms %.0f", rms);
+}
+
+/* New source in the static 44.1 kHz format, stopped by the user while streaming */
+static void test_user_stop(uint32_t *seed)
+{
+    const stream_t s = { APP_RTP_PT_L16_MONO, 44100, 1, 10, 10, 0, 0, 100, 0x5EED0002 };
+    app_rtp_stats_t before, stats;
+    double played_ms, rms;
+
+    app_rtp_get_stats(&before);
+    const sent_t sent = send_stream(&s, seed, 50);
+    wait_stream_end(&stats);
+    codec_take(s.sample_rate, &played_ms, &rms);
+    printf("44.1 kHz: sent %" PRIu32 ", %" PRIu32 " ignored, played %.0f ms\n", sent.delivered,
+           stats.ignored - before.ignored, played_ms);
+
+    TEST_CHECK(stats.streams == 2 && stats.ssrc == s.ssrc && !stats.playing, "%" PRIu32 " streams, ssrc %08" PRIx32,
+               stats.streams, stats.ssrc);
+    /* The stop takes effect after the packets already on the way */
+    TEST_CHECK(stats.ignored - before.ignored >= 40 && stats.ignored - before.ignored <= 50,
+               "%" PRIu32 " ignored", stats.ignored - before.ignored);
+    TEST_CHECK(stats.jitter.received + stats.ignored - before.ignored == sent.delivered,
+               "%" PRIu32 " received", stats.jitter.received);
+    TEST_CHECK(played_ms > 0 && played_ms < 50 * s.ptime_ms, "%.0f ms played after the stop", played_ms);
+    TEST_CHECK(app_media_get_state() == APP_MEDIA_STATE_IDLE, "playing after the stop");
+}
+
+int main(void)
+{
+    const app_rtp_config_t config = {
+        .port = RTP_TEST_PORT,
+        .sample_rate = 16000,
+        .channels = 1,
+        .min_delay_ms = 40,
+        .max_delay_ms = 300,
+        .max_ppm = 500,
+        .timeout_ms = RTP_TIMEOUT_MS,
+        .stats_period_ms = 1000,
+    };
+    uint32_t seed = 2024;
+    app_rtp_stats_t stats;
+
+    test_parse(&config);
+
+    TEST_CHECK(app_rtp_get_stats(&stats) == ESP_ERR_INVALID_STATE, "stats before start");
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+    app_media_config_t media_cfg = { .codec = (esp_codec_dev_handle_t)&codec_open, .volume = 70 };
+    TEST_CHECK(app_media_init(&media_cfg) == ESP_OK, "app_media_init");
+    TEST_CHECK(app_rtp_start(&config) == ESP_OK, "app_rtp_start");
+    TEST_CHECK(app_rtp_start(&config) == ESP_ERR_INVALID_STATE, "second app_rtp_start");
+
+    sender_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sender_addr = (struct sockaddr_in) {
+        .sin_family = AF_INET,
+        .sin_port = htons(RTP_TEST_PORT),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    TEST_CHECK(sender_sock >= 0, "sender socket");
+
+    test_stream(&seed);
+    test_user_stop(&seed);
+
+    TEST_CHECK(app_rtp_stop() == ESP_OK, "app_rtp_stop");
+    TEST_CHECK(app_rtp_stop() == ESP_ERR_INVALID_STATE, "second app_rtp_stop");
+    close(sender_sock);
+    return test_result("test_rtp");
+}
@@ -0,0 +1,586 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Storage read cache (app_storage) over a modeled flash file system: the backend calls of the
+ * cache layer are wrapped (-Wl,--wrap), APP_STORAGE_BACKEND_PATH is a temporary directory and a
+ * backend read sleeps like the flash would. Sequential, random and whole block reads must return
+ * the file content, changes through one descriptor must be seen by the others, also while they
+ * fill the cache. A slow backend read of one file must not stall the cache hits of another and
+ * readers of different files must overlap. The throughput is printed.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_vfs.h"
+#include "app_storage.h"
+#include "test_util.h"
+
+/* Modeled backend read: per call and per KB (about 10 MB/s), files named slow* per call */
+#define BACKEND_CALL_US     (1000)
+#define BACKEND_KB_US       (100)
+#define BACKEND_SLOW_US     (100000)
+/* Cache hits of a file while another one is read from the slow backend */
+#define STALL_MAX_US        (20000)
+
+#define DATA_FILES          (4)
+#define DATA_SIZE           (256 * 1024)
+#define SHARED_BLOCKS       (8)
+#define SHARED_READERS      (3)
+#define SHARED_WRITES       (200)
+#define HOT_SIZE            (16 * 1024)
+
+static char backend_dir[32];
+static bool backend_slow[1024];
+static atomic_int backend_reads;
+/* Called once by the next backend read, after the data is read */
+static void (*backend_hook)(void);
+static const esp_vfs_t *vfs;
+
+/* ---------------------------- Modeled backend ------------------------------ */
+
+int __real_open(const char *path, int flags, ...);
+ssize_t __real_read(int fd, void *dst, size_t size);
+int __real_stat(const char *path, struct stat *st);
+int __real_unlink(const char *path);
+int __real_rename(const char *src, const char *dst);
+int __real_mkdir(const char *path, mode_t mode);
+int __real_rmdir(const char *path);
+DIR *__real_opendir(const char *path);
+
+/* Backend path in the temporary directory */
+static const char *backend_path(char *real, const char *path)
+{
+    const size_t len = strlen(APP_STORAGE_BACKEND_PATH);
+    if (strncmp(path, APP_STORAGE_BACKEND_PATH, len) != 0) {
+        return path;
+    }
+    snprintf(real, PATH_MAX, "%s%s", backend_dir, path + len);
+    return real;
+}
+
+int __wrap_open(const char *path, int flags, ...)
+{
+    char real[PATH_MAX];
+    int mode = 0;
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, int);
+        va_end(args);
+    }
+
+    int fd = __real_open(backend_path(real, path), flags, mode);
+    if (fd >= 0 && fd < (int)(sizeof(backend_slow) / sizeof(backend_slow[0]))) {
+        const char *name = strrchr(path, '/');
+        backend_slow[fd] = name && strncmp(name, "/slow", 5) == 0;
+    }
+    return fd;
+}
+
+/* The data is read first, so a write during the modeled latency makes it stale */
+ssize_t __wrap_read(int fd, void *dst, size_t size)
+{
+    ssize_t len = __real_read(fd, dst, size);
+    atomic_fetch_add(&backend_reads, 1);
+    void (*hook)(void) = backend_hook;
+    if (hook) {
+        backend_hook = NULL;
+        hook();
+    }
+    const bool slow = fd >= 0 && fd < (int)(sizeof(backend_slow) / sizeof(backend_slow[0])) && backend_slow[fd];
+    usleep(slow ? BACKEND_SLOW_US : BACKEND_CALL_US + (len > 0 ? len : 0) / 1024 * BACKEND_KB_US);
+    return len;
+}
+
+int __wrap_stat(const char *path, struct stat *st)
+{
+    char real[PATH_MAX];
+    return __real_stat(backend_path(real, path), st);
+}
+
+int __wrap_unlink(const char *path)
+{
+    char real[PATH_MAX];
+    return __real_unlink(backend_path(real, path));
+}
+
+int __wrap_rename(const char *src, const char *dst)
+{
+    char real_src[PATH_MAX], real_dst[PATH_MAX];
+    return __real_rename(backend_path(real_src, src), backend_path(real_dst, dst));
+}
+
+int __wrap_mkdir(const char *path, mode_t mode)
+{
+    char real[PATH_MAX];
+    return __real_mkdir(backend_path(real, path), mode);
+}
+
+int __wrap_rmdir(const char *path)
+{
+    char real[PATH_MAX];
+    return __real_rmdir(backend_path(real, path));
+}
+
+DIR *__wrap_opendir(const char *path)
+{
+    char real[PATH_MAX];
+    return __real_opendir(backend_path(real, path));
+}
+
+static esp_err_t backend_mount(const char *base_path, const char *partition, size_t max_files)
+{
+    return ESP_OK;
+}
+
+static void backend_unmount(const char *partition)
+{
+}
+
+static esp_err_t backend_info(const char *partition, size_t *total, size_t *used)
+{
+    *total = 0;
+    *used = 0;
+    return ESP_OK;
+}
+
+static const app_storage_backend_t test_backend = {
+    .name = "modeled flash",
+    .mount = backend_mount,
+    .unmount = backend_unmount,
+    .info = backend_info,
+};
+
+/* ---------------------------- Helpers -------------------------------------- */
+
+static inline uint8_t pattern(int file, uint32_t pos)
+{
+    return (uint8_t)((pos * 2654435761u) >> 24) ^ (uint8_t)(pos >> 12) ^ (uint8_t)(file * 37);
+}
+
+static void make_file(const char *path, int file, size_t size)
+{
+    static uint8_t buf[APP_STORAGE_BLOCK_SIZE];
+    int fd = vfs->open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    TEST_CHECK(fd >= 0, "create %s: errno %d", path, errno);
+    for (uint32_t pos = 0; pos < size; pos += sizeof(buf)) {
+        for (size_t i = 0; i < sizeof(buf); i++) {
+            buf[i] = pattern(file, pos + i);
+        }
+        TEST_CHECK(vfs->write(fd, buf, sizeof(buf)) == sizeof(buf), "write %s", path);
+    }
+    vfs->close(fd);
+}
+
+/* Bytes of buf, read at pos, which differ from the pattern */
+static int check_pattern(int file, uint32_t pos, const uint8_t *buf, size_t len)
+{
+    int diff = 0;
+    for (size_t i = 0; i < len; i++) {
+        diff += (buf[i] != pattern(file, pos + i));
+    }
+    return diff;
+}
+
+static void data_path(char *path, int file)
+{
+    sprintf(path, "/data%d.bin", file);
+}
+
+/* Read the whole file sequentially in chunks, returns the bytes which differ */
+static int read_all(int fd, int file, size_t chunk)
+{
+    uint8_t *buf = malloc(chunk);
+    uint32_t pos = 0;
+    int diff = 0;
+    ssize_t len;
+
+    vfs->lseek(fd, 0, SEEK_SET);
+    while ((len = vfs->read(fd, buf, chunk)) > 0) {
+        diff += check_pattern(file, pos, buf, len);
+        pos += len;
+    }
+    TEST_CHECK(len == 0 && pos == DATA_SIZE, "file %d chunk %zu: read %u bytes, last %zd", file, chunk, pos, len);
+    free(buf);
+    return diff;
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_read(void)
+{
+    static const size_t chunks[] = { 1, 100, 512, 4096, 5000, 16384, 20000 };
+    static uint8_t buf[8192];
+    uint32_t seed = 0x600D5EED;
+    char path[32];
+
+    data_path(path, 0);
+    int fd = vfs->open(path, O_RDONLY, 0);
+    TEST_CHECK(fd >= 0, "open %s", path);
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        int diff = read_all(fd, 0, chunks[i]);
+        TEST_CHECK(diff == 0, "sequential chunk %zu: %d bytes differ", chunks[i], diff);
+    }
+
+    /* Random offsets, across block boundaries and past the end of the file */
+    for (int i = 0; i < 2000; i++) {
+        uint32_t pos = test_rand(&seed) % (DATA_SIZE + 100);
+        size_t len = 1 + test_rand(&seed) % sizeof(buf);
+        TEST_CHECK(vfs->lseek(fd, pos, SEEK_SET) == pos, "seek %u", pos);
+        ssize_t n = vfs->read(fd, buf, len);
+        size_t exp = pos >= DATA_SIZE ? 0 : (DATA_SIZE - pos < len ? DATA_SIZE - pos : len);
+        TEST_CHECK(n == (ssize_t)exp, "read %zu at %u: %zd", len, pos, n);
+        TEST_CHECK(n <= 0 || check_pattern(0, pos, buf, n) == 0, "read %zu at %u: data differ", len, pos);
+    }
+    TEST_CHECK(vfs->lseek(fd, -10, SEEK_END) == DATA_SIZE - 10, "SEEK_END");
+    TEST_CHECK(vfs->lseek(fd, -1, SEEK_SET) == -1 && errno == EINVAL, "negative seek");
+    vfs->close(fd);
+
+    /* Not cached (path longer than the node table keeps) */
+    char long_path[128];
+    memset(long_path, 'x', sizeof(long_path));
+    long_path[0] = '/';
+    strcpy(long_path + 100, ".bin");
+    make_file(long_path, 5, 64 * 1024);
+    fd = vfs->open(long_path, O_RDONLY, 0);
+    ssize_t n = vfs->read(fd, buf, sizeof(buf));
+    TEST_CHECK(n == sizeof(buf) && check_pattern(5, 0, buf, n) == 0, "uncached file: %zd", n);
+    vfs->close(fd);
+    TEST_CHECK(vfs->unlink(long_path) == 0, "unlink uncached file");
+
+    /* Descriptor table */
+    int fds[APP_STORAGE_MAX_FILES];
+    for (int i = 0; i < APP_STORAGE_MAX_FILES; i++) {
+        fds[i] = vfs->open(path, O_RDONLY, 0);
+    }
+    TEST_CHECK(vfs->open(path, O_RDONLY, 0) == -1 && errno == ENFILE, "descriptor over the limit");
+    for (int i = 0; i < APP_STORAGE_MAX_FILES; i++) {
+        TEST_CHECK(fds[i] >= 0 && vfs->close(fds[i]) == 0, "descriptor %d", i);
+    }
+    TEST_CHECK(vfs->read(fds[0], buf, 1) == -1 && errno == EBADF, "read of a closed descriptor");
+    TEST_CHECK(vfs->open("/missing.bin", O_RDONLY, 0) == -1, "missing file opened");
+
+    app_storage_stats_t stats;
+    app_storage_get_stats(&stats);
+    TEST_CHECK(stats.hit_bytes > 0 && stats.readahead_blocks > 0 && stats.direct_bytes > 0,
+               "cache not used: hit %u, read ahead %u, direct %u", stats.hit_bytes, stats.readahead_blocks,
+               stats.direct_bytes);
+}
+
+/* Changes through one descriptor (or path) are seen by another one with the file cached */
+static void test_coherence(void)
+{
+    static uint8_t buf[DATA_SIZE];
+    static uint8_t change[1000];
+    char path[32];
+
+    memset(change, 0xA5, sizeof(change));
+
+    data_path(path, 2);
+    int reader = vfs->open(path, O_RDONLY, 0);
+    int writer = vfs->open(path, O_RDWR, 0);
+    TEST_CHECK(read_all(reader, 2, 1000) == 0, "initial content");
+
+    /* Across a block boundary */
+    const uint32_t pos = 3 * APP_STORAGE_BLOCK_SIZE - 300;
+    vfs->lseek(writer, pos, SEEK_SET);
+    TEST_CHECK(vfs->write(writer, change, sizeof(change)) == sizeof(change), "write");
+    vfs->lseek(reader, pos - 100, SEEK_SET);
+    TEST_CHECK(vfs->read(reader, buf, 1200) == 1200, "read after write");
+    TEST_CHECK(check_pattern(2, pos - 100, buf, 100) == 0 && memcmp(buf + 100, change, sizeof(change)) == 0 &&
+               check_pattern(2, pos + 1000, buf + 1100, 100) == 0, "stale data after write");
+
+    TEST_CHECK(vfs->ftruncate(writer, 10000) == 0, "ftruncate");
+    vfs->lseek(reader, 9000, SEEK_SET);
+    TEST_CHECK(vfs->read(reader, buf, 4000) == 1000, "read after truncate");
+    struct stat st;
+    TEST_CHECK(vfs->fstat(reader, &st) == 0 && st.st_size == 10000, "fstat after truncate");
+    TEST_CHECK(vfs->fsync(writer) == 0, "fsync");
+    vfs->close(writer);
+    vfs->close(reader);
+
+    /* Cached under the old name: a file renamed over it, then a new one in its place */
+    char other[32];
+    data_path(other, 3);
+    reader = vfs->open(path, O_RDONLY, 0);
+    vfs->read(reader, buf, 5000);
+    vfs->close(reader);
+    make_file("/new.bin", 6, DATA_SIZE);
+    TEST_CHECK(vfs->rename("/new.bin", path) == 0, "rename");
+    reader = vfs->open(path, O_RDONLY, 0);
+    TEST_CHECK(vfs->read(reader, buf, DATA_SIZE) == DATA_SIZE && check_pattern(6, 0, buf, DATA_SIZE) == 0,
+               "stale data after rename");
+    vfs->close(reader);
+    TEST_CHECK(vfs->unlink(path) == 0 && vfs->stat(path, &st) == -1, "unlink");
+    make_file(path, 2, DATA_SIZE);
+    reader = vfs->open(path, O_RDONLY, 0);
+    TEST_CHECK(read_all(reader, 2, 700) == 0, "stale data after unlink");
+    vfs->close(reader);
+
+    /* Append goes to the end, wherever the position is */
+    writer = vfs->open(other, O_WRONLY | O_APPEND, 0);
+    vfs->lseek(writer, 0, SEEK_SET);
+    TEST_CHECK(vfs->write(writer, change, 10) == 10 && vfs->lseek(writer, 0, SEEK_CUR) == DATA_SIZE + 10, "append");
+    vfs->close(writer);
+    TEST_CHECK(vfs->stat(other, &st) == 0 && st.st_size == DATA_SIZE + 10, "size after append");
+    writer = vfs->open(other, O_RDWR, 0);
+    TEST_CHECK(vfs->ftruncate(writer, DATA_SIZE) == 0, "truncate back");
+    vfs->close(writer);
+}
+
+static int race_writer;
+
+static void race_write(void)
+{
+    static const uint32_t words[APP_STORAGE_BLOCK_SIZE / 4] = { 0 };
+    vfs->lseek(race_writer, 0, SEEK_SET);
+    vfs->write(race_writer, words, sizeof(words));
+}
+
+/* Write of a block, which another descriptor is filling into the cache */
+static void test_fill_race(void)
+{
+    static uint8_t buf[4 * APP_STORAGE_BLOCK_SIZE];
+    memset(buf, 0xFF, sizeof(buf));
+    int fd = vfs->open("/race.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    vfs->write(fd, buf, sizeof(buf));
+    vfs->close(fd);
+
+    race_writer = vfs->open("/race.bin", O_WRONLY, 0);
+    int reader = vfs->open("/race.bin", O_RDONLY, 0);
+    backend_hook = race_write;
+    /* Old or new data, both are right */
+    TEST_CHECK(vfs->read(reader, buf, 100) == 100 && backend_hook == NULL, "read during write");
+    vfs->lseek(reader, 0, SEEK_SET);
+    TEST_CHECK(vfs->read(reader, buf, 100) == 100 && buf[0] == 0 && buf[99] == 0,
+               "block filled during a write is cached with the old data");
+    vfs->close(reader);
+    vfs->close(race_writer);
+}
+
+/* Writer of whole blocks and readers filling the cache from the same file at once */
+static atomic_uint shared_published[SHARED_BLOCKS];
+static atomic_bool shared_done;
+static atomic_int shared_stale;
+static SemaphoreHandle_t tasks_done;
+
+static void shared_writer(void *arg)
+{
+    static uint32_t words[APP_STORAGE_BLOCK_SIZE / 4];
+    uint32_t seed = 99;
+    int fd = vfs->open("/shared.bin", O_WRONLY, 0);
+
+    for (uint32_t v = 2; v < 2 + SHARED_WRITES; v++) {
+        int block = test_rand(&seed) % SHARED_BLOCKS;
+        for (size_t i = 0; i < sizeof(words) / 4; i++) {
+            words[i] = v;
+        }
+        vfs->lseek(fd, block * APP_STORAGE_BLOCK_SIZE, SEEK_SET);
+        vfs->write(fd, words, sizeof(words));
+        atomic_store(&shared_published[block], v);
+        vTaskDelay(1);
+    }
+    vfs->close(fd);
+    atomic_store(&shared_done, true);
+    xSemaphoreGive(tasks_done);
+    vTaskDelete(NULL);
+}
+
+static void shared_reader(void *arg)
+{
+    static uint32_t words[SHARED_READERS][SHARED_BLOCKS * APP_STORAGE_BLOCK_SIZE / 4];
+    uint32_t *data = words[(intptr_t)arg];
+    int fd = vfs->open("/shared.bin", O_RDONLY, 0);
+
+    while (!atomic_load(&shared_done)) {
+        uint32_t before[SHARED_BLOCKS];
+        for (int b = 0; b < SHARED_BLOCKS; b++) {
+            before[b] = atomic_load(&shared_published[b]);
+        }
+        /* Small sequential reads, so the blocks are filled into the cache */
+        vfs->lseek(fd, 0, SEEK_SET);
+        size_t done = 0;
+        ssize_t len;
+        while (done < sizeof(words[0]) && (len = vfs->read(fd, (uint8_t *)data + done, 1000)) > 0) {
+            done += len;
+        }
+        for (size_t i = 0; i < done / 4; i++) {
+            if (data[i] < before[i / (APP_STORAGE_BLOCK_SIZE / 4)]) {
+                atomic_fetch_add(&shared_stale, 1);
+                break;
+            }
+        }
+    }
+    vfs->close(fd);
+    xSemaphoreGive(tasks_done);
+    vTaskDelete(NULL);
+}
+
+static void test_shared(void)
+{
+    static uint32_t words[SHARED_BLOCKS * APP_STORAGE_BLOCK_SIZE / 4];
+    for (size_t i = 0; i < sizeof(words) / 4; i++) {
+        words[i] = 1;
+    }
+    int fd = vfs->open("/shared.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    vfs->write(fd, words, sizeof(words));
+    vfs->close(fd);
+    for (int b = 0; b < SHARED_BLOCKS; b++) {
+        atomic_store(&shared_published[b], 1);
+    }
+
+    for (intptr_t i = 0; i < SHARED_READERS; i++) {
+        xTaskCreate(shared_reader, "reader", 4096, (void *)i, 5, NULL);
+    }
+    xTaskCreate(shared_writer, "writer", 4096, NULL, 5, NULL);
+    for (int i = 0; i < SHARED_READERS + 1; i++) {
+        xSemaphoreTake(tasks_done, portMAX_DELAY);
+    }
+    TEST_CHECK(atomic_load(&shared_stale) == 0, "%d reads returned blocks older than a finished write",
+               atomic_load(&shared_stale));
+}
+
+static atomic_bool slow_done;
+
+static void slow_reader(void *arg)
+{
+    static uint8_t buf[512];
+    int fd = vfs->open("/slow.bin", O_RDONLY, 0);
+    for (int i = 0; i < 5 * APP_STORAGE_BLOCK_SIZE / (int)sizeof(buf); i++) {
+        vfs->read(fd, buf, sizeof(buf));
+    }
+    vfs->close(fd);
+    atomic_store(&slow_done, true);
+    xSemaphoreGive(tasks_done);
+    vTaskDelete(NULL);
+}
+
+/* Cache hits of one file during the slow backend reads of another */
+static void test_stall(void)
+{
+    static uint8_t buf[512];
+    uint32_t seed = 5;
+    char path[32];
+
+    make_file("/slow.bin", 7, 8 * APP_STORAGE_BLOCK_SIZE);
+    data_path(path, 1);
+    int fd = vfs->open(path, O_RDONLY, 0);
+    for (int i = 0; i < HOT_SIZE / (int)sizeof(buf); i++) {
+        vfs->read(fd, buf, sizeof(buf));
+    }
+
+    xTaskCreate(slow_reader, "slow", 4096, NULL, 5, NULL);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    double worst = 0;
+    int reads = 0;
+    while (!atomic_load(&slow_done)) {
+        uint32_t pos = test_rand(&seed) % (HOT_SIZE - sizeof(buf));
+        double start = test_now_us();
+        vfs->lseek(fd, pos, SEEK_SET);
+        ssize_t len = vfs->read(fd, buf, sizeof(buf));
+        double us = test_now_us() - start;
+        worst = us > worst ? us : worst;
+        TEST_CHECK(len == sizeof(buf) && check_pattern(1, pos, buf, len) == 0, "hot read at %u", pos);
+        reads++;
+        usleep(500);
+    }
+    xSemaphoreTake(tasks_done, portMAX_DELAY);
+    vfs->close(fd);
+
+    printf("cache hits during slow backend reads: %d reads, worst %.1f ms\n", reads, worst / 1000);
+    TEST_CHECK(reads > 10 && worst < STALL_MAX_US, "cache hits stalled %.1f ms by another file", worst / 1000);
+}
+
+static void data_reader(void *arg)
+{
+    char path[32];
+    const int file = (intptr_t)arg;
+    data_path(path, file);
+    int fd = vfs->open(path, O_RDONLY, 0);
+    int diff = read_all(fd, file, 512);
+    TEST_CHECK(diff == 0, "file %d: %d bytes differ", file, diff);
+    vfs->close(fd);
+    xSemaphoreGive(tasks_done);
+    vTaskDelete(NULL);
+}
+
+/* Time of files read at once, by one task each */
+static double read_files(int count)
+{
+    double start = test_now_us();
+    for (intptr_t i = 0; i < count; i++) {
+        xTaskCreate(data_reader, "data", 4096, (void *)i, 5, NULL);
+    }
+    for (int i = 0; i < count; i++) {
+        xSemaphoreTake(tasks_done, portMAX_DELAY);
+    }
+    return test_now_us() - start;
+}
+
+static void test_parallel(void)
+{
+    int reads = atomic_load(&backend_reads);
+    double one = read_files(1);
+    int one_reads = atomic_load(&backend_reads) - reads;
+    double all = read_files(DATA_FILES);
+
+    printf("sequential read of %d KB in 512 B reads: %.0f KB/s, %d backend reads; %d files at once %.0f KB/s "
+           "(%.1fx the time of one)\n", DATA_SIZE / 1024, DATA_SIZE / 1024 / (one / 1e6), one_reads, DATA_FILES,
+           DATA_FILES * DATA_SIZE / 1024 / (all / 1e6), all / one);
+    TEST_CHECK(all < one * DATA_FILES / 2, "readers of %d files took %.1fx the time of one", DATA_FILES, all / one);
+}
+
+int main(void)
+{
+    strcpy(backend_dir, "/tmp/test_storage.XXXXXX");
+    if (mkdtemp(backend_dir) == NULL) {
+        printf("Cannot create the backend directory\n");
+        return 1;
+    }
+    TEST_CHECK(app_storage_mount_backend(&test_backend) == ESP_OK, "mount");
+    vfs = host_vfs_get(APP_STORAGE_MOUNT_POINT);
+    if (vfs == NULL) {
+        printf("Cache layer not registered\n");
+        return 1;
+    }
+    tasks_done = xSemaphoreCreateCounting(16, 0);
+
+    char path[32];
+    for (int i = 0; i < DATA_FILES; i++) {
+        data_path(path, i);
+        make_file(path, i, DATA_SIZE);
+    }
+
+    test_read();
+    test_coherence();
+    test_fill_race();
+    test_shared();
+    test_stall();
+    test_parallel();
+
+    app_storage_stats_t stats;
+    app_storage_get_stats(&stats);
+    printf("stats: %u backend reads, %u KB hit, %u blocks missed (%u read ahead), %u KB direct\n", stats.backend_reads,
+           stats.hit_bytes / 1024, stats.miss_blocks, stats.readahead_blocks, stats.direct_bytes / 1024);
+
+    app_storage_unmount();
+    char cmd[64];
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", backend_dir);
+    system(cmd);
+    return test_result("test_storage");
+}
@@ -0,0 +1,304 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Paged text viewer (app_text_view): a multi-MB file with short, empty, CR LF, UTF-8 and very long
+ * lines is indexed in the background; every shown page, also while indexing, must match the page
+ * cut by a straightforward reference. Reports index size, indexing time and page render time.
+ *
+ *   test_text_view [file]      view the given file instead of the generated one
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "app_mem.h"
+#include "app_text_view.h"
+#include "test_util.h"
+
+/* Row splitting of app_text_view.c */
+#define LINE_MAX_CHARS      (44)
+#define ROW_BYTES           (LINE_MAX_CHARS + 8)
+#define ROWS                APP_TEXT_VIEW_ROWS
+
+static uint8_t *text;
+static size_t text_size;
+static uint32_t *rows;              /*!< Reference row start offsets */
+static uint32_t row_count;
+
+/* ---------------------------- Test file ------------------------------------ */
+
+static void make_text(size_t size)
+{
+    static const char *utf8[] = { "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    uint32_t rnd = 7;
+
+    text = malloc(size + 4096);
+    text_size = 0;
+    while (text_size < size) {
+        uint32_t kind = test_rand(&rnd) % 100;
+        size_t len = (kind < 5) ? 0 : (kind < 8) ? 500 + test_rand(&rnd) % 3000 : test_rand(&rnd) % 100;
+        for (size_t i = 0; i < len; i++) {
+            if (test_rand(&rnd) % 16 == 0) {
+                const char *c = utf8[test_rand(&rnd) % 3];
+                memcpy(&text[text_size], c, strlen(c));
+                text_size += strlen(c);
+            } else {
+                text[text_size++] = 'a' + test_rand(&rnd) % 26;
+            }
+        }
+        if (test_rand(&rnd) % 4 == 0) {
+            text[text_size++] = '\r';
+        }
+        text[text_size++] = '\n';
+    }
+    /* No new line at the end */
+    text[text_size++] = 'z';
+}
+
+static void load_text(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        exit(2);
+    }
+    fseek(f, 0, SEEK_END);
+    text_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = malloc(text_size + 1);
+    if (fread(text, 1, text_size, f) != text_size) {
+        exit(2);
+    }
+    fclose(f);
+}
+
+/* Reference: every new line starts a row, lines longer than LINE_MAX_CHARS bytes are wrapped before
+   the next character start, which is not CR */
+static void split_rows(void)
+{
+    uint32_t len = 0;
+
+    rows = malloc((text_size + 1) * sizeof(uint32_t));
+    row_count = 0;
+    rows[row_count++] = 0;
+    for (size_t i = 0; i < text_size; i++) {
+        uint8_t b = text[i];
+        bool char_start = (b & 0xC0) != 0x80;
+        if (b == '\n') {
+            len = 0;
+            if (i + 1 < text_size) {
+                rows[row_count++] = i + 1;
+            }
+        } else if (len >= LINE_MAX_CHARS && char_start && b != '\r') {
+            rows[row_count++] = i;
+            len = 1;
+        } else {
+            len++;
+        }
+    }
+}
+
+/* Page text as the viewer shows it from row first: rows without line end, each ended by new line */
+static char *expected_page(uint32_t first, uint32_t lines)
+{
+    static char page[ROWS * (ROW_BYTES + 1) + 1];
+    char *out = page;
+    size_t page_start = rows[first];
+    size_t page_end = page_start + ROWS * ROW_BYTES;
+
+    for (uint32_t r = first; r < lines && r < first + ROWS; r++) {
+        size_t from = rows[r];
+        size_t to = (r + 1 < row_count) ? rows[r + 1] : text_size;
+        to = (to > page_end) ? page_end : to;
+        to = (to > from + ROW_BYTES) ? from + ROW_BYTES : to;
+        while (to > from && (text[to - 1] == '\n' || text[to - 1] == '\r')) {
+            to--;
+        }
+        memcpy(out, &text[from], (to > from) ? to - from : 0);
+        out += (to > from) ? to - from : 0;
+        *out++ = '\n';
+    }
+    *out = '\0';
+    return page;
+}
+
+/* ---------------------------- Viewer --------------------------------------- */
+
+typedef struct {
+    lv_obj_t *label;
+    lv_obj_t *status;
+} view_parts_t;
+
+static view_parts_t view_parts(lv_obj_t *view)
+{
+    return (view_parts_t) {
+        .label = lv_obj_get_child(view, 0),
+        .status = lv_obj_get_child(view, 2),
+    };
+}
+
+/* Status "first/lines" with "+" while indexing */
+static bool view_status(lv_obj_t *view, uint32_t *first, uint32_t *lines)
+{
+    const char *status = lv_label_get_text(view_parts(view).status);
+    unsigned a = 0, b = 0;
+    if (sscanf(status, "%u/%u", &a, &b) != 2) {
+        *first = 0;
+        *lines = 0;
+        return true;
+    }
+    *first = a - 1;
+    *lines = b;
+    return strchr(status, '+') != NULL;
+}
+
+static int check_page(lv_obj_t *view, const char *when)
+{
+    uint32_t first, lines;
+    view_status(view, &first, &lines);
+    const char *shown = lv_label_get_text(view_parts(view).label);
+    if (lines == 0 || lines > row_count || first >= lines) {
+        printf("%s: status %s\n", when, lv_label_get_text(view_parts(view).status));
+        return 1;
+    }
+    if (strcmp(shown, expected_page(first, lines)) != 0) {
+        printf("%s: page at row %" PRIu32 " differs:\n--- shown\n%s--- expected\n%s", when, first, shown,
+               expected_page(first, lines));
+        return 1;
+    }
+    return 0;
+}
+
+static void test_view(const char *path)
+{
+    app_mem_stats_t stats;
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+
+    double t0 = test_now_us();
+    lv_obj_t *view = app_text_view_create(lv_screen_active(), path);
+    TEST_CHECK(view != NULL, "app_text_view_create(%s)", path);
+    if (view == NULL) {
+        app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+        return;
+    }
+    app_mem_get_stats(&stats);
+    printf("viewer state incl. index: %zu bytes for %zu bytes of text\n", stats.arena[APP_MEM_ARENA_WINDOW].used, text_size);
+
+    /* Pages shown while the index grows */
+    uint32_t rnd = 1;
+    int bad = 0, checks = 0;
+    uint32_t first, lines;
+    bool first_page = true;
+    while (view_status(view, &first, &lines) || lines == 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        lv_timer_handler();
+        if (first_page && lines > 0) {
+            printf("first page after %.1f ms\n", (test_now_us() - t0) / 1000);
+            first_page = false;
+        }
+        app_text_view_scroll(view, (int32_t)(test_rand(&rnd) % 4000) - 1000);
+        bad += check_page(view, "indexing");
+        checks++;
+    }
+    printf("indexed %" PRIu32 " rows in %.0f ms (%d pages checked meanwhile)\n", lines, (test_now_us() - t0) / 1000, checks);
+    TEST_CHECK(lines == row_count, "indexed %" PRIu32 " rows, expected %" PRIu32, lines, row_count);
+
+    /* Random jumps, single steps and both ends */
+    double render_us = 0;
+    const int jumps = 2000;
+    for (int i = 0; i < jumps; i++) {
+        view_status(view, &first, &lines);
+        int32_t delta = (i % 4 == 0) ? (int32_t)(test_rand(&rnd) % row_count) - (int32_t)first :
+                        (i % 4 == 1) ? 1 : (i % 4 == 2) ? -ROWS : (int32_t)(test_rand(&rnd) % 50);
+        double t = test_now_us();
+        app_text_view_scroll(view, delta);
+        render_us += test_now_us() - t;
+        bad += check_page(view, "scroll");
+    }
+    app_text_view_scroll(view, -(int32_t)row_count);
+    bad += check_page(view, "top");
+    app_text_view_scroll(view, row_count);
+    bad += check_page(view, "bottom");
+    TEST_CHECK(bad == 0, "%d of %d pages differ", bad, checks + jumps + 2);
+    printf("page render with rescan: %.1f us average\n", render_us / jumps);
+
+    lv_obj_delete(view);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+}
+
+/* The viewer is closed while the indexer is running: the deletion waits for it */
+static void test_close_while_indexing(const char *path)
+{
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    lv_obj_t *view = app_text_view_create(lv_screen_active(), path);
+    TEST_CHECK(view != NULL, "app_text_view_create(%s)", path);
+    if (view) {
+        lv_timer_handler();
+        lv_obj_delete(view);
+    }
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+}
+
+static void test_small(const char *content)
+{
+    char path[] = "/tmp/test_text_viewXXXXXX";
+    int fd = mkstemp(path);
+    TEST_CHECK(fd >= 0 && write(fd, content, strlen(content)) == (ssize_t)strlen(content), "temp file");
+    close(fd);
+
+    free(text);
+    free(rows);
+    text_size = strlen(content);
+    text = malloc(text_size + 1);
+    memcpy(text, content, text_size);
+    split_rows();
+
+    test_view(path);
+    unlink(path);
+}
+
+int main(int argc, char **argv)
+{
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+
+    /* Small files: empty, one row, exactly one page, wrapped line */
+    test_small("");
+    test_small("one line");
+    test_small("1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n");
+    test_small("\n\n\r\n\n");
+    test_small("0123456789012345678901234567890123456789012345678901234567890123456789\xE2\x82\xAC\n");
+
+    free(text);
+    free(rows);
+    char path[] = "/tmp/test_text_viewXXXXXX";
+    if (argc > 1) {
+        load_text(argv[1]);
+    } else {
+        make_text(6 * 1024 * 1024);
+        int fd = mkstemp(path);
+        TEST_CHECK(fd >= 0 && write(fd, text, text_size) == (ssize_t)text_size, "temp file");
+        close(fd);
+    }
+    split_rows();
+    printf("%zu bytes, %" PRIu32 " rows\n", text_size, row_count);
+
+    const char *file = (argc > 1) ? argv[1] : path;
+    test_view(file);
+    test_close_while_indexing(file);
+
+    if (argc == 1) {
+        unlink(path);
+    }
+    free(text);
+    free(rows);
+
+    return test_result("test_text_view");
+}
@@ -0,0 +1,398 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Voice activity detector (app_vad): speech onset latency, missed segments and false triggers
+ * on labeled audio, with the menuconfig defaults and the block size of the recorder.
+ *
+ *   test_vad                       synthetic clips (speech-like bursts over several backgrounds)
+ *   test_vad clip.wav labels.txt   16bit mono WAV and its labels (Audacity label track export:
+ *                                  "start end [text]" in seconds, one speech segment per line)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sdkconfig.h"
+#include "app_mem.h"
+#include "app_vad.h"
+#include "test_util.h"
+
+/* Recorder block: 1 KB of 16bit mono at 22.05 kHz */
+#define BLOCK_SAMPLES       (512)
+#define SAMPLE_RATE         (22050)
+#define MAX_LABELS          (64)
+
+typedef struct {
+    double start;
+    double end;
+} label_t;
+
+typedef struct {
+    int16_t *samples;
+    size_t count;
+    uint32_t sample_rate;
+    label_t labels[MAX_LABELS];
+    size_t labels_count;
+} clip_t;
+
+typedef struct {
+    size_t segments;
+    size_t missed;
+    size_t false_triggers;
+    double onset_max_ms;
+    double onset_sum_ms;
+    size_t onsets;
+    double longest_s;           /*!< Longest segment recorded */
+    bool preroll_ok;
+} result_t;
+
+/* ---------------------------- Synthetic clips ------------------------------ */
+
+static uint32_t rnd_state = 0x2545F491;
+
+static double rnd_uniform(void)
+{
+    return (test_rand(&rnd_state) >> 8) / 16777216.0;
+}
+
+static double rnd_gauss(void)
+{
+    double u1 = rnd_uniform() + 1e-12;
+    double u2 = rnd_uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+static void clip_alloc(clip_t *clip, double seconds)
+{
+    memset(clip, 0, sizeof(clip_t));
+    clip->sample_rate = SAMPLE_RATE;
+    clip->count = (size_t)(seconds * SAMPLE_RATE);
+    clip->samples = calloc(clip->count, sizeof(int16_t));
+}
+
+static int16_t sat16(double v)
+{
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+/* Background: white noise of rms (full scale 32768), optional 50 Hz hum, level change at step_s */
+static void clip_noise(clip_t *clip, double rms, double hum_rms, double step_s, double step_gain)
+{
+    for (size_t i = 0; i < clip->count; i++) {
+        double t = (double)i / clip->sample_rate;
+        double gain = (step_s > 0 && t >= step_s) ? step_gain : 1.0;
+        double v = rms * gain * rnd_gauss() + hum_rms * gain * sqrt(2) * sin(2 * M_PI * 50 * t);
+        clip->samples[i] = sat16(clip->samples[i] + v);
+    }
+}
+
+/* Speech-like burst: harmonics of a gliding f0 with syllable envelope, fricatives between syllables */
+static void clip_speech(clip_t *clip, double start, double len, double rms)
+{
+    size_t from = (size_t)(start * clip->sample_rate);
+    size_t to = (size_t)((start + len) * clip->sample_rate);
+    double f0 = 110 + 100 * rnd_uniform();
+    double phase = 0;
+
+    for (size_t i = from; i < to && i < clip->count; i++) {
+        double t = (double)(i - from) / clip->sample_rate;
+        /* ~4 syllables per second, onset of the first syllable within 10 ms */
+        double syll = fmod(t * 4.0, 1.0);
+        double env = syll < 0.7 ? sin(M_PI * syll / 0.7) : 0;
+        env = sqrt(env);
+        double f = f0 * (1 + 0.1 * sin(2 * M_PI * 1.5 * t));
+        phase += 2 * M_PI * f / clip->sample_rate;
+        double v = 0;
+        for (int h = 1; h <= 8; h++) {
+            v += sin(h * phase) / h;
+        }
+        /* Fricative in the syllable gaps */
+        double fric = syll >= 0.75 ? 0.3 * rnd_gauss() : 0;
+        clip->samples[i] = sat16(clip->samples[i] + rms * (env * v * 1.1 + fric));
+    }
+
+    clip->labels[clip->labels_count++] = (label_t) {
+        start, start + len
+    };
+}
+
+/* Short clicks (door knock, handling noise): 5 ms decaying bursts */
+static void clip_clicks(clip_t *clip, double start, int count, double interval, double peak)
+{
+    for (int c = 0; c < count; c++) {
+        size_t from = (size_t)((start + c * interval) * clip->sample_rate);
+        for (size_t i = 0; i < clip->sample_rate / 200 && from + i < clip->count; i++) {
+            double v = peak * exp(-(double)i / (clip->sample_rate / 1000.0)) * rnd_gauss();
+            clip->samples[from + i] = sat16(clip->samples[from + i] + v);
+        }
+    }
+}
+
+/* ---------------------------- WAV and labels ------------------------------- */
+
+static bool clip_load(clip_t *clip, const char *wav_path, const char *labels_path)
+{
+    memset(clip, 0, sizeof(clip_t));
+
+    FILE *f = fopen(wav_path, "rb");
+    if (f == NULL) {
+        printf("Cannot open %s\n", wav_path);
+        return false;
+    }
+    uint8_t hdr[12];
+    uint16_t channels = 0, bits = 0;
+    bool ok = fread(hdr, 1, 12, f) == 12 && memcmp(hdr, "RIFF", 4) == 0 && memcmp(&hdr[8], "WAVE", 4) == 0;
+    while (ok && fread(hdr, 1, 8, f) == 8) {
+        uint32_t size = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t)hdr[7] << 24);
+        if (memcmp(hdr, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            ok = size >= 16 && fread(fmt, 1, 16, f) == 16;
+            channels = fmt[2] | (fmt[3] << 8);
+            clip->sample_rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            bits = fmt[14] | (fmt[15] << 8);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            clip->count = size / 2;
+            clip->samples = malloc(size);
+            ok = clip->samples && fread(clip->samples, 2, clip->count, f) == clip->count;
+            break;
+        } else {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    if (!ok || clip->samples == NULL || channels != 1 || bits != 16) {
+        printf("%s: only 16bit mono PCM WAV is supported\n", wav_path);
+        return false;
+    }
+
+    f = fopen(labels_path, "r");
+    if (f == NULL) {
+        printf("Cannot open %s\n", labels_path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), f) && clip->labels_count < MAX_LABELS) {
+        label_t *l = &clip->labels[clip->labels_count];
+        if (sscanf(line, "%lf %lf", &l->start, &l->end) == 2 && l->end > l->start) {
+            clip->labels_count++;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+/* ---------------------------- Evaluation ----------------------------------- */
+
+static result_t clip_run(const clip_t *clip, bool verbose)
+{
+    const app_vad_config_t cfg = {
+        .sample_rate = clip->sample_rate,
+        .threshold_db = CONFIG_APP_VAD_THRESHOLD_DB,
+        .min_energy = CONFIG_APP_VAD_MIN_ENERGY,
+        .attack_ms = CONFIG_APP_VAD_ATTACK_MS,
+        .hangover_ms = CONFIG_APP_VAD_HANGOVER_MS,
+    };
+    const double hangover_s = CONFIG_APP_VAD_HANGOVER_MS / 1000.0;
+    result_t res = {
+        .segments = clip->labels_count,
+        .preroll_ok = true,
+    };
+    bool detected[MAX_LABELS] = { 0 };
+    app_vad_t vad;
+    app_vad_preroll_t preroll;
+    double segment_start = 0;
+
+    app_vad_init(&vad, &cfg);
+    TEST_CHECK(app_mem_arena_begin(APP_MEM_ARENA_REC) == ESP_OK, "REC arena busy");
+    TEST_CHECK(app_vad_preroll_init(&preroll, BLOCK_SAMPLES * sizeof(int16_t), CONFIG_APP_VAD_PREROLL_MS, clip->sample_rate),
+               "pre-roll does not fit the REC arena");
+
+    for (size_t pos = 0; pos + BLOCK_SAMPLES <= clip->count; pos += BLOCK_SAMPLES) {
+        const int16_t *block = &clip->samples[pos];
+        /* The event is known when the whole block is recorded */
+        double t = (double)(pos + BLOCK_SAMPLES) / clip->sample_rate;
+        app_vad_event_t event = app_vad_process(&vad, block, BLOCK_SAMPLES);
+
+        if (!vad.active || event == APP_VAD_EVENT_SPEECH_START) {
+            app_vad_preroll_push(&preroll, block);
+        }
+        if (event == APP_VAD_EVENT_SPEECH_START) {
+            segment_start = t;
+        } else if (event == APP_VAD_EVENT_SPEECH_END || (vad.active && pos + 2 * BLOCK_SAMPLES > clip->count)) {
+            res.longest_s = t - segment_start > res.longest_s ? t - segment_start : res.longest_s;
+        }
+        if (event == APP_VAD_EVENT_SPEECH_START) {
+            /* Oldest pre-roll sample, which is written first to the file */
+            double preroll_start = t - (double)(preroll.used * BLOCK_SAMPLES) / clip->sample_rate;
+            size_t seg = MAX_LABELS;
+            for (size_t i = 0; i < clip->labels_count; i++) {
+                if (t >= clip->labels[i].start && t <= clip->labels[i].end + hangover_s) {
+                    seg = i;
+                    break;
+                }
+            }
+            if (seg == MAX_LABELS) {
+                res.false_triggers++;
+                if (verbose) {
+                    printf("  false trigger at %.3f s\n", t);
+                }
+            } else if (!detected[seg]) {
+                double onset_ms = (t - clip->labels[seg].start) * 1000;
+                detected[seg] = true;
+                res.onsets++;
+                res.onset_sum_ms += onset_ms;
+                res.onset_max_ms = onset_ms > res.onset_max_ms ? onset_ms : res.onset_max_ms;
+                if (preroll_start > clip->labels[seg].start) {
+                    res.preroll_ok = false;
+                }
+                if (verbose) {
+                    printf("  speech %.3f-%.3f s: start after %.0f ms, pre-roll from %.3f s\n",
+                           clip->labels[seg].start, clip->labels[seg].end, onset_ms, preroll_start);
+                }
+            }
+            while (app_vad_preroll_pop(&preroll) != NULL) {
+            }
+        }
+        /* Speech continued from the previous segment (gap shorter than the hangover) */
+        for (size_t i = 0; vad.active && i < clip->labels_count; i++) {
+            if (!detected[i] && t >= clip->labels[i].start && t <= clip->labels[i].end) {
+                detected[i] = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < clip->labels_count; i++) {
+        res.missed += !detected[i];
+    }
+
+    app_vad_preroll_deinit(&preroll);
+    app_mem_arena_end(APP_MEM_ARENA_REC);
+    return res;
+}
+
+static void report(const char *name, const result_t *res)
+{
+    printf("%-28s segments %2zu missed %zu false %zu onset avg %5.1f max %5.1f ms longest %4.1f s%s\n", name,
+           res->segments, res->missed, res->false_triggers, res->onsets ? res->onset_sum_ms / res->onsets : 0.0,
+           res->onset_max_ms, res->longest_s, res->preroll_ok ? "" : " (pre-roll too short)");
+}
+
+/* ---------------------------- Test cases ----------------------------------- */
+
+/* Speech over a background, speech_db and noise_db in dBFS (rms), speech start detected within onset_ms */
+static void case_speech(const char *name, double noise_db, double hum_db, double speech_db, double onset_ms)
+{
+    clip_t clip;
+    clip_alloc(&clip, 20);
+    clip_noise(&clip, 32768 * pow(10, noise_db / 20), hum_db < -100 ? 0 : 32768 * pow(10, hum_db / 20), 0, 1);
+    double rms = 32768 * pow(10, speech_db / 20);
+    clip_speech(&clip, 2.0, 1.2, rms);
+    clip_speech(&clip, 5.5, 0.6, rms);
+    clip_speech(&clip, 8.0, 2.5, rms);
+    clip_speech(&clip, 13.0, 0.4, rms);
+    clip_speech(&clip, 16.0, 1.5, rms);
+
+    result_t res = clip_run(&clip, false);
+    report(name, &res);
+    TEST_CHECK(res.missed == 0, "%s: %zu missed", name, res.missed);
+    TEST_CHECK(res.false_triggers == 0, "%s: %zu false triggers", name, res.false_triggers);
+    TEST_CHECK(res.onset_max_ms <= onset_ms, "%s: onset %.1f ms over %.1f ms", name, res.onset_max_ms, onset_ms);
+    TEST_CHECK(res.preroll_ok, "%s: speech start not in the pre-roll", name);
+    free(clip.samples);
+}
+
+/* Background only, no speech must be detected */
+static void case_noise(const char *name, double noise_db, double hum_db, double step_db, bool clicks)
+{
+    clip_t clip;
+    clip_alloc(&clip, 20);
+    clip_noise(&clip, 32768 * pow(10, noise_db / 20), hum_db < -100 ? 0 : 32768 * pow(10, hum_db / 20), 8.0,
+               pow(10, step_db / 20));
+    if (clicks) {
+        clip_clicks(&clip, 3.0, 4, 0.25, 8000);
+        clip_clicks(&clip, 12.0, 2, 0.5, 16000);
+    }
+
+    result_t res = clip_run(&clip, false);
+    report(name, &res);
+    TEST_CHECK(res.false_triggers == 0, "%s: %zu false triggers", name, res.false_triggers);
+    free(clip.samples);
+}
+
+/* Loud hum switched on while recording: taken as speech, but the segment must end */
+static void case_hum_on(void)
+{
+    clip_t clip;
+    clip_alloc(&clip, 20);
+    clip_noise(&clip, 32768 * pow(10, -55 / 20.0), 32768 * pow(10, -60 / 20.0), 5.0, pow(10, 30 / 20.0));
+
+    result_t res = clip_run(&clip, false);
+    report("hum -30 dB switched on", &res);
+    TEST_CHECK(res.false_triggers <= 1, "%zu false triggers", res.false_triggers);
+    TEST_CHECK(res.longest_s < 5.0, "segment of %.1f s", res.longest_s);
+    free(clip.samples);
+}
+
+static void test_preroll_ring(void)
+{
+    app_vad_preroll_t preroll;
+    uint8_t block[16];
+
+    TEST_CHECK(app_mem_arena_begin(APP_MEM_ARENA_REC) == ESP_OK, "REC arena busy");
+    /* 10 ms at 8 kHz = 160 bytes = 10 blocks of 16 bytes */
+    TEST_CHECK(app_vad_preroll_init(&preroll, sizeof(block), 10, 8000), "init");
+    TEST_CHECK(preroll.block_count == 10, "%zu blocks", preroll.block_count);
+    for (int i = 0; i < 25; i++) {
+        memset(block, i, sizeof(block));
+        app_vad_preroll_push(&preroll, block);
+    }
+    /* The newest 10 blocks, oldest first */
+    for (int i = 15; i < 25; i++) {
+        const uint8_t *b = app_vad_preroll_pop(&preroll);
+        TEST_CHECK(b != NULL && b[0] == i && b[15] == i, "block %d", i);
+    }
+    TEST_CHECK(app_vad_preroll_pop(&preroll) == NULL, "ring not empty");
+    app_vad_preroll_deinit(&preroll);
+    app_mem_arena_end(APP_MEM_ARENA_REC);
+}
+
+int main(int argc, char **argv)
+{
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+
+    if (argc == 3) {
+        clip_t clip;
+        if (!clip_load(&clip, argv[1], argv[2])) {
+            return 2;
+        }
+        result_t res = clip_run(&clip, true);
+        report(argv[1], &res);
+        free(clip.samples);
+        return (res.missed || res.false_triggers) ? 1 : 0;
+    }
+
+    test_preroll_ring();
+
+    /* Speech at -26 dBFS (normal voice at ~1 m), backgrounds from quiet room to noisy. Detection
+       within the attack time plus two blocks (block granularity, syllable onset), later for speech
+       only a few dB over the threshold */
+    const double onset_ms = CONFIG_APP_VAD_ATTACK_MS + 2000.0 * BLOCK_SAMPLES / SAMPLE_RATE;
+    case_speech("speech, quiet room", -60, -200, -26, onset_ms);
+    case_speech("speech, fan noise -45 dB", -45, -200, -26, onset_ms);
+    case_speech("speech, hum -40 dB", -55, -40, -26, onset_ms);
+    case_speech("quiet speech -36 dB", -55, -200, -36, 150);
+
+    case_noise("noise -45 dB", -45, -200, 0, false);
+    case_noise("noise step +6 dB", -45, -200, 6, false);
+    case_noise("hum -35 dB, step +6 dB", -55, -35, 6, false);
+    case_noise("clicks over -50 dB", -50, -200, 0, true);
+    case_hum_on();
+
+    return test_result("test_vad");
+}
@@ -0,0 +1,449 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * MJPEG/AVI player (app_video, app_avi): a generated AVI with interleaved PCM is demuxed and played
+ * through a codec that consumes samples in real time and a JPEG decoder with a set decode time.
+ * Frames must be shown in order and within one frame period of their presentation time; frames
+ * that cannot be decoded in time are dropped, not shown late.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "jpeg_decoder.h"
+#include "esp_codec_dev.h"
+#include "app_mem.h"
+#include "app_avi.h"
+#include "app_video.h"
+#include "test_util.h"
+
+#define VIDEO_W             (320)
+#define VIDEO_H             (240)
+#define VIDEO_FPS           (25)
+#define VIDEO_FRAMES        (75)
+#define FRAME_US            (1000000 / VIDEO_FPS)
+#define AUDIO_RATE          (16000)
+#define AUDIO_PER_FRAME     (AUDIO_RATE / VIDEO_FPS)
+/* Seen on screen: presentation timer period (5 ms) and test loop tick after the frame is ready */
+#define SHOW_SLACK_US       (10000)
+
+/* ---------------------------- AVI file ------------------------------------- */
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} avi_buf_t;
+
+static void put(avi_buf_t *b, const void *data, size_t len)
+{
+    if (b->len + len > b->cap) {
+        b->cap = (b->len + len) * 2;
+        b->data = realloc(b->data, b->cap);
+    }
+    memcpy(&b->data[b->len], data, len);
+    b->len += len;
+}
+
+static void put32(avi_buf_t *b, uint32_t v)
+{
+    uint8_t le[4] = { v, v >> 8, v >> 16, v >> 24 };
+    put(b, le, 4);
+}
+
+static void put16(avi_buf_t *b, uint16_t v)
+{
+    uint8_t le[2] = { v, v >> 8 };
+    put(b, le, 2);
+}
+
+/* Chunk header, the size is patched by chunk_end() */
+static size_t chunk_begin(avi_buf_t *b, const char *id, const char *list_type)
+{
+    put(b, id, 4);
+    put32(b, 0);
+    size_t start = b->len;
+    if (list_type) {
+        put(b, list_type, 4);
+    }
+    return start;
+}
+
+static void chunk_end(avi_buf_t *b, size_t start)
+{
+    uint32_t size = b->len - start;
+    memcpy(&b->data[start - 4], (uint8_t[4]) {
+        size, size >> 8, size >> 16, size >> 24
+    }, 4);
+    if (size & 1) {
+        put(b, "", 1);
+    }
+}
+
+static void chunk(avi_buf_t *b, const char *id, const void *data, size_t len)
+{
+    size_t c = chunk_begin(b, id, NULL);
+    put(b, data, len);
+    chunk_end(b, c);
+}
+
+static void strh(avi_buf_t *b, const char *type, const char *handler, uint32_t scale, uint32_t rate, uint32_t length,
+                 uint32_t sample_size)
+{
+    size_t c = chunk_begin(b, "strh", NULL);
+    put(b, type, 4);
+    put(b, handler, 4);
+    put32(b, 0);                    /* flags */
+    put32(b, 0);                    /* priority, language */
+    put32(b, 0);                    /* initial frames */
+    put32(b, scale);
+    put32(b, rate);
+    put32(b, 0);                    /* start */
+    put32(b, length);
+    put32(b, 0);                    /* suggested buffer size */
+    put32(b, 0);                    /* quality */
+    put32(b, sample_size);
+    put32(b, 0);                    /* frame rectangle */
+    put16(b, VIDEO_W);
+    put16(b, VIDEO_H);
+    chunk_end(b, c);
+}
+
+/* Frame "JPEG": SOI, frame index, index dependent padding, EOI */
+static size_t frame_data(uint8_t *buf, uint32_t frame)
+{
+    size_t len = 0;
+    buf[len++] = 0xFF;
+    buf[len++] = 0xD8;
+    memcpy(&buf[len], &frame, sizeof(frame));
+    len += sizeof(frame);
+    for (uint32_t i = 0; i < 100 + frame * 7; i++) {
+        buf[len++] = frame;
+    }
+    buf[len++] = 0xFF;
+    buf[len++] = 0xD9;
+    return len;
+}
+
+static void write_avi(const char *path, bool audio)
+{
+    avi_buf_t b = { 0 };
+    uint8_t frame[2048];
+    int16_t samples[AUDIO_PER_FRAME];
+
+    size_t riff = chunk_begin(&b, "RIFF", "AVI ");
+    size_t hdrl = chunk_begin(&b, "LIST", "hdrl");
+    size_t avih = chunk_begin(&b, "avih", NULL);
+    put32(&b, FRAME_US);
+    put32(&b, 0);
+    put32(&b, 0);
+    put32(&b, 0x10);
+    put32(&b, VIDEO_FRAMES);
+    put32(&b, 0);
+    put32(&b, audio ? 2 : 1);
+    put32(&b, 0);
+    put32(&b, VIDEO_W);
+    put32(&b, VIDEO_H);
+    put(&b, (uint8_t[16]) {
+        0
+    }, 16);
+    chunk_end(&b, avih);
+
+    size_t strl = chunk_begin(&b, "LIST", "strl");
+    strh(&b, "vids", "MJPG", 1, VIDEO_FPS, VIDEO_FRAMES, 0);
+    size_t strf = chunk_begin(&b, "strf", NULL);
+    put32(&b, 40);
+    put32(&b, VIDEO_W);
+    put32(&b, VIDEO_H);
+    put16(&b, 1);
+    put16(&b, 24);
+    put(&b, "MJPG", 4);
+    put32(&b, VIDEO_W * VIDEO_H * 3);
+    put(&b, (uint8_t[16]) {
+        0
+    }, 16);
+    chunk_end(&b, strf);
+    chunk_end(&b, strl);
+
+    if (audio) {
+        strl = chunk_begin(&b, "LIST", "strl");
+        strh(&b, "auds", "\0\0\0\0", 1, AUDIO_RATE, VIDEO_FRAMES * AUDIO_PER_FRAME, 2);
+        strf = chunk_begin(&b, "strf", NULL);
+        put16(&b, 1);
+        put16(&b, 1);
+        put32(&b, AUDIO_RATE);
+        put32(&b, AUDIO_RATE * 2);
+        put16(&b, 2);
+        put16(&b, 16);
+        chunk_end(&b, strf);
+        chunk_end(&b, strl);
+    }
+    chunk_end(&b, hdrl);
+
+    /* Sound of each frame ahead of it, in "rec " lists every third frame, ignored chunks between */
+    size_t movi = chunk_begin(&b, "LIST", "movi");
+    for (uint32_t i = 0; i < VIDEO_FRAMES; i++) {
+        if (audio) {
+            for (int s = 0; s < AUDIO_PER_FRAME; s++) {
+                samples[s] = i;
+            }
+            size_t rec = (i % 3 == 0) ? chunk_begin(&b, "LIST", "rec ") : 0;
+            chunk(&b, "01wb", samples, sizeof(samples));
+            if (rec) {
+                chunk(&b, "JUNK", "xxxxx", 5);
+                chunk_end(&b, rec);
+            }
+        }
+        chunk(&b, "00dc", frame, frame_data(frame, i));
+    }
+    chunk_end(&b, movi);
+    chunk(&b, "idx1", (uint8_t[16]) {
+        0
+    }, 16);
+    chunk_end(&b, riff);
+
+    FILE *f = fopen(path, "wb");
+    TEST_CHECK(f && fwrite(b.data, 1, b.len, f) == b.len, "write %s", path);
+    fclose(f);
+    free(b.data);
+}
+
+/* ---------------------------- Decoder and codec ---------------------------- */
+
+static volatile uint32_t decode_us;
+static volatile int decode_errors;
+
+/* Checks the frame, takes decode_us and writes the frame index into the first pixels */
+esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
+{
+    const uint8_t *in = cfg->indata;
+    uint32_t frame;
+    size_t len = cfg->indata_size;
+
+    memcpy(&frame, &in[2], sizeof(frame));
+    if (len < 8 || in[0] != 0xFF || in[1] != 0xD8 || in[len - 2] != 0xFF || in[len - 1] != 0xD9 ||
+            len != 108 + frame * 7) {
+        decode_errors++;
+        return ESP_FAIL;
+    }
+    img->width = VIDEO_W >> cfg->out_scale;
+    img->height = VIDEO_H >> cfg->out_scale;
+    img->output_len = img->width * img->height * 2;
+    if (cfg->outbuf_size < img->output_len) {
+        decode_errors++;
+        return ESP_ERR_NO_MEM;
+    }
+    usleep(decode_us);
+    memcpy(cfg->outbuf, &frame, sizeof(frame));
+    return ESP_OK;
+}
+
+static int64_t codec_open_us;
+static int64_t codec_due_us;
+static uint32_t codec_rate;
+static size_t codec_bytes;
+static int codec_bad_samples;
+
+/* Plays in real time: a write returns when its samples are played */
+int esp_codec_dev_open(esp_codec_dev_handle_t dev, esp_codec_dev_sample_info_t *fs)
+{
+    codec_rate = fs->sample_rate * fs->channel * (fs->bits_per_sample / 8);
+    codec_open_us = esp_timer_get_time();
+    codec_due_us = codec_open_us;
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_write(esp_codec_dev_handle_t dev, void *data, int len)
+{
+    /* Samples carry the index of their frame, which never decreases */
+    const int16_t *s = data;
+    static int16_t last;
+    if (codec_bytes == 0) {
+        last = 0;
+    }
+    for (int i = 0; i < len / 2; i++) {
+        codec_bad_samples += (s[i] < last || s[i] > last + 1);
+        last = s[i];
+    }
+    codec_bytes += len;
+
+    codec_due_us += (int64_t)len * 1000000 / codec_rate;
+    int64_t wait = codec_due_us - esp_timer_get_time();
+    if (wait > 0) {
+        usleep(wait);
+    }
+    return ESP_CODEC_DEV_OK;
+}
+
+int esp_codec_dev_close(esp_codec_dev_handle_t dev)
+{
+    return ESP_CODEC_DEV_OK;
+}
+
+/* ---------------------------- Tests ---------------------------------------- */
+
+static void test_demux(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    app_avi_t avi;
+    TEST_CHECK(app_avi_open(&avi, f) == ESP_OK, "app_avi_open");
+    TEST_CHECK(avi.info.width == VIDEO_W && avi.info.height == VIDEO_H && avi.info.frame_us == FRAME_US &&
+               avi.info.total_frames == VIDEO_FRAMES, "video %ux%u %" PRIu32 " us %" PRIu32 " frames",
+               avi.info.width, avi.info.height, avi.info.frame_us, avi.info.total_frames);
+    TEST_CHECK(avi.info.has_audio && avi.info.sample_rate == AUDIO_RATE && avi.info.channels == 1 &&
+               avi.info.bits_per_sample == 16, "audio %" PRIu32 " Hz %u ch", avi.info.sample_rate, avi.info.channels);
+
+    app_avi_chunk_t type;
+    uint32_t size, video = 0, audio = 0;
+    uint8_t buf[2048], expected[2048];
+    while (app_avi_next_chunk(&avi, &type, &size) == ESP_OK) {
+        if (type == APP_AVI_CHUNK_VIDEO) {
+            size_t len = app_avi_read(&avi, buf, sizeof(buf));
+            TEST_CHECK(len == size && len == frame_data(expected, video) && memcmp(buf, expected, len) == 0,
+                       "frame %" PRIu32, video);
+            video++;
+        } else {
+            /* Odd reads across the chunk */
+            size_t total = 0, len;
+            while ((len = app_avi_read(&avi, buf, 333)) > 0) {
+                total += len;
+            }
+            TEST_CHECK(total == size && total == AUDIO_PER_FRAME * 2, "audio chunk %" PRIu32 ": %zu B", audio, total);
+            audio++;
+        }
+    }
+    TEST_CHECK(video == VIDEO_FRAMES && audio == VIDEO_FRAMES, "%" PRIu32 " video and %" PRIu32 " audio chunks", video, audio);
+    fclose(f);
+}
+
+/* Plays the file, checks the order and the presentation time of the shown frames */
+static void test_play(const char *path, bool sound, uint32_t decode_time_us, bool expect_drops)
+{
+    const app_video_config_t cfg = {
+        .codec = sound ? (esp_codec_dev_handle_t)&codec_rate : NULL,
+        .max_width = VIDEO_W,
+        .max_height = VIDEO_H,
+    };
+    app_video_stats_t stats = { 0 };
+    app_mem_stats_t mem;
+
+    decode_us = decode_time_us;
+    decode_errors = 0;
+    codec_bytes = 0;
+    codec_bad_samples = 0;
+
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    lv_obj_t *video = app_video_create(lv_screen_active(), path, &cfg);
+    TEST_CHECK(video != NULL, "app_video_create");
+    if (video == NULL) {
+        app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+        return;
+    }
+    lv_obj_t *canvas = lv_obj_get_child(video, 0);
+
+    /* Lateness against the played sound, or the spread of the lateness against the system time */
+    int64_t late_min = INT64_MAX, late_max = INT64_MIN;
+    int64_t last_frame = -1;
+    uint32_t shown = 0, out_of_order = 0;
+    int64_t until = esp_timer_get_time() + (int64_t)VIDEO_FRAMES * FRAME_US * 2 + 2000000;
+    while (!stats.done && esp_timer_get_time() < until) {
+        lv_timer_handler();
+        app_video_get_stats(video, &stats);
+        if (stats.frames_shown != shown) {
+            int64_t now = esp_timer_get_time();
+            uint32_t frame;
+            memcpy(&frame, lv_canvas_get_buf(canvas), sizeof(frame));
+            out_of_order += ((int64_t)frame <= last_frame);
+            int64_t late = now - (int64_t)frame * FRAME_US - (sound ? codec_open_us : 0);
+            late_min = (late < late_min) ? late : late_min;
+            late_max = (late > late_max) ? late : late_max;
+            last_frame = frame;
+            shown = stats.frames_shown;
+        }
+        vTaskDelay(1);
+    }
+
+    late_max = sound ? late_max : late_max - late_min;
+    printf("%s, decode %" PRIu32 " ms: shown %" PRIu32 ", dropped %" PRIu32 ", drift max %" PRIi32 " us, "
+           "shown late by %" PRIi64 " us\n", sound ? "sound" : "no sound", decode_time_us / 1000,
+           stats.frames_shown, stats.frames_dropped, stats.drift_us_max, late_max);
+
+    TEST_CHECK(stats.done, "playback did not end");
+    TEST_CHECK(decode_errors == 0, "%d frames corrupted by the demuxer", decode_errors);
+    TEST_CHECK(out_of_order == 0, "%" PRIu32 " frames shown out of order", out_of_order);
+    TEST_CHECK(stats.frames_shown + stats.frames_dropped == VIDEO_FRAMES, "shown %" PRIu32 " + dropped %" PRIu32,
+               stats.frames_shown, stats.frames_dropped);
+    TEST_CHECK(expect_drops ? stats.frames_dropped > 0 : stats.frames_dropped == 0, "dropped %" PRIu32, stats.frames_dropped);
+    TEST_CHECK(stats.drift_us_max <= FRAME_US, "drift %" PRIi32 " us over one frame", stats.drift_us_max);
+    TEST_CHECK(late_max <= FRAME_US + SHOW_SLACK_US, "shown late by %" PRIi64 " us", late_max);
+    if (sound) {
+        TEST_CHECK(codec_bytes == VIDEO_FRAMES * AUDIO_PER_FRAME * 2 && codec_bad_samples == 0,
+                   "sound: %zu B, %d samples out of order", codec_bytes, codec_bad_samples);
+    }
+
+    lv_obj_delete(video);
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    app_mem_get_stats(&mem);
+    TEST_CHECK(mem.pool[APP_MEM_POOL_AUDIO].used == 0, "audio blocks not returned");
+}
+
+/* Window closed during the playback: all tasks stop before the buffers are released */
+static void test_close(const char *path)
+{
+    const app_video_config_t cfg = {
+        .codec = (esp_codec_dev_handle_t) &codec_rate,
+        .max_width = VIDEO_W,
+        .max_height = VIDEO_H,
+    };
+    app_mem_stats_t mem;
+
+    decode_us = 5000;
+    codec_bytes = 0;
+    app_mem_arena_begin(APP_MEM_ARENA_WINDOW);
+    lv_obj_t *video = app_video_create(lv_screen_active(), path, &cfg);
+    TEST_CHECK(video != NULL, "app_video_create");
+    for (int i = 0; i < 300 && video; i++) {
+        lv_timer_handler();
+        vTaskDelay(1);
+    }
+    if (video) {
+        lv_obj_delete(video);
+    }
+    app_mem_arena_end(APP_MEM_ARENA_WINDOW);
+    app_mem_get_stats(&mem);
+    TEST_CHECK(mem.pool[APP_MEM_POOL_AUDIO].used == 0, "audio blocks not returned");
+}
+
+int main(void)
+{
+    char with_sound[] = "/tmp/test_videoXXXXXX";
+    char without_sound[] = "/tmp/test_videoXXXXXX";
+    close(mkstemp(with_sound));
+    close(mkstemp(without_sound));
+    write_avi(with_sound, true);
+    write_avi(without_sound, false);
+
+    TEST_CHECK(app_mem_init() == ESP_OK, "app_mem_init");
+
+    test_demux(with_sound);
+    test_play(with_sound, true, 2000, false);
+    test_play(without_sound, false, 2000, false);
+    test_play(with_sound, false, 2000, false);
+    /* Decoding takes longer than a frame period */
+    test_play(with_sound, true, FRAME_US * 3 / 2, true);
+    test_close(with_sound);
+
+    unlink(with_sound);
+    unlink(without_sound);
+
+    return test_result("test_video");
+}
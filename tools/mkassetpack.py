@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Build read-only asset pack partition image, which is memory-mapped and
+# mounted at /assets by main/app_assets.c. The format is described in
+# main/app_assets.h.
+#
+# With --predecode, a pre-decoded *.rgbz variant (see tools/mkrgbz.py) is added
+# for each image, the file browser opens it instead of the original.
+# With --jpeg-restart, JPEG images get a restart marker after every MCU row, so
+# they can be decoded in parallel (main/app_jpeg_par.c).
+#
+# Usage: mkassetpack.py input_dir output.bin [--size 0x400000] [--align 16] [--predecode 320x240 [--swap]]
+#                       [--jpeg-restart]
+#        mkassetpack.py --list output.bin
+
+import argparse
+import io
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import zlib
+
+import mkrgbz
+
+MAGIC = 0x4B415041  # "APAK"
+VERSION = 1
+NAME_LEN = 48
+HEADER = struct.Struct('<IHHIIII8x')
+# Images, which get the pre-decoded variant
+PREDECODE_EXT = ('.jpg', '.jpeg', '.png', '.bmp', '.qoi', '.ppm')
+ENTRY = struct.Struct('<%dsIIII' % NAME_LEN)
+
+
+def align_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def build(files, align):
+    """Return pack image of (name, data) pairs"""
+    index_end = HEADER.size + ENTRY.size * len(files)
+    offset = align_up(index_end, align)
+    entries = b''
+    data = b''
+    for name, content in files:
+        encoded = name.encode('utf-8')
+        if len(encoded) >= NAME_LEN:
+            raise ValueError('File name too long (max %d bytes): %s' % (NAME_LEN - 1, name))
+        entries += ENTRY.pack(encoded, offset, len(content), zlib.crc32(content), 0)
+        padded = content + b'\xff' * (align_up(len(content), align) - len(content))
+        data += padded
+        offset += len(padded)
+
+    image_size = align_up(index_end, align) + len(data)
+    header = HEADER.pack(MAGIC, VERSION, ENTRY.size, len(files), zlib.crc32(entries), align, image_size)
+    gap = b'\xff' * (align_up(index_end, align) - index_end)
+    return header + entries + gap + data
+
+
+def parse(image):
+    """Return list of (name, data) pairs, check all CRCs"""
+    magic, version, entry_size, count, index_crc, align, image_size = HEADER.unpack_from(image, 0)
+    if magic != MAGIC:
+        raise ValueError('Not an asset pack')
+    if version != VERSION or entry_size != ENTRY.size:
+        raise ValueError('Unsupported version %d' % version)
+    if image_size > len(image):
+        raise ValueError('Truncated image')
+    index = image[HEADER.size:HEADER.size + ENTRY.size * count]
+    if zlib.crc32(index) != index_crc:
+        raise ValueError('Index CRC mismatch')
+
+    files = []
+    for i in range(count):
+        name, offset, size, crc, _ = ENTRY.unpack_from(index, i * ENTRY.size)
+        content = image[offset:offset + size]
+        if offset % align or offset + size > image_size or zlib.crc32(content) != crc:
+            raise ValueError('Entry %d corrupted' % i)
+        files.append((name.rstrip(b'\0').decode('utf-8'), content))
+    return files
+
+
+def jpeg_has_restart(content):
+    """Check for DRI segment before the start of scan"""
+    pos = 2
+    while pos + 4 <= len(content) and content[pos] == 0xFF:
+        marker = content[pos + 1]
+        if marker == 0xDD:
+            return True
+        if marker == 0xDA:
+            break
+        pos += 2 + struct.unpack_from('>H', content, pos + 2)[0]
+    return False
+
+
+def jpeg_restart(files):
+    """Return files with restart marker after every MCU row in JPEG images"""
+    jpegtran = shutil.which('jpegtran')
+    try:
+        from PIL import Image
+    except ImportError:
+        Image = None
+    if jpegtran is None and Image is None:
+        print('Warning: neither jpegtran nor Pillow is installed, JPEG images are not re-encoded')
+        return files
+
+    result = []
+    for name, content in files:
+        if name.lower().endswith(('.jpg', '.jpeg')) and not jpeg_has_restart(content):
+            if jpegtran:
+                # Lossless, only the entropy-coded data is rewritten
+                content = subprocess.run([jpegtran, '-restart', '1', '-copy', 'none'], input=content,
+                                         stdout=subprocess.PIPE, check=True).stdout
+            else:
+                # Re-encoded with the original quantization tables and subsampling
+                img = Image.open(io.BytesIO(content))
+                out = io.BytesIO()
+                img.save(out, 'JPEG', quality='keep', subsampling='keep', restart_marker_rows=1)
+                content = out.getvalue()
+        result.append((name, content))
+    return result
+
+
+def predecode(files, size, swap):
+    """Return *.rgbz variants of images in files (name, data) list"""
+    max_width, max_height = (int(x) for x in size.split('x'))
+    names = set(name for name, _ in files)
+    variants = []
+    for name, content in files:
+        variant = mkrgbz.output_name(name)
+        if not name.lower().endswith(PREDECODE_EXT) or variant in names:
+            continue
+        tmp = tempfile.NamedTemporaryFile(suffix=os.path.splitext(name)[1], delete=False)
+        try:
+            tmp.write(content)
+            tmp.close()
+            width, height, rgb = mkrgbz.load_rgb(tmp.name, max_width, max_height)
+        except ImportError:
+            print('Warning: Pillow is not installed, images are not pre-decoded')
+            return []
+        finally:
+            os.unlink(tmp.name)
+        variants.append((variant, mkrgbz.encode(width, height, rgb, swap)))
+    return variants
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Build read-only asset pack partition image')
+    parser.add_argument('input', help='directory with assets (flat), or image with --list')
+    parser.add_argument('output', nargs='?')
+    parser.add_argument('--size', type=lambda x: int(x, 0), default=0,
+                        help='partition size, the image is padded to it')
+    parser.add_argument('--align', type=int, default=16, help='data alignment of each file')
+    parser.add_argument('--list', action='store_true', help='check and list existing image')
+    parser.add_argument('--predecode', metavar='WxH', help='add pre-decoded RGB565 variant of images for this display')
+    parser.add_argument('--swap', action='store_true', help='pre-decoded images are byte-swapped (CONFIG_LV_COLOR_16_SWAP)')
+    parser.add_argument('--jpeg-restart', action='store_true', help='add restart marker after every MCU row to JPEG images')
+    args = parser.parse_args()
+
+    if args.list:
+        with open(args.input, 'rb') as f:
+            for name, content in parse(f.read()):
+                print('%10d  %s' % (len(content), name))
+        return
+
+    if args.output is None:
+        parser.error('output is required')
+
+    names = sorted(n for n in os.listdir(args.input) if os.path.isfile(os.path.join(args.input, n)))
+    files = []
+    for name in names:
+        with open(os.path.join(args.input, name), 'rb') as f:
+            files.append((name, f.read()))
+    if args.jpeg_restart:
+        files = jpeg_restart(files)
+    if args.predecode:
+        files = sorted(files + predecode(files, args.predecode, args.swap))
+
+    image = build(files, args.align)
+    if parse(image) != files:
+        sys.exit('Round trip check failed')
+    if args.size:
+        if len(image) > args.size:
+            sys.exit('Asset pack (%d bytes) does not fit the partition (%d bytes)' % (len(image), args.size))
+        image += b'\xff' * (args.size - len(image))
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print('%d files, %d bytes' % (len(files), len(image)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Convert images into the pre-decoded RGB565 + LZ4 format (*.rgbz), which is
+# decompressed by main/app_img_dec_rgbz.c straight into the display buffer.
+# The format is described there. Images are scaled down to fit the display.
+#
+# JPEG, PNG, BMP, ... are loaded by Pillow, binary PPM (P6) also without it.
+#
+# Usage: mkrgbz.py [--size 320x240] [--swap] [-o output_dir] image [image ...]
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = b'RGBZ'
+VERSION = 1
+FLAG_SWAPPED = 0x01
+HEADER = struct.Struct('<4sBBHHH4x')
+BAND_ROWS = 16
+
+# LZ4 block format limits
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 0xFFFF
+HASH_LOG = 14
+
+
+def _lz4_length(n):
+    out = bytearray()
+    while n >= 255:
+        out.append(255)
+        n -= 255
+    out.append(n)
+    return out
+
+
+def _lz4_sequence(out, literals, match_len):
+    lit_len = len(literals)
+    token = (min(lit_len, 15) << 4) | (min(match_len - MIN_MATCH, 15) if match_len else 0)
+    out.append(token)
+    if lit_len >= 15:
+        out += _lz4_length(lit_len - 15)
+    out += literals
+
+
+def lz4_compress(data):
+    """Compress data into one LZ4 block (greedy, hash of 4 bytes)"""
+    n = len(data)
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    limit = n - MF_LIMIT
+
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        ref = table.get(key)
+        table[key] = pos
+        if ref is None or pos - ref > MAX_OFFSET:
+            pos += 1
+            continue
+
+        # Extend the match, the last literals must stay uncompressed
+        length = MIN_MATCH
+        end = n - LAST_LITERALS
+        while pos + length < end and data[ref + length] == data[pos + length]:
+            length += 1
+
+        _lz4_sequence(out, data[anchor:pos], length)
+        out += struct.pack('<H', pos - ref)
+        if length - MIN_MATCH >= 15:
+            out += _lz4_length(length - MIN_MATCH - 15)
+
+        pos += length
+        anchor = pos
+
+    _lz4_sequence(out, data[anchor:], 0)
+    return bytes(out)
+
+
+def lz4_decompress(block, size):
+    """Reference decoder, used to verify the output"""
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        token = block[i]
+        i += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                b = block[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        out += block[i:i + length]
+        i += length
+        if i >= len(block):
+            break
+        offset = block[i] | (block[i + 1] << 8)
+        i += 2
+        length = token & 0x0F
+        if length == 15:
+            while True:
+                b = block[i]
+                i += 1
+                length += b
+                if b != 255:
+                    break
+        length += MIN_MATCH
+        for _ in range(length):
+            out.append(out[-offset])
+    if len(out) != size:
+        raise ValueError('LZ4 size mismatch')
+    return bytes(out)
+
+
+def load_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        if pos >= len(data):
+            raise ValueError('Truncated PPM: %s' % path)
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        raise ValueError('Only 8bit binary PPM is supported: %s' % path)
+    width, height = int(fields[1]), int(fields[2])
+    return width, height, data[pos + 1:pos + 1 + width * height * 3]
+
+
+def load_rgb(path, max_width, max_height):
+    """Return (width, height, RGB888 bytes) scaled to fit max_width x max_height"""
+    try:
+        from PIL import Image
+    except ImportError:
+        Image = None
+
+    if Image is not None:
+        img = Image.open(path).convert('RGB')
+        img.thumbnail((max_width, max_height), Image.LANCZOS)
+        return img.width, img.height, img.tobytes()
+
+    if not path.lower().endswith('.ppm'):
+        raise ImportError('Pillow is needed to load %s' % path)
+    width, height, rgb = load_ppm(path)
+    if width <= max_width and height <= max_height:
+        return width, height, rgb
+
+    # Nearest neighbour fallback without Pillow
+    scale = max(width / max_width, height / max_height)
+    out_w, out_h = int(width / scale), int(height / scale)
+    out = bytearray()
+    for y in range(out_h):
+        row = int(y * scale) * width
+        for x in range(out_w):
+            p = (row + int(x * scale)) * 3
+            out += rgb[p:p + 3]
+    return out_w, out_h, bytes(out)
+
+
+def encode(width, height, rgb, swap):
+    """Return *.rgbz image of RGB888 pixels"""
+    pixels = bytearray()
+    fmt = '>H' if swap else '<H'
+    for i in range(0, width * height * 3, 3):
+        r, g, b = rgb[i], rgb[i + 1], rgb[i + 2]
+        pixels += struct.pack(fmt, ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+
+    stride = width * 2
+    sizes = b''
+    blocks = b''
+    for y in range(0, height, BAND_ROWS):
+        band = bytes(pixels[y * stride:min(y + BAND_ROWS, height) * stride])
+        block = lz4_compress(band)
+        if lz4_decompress(block, len(band)) != band:
+            raise ValueError('LZ4 round trip failed')
+        sizes += struct.pack('<I', len(block))
+        blocks += block
+
+    header = HEADER.pack(MAGIC, VERSION, FLAG_SWAPPED if swap else 0, BAND_ROWS, width, height)
+    return header + sizes + blocks
+
+
+def convert(path, output, max_width, max_height, swap):
+    width, height, rgb = load_rgb(path, max_width, max_height)
+    image = encode(width, height, rgb, swap)
+    with open(output, 'wb') as f:
+        f.write(image)
+    return width, height, len(image)
+
+
+def output_name(path):
+    return os.path.splitext(os.path.basename(path))[0] + '.rgbz'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert images into pre-decoded RGB565 + LZ4 format')
+    parser.add_argument('images', nargs='+')
+    parser.add_argument('-o', '--output-dir', default='.', help='output directory')
+    parser.add_argument('--size', default='320x240', help='display resolution, larger images are scaled down')
+    parser.add_argument('--swap', action='store_true', help='store RGB565 byte-swapped (CONFIG_LV_COLOR_16_SWAP)')
+    args = parser.parse_args()
+
+    max_width, max_height = (int(x) for x in args.size.split('x'))
+    for path in args.images:
+        output = os.path.join(args.output_dir, output_name(path))
+        try:
+            width, height, size = convert(path, output, max_width, max_height, args.swap)
+        except ImportError as e:
+            sys.exit(str(e))
+        print('%s: %dx%d, %d bytes (%.1f%% of RGB565)' % (output, width, height, size,
+                                                         100.0 * size / (width * height * 2)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Send 16bit PCM WAV (or a test tone) as RTP L16 stream, which is played by the
+# receiver in main/app_rtp.c (CONFIG_APP_RTP). Network impairments can be simulated:
+# random delay (jitter, which also reorders packets), loss, duplicates and sender
+# clock drift. The numbers of simulated losses and reordered packets are printed at
+# the end, to be compared with the receiver statistics.
+#
+# Usage: rtp_send.py [input.wav | --tone 440] [--host 192.168.1.10] [--port 5004]
+#                    [--ptime 20] [--jitter-ms 40] [--loss 0.05] [--drift-ppm 300]
+
+import argparse
+import heapq
+import math
+import random
+import socket
+import struct
+import sys
+import time
+import wave
+
+# Static payload types of L16 (RFC 3551)
+PT_L16_STEREO = 10
+PT_L16_MONO = 11
+PT_DYNAMIC = 96
+MAX_PAYLOAD = 1472 - 12
+
+
+def read_wav(path):
+    with wave.open(path, 'rb') as wav:
+        channels = wav.getnchannels()
+        if wav.getsampwidth() != 2 or channels > 2:
+            sys.exit('Only 16bit mono or stereo PCM is supported')
+        sample_rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+    # WAV is little-endian, L16 is big-endian
+    count = len(raw) // 2
+    samples = struct.unpack('<%dh' % count, raw[:count * 2])
+    return sample_rate, channels, struct.pack('>%dh' % count, *samples)
+
+
+def make_tone(freq, seconds, sample_rate, channels):
+    frames = int(seconds * sample_rate)
+    samples = []
+    for i in range(frames):
+        value = int(12000 * math.sin(2 * math.pi * freq * i / sample_rate))
+        samples += [value] * channels
+    return struct.pack('>%dh' % len(samples), *samples)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Send PCM as RTP L16 stream with simulated network impairments')
+    parser.add_argument('input', nargs='?', help='16bit PCM WAV file')
+    parser.add_argument('--tone', type=float, help='Send sine of this frequency (Hz) instead of a file')
+    parser.add_argument('--seconds', type=float, default=10, help='Tone length (default: %(default)s)')
+    parser.add_argument('--rate', type=int, default=16000, help='Tone sample rate (default: %(default)s)')
+    parser.add_argument('--channels', type=int, default=1, choices=[1, 2], help='Tone channels (default: %(default)s)')
+    parser.add_argument('--host', default='127.0.0.1', help='Receiver address (default: %(default)s)')
+    parser.add_argument('--port', type=int, default=5004, help='Receiver UDP port (default: %(default)s)')
+    parser.add_argument('--pt', type=int,
+                        help='Payload type (default: 10/11 for 44.1 kHz, else %d, the format set in menuconfig)' % PT_DYNAMIC)
+    parser.add_argument('--ptime', type=float, default=20, help='Packet length in ms (default: %(default)s)')
+    parser.add_argument('--jitter-ms', type=float, default=0,
+                        help='Random extra delay of each packet, 0..N ms (default: %(default)s)')
+    parser.add_argument('--loss', type=float, default=0, help='Packet loss probability (default: %(default)s)')
+    parser.add_argument('--duplicate', type=float, default=0, help='Packet duplicate probability (default: %(default)s)')
+    parser.add_argument('--drift-ppm', type=float, default=0,
+                        help='Sender clock error, positive sends faster (default: %(default)s)')
+    parser.add_argument('--repeat', type=int, default=1, help='Send the input N times (default: %(default)s)')
+    parser.add_argument('--seed', type=int, help='Random seed, for repeatable runs')
+    args = parser.parse_args()
+
+    if args.input:
+        sample_rate, channels, pcm = read_wav(args.input)
+    elif args.tone:
+        sample_rate, channels = args.rate, args.channels
+        pcm = make_tone(args.tone, args.seconds, sample_rate, channels)
+    else:
+        sys.exit('Input WAV or --tone is needed')
+
+    pt = args.pt
+    if pt is None:
+        pt = PT_DYNAMIC
+        if sample_rate == 44100:
+            pt = PT_L16_STEREO if channels == 2 else PT_L16_MONO
+
+    frame_size = 2 * channels
+    frames = max(1, int(sample_rate * args.ptime / 1000))
+    if frames * frame_size > MAX_PAYLOAD:
+        sys.exit('Packet of %d bytes does not fit one datagram, use a shorter --ptime' % (frames * frame_size))
+
+    rng = random.Random(args.seed)
+    ssrc = rng.getrandbits(32)
+    seq0 = rng.getrandbits(16)
+    ts0 = rng.getrandbits(32)
+    interval = args.ptime / 1000 / (1 + args.drift_ppm * 1e-6)
+
+    # Schedule all packets by their send time: nominal time plus random delay
+    queue = []
+    packet_len = frames * frame_size
+    count = 0
+    lost = duplicated = 0
+    for _ in range(args.repeat):
+        for offset in range(0, len(pcm) - packet_len + 1, packet_len):
+            if rng.random() < args.loss:
+                lost += 1
+            else:
+                send_time = count * interval + rng.uniform(0, args.jitter_ms / 1000)
+                heapq.heappush(queue, (send_time, count, offset))
+                if rng.random() < args.duplicate:
+                    duplicated += 1
+                    heapq.heappush(queue, (send_time + rng.uniform(0, args.jitter_ms / 1000), count, offset))
+            count += 1
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    print('Sending %d packets (%.1f ms, %d Hz, %d ch, PT %d) to %s:%d' %
+          (count, args.ptime, sample_rate, channels, pt, args.host, args.port))
+
+    start = time.monotonic()
+    newest = -1
+    reordered = 0
+    sent = 0
+    while queue:
+        send_time, index, offset = heapq.heappop(queue)
+        delay = start + send_time - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        if index < newest:
+            reordered += 1
+        newest = max(newest, index)
+        header = struct.pack('>BBHII', 0x80, (0x80 if index == 0 else 0) | pt,
+                             (seq0 + index) & 0xFFFF, (ts0 + index * frames) & 0xFFFFFFFF, ssrc)
+        sock.sendto(header + pcm[offset:offset + packet_len], (args.host, args.port))
+        sent += 1
+
+    print('Sent %d, lost %d, reordered %d, duplicated %d (SSRC %08x)' % (sent, lost, reordered, duplicated, ssrc))
+
+
+if __name__ == '__main__':
+    main()
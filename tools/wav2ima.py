@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Transcode 16bit PCM WAV into IMA ADPCM WAV (4:1), which is played by the
+# "WAV IMA ADPCM" decoder in main/app_audio_dec.c.
+#
+# Usage: wav2ima.py input.wav output.wav [--block-align 512]
+
+import argparse
+import struct
+import sys
+import wave
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+class ImaState:
+    def __init__(self):
+        self.predictor = 0
+        self.index = 0
+
+    def encode(self, sample):
+        step = STEP_TABLE[self.index]
+        diff = sample - self.predictor
+        nibble = 0
+        if diff < 0:
+            nibble = 8
+            diff = -diff
+
+        # Same quantization as the decoder reconstructs
+        delta = step >> 3
+        if diff >= step:
+            nibble |= 4
+            diff -= step
+            delta += step
+        step >>= 1
+        if diff >= step:
+            nibble |= 2
+            diff -= step
+            delta += step
+        step >>= 1
+        if diff >= step:
+            nibble |= 1
+            delta += step
+
+        self.predictor += -delta if nibble & 8 else delta
+        self.predictor = max(-32768, min(32767, self.predictor))
+        self.index = max(0, min(88, self.index + INDEX_TABLE[nibble]))
+        return nibble
+
+
+def encode(samples, channels, block_align):
+    frames_per_block = ((block_align - 4 * channels) * 2) // channels + 1
+    states = [ImaState() for _ in range(channels)]
+    out = bytearray()
+    frames = len(samples) // channels
+
+    for start in range(0, frames, frames_per_block):
+        count = min(frames_per_block, frames - start)
+        # Pad the last block, the real length is stored in the "fact" chunk
+        block = [samples[(start + min(i, count - 1)) * channels + c]
+                 for i in range(frames_per_block) for c in range(channels)]
+
+        for c in range(channels):
+            states[c].predictor = block[c]
+            out += struct.pack('<hBB', block[c], states[c].index, 0)
+
+        for group in range(1, frames_per_block, 8):
+            for c in range(channels):
+                nibbles = [states[c].encode(block[(group + i) * channels + c]) for i in range(8)]
+                out += bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, 8, 2))
+
+    return out, frames_per_block, frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Transcode 16bit PCM WAV to IMA ADPCM WAV')
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--block-align', type=int, default=512,
+                        help='Bytes per ADPCM block (default: %(default)s)')
+    args = parser.parse_args()
+
+    with wave.open(args.input, 'rb') as wav:
+        channels = wav.getnchannels()
+        if wav.getsampwidth() != 2 or channels > 2:
+            sys.exit('Only 16bit mono or stereo PCM is supported')
+        sample_rate = wav.getframerate()
+        raw = wav.readframes(wav.getnframes())
+
+    if (args.block_align - 4 * channels) % (4 * channels) != 0:
+        sys.exit('Block align must be 4 * channels * N + 4 * channels')
+
+    samples = struct.unpack('<%dh' % (len(raw) // 2), raw)
+    data, frames_per_block, frames = encode(samples, channels, args.block_align)
+
+    byte_rate = sample_rate * args.block_align // frames_per_block
+    fmt = struct.pack('<HHIIHHHH', 0x0011, channels, sample_rate, byte_rate,
+                      args.block_align, 4, 2, frames_per_block)
+    fact = struct.pack('<I', frames)
+    body = (b'WAVE' +
+            b'fmt ' + struct.pack('<I', len(fmt)) + fmt +
+            b'fact' + struct.pack('<I', len(fact)) + fact +
+            b'data' + struct.pack('<I', len(data)) + data)
+    if len(data) & 1:
+        body += b'\0'
+
+    with open(args.output, 'wb') as f:
+        f.write(b'RIFF' + struct.pack('<I', len(body)) + body)
+
+    print('%s: %d -> %d bytes (%d frames)' % (args.output, len(raw), len(data), frames))
+
+
+if __name__ == '__main__':
+    main()